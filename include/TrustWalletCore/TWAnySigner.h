@@ -18,6 +18,16 @@ struct TWAnySigner;
 /// Signs a transaction.
 extern TWData *_Nonnull TWAnySignerSign(TWData *_Nonnull input, enum TWCoinType coin);
 
+/// Signs a batch of transactions of the same coin, optionally on several threads.
+///
+/// Inputs are serialized SigningInputs, each prefixed with its length as a varint (protobuf length-delimited format).
+/// The serialized SigningOutputs are appended to outputs in the same format and order.  The output of an input which
+/// could not be signed is empty; if errors is provided, the error messages are appended to it in the same format
+/// (empty for inputs signed successfully).
+/// threads: number of worker threads, 0 to use all cores, 1 to sign on the calling thread.
+/// Returns the number of inputs which could not be signed, or -1 if the input stream is malformed (nothing is appended then).
+extern int TWAnySignerSignBatch(TWData *_Nonnull inputs, enum TWCoinType coin, uint32_t threads, TWData *_Nonnull outputs, TWData *_Nullable errors);
+
 /// Signs a json transaction with private key.
 extern TWString *_Nonnull TWAnySignerSignJSON(TWString *_Nonnull json, TWData *_Nonnull key, enum TWCoinType coin);
 
@@ -76,6 +76,14 @@ struct TWPrivateKey *_Nonnull TWHDWalletGetKey(struct TWHDWallet *_Nonnull walle
 TW_EXPORT_METHOD
 struct TWPrivateKey *_Nonnull TWHDWalletGetDerivedKey(struct TWHDWallet *_Nonnull wallet, enum TWCoinType coin, uint32_t account, uint32_t change, uint32_t address);
 
+/// Derives the addresses of a range of address indices, on the bip44 path of the coin with the given account and change.
+/// Change and address indices are hardened for ed25519, ed25519-blake2b-nano and curve25519 coins.
+/// The addresses are returned in index order as a stream of varint length-prefixed strings (empty if an address cannot be derived).
+/// threads: number of worker threads, 0 to use all cores, 1 to derive on the calling thread.
+/// Null is returned on an invalid index range (non-hardened indices only).
+TW_EXPORT_METHOD
+TWData *_Nullable TWHDWalletDeriveAddresses(struct TWHDWallet *_Nonnull wallet, enum TWCoinType coin, uint32_t account, uint32_t change, uint32_t startIndex, uint32_t count, uint32_t threads);
+
 /// Returns the extended private key.
 TW_EXPORT_METHOD
 TWString *_Nonnull TWHDWalletGetExtendedPrivateKey(struct TWHDWallet *_Nonnull wallet, enum TWPurpose purpose, enum TWCoinType coin, enum TWHDVersion version);
@@ -88,4 +96,9 @@ TWString *_Nonnull TWHDWalletGetExtendedPublicKey(struct TWHDWallet *_Nonnull wa
 TW_EXPORT_STATIC_METHOD
 struct TWPublicKey *_Nullable TWHDWalletGetPublicKeyFromExtended(TWString *_Nonnull extended, enum TWCoinType coin, TWString *_Nonnull derivationPath);
 
+/// Derives the addresses of a range of address indices from an extended (account) public key, in the format of TWHDWalletDeriveAddresses.
+/// Null is returned on an invalid extended key or index range.
+TW_EXPORT_STATIC_METHOD
+TWData *_Nullable TWHDWalletDeriveAddressesFromExtended(TWString *_Nonnull extended, enum TWCoinType coin, uint32_t change, uint32_t startIndex, uint32_t count, uint32_t threads);
+
 TW_EXTERN_C_END
@@ -43,6 +43,14 @@ TWData *_Nonnull TWPublicKeyData(struct TWPublicKey *_Nonnull pk);
 TW_EXPORT_METHOD
 bool TWPublicKeyVerify(struct TWPublicKey *_Nonnull pk, TWData *_Nonnull signature, TWData *_Nonnull message);
 
+/// Verifies many signatures together, each of the message and by the public key at the same index.
+///
+/// Public keys (all of the given type), signatures and messages are each prefixed with their length as a varint
+/// (protobuf length-delimited format).  Returns one byte per signature, 1 if it is valid and 0 otherwise, or null if
+/// the numbers of public keys, signatures and messages differ.  Each result is the same as TWPublicKeyVerify would return.
+TW_EXPORT_STATIC_METHOD
+TWData *_Nullable TWPublicKeyVerifyBatch(TWData *_Nonnull publicKeys, enum TWPublicKeyType type, TWData *_Nonnull signatures, TWData *_Nonnull messages);
+
 TW_EXPORT_METHOD
 bool TWPublicKeyVerifySchnorr(struct TWPublicKey *_Nonnull pk, TWData *_Nonnull signature, TWData *_Nonnull message);
 
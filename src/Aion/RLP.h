@@ -11,6 +11,7 @@
 #include "Ethereum/RLP.h"
 
 #include <boost/multiprecision/cpp_int.hpp>
+#include <array>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -21,16 +22,29 @@ namespace TW::Aion {
 /// https://github.com/aionnetwork/aion/issues/680
 struct RLP {
     static Data encodeLong(boost::multiprecision::uint128_t l) noexcept {
+        Ethereum::RLPSizer sizer;
+        addLong(sizer, l);
+        Data result(sizer.size());
+        Ethereum::RLPWriter writer(result.data());
+        addLong(writer, l);
+        return result;
+    }
+
+    /// Adds a long number to an Ethereum::RLPSizer or RLPWriter: as an Ethereum number if it fits in 32 bits, else
+    /// always in 8 bytes.
+    template <typename Sink>
+    static void addLong(Sink& rlp, boost::multiprecision::uint128_t l) noexcept {
         if ((l & 0x00000000FFFFFFFFL) == l) {
-            return Ethereum::RLP::encode(static_cast<uint256_t>(l));
+            rlp.add(static_cast<uint256_t>(l));
+            return;
         }
-        Data result(9);
-        result[0] = 0x80 + 8;
+        std::array<byte, 9> encoded;
+        encoded[0] = 0x80 + 8;
         for (int i = 8; i > 0; i--) {
-            result[i] = (byte)(l & 0xFF);
+            encoded[i] = (byte)(l & 0xFF);
             l >>= 8;
         }
-        return result;
+        rlp.addEncoded(encoded.data(), encoded.size());
     }
 };
 
@@ -13,17 +13,13 @@ using namespace TW::Aion;
 using boost::multiprecision::uint128_t;
 
 Data Transaction::encode() const noexcept {
-    auto encoded = Data();
-    append(encoded, Ethereum::RLP::encode(nonce));
-    append(encoded, Ethereum::RLP::encode(to.bytes));
-    append(encoded, Ethereum::RLP::encode(amount));
-    append(encoded, Ethereum::RLP::encode(payload));
-    append(encoded, Ethereum::RLP::encode(timestamp));
-    append(encoded, RLP::encodeLong(gasLimit));
-    append(encoded, RLP::encodeLong(gasPrice));
-    append(encoded, RLP::encodeLong(uint128_t(1))); // Aion transaction type
-    if (!signature.empty()) {
-        append(encoded, Ethereum::RLP::encode(signature));
-    }
-    return Ethereum::RLP::encodeList(encoded);
+    return Ethereum::RLP::writeList([&](auto& rlp) {
+        rlp.add(uint256_t(nonce)).add(to.bytes).add(uint256_t(amount)).add(payload).add(uint256_t(timestamp));
+        RLP::addLong(rlp, gasLimit);
+        RLP::addLong(rlp, gasPrice);
+        RLP::addLong(rlp, uint128_t(1)); // Aion transaction type
+        if (!signature.empty()) {
+            rlp.add(signature);
+        }
+    });
 }
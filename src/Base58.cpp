@@ -59,6 +59,23 @@ Base58 Base58::bitcoin = Base58(bitcoinDigits, bitcoinCharacterMap);
 
 Base58 Base58::ripple = Base58(rippleDigits, rippleCharacterMap);
 
+Data Base58::decodeCheck(const char* begin, const char* end, Hash::HasherType hasher) const {
+    auto result = decode(begin, end);
+    if (result.size() < 4) {
+        return {};
+    }
+
+    // re-calculate the checksum on the stack, ensure it matches the included 4-byte checksum
+    std::array<byte, Hash::maxDigestSize> hash;
+    Hash::hash(hasher, result.data(), result.size() - 4, hash.data());
+    if (!std::equal(hash.begin(), hash.begin() + 4, result.end() - 4)) {
+        return {};
+    }
+
+    result.resize(result.size() - 4);
+    return result;
+}
+
 Data Base58::decodeCheck(const char* begin, const char* end, Hash::Hasher hasher) const {
     auto result = decode(begin, end);
     if (result.size() < 4) {
@@ -140,6 +157,17 @@ Data Base58::decode(const char* begin, const char* end) const {
     return result;
 }
 
+std::string Base58::encodeCheck(const byte* begin, const byte* end, Hash::HasherType hasher) const {
+    // add 4-byte hash check to the end
+    std::array<byte, Hash::maxDigestSize> hash;
+    Hash::hash(hasher, begin, end - begin, hash.data());
+    Data dataWithCheck;
+    dataWithCheck.reserve(end - begin + 4);
+    dataWithCheck.assign(begin, end);
+    dataWithCheck.insert(dataWithCheck.end(), hash.begin(), hash.begin() + 4);
+    return encode(dataWithCheck);
+}
+
 std::string Base58::encodeCheck(const byte* begin, const byte* end, Hash::Hasher hasher) const {
     // add 4-byte hash check to the end
     Data dataWithCheck(begin, end);
@@ -10,6 +10,7 @@
 #include "CashAddress.h"
 #include "SegwitAddress.h"
 #include "Signer.h"
+#include "../Hash.h"
 
 using namespace TW::Bitcoin;
 using namespace std;
@@ -55,15 +56,26 @@ string Entry::normalizeAddress(TWCoinType coin, const string& address) const {
     }
 }
 
-string Entry::deriveAddress(TWCoinType coin, const PublicKey& publicKey, TW::byte p2pkh, const char* hrp) const {
+/// Whether the default address of a coin is a native segwit one.
+static bool segwitDefault(TWCoinType coin) {
     switch (coin) {
         case TWCoinTypeBitcoin:
         case TWCoinTypeDigiByte:
         case TWCoinTypeLitecoin:
         case TWCoinTypeViacoin:
         case TWCoinTypeBitcoinGold:
-            return SegwitAddress(publicKey, 0, hrp).string();
+            return true;
+
+        default:
+            return false;
+    }
+}
 
+string Entry::deriveAddress(TWCoinType coin, const PublicKey& publicKey, TW::byte p2pkh, const char* hrp) const {
+    if (segwitDefault(coin)) {
+        return SegwitAddress(publicKey, 0, hrp).string();
+    }
+    switch (coin) {
         case TWCoinTypeBitcoinCash:
             return CashAddress(publicKey).string();
 
@@ -78,10 +90,49 @@ string Entry::deriveAddress(TWCoinType coin, const PublicKey& publicKey, TW::byt
     }
 }
 
+void Entry::deriveAddresses(TWCoinType coin, const std::vector<PublicKey>& publicKeys, TW::byte p2pkh, const char* hrp,
+                            std::vector<std::string>& addresses) const {
+    if (coin == TWCoinTypeBitcoinCash) {
+        CoinEntry::deriveAddresses(coin, publicKeys, p2pkh, hrp, addresses);
+        return;
+    }
+
+    // the public key hashes of all compressed keys at once
+    std::vector<const TW::byte*> data;
+    std::vector<size_t> sizes;
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < publicKeys.size(); ++i) {
+        if (publicKeys[i].type != TWPublicKeyTypeSECP256k1) {
+            continue;
+        }
+        data.push_back(publicKeys[i].bytes.data());
+        sizes.push_back(publicKeys[i].bytes.size());
+        indices.push_back(i);
+    }
+    std::vector<TW::Hash::Digest<TW::Hash::ripemdSize>> hashes(indices.size());
+    TW::Hash::sha256ripemdMulti(data.data(), sizes.data(), indices.size(), hashes.data());
+
+    const auto segwit = segwitDefault(coin);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (segwit) {
+            addresses[indices[i]] = SegwitAddress(hrp, 0, TW::Data(hashes[i].begin(), hashes[i].end())).string();
+        } else {
+            auto bytes = TW::Data{p2pkh};
+            bytes.insert(bytes.end(), hashes[i].begin(), hashes[i].end());
+            addresses[indices[i]] = Address(bytes).string();
+        }
+    }
+}
+
 void Entry::sign(TWCoinType coin, const TW::Data& dataIn, TW::Data& dataOut) const {
     signTemplate<Signer, Proto::SigningInput>(dataIn, dataOut);
 }
 
+void Entry::signBatch(TWCoinType coin, const std::vector<TW::Data>& inputs, size_t begin, size_t end,
+                      std::vector<TW::Data>& outputs, std::vector<std::string>& errors) const {
+    signBatchTemplate<Signer, Proto::SigningInput>(inputs, begin, end, outputs, errors);
+}
+
 void Entry::plan(TWCoinType coin, const TW::Data& dataIn, TW::Data& dataOut) const {
     planTemplate<Signer, Proto::SigningInput>(dataIn, dataOut);
 }
@@ -0,0 +1,30 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include "../Data.h"
+
+namespace TW::Bitcoin {
+
+/// Signature hash components which depend only on the transaction, not on the input being signed
+/// (the BIP143 / ZIP243 midstate).  Computed once per transaction and reused for every input,
+/// so signing N inputs does not rehash all inputs and outputs N times.
+struct SigHashCache {
+    /// Hash of all input outpoints
+    Data hashPrevouts;
+
+    /// Hash of all input sequence numbers
+    Data hashSequence;
+
+    /// Hash of all outputs
+    Data hashOutputs;
+
+    /// Serialized outputs, used by the legacy (BASE) signature hash
+    Data outputs;
+};
+
+} // namespace TW::Bitcoin
@@ -20,17 +20,23 @@ using namespace TW::Bitcoin;
 
 Data Transaction::getPreImage(const Script& scriptCode, size_t index,
                               enum TWBitcoinSigHashType hashType, uint64_t amount) const {
+    return getPreImage(scriptCode, index, hashType, amount, getSigHashCache());
+}
+
+Data Transaction::getPreImage(const Script& scriptCode, size_t index,
+                              enum TWBitcoinSigHashType hashType, uint64_t amount,
+                              const SigHashCache& cache) const {
     assert(index < inputs.size());
 
     Data data;
+    data.reserve(4 + 32 + 32 + 36 + scriptCode.bytes.size() + 9 + 8 + 4 + 32 + 4 + 4);
 
     // Version
     encode32LE(version, data);
 
     // Input prevouts (none/all, depending on flags)
     if ((hashType & TWBitcoinSigHashTypeAnyoneCanPay) == 0) {
-        auto hashPrevouts = getPrevoutHash();
-        std::copy(std::begin(hashPrevouts), std::end(hashPrevouts), std::back_inserter(data));
+        append(data, cache.hashPrevouts);
     } else {
         std::fill_n(back_inserter(data), 32, 0);
     }
@@ -38,8 +44,7 @@ Data Transaction::getPreImage(const Script& scriptCode, size_t index,
     // Input nSequence (none/all, depending on flags)
     if ((hashType & TWBitcoinSigHashTypeAnyoneCanPay) == 0 &&
         !hashTypeIsSingle(hashType) && !hashTypeIsNone(hashType)) {
-        auto hashSequence = getSequenceHash();
-        std::copy(std::begin(hashSequence), std::end(hashSequence), std::back_inserter(data));
+        append(data, cache.hashSequence);
     } else {
         std::fill_n(back_inserter(data), 32, 0);
     }
@@ -55,8 +60,7 @@ Data Transaction::getPreImage(const Script& scriptCode, size_t index,
 
     // Outputs (none/one/all, depending on flags)
     if (!hashTypeIsSingle(hashType) && !hashTypeIsNone(hashType)) {
-        auto hashOutputs = getOutputsHash();
-        copy(begin(hashOutputs), end(hashOutputs), back_inserter(data));
+        append(data, cache.hashOutputs);
     } else if (hashTypeIsSingle(hashType) && index < outputs.size()) {
         Data outputData;
         outputs[index].encode(outputData);
@@ -103,6 +107,17 @@ Data Transaction::getOutputsHash() const {
     return hash;
 }
 
+SigHashCache Transaction::getSigHashCache() const {
+    SigHashCache cache;
+    cache.hashPrevouts = getPrevoutHash();
+    cache.hashSequence = getSequenceHash();
+    for (auto& output : outputs) {
+        output.encode(cache.outputs);
+    }
+    cache.hashOutputs = Hash::hash(hasher, cache.outputs);
+    return cache;
+}
+
 void Transaction::encode(Data& data, enum SegwitFormatMode segwitFormat) const {
     bool useWitnessFormat = true;
     switch (segwitFormat) {
@@ -151,29 +166,37 @@ bool Transaction::hasWitness() const {
 Data Transaction::getSignatureHash(const Script& scriptCode, size_t index,
                                    enum TWBitcoinSigHashType hashType, uint64_t amount,
                                    enum SignatureVersion version) const {
+    return getSignatureHash(scriptCode, index, hashType, amount, version, getSigHashCache());
+}
+
+Data Transaction::getSignatureHash(const Script& scriptCode, size_t index,
+                                   enum TWBitcoinSigHashType hashType, uint64_t amount,
+                                   enum SignatureVersion version, const SigHashCache& cache) const {
     switch (version) {
     case BASE:
-        return getSignatureHashBase(scriptCode, index, hashType);
+        return getSignatureHashBase(scriptCode, index, hashType, cache);
     case WITNESS_V0:
-        return getSignatureHashWitnessV0(scriptCode, index, hashType, amount);
+        return getSignatureHashWitnessV0(scriptCode, index, hashType, amount, cache);
     }
 }
 
 /// Generates the signature hash for Witness version 0 scripts.
 Data Transaction::getSignatureHashWitnessV0(const Script& scriptCode, size_t index,
                                             enum TWBitcoinSigHashType hashType,
-                                            uint64_t amount) const {
-    auto preimage = getPreImage(scriptCode, index, hashType, amount);
+                                            uint64_t amount, const SigHashCache& cache) const {
+    auto preimage = getPreImage(scriptCode, index, hashType, amount, cache);
     auto hash = Hash::hash(hasher, preimage);
     return hash;
 }
 
 /// Generates the signature hash for for scripts other than witness scripts.
 Data Transaction::getSignatureHashBase(const Script& scriptCode, size_t index,
-                                       enum TWBitcoinSigHashType hashType) const {
+                                       enum TWBitcoinSigHashType hashType, const SigHashCache& cache) const {
     assert(index < inputs.size());
 
     Data data;
+    // every serialized input is 36 (outpoint) + 1 (empty script) + 4 (sequence) bytes, except the one signed
+    data.reserve(4 + 9 + inputs.size() * 41 + scriptCode.bytes.size() + 9 + cache.outputs.size() + 4 + 4);
 
     encode32LE(version, data);
 
@@ -188,12 +211,17 @@ Data Transaction::getSignatureHashBase(const Script& scriptCode, size_t index,
     auto hashSingle = hashTypeIsSingle(hashType);
     auto serializedOutputCount = hashNone ? 0 : (hashSingle ? index + 1 : outputs.size());
     encodeVarInt(serializedOutputCount, data);
-    for (auto subindex = 0; subindex < serializedOutputCount; subindex += 1) {
-        if (hashSingle && subindex != index) {
-            auto output = TransactionOutput(-1, {});
-            output.encode(data);
-        } else {
-            outputs[subindex].encode(data);
+    if (!hashNone && !hashSingle) {
+        // all outputs, serialized once per transaction
+        append(data, cache.outputs);
+    } else {
+        for (auto subindex = 0; subindex < serializedOutputCount; subindex += 1) {
+            if (hashSingle && subindex != index) {
+                auto output = TransactionOutput(-1, {});
+                output.encode(data);
+            } else {
+                outputs[subindex].encode(data);
+            }
         }
     }
 
@@ -13,6 +13,7 @@
 #include "../Hash.h"
 #include "../Data.h"
 
+#include "SigHashCache.h"
 #include "SignatureVersion.h"
 #include <vector>
 
@@ -57,10 +58,16 @@ public:
 
     /// Generates the signature pre-image.
     Data getPreImage(const Script& scriptCode, size_t index, enum TWBitcoinSigHashType hashType, uint64_t amount) const;
+    /// Generates the signature pre-image, using previously computed transaction-wide hashes.
+    Data getPreImage(const Script& scriptCode, size_t index, enum TWBitcoinSigHashType hashType, uint64_t amount,
+                     const SigHashCache& cache) const;
     Data getPrevoutHash() const;
     Data getSequenceHash() const;
     Data getOutputsHash() const;
 
+    /// Computes the signature hash components shared by all inputs; to be reused when signing multiple inputs.
+    SigHashCache getSigHashCache() const;
+
     enum SegwitFormatMode {
         NonSegwit,
         IfHasWitness,
@@ -82,6 +89,10 @@ public:
     Data getSignatureHash(const Script& scriptCode, size_t index, enum TWBitcoinSigHashType hashType,
                           uint64_t amount, enum SignatureVersion version) const;
 
+    /// Generates the signature hash for this transaction, using previously computed transaction-wide hashes.
+    Data getSignatureHash(const Script& scriptCode, size_t index, enum TWBitcoinSigHashType hashType,
+                          uint64_t amount, enum SignatureVersion version, const SigHashCache& cache) const;
+
     void serializeInput(size_t subindex, const Script&, size_t index, enum TWBitcoinSigHashType hashType, Data& data) const;
 
     /// Converts to Protobuf model
@@ -90,11 +101,12 @@ public:
 private:
     /// Generates the signature hash for Witness version 0 scripts.
     Data getSignatureHashWitnessV0(const Script& scriptCode, size_t index,
-                                   enum TWBitcoinSigHashType hashType, uint64_t amount) const;
+                                   enum TWBitcoinSigHashType hashType, uint64_t amount,
+                                   const SigHashCache& cache) const;
 
     /// Generates the signature hash for for scripts other than witness scripts.
     Data getSignatureHashBase(const Script& scriptCode, size_t index,
-                              enum TWBitcoinSigHashType hashType) const;
+                              enum TWBitcoinSigHashType hashType, const SigHashCache& cache) const;
 };
 
 } // namespace TW::Bitcoin
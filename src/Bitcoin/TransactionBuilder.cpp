@@ -66,7 +66,8 @@ TransactionPlan TransactionBuilder::plan(const Bitcoin::Proto::SigningInput& inp
     auto plan = TransactionPlan();
 
     const auto& feeCalculator = getFeeCalculator(static_cast<TWCoinType>(input.coin_type()));
-    auto unspentSelector = UnspentSelector(feeCalculator);
+    const auto algorithm = input.input_selector() == Proto::BranchAndBound ? UnspentSelector::BranchAndBound : UnspentSelector::Compatible;
+    auto unspentSelector = UnspentSelector(feeCalculator, algorithm);
     bool maxAmount = input.use_max_amount();
 
     if (input.amount() == 0 && !maxAmount) {
@@ -127,6 +128,16 @@ TransactionPlan TransactionBuilder::plan(const Bitcoin::Proto::SigningInput& inp
 
             // compute change
             plan.change = plan.availableAmount - plan.amount - plan.fee;
+
+            if (!maxAmount && algorithm == UnspentSelector::BranchAndBound) {
+                // inputs which need no change output: the excess, less than the cost of a change, goes to the fee
+                const auto excess = plan.availableAmount - input.amount() - feeCalculator.calculate(plan.utxos.size(), 1, input.byte_fee());
+                if (excess >= 0 && excess <= unspentSelector.costOfChange(input.byte_fee(), output_size)) {
+                    plan.amount = input.amount();
+                    plan.fee = plan.availableAmount - plan.amount;
+                    plan.change = 0;
+                }
+            }
         }
     }
     assert(plan.change >= 0 && plan.change <= plan.availableAmount);
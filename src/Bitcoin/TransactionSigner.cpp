@@ -35,6 +35,9 @@ Result<Transaction, Common::Proto::SigningError> TransactionSigner<Transaction,
     signedInputs.clear();
     std::copy(std::begin(transaction.inputs), std::end(transaction.inputs),
               std::back_inserter(signedInputs));
+    if (!estimationMode) {
+        sigHashCache = transaction.getSigHashCache();
+    }
 
     const auto hashSingle = hashTypeIsSingle(static_cast<enum TWBitcoinSigHashType>(input.hash_type()));
     for (auto i = 0; i < plan.utxos.size(); i++) {
@@ -134,10 +137,8 @@ Result<void, Common::Proto::SigningError> TransactionSigner<Transaction, Transac
 template <typename Transaction, typename TransactionBuilder>
 Result<std::vector<Data>, Common::Proto::SigningError> TransactionSigner<Transaction, TransactionBuilder>::signStep(
     Script script, size_t index, const Proto::UnspentTransaction& utxo, uint32_t version) const {
-    Transaction transactionToSign(transaction);
-    transactionToSign.inputs = signedInputs;
-    transactionToSign.outputs = transaction.outputs;
-
+    // Note: signature hashes do not depend on the scripts of the other inputs, so the unsigned
+    // transaction can be used directly, no need to copy in the already signed inputs.
     Data data;
     std::vector<Data> keys;
     int required;
@@ -178,7 +179,7 @@ Result<std::vector<Data>, Common::Proto::SigningError> TransactionSigner<Transac
                 // Error: missing key
                 return Result<std::vector<Data>, Common::Proto::SigningError>::failure(Common::Proto::Error_missing_private_key);
             }
-            auto signature = createSignature(transactionToSign, script, pair, index, utxo.amount(), version);
+            auto signature = createSignature(script, pair, index, utxo.amount(), version);
             if (signature.empty()) {
                 // Error: Failed to sign
                 return Result<std::vector<Data>, Common::Proto::SigningError>::failure(Common::Proto::Error_signing);
@@ -195,7 +196,7 @@ Result<std::vector<Data>, Common::Proto::SigningError> TransactionSigner<Transac
             // Error: Missing key
             return Result<std::vector<Data>, Common::Proto::SigningError>::failure(Common::Proto::Error_missing_private_key);
         }
-        auto signature = createSignature(transactionToSign, script, pair, index, utxo.amount(), version);
+        auto signature = createSignature(script, pair, index, utxo.amount(), version);
         if (signature.empty()) {
             // Error: Failed to sign
             return Result<std::vector<Data>, Common::Proto::SigningError>::failure(Common::Proto::Error_signing);
@@ -208,7 +209,7 @@ Result<std::vector<Data>, Common::Proto::SigningError> TransactionSigner<Transac
             // Error: Missing keys
             return Result<std::vector<Data>, Common::Proto::SigningError>::failure(Common::Proto::Error_missing_private_key);
         }
-        auto signature = createSignature(transactionToSign, script, pair, index, utxo.amount(), version);
+        auto signature = createSignature(script, pair, index, utxo.amount(), version);
         if (signature.empty()) {
             // Error: Failed to sign
             return Result<std::vector<Data>, Common::Proto::SigningError>::failure(Common::Proto::Error_signing);
@@ -226,8 +227,7 @@ Result<std::vector<Data>, Common::Proto::SigningError> TransactionSigner<Transac
 
 template <typename Transaction, typename TransactionBuilder>
 Data TransactionSigner<Transaction, TransactionBuilder>::createSignature(
-    const Transaction& transaction,
-    const Script& script, 
+    const Script& script,
     const std::optional<KeyPair>& pair,
     size_t index,
     Amount amount,
@@ -239,7 +239,7 @@ Data TransactionSigner<Transaction, TransactionBuilder>::createSignature(
     }
     auto key = std::get<0>(pair.value());
     Data sighash = transaction.getSignatureHash(script, index, static_cast<TWBitcoinSigHashType>(input.hash_type()), amount,
-                                                static_cast<SignatureVersion>(version));
+                                                static_cast<SignatureVersion>(version), sigHashCache);
     auto pk = PrivateKey(key);
     auto sig = pk.signAsDER(sighash, TWCurveSECP256k1);
     if (!sig.empty()) {
@@ -274,18 +274,25 @@ Data TransactionSigner<Transaction, TransactionBuilder>::pushAll(const std::vect
 }
 
 template <typename Transaction, typename TransactionBuilder>
-std::optional<KeyPair> TransactionSigner<Transaction, TransactionBuilder>::keyPairForPubKeyHash(const Data& hash) const {
+void TransactionSigner<Transaction, TransactionBuilder>::indexKeyPairs() {
+    keyPairs.clear();
     for (auto& key : input.private_key()) {
         auto privKey = PrivateKey(key);
         auto pubKeyExtended = privKey.getPublicKey(TWPublicKeyTypeSECP256k1Extended);
         auto pubKey = pubKeyExtended.compressed();
-        if (Hash::sha256ripemd(pubKey.bytes.data(), pubKey.bytes.size()) == hash) {
-            return std::make_tuple(privKey, pubKey);
-        } else if (Hash::sha256ripemd(pubKeyExtended.bytes.data(), pubKeyExtended.bytes.size()) == hash) {
-            return std::make_tuple(privKey, pubKeyExtended);
-        }
+        // emplace keeps the first entry, so the earliest matching key wins, as with a linear search
+        keyPairs.emplace(Hash::sha256ripemd(pubKey.bytes.data(), pubKey.bytes.size()), std::make_tuple(privKey, pubKey));
+        keyPairs.emplace(Hash::sha256ripemd(pubKeyExtended.bytes.data(), pubKeyExtended.bytes.size()), std::make_tuple(privKey, pubKeyExtended));
+    }
+}
+
+template <typename Transaction, typename TransactionBuilder>
+std::optional<KeyPair> TransactionSigner<Transaction, TransactionBuilder>::keyPairForPubKeyHash(const Data& hash) const {
+    auto it = keyPairs.find(hash);
+    if (it == keyPairs.end()) {
+        return {};
     }
-    return {};
+    return it->second;
 }
 
 template <typename Transaction, typename TransactionBuilder>
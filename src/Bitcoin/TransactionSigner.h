@@ -8,6 +8,7 @@
 
 #include "Amount.h"
 #include "Script.h"
+#include "SigHashCache.h"
 #include "Transaction.h"
 #include "TransactionBuilder.h"
 #include "TransactionInput.h"
@@ -20,6 +21,7 @@
 #include "../Zcash/TransactionBuilder.h"
 #include "../proto/Bitcoin.pb.h"
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -45,6 +47,12 @@ class TransactionSigner {
     /// List of signed inputs.
     std::vector<TransactionInput> signedInputs;
 
+    /// Signature hash components shared by all inputs, computed once per sign().
+    SigHashCache sigHashCache;
+
+    /// Key pairs of the input private keys, by public key hash (both compressed and extended public keys).
+    std::map<Data, KeyPair> keyPairs;
+
     bool estimationMode = false;
 
   public:
@@ -60,6 +68,7 @@ class TransactionSigner {
       transaction = TransactionBuilder::template build<Transaction>(
         plan, input.to_address(), input.change_address(), TWCoinType(input.coin_type()), input.lock_time()
       );
+      indexKeyPairs();
     }
 
     /// Signs the transaction.
@@ -77,9 +86,12 @@ class TransactionSigner {
     Result<void, Common::Proto::SigningError> sign(Script script, size_t index, const Proto::UnspentTransaction& utxo);
     Result<std::vector<Data>, Common::Proto::SigningError> signStep(Script script, size_t index,
                                        const Proto::UnspentTransaction& utxo, uint32_t version) const;
-    Data createSignature(const Transaction& transaction, const Script& script, const std::optional<KeyPair>&,
+    Data createSignature(const Script& script, const std::optional<KeyPair>&,
                          size_t index, Amount amount, uint32_t version) const;
 
+    /// Derives the public keys of the input private keys, and indexes them by public key hash.
+    void indexKeyPairs();
+
     /// Returns the private key for the given public key hash.
     std::optional<KeyPair> keyPairForPubKeyHash(const Data& hash) const;
 
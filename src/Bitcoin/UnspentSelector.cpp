@@ -8,23 +8,19 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
+#include <random>
 
 using namespace TW;
 using namespace TW::Bitcoin;
 
-/// A selection of unspent transactions.
-struct Selection {
-    std::vector<Proto::UnspentTransaction> utxos;
-    int64_t total;
-};
-
 // Filters utxos that are dust
 template <typename T>
 std::vector<Proto::UnspentTransaction>
 UnspentSelector::filterDustInput(const T& selectedUtxos, int64_t byteFee) {
     auto inputFeeLimit = feeCalculator.calculateSingleInput(byteFee);
     std::vector<Proto::UnspentTransaction> filteredUtxos;
-    for (auto utxo: selectedUtxos) {
+    for (const auto& utxo: selectedUtxos) {
         if (utxo.amount() > inputFeeLimit) {
             filteredUtxos.push_back(utxo);
         }
@@ -32,56 +28,68 @@ UnspentSelector::filterDustInput(const T& selectedUtxos, int64_t byteFee) {
     return filteredUtxos;
 }
 
-// Slice Array
-// [0,1,2,3,4,5,6,7,8,9].eachSlices(3)
-// >
-// [[0, 1, 2], [1, 2, 3], [2, 3, 4], [3, 4, 5], [4, 5, 6], [5, 6, 7], [6, 7, 8],
-// [7, 8, 9]]
 template <typename T>
-static inline auto slice(const T& elements, size_t sliceSize) {
-    std::vector<std::vector<Proto::UnspentTransaction>> slices;
-    for (auto i = 0; i <= elements.size() - sliceSize; i += 1) {
-        slices.emplace_back();
-        slices[i].reserve(sliceSize);
-        for (auto j = i; j < i + sliceSize; j += 1) {
-            slices[i].push_back(elements[j]);
-        }
+std::vector<Proto::UnspentTransaction>
+UnspentSelector::select(const T& utxos, int64_t targetValue, int64_t byteFee, int64_t numOutputs) {
+    // work on amounts only, UTXOs are copied only once selected
+    std::vector<int64_t> amounts;
+    amounts.reserve(utxos.size());
+    for (const auto& utxo : utxos) {
+        amounts.push_back(utxo.amount());
+    }
+
+    const auto indices = selectIndices(amounts, targetValue, byteFee, numOutputs);
+    std::vector<Proto::UnspentTransaction> selected;
+    selected.reserve(indices.size());
+    for (auto index : indices) {
+        selected.push_back(utxos[static_cast<int>(index)]);
     }
-    return slices;
+    return selected;
 }
 
-template <typename T>
-std::vector<Proto::UnspentTransaction>
-UnspentSelector::select(const T& utxos, int64_t targetValue, int64_t byteFee, int64_t numOutputs) {
+std::vector<size_t> UnspentSelector::selectIndices(const std::vector<int64_t>& amounts, int64_t targetValue,
+                                                   int64_t byteFee, int64_t numOutputs) const {
     // if target value is zero, no UTXOs are needed
     if (targetValue == 0) {
         return {};
     }
 
     // total values of utxos should be greater than targetValue
-    if (utxos.empty() || sum(utxos) < targetValue) {
+    if (amounts.empty() || std::accumulate(amounts.begin(), amounts.end(), int64_t(0)) < targetValue) {
         return {};
     }
-    assert(utxos.size() >= 1);
+    assert(amounts.size() >= 1);
+
+    if (algorithm == BranchAndBound) {
+        auto selected = selectBranchAndBound(amounts, targetValue, byteFee, numOutputs);
+        if (selected.empty()) {
+            selected = selectKnapsack(amounts, targetValue, byteFee, numOutputs);
+        }
+        if (!selected.empty()) {
+            return selected;
+        }
+    }
+    return selectCompatible(amounts, targetValue, byteFee, numOutputs);
+}
 
+std::vector<size_t> UnspentSelector::selectCompatible(const std::vector<int64_t>& amounts, int64_t targetValue,
+                                                      int64_t byteFee, int64_t numOutputs) const {
     // definitions for the following caluculation
     const auto doubleTargetValue = targetValue * 2;
 
-    // Get all possible utxo selections up to a maximum size, sort by total amount, increasing
-    auto sortedUtxos = utxos;
-    std::sort(sortedUtxos.begin(), sortedUtxos.end(),
-              [](const Proto::UnspentTransaction& lhs, const Proto::UnspentTransaction& rhs) {
-                  return lhs.amount() < rhs.amount();
-              });
-    // Precompute maximum amount possible to obtain with given number of UTXOs
-    const auto n = sortedUtxos.size();
-    std::vector<uint64_t> maxWithXInputs = std::vector<uint64_t>();
-    maxWithXInputs.push_back(0);
-    int64_t maxSum = 0;
-    for (auto i = 0; i < n; ++i) {
-        maxSum += sortedUtxos[n - 1 - i].amount();
-        maxWithXInputs.push_back(maxSum);
+    // Sort by amount, increasing (indices only).
+    std::vector<size_t> sorted(amounts.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&amounts](size_t lhs, size_t rhs) { return amounts[lhs] < amounts[rhs]; });
+    // Prefix sums, sum of a slice [i, i + numInputs) is prefix[i + numInputs] - prefix[i]
+    const auto n = sorted.size();
+    std::vector<int64_t> prefix(n + 1, 0);
+    for (auto i = 0ul; i < n; ++i) {
+        prefix[i + 1] = prefix[i] + amounts[sorted[i]];
     }
+    // Maximum amount possible to obtain with given number of UTXOs, that is the sum of the last slice
+    auto maxWithXInputs = [&prefix, n](size_t numInputs) { return prefix[n] - prefix[n - numInputs]; };
 
     // difference from 2x targetValue
     auto distFrom2x = [doubleTargetValue](int64_t val) -> int64_t {
@@ -93,57 +101,272 @@ UnspentSelector::select(const T& utxos, int64_t targetValue, int64_t byteFee, in
 
     const int64_t dustThreshold = feeCalculator.calculateSingleInput(byteFee);
 
+    // Selected slice, without dust inputs
+    auto sliceAt = [&](size_t start, size_t numInputs) {
+        std::vector<size_t> selected;
+        selected.reserve(numInputs);
+        for (auto i = start; i < start + numInputs; ++i) {
+            if (amounts[sorted[i]] > dustThreshold) {
+                selected.push_back(sorted[i]);
+            }
+        }
+        return selected;
+    };
+
     // 1. Find a combination of the fewest inputs that is
     //    (1) bigger than what we need
     //    (2) closer to 2x the amount,
     //    (3) and does not produce dust change.
-    for (int64_t numInputs = 1; numInputs <= n; ++numInputs) {
+    // Slices (of consecutive sorted UTXOs) are examined without being materialized.
+    for (size_t numInputs = 1; numInputs <= n; ++numInputs) {
         const auto fee = feeCalculator.calculate(numInputs, numOutputs, byteFee);
         const auto targetWithFeeAndDust = targetValue + fee + dustThreshold;
-        if (maxWithXInputs[numInputs] < targetWithFeeAndDust) {
+        if (maxWithXInputs(numInputs) < targetWithFeeAndDust) {
             // no way to satisfy with only numInputs inputs, skip
             continue;
         }
-        auto slices = slice(sortedUtxos, static_cast<size_t>(numInputs));
-        slices.erase(
-            std::remove_if(slices.begin(), slices.end(),
-                [targetWithFeeAndDust](const std::vector<Proto::UnspentTransaction>& slice) {
-                    return sum(slice) < targetWithFeeAndDust;
-                }),
-            slices.end());
-        if (!slices.empty()) {
-            std::sort(slices.begin(), slices.end(),
-                [distFrom2x](const std::vector<Proto::UnspentTransaction>& lhs,
-                            const std::vector<Proto::UnspentTransaction>& rhs) {
-                    return distFrom2x(sum(lhs)) < distFrom2x(sum(rhs));
-                });
-            return filterDustInput(slices.front(), byteFee);
+        // the last slice is sufficient, so there is a match; on ties the first slice wins
+        size_t best = n;
+        int64_t bestDist = 0;
+        for (size_t start = 0; start + numInputs <= n; ++start) {
+            const auto sum = prefix[start + numInputs] - prefix[start];
+            if (sum >= targetWithFeeAndDust && (best == n || distFrom2x(sum) < bestDist)) {
+                best = start;
+                bestDist = distFrom2x(sum);
+            }
         }
+        return sliceAt(best, numInputs);
     }
 
     // 2. If not, find a valid combination of outputs even if they produce dust change.
-    for (int64_t numInputs = 1; numInputs <= n; ++numInputs) {
+    for (size_t numInputs = 1; numInputs <= n; ++numInputs) {
         const auto fee = feeCalculator.calculate(numInputs, numOutputs, byteFee);
         const auto targetWithFee = targetValue + fee;
-        if (maxWithXInputs[numInputs] < targetWithFee) {
+        if (maxWithXInputs(numInputs) < targetWithFee) {
             // no way to satisfy with only numInputs inputs, skip
             continue;
         }
-        auto slices = slice(sortedUtxos, static_cast<size_t>(numInputs));
-        slices.erase(
-            std::remove_if(slices.begin(), slices.end(),
-                [targetWithFee](const std::vector<Proto::UnspentTransaction>& slice) {
-                    return sum(slice) < targetWithFee;
-                }),
-            slices.end());
-        if (!slices.empty()) {
-            return filterDustInput(slices.front(), byteFee);
+        // slice sums are increasing, take the first sufficient one
+        for (size_t start = 0; start + numInputs <= n; ++start) {
+            if (prefix[start + numInputs] - prefix[start] >= targetWithFee) {
+                return sliceAt(start, numInputs);
+            }
         }
     }
 
     return {};
 }
 
+namespace {
+
+/// Tracks the search effort against a Budget.
+class BudgetTracker {
+  public:
+    explicit BudgetTracker(const UnspentSelector::Budget& budget)
+        : budget(budget), deadline(std::chrono::steady_clock::now() + budget.maxTime) {}
+
+    /// Counts one search step, returns false if the budget is exhausted.
+    bool step() {
+        ++tries;
+        if (tries > budget.maxTries) {
+            return false;
+        }
+        // check the clock only occasionally
+        if (budget.maxTime.count() > 0 && (tries % 1024) == 0 && std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        return true;
+    }
+
+  private:
+    const UnspentSelector::Budget& budget;
+    const std::chrono::steady_clock::time_point deadline;
+    size_t tries = 0;
+};
+
+/// UTXOs with positive effective value (amount less the fee of spending it), as (index, effective value),
+/// sorted by decreasing effective value, limited to maxCandidates.
+std::vector<std::pair<size_t, int64_t>> effectiveValues(const std::vector<int64_t>& amounts, int64_t inputFee, size_t maxCandidates) {
+    std::vector<std::pair<size_t, int64_t>> candidates;
+    candidates.reserve(amounts.size());
+    for (auto i = 0ul; i < amounts.size(); ++i) {
+        if (amounts[i] > inputFee) {
+            candidates.emplace_back(i, amounts[i] - inputFee);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+    if (maxCandidates > 0 && candidates.size() > maxCandidates) {
+        candidates.resize(maxCandidates);
+    }
+    return candidates;
+}
+
+/// Returns the UTXO indices of the chosen candidates, in original order.
+std::vector<size_t> chosenIndices(const std::vector<std::pair<size_t, int64_t>>& candidates, const std::vector<bool>& chosen) {
+    std::vector<size_t> indices;
+    for (auto i = 0ul; i < chosen.size(); ++i) {
+        if (chosen[i]) {
+            indices.push_back(candidates[i].first);
+        }
+    }
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+} // namespace
+
+int64_t UnspentSelector::costOfChange(int64_t byteFee, int64_t numOutputs) const {
+    // creating the change output now, plus spending it later
+    const auto noChangeOutputs = std::max(int64_t(1), numOutputs - 1);
+    return feeCalculator.calculate(0, noChangeOutputs + 1, byteFee) - feeCalculator.calculate(0, noChangeOutputs, byteFee) +
+           feeCalculator.calculateSingleInput(byteFee);
+}
+
+std::vector<size_t> UnspentSelector::selectBranchAndBound(const std::vector<int64_t>& amounts, int64_t targetValue,
+                                                          int64_t byteFee, int64_t numOutputs) const {
+    // Depth-first search over include/exclude decisions on UTXOs sorted by decreasing effective value,
+    // for a selection covering target and fee without change output, with excess less than the cost of a change.
+    // See also https://github.com/bitcoin/bitcoin/blob/master/src/wallet/coinselection.cpp (SelectCoinsBnB)
+    const auto inputFee = feeCalculator.calculateSingleInput(byteFee);
+    const auto noChangeOutputs = std::max(int64_t(1), numOutputs - 1);
+    const auto target = targetValue + feeCalculator.calculate(0, noChangeOutputs, byteFee);
+    const auto costOfChange = this->costOfChange(byteFee, numOutputs);
+
+    const auto candidates = effectiveValues(amounts, inputFee, budget.maxCandidates);
+    int64_t available = 0;
+    for (const auto& candidate : candidates) {
+        available += candidate.second;
+    }
+    if (available < target) {
+        return {};
+    }
+
+    auto tracker = BudgetTracker(budget);
+    int64_t value = 0;
+    std::vector<bool> selection; // decisions on the first selection.size() candidates
+    selection.reserve(candidates.size());
+    std::vector<bool> best;
+    int64_t bestWaste = std::numeric_limits<int64_t>::max();
+    while (tracker.step()) {
+        bool backtrack = false;
+        if (value + available < target || value > target + costOfChange) {
+            // cannot reach the target, or already over it by too much
+            backtrack = true;
+        } else if (value >= target) {
+            const auto waste = value - target;
+            if (waste <= bestWaste) {
+                best = selection;
+                best.resize(candidates.size());
+                bestWaste = waste;
+                if (bestWaste == 0) {
+                    break;
+                }
+            }
+            backtrack = true;
+        }
+
+        if (backtrack) {
+            // walk back to the last included candidate and exclude it
+            while (!selection.empty() && !selection.back()) {
+                selection.pop_back();
+                available += candidates[selection.size()].second;
+            }
+            if (selection.empty()) {
+                // explored all
+                break;
+            }
+            selection.back() = false;
+            value -= candidates[selection.size() - 1].second;
+        } else {
+            const auto current = selection.size();
+            available -= candidates[current].second;
+            // skip if equal to the previous, already excluded candidate: that branch was explored
+            if (!selection.empty() && !selection.back() && candidates[current].second == candidates[current - 1].second) {
+                selection.push_back(false);
+            } else {
+                selection.push_back(true);
+                value += candidates[current].second;
+            }
+        }
+    }
+
+    if (best.empty()) {
+        return {};
+    }
+    return chosenIndices(candidates, best);
+}
+
+std::vector<size_t> UnspentSelector::selectKnapsack(const std::vector<int64_t>& amounts, int64_t targetValue,
+                                                    int64_t byteFee, int64_t numOutputs) const {
+    // Stochastic approximation of the smallest subset covering target, fee and a non-dust change;
+    // the single smallest sufficient UTXO is used if it is better.  Deterministic (fixed seed).
+    // See also https://github.com/bitcoin/bitcoin/blob/master/src/wallet/coinselection.cpp (KnapsackSolver)
+    const auto inputFee = feeCalculator.calculateSingleInput(byteFee);
+    const auto target = targetValue + feeCalculator.calculate(0, numOutputs, byteFee) + inputFee;
+
+    const auto candidates = effectiveValues(amounts, inputFee, budget.maxCandidates);
+    // smallest single candidate which is enough (candidates are in decreasing order)
+    int lowestLarger = -1;
+    size_t firstApplicable = 0;
+    while (firstApplicable < candidates.size() && candidates[firstApplicable].second >= target) {
+        lowestLarger = static_cast<int>(firstApplicable);
+        ++firstApplicable;
+    }
+    int64_t total = 0;
+    for (auto i = firstApplicable; i < candidates.size(); ++i) {
+        total += candidates[i].second;
+    }
+
+    std::vector<bool> best;
+    int64_t bestValue = total;
+    if (total >= target) {
+        // approximate best subset of the smaller candidates
+        const auto n = candidates.size() - firstApplicable;
+        best.assign(n, true);
+        auto tracker = BudgetTracker(budget);
+        auto random = std::mt19937_64(0);
+        bool exhausted = false;
+        std::vector<bool> included;
+        for (int rep = 0; rep < 1000 && bestValue != target && !exhausted; ++rep) {
+            included.assign(n, false);
+            int64_t value = 0;
+            bool reachedTarget = false;
+            for (int pass = 0; pass < 2 && !reachedTarget && !exhausted; ++pass) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (!tracker.step()) {
+                        exhausted = true;
+                        break;
+                    }
+                    // first pass: random subset; second pass: add the remaining until the target is reached
+                    if (pass == 0 ? (random() & 1) != 0 : !included[i]) {
+                        value += candidates[firstApplicable + i].second;
+                        included[i] = true;
+                        if (value >= target) {
+                            reachedTarget = true;
+                            if (value < bestValue) {
+                                bestValue = value;
+                                best = included;
+                            }
+                            value -= candidates[firstApplicable + i].second;
+                            included[i] = false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (lowestLarger >= 0 && (best.empty() || (bestValue != target && candidates[lowestLarger].second <= bestValue))) {
+        return {candidates[lowestLarger].first};
+    }
+    if (best.empty()) {
+        return {};
+    }
+    best.insert(best.begin(), firstApplicable, false);
+    return chosenIndices(candidates, best);
+}
+
 template <typename T>
 std::vector<Proto::UnspentTransaction>
 UnspentSelector::selectMaxAmount(const T& utxos, int64_t byteFee) {
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <numeric>
 #include <vector>
 
@@ -17,6 +18,27 @@ namespace TW::Bitcoin {
 
 class UnspentSelector {
   public:
+    /// UTXO selection algorithms.
+    enum Algorithm {
+        /// Fewest inputs, a run of consecutive UTXOs (sorted by amount) with total closest to 2x the target,
+        /// avoiding dust change if possible.  Same results as earlier versions.
+        Compatible,
+        /// Branch-and-bound search for an input set which needs no change output; if there is none,
+        /// knapsack search for the smallest sufficient input set with change; finally Compatible.
+        BranchAndBound,
+    };
+
+    /// Limits on the search effort of the BranchAndBound and knapsack searches;
+    /// if exhausted, the best selection found so far is used (or the next fallback).
+    struct Budget {
+        /// Maximum number of search steps
+        size_t maxTries = 100'000;
+        /// Maximum wall-clock time, 0 for no limit
+        std::chrono::milliseconds maxTime{0};
+        /// Maximum number of UTXOs considered (the largest ones are kept), 0 for no limit.  Bounds memory use.
+        size_t maxCandidates = 0;
+    };
+
     /// Selects unspent transactions to use given a target transaction value.
     ///
     /// \returns the list of selected utxos or an empty list if there are
@@ -25,13 +47,25 @@ class UnspentSelector {
     std::vector<Proto::UnspentTransaction> select(const T& utxos, int64_t targetValue,
                                                   int64_t byteFee, int64_t numOutputs = 2);
 
+    /// Selects UTXOs, given only their amounts.  Same as select(), but returns indices into the amounts array.
+    std::vector<size_t> selectIndices(const std::vector<int64_t>& amounts, int64_t targetValue,
+                                      int64_t byteFee, int64_t numOutputs = 2) const;
+
     /// Selects UTXOs for max amount; select all except those which would reduce output (dust).
     /// One output and no change is assumed.
     template <typename T>
     std::vector<Proto::UnspentTransaction> selectMaxAmount(const T& utxos, int64_t byteFee);
 
+    /// Fee of a change output, among numOutputs outputs, plus that of spending it later.  A BranchAndBound selection
+    /// without change exceeds the target value and fee by less than this.
+    int64_t costOfChange(int64_t byteFee, int64_t numOutputs = 2) const;
+
     /// Construct, using provided feeCalculator (see getFeeCalculator()).
-    explicit UnspentSelector(const FeeCalculator& feeCalculator) : feeCalculator(feeCalculator) {}
+    explicit UnspentSelector(const FeeCalculator& feeCalculator) : UnspentSelector(feeCalculator, Compatible) {}
+    /// Construct, with the given selection algorithm, and optionally search limits.
+    UnspentSelector(const FeeCalculator& feeCalculator, Algorithm algorithm) : UnspentSelector(feeCalculator, algorithm, Budget()) {}
+    UnspentSelector(const FeeCalculator& feeCalculator, Algorithm algorithm, Budget budget)
+        : feeCalculator(feeCalculator), algorithm(algorithm), budget(budget) {}
     UnspentSelector() : UnspentSelector(getFeeCalculator(TWCoinTypeBitcoin)) {}
 
     template <typename T>
@@ -45,7 +79,14 @@ class UnspentSelector {
 
   private:
     const FeeCalculator& feeCalculator;
+    const Algorithm algorithm;
+    const Budget budget;
+
     template <typename T> std::vector<Proto::UnspentTransaction> filterDustInput(const T& selectedUtxos, int64_t byteFee);
+
+    std::vector<size_t> selectCompatible(const std::vector<int64_t>& amounts, int64_t targetValue, int64_t byteFee, int64_t numOutputs) const;
+    std::vector<size_t> selectBranchAndBound(const std::vector<int64_t>& amounts, int64_t targetValue, int64_t byteFee, int64_t numOutputs) const;
+    std::vector<size_t> selectKnapsack(const std::vector<int64_t>& amounts, int64_t targetValue, int64_t byteFee, int64_t numOutputs) const;
 };
 
 } // namespace TW::Bitcoin
@@ -7,6 +7,7 @@
 #include "Coin.h"
 
 #include "CoinEntry.h"
+#include "Parallel.h"
 #include <TrustWalletCore/TWCoinTypeConfiguration.h>
 #include <TrustWalletCore/TWHRP.h>
 
@@ -222,12 +223,37 @@ std::string TW::deriveAddress(TWCoinType coin, const PublicKey& publicKey) {
     return dispatcher->deriveAddress(coin, publicKey, p2pkh, hrp);
 }
 
+std::vector<std::string> TW::deriveAddresses(TWCoinType coin, const std::vector<PublicKey>& publicKeys) {
+    auto p2pkh = TW::p2pkhPrefix(coin);
+    auto hrp = stringForHRP(TW::hrp(coin));
+
+    auto dispatcher = coinDispatcher(coin);
+    assert(dispatcher != nullptr);
+    std::vector<std::string> addresses(publicKeys.size());
+    dispatcher->deriveAddresses(coin, publicKeys, p2pkh, hrp, addresses);
+    return addresses;
+}
+
 void TW::anyCoinSign(TWCoinType coinType, const Data& dataIn, Data& dataOut) {
     auto dispatcher = coinDispatcher(coinType);
     assert(dispatcher != nullptr);
     dispatcher->sign(coinType, dataIn, dataOut);
 }
 
+void TW::anyCoinSignBatch(TWCoinType coinType, const std::vector<Data>& inputs, std::vector<Data>& outputs,
+                          std::vector<std::string>& errors, size_t threads) {
+    auto dispatcher = coinDispatcher(coinType);
+    assert(dispatcher != nullptr);
+    const auto count = inputs.size();
+    outputs.assign(count, Data());
+    errors.assign(count, std::string());
+
+    // Each input has its own output and error slot, so no locking is needed.
+    parallelFor(count, threads, [&](size_t begin, size_t end) {
+        dispatcher->signBatch(coinType, inputs, begin, end, outputs, errors);
+    });
+}
+
 std::string TW::anySignJSON(TWCoinType coinType, const std::string& json, const Data& key) {
     auto dispatcher = coinDispatcher(coinType);
     assert(dispatcher != nullptr);
@@ -295,10 +321,18 @@ enum TWHRP TW::hrp(TWCoinType coin) {
 }
 
 Hash::Hasher TW::publicKeyHasher(TWCoinType coin) {
-    return getCoinInfo(coin).publicKeyHasher;
+    return Hash::hasher(getCoinInfo(coin).publicKeyHasher);
 }
 
 Hash::Hasher TW::base58Hasher(TWCoinType coin) {
+    return Hash::hasher(getCoinInfo(coin).base58Hasher);
+}
+
+Hash::HasherType TW::publicKeyHasherType(TWCoinType coin) {
+    return getCoinInfo(coin).publicKeyHasher;
+}
+
+Hash::HasherType TW::base58HasherType(TWCoinType coin) {
     return getCoinInfo(coin).base58Hasher;
 }
 
@@ -59,12 +59,22 @@ std::string deriveAddress(TWCoinType coin, const PrivateKey& privateKey);
 /// Derives the address for a particular coin from the public key.
 std::string deriveAddress(TWCoinType coin, const PublicKey& publicKey);
 
+/// Derives the addresses for a particular coin from several public keys, hashing them together where the coin supports
+/// it.  An address which can't be derived is left empty.
+std::vector<std::string> deriveAddresses(TWCoinType coin, const std::vector<PublicKey>& publicKeys);
+
 /// Hasher for deriving the public key hash.
 Hash::Hasher publicKeyHasher(TWCoinType coin);
 
 /// Hasher to use for base 58 checksums.
 Hash::Hasher base58Hasher(TWCoinType coin);
 
+/// Hash function for deriving the public key hash, for the allocation free Hash functions.
+Hash::HasherType publicKeyHasherType(TWCoinType coin);
+
+/// Hash function to use for base 58 checksums, for the allocation free Hash functions.
+Hash::HasherType base58HasherType(TWCoinType coin);
+
 /// Returns static prefix for a coin type.
 byte staticPrefix(TWCoinType coin);
 
@@ -80,6 +90,12 @@ enum TWHRP hrp(TWCoinType coin);
 // Note: use output parameter to avoid unneeded copies
 void anyCoinSign(TWCoinType coinType, const Data& dataIn, Data& dataOut);
 
+/// Signs a batch of serialized inputs of the same coin: inputs[i] is signed into outputs[i].
+/// Errors are per input: errors[i] is empty on success, or the error message (outputs[i] is then empty).
+/// threads: number of worker threads, 0 to use all cores, 1 to sign on the calling thread.
+void anyCoinSignBatch(TWCoinType coinType, const std::vector<Data>& inputs, std::vector<Data>& outputs,
+                      std::vector<std::string>& errors, size_t threads = 1);
+
 uint32_t slip44Id(TWCoinType coin);
 
 std::string anySignJSON(TWCoinType coinType, const std::string& json, const Data& key);
@@ -106,8 +122,8 @@ struct CoinInfo {
     byte p2pkhPrefix;
     byte p2shPrefix;
     TWHRP hrp;
-    Hash::Hasher publicKeyHasher;
-    Hash::Hasher base58Hasher;
+    Hash::HasherType publicKeyHasher;
+    Hash::HasherType base58Hasher;
     const char* symbol;
     int decimals;
     const char* explorerTransactionUrl;
@@ -11,7 +11,9 @@
 #include "Data.h"
 #include "PublicKey.h"
 #include "PrivateKey.h"
+#include "proto/Common.pb.h"
 
+#include <exception>
 #include <string>
 #include <vector>
 
@@ -27,8 +29,39 @@ public:
     // normalizeAddress is optional, it may leave this default, no-change implementation
     virtual std::string normalizeAddress(TWCoinType coin, const std::string& address) const { return address; }
     virtual std::string deriveAddress(TWCoinType coin, const PublicKey& publicKey, TW::byte p2pkh, const char* hrp) const = 0;
+    // Batch address derivation: addresses[i] is derived from publicKeys[i], or left empty on failure.
+    // It is optional, default impl. calls deriveAddress() for each; coins may override it to hash the keys together (see Hash::sha256Multi).
+    virtual void deriveAddresses(TWCoinType coin, const std::vector<PublicKey>& publicKeys, TW::byte p2pkh, const char* hrp,
+                                 std::vector<std::string>& addresses) const {
+        for (size_t i = 0; i < publicKeys.size(); ++i) {
+            try {
+                addresses[i] = deriveAddress(coin, publicKeys[i], p2pkh, hrp);
+            } catch (...) {
+                addresses[i].clear();
+            }
+        }
+    }
     // Signing
     virtual void sign(TWCoinType coin, const Data& dataIn, Data& dataOut) const = 0;
+    // Batch signing, of inputs [begin, end): inputs[i] is signed into outputs[i], or errors[i] is set on failure.
+    // It is optional, default impl. calls sign() for each; coins may override it (see signBatchTemplate) to reuse state across inputs.
+    virtual void signBatch(TWCoinType coin, const std::vector<Data>& inputs, size_t begin, size_t end,
+                           std::vector<Data>& outputs, std::vector<std::string>& errors) const {
+        for (auto i = begin; i < end; ++i) {
+            try {
+                sign(coin, inputs[i], outputs[i]);
+                if (outputs[i].empty()) {
+                    errors[i] = "Signing failed";
+                }
+            } catch (const std::exception& ex) {
+                outputs[i].clear();
+                errors[i] = ex.what();
+            } catch (...) {
+                outputs[i].clear();
+                errors[i] = "Signing failed";
+            }
+        }
+    }
     virtual bool supportsJSONSigning() const { return false; }
     // It is optional, Signing JSON input with private key
     virtual std::string signJSON(TWCoinType coin, const std::string& json, const Data& key) const { return ""; }
@@ -48,6 +81,54 @@ void signTemplate(const Data& dataIn, Data& dataOut) {
     dataOut.insert(dataOut.end(), serializedOut.begin(), serializedOut.end());
 }
 
+// Error reported in a signing output, empty if none: outputs which have an error field (a Common::Proto::SigningError,
+// or a message) report failures there, with a non-empty output.
+inline std::string signingErrorMessage(Common::Proto::SigningError error) {
+    return error == Common::Proto::OK ? "" : Common::Proto::SigningError_Name(error);
+}
+inline std::string signingErrorMessage(const std::string& error) { return error; }
+template <typename Output>
+auto signingError(const Output& output, int) -> decltype(signingErrorMessage(output.error())) {
+    return signingErrorMessage(output.error());
+}
+template <typename Output>
+std::string signingError(const Output&, long) { return ""; }
+
+// Batch version of signTemplate; the input message and output buffer are reused across inputs.
+// An input which cannot be parsed or signed (yields an error in its output, or an empty output) gets an error, and does
+// not fail the others.
+template <typename Signer, typename Input>
+void signBatchTemplate(const std::vector<Data>& inputs, size_t begin, size_t end,
+                       std::vector<Data>& outputs, std::vector<std::string>& errors) {
+    auto input = Input();
+    std::string serializedOut;
+    for (auto i = begin; i < end; ++i) {
+        try {
+            if (!input.ParseFromArray(inputs[i].data(), (int)inputs[i].size())) {
+                errors[i] = "Invalid input";
+                continue;
+            }
+            const auto output = Signer::sign(input);
+            auto error = signingError(output, 0);
+            if (!error.empty()) {
+                errors[i] = std::move(error);
+                continue;
+            }
+            output.SerializeToString(&serializedOut);
+            if (serializedOut.empty()) {
+                // signers which catch errors return an empty output
+                errors[i] = "Signing failed";
+                continue;
+            }
+            outputs[i].assign(serializedOut.begin(), serializedOut.end());
+        } catch (const std::exception& ex) {
+            errors[i] = ex.what();
+        } catch (...) {
+            errors[i] = "Signing failed";
+        }
+    }
+}
+
 // Note: use output parameter to avoid unneeded copies
 template <typename Planner, typename Input>
 void planTemplate(const Data& dataIn, Data& dataOut) {
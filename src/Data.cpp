@@ -14,4 +14,27 @@ Data subData(const Data& data, size_t index, size_t length) {
     return TW::data(data.data() + index, subLength);
 }
 
+bool readDelimited(const Data& stream, std::vector<Data>& items) {
+    size_t index = 0;
+    while (index < stream.size()) {
+        uint64_t size = 0;
+        for (auto shift = 0; ; shift += 7) {
+            if (index >= stream.size() || shift > 28) {
+                return false;
+            }
+            const auto byte = stream[index++];
+            size |= uint64_t(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        if (size > stream.size() - index) {
+            return false;
+        }
+        items.emplace_back(stream.begin() + index, stream.begin() + index + size);
+        index += size;
+    }
+    return true;
+}
+
 } // namespace TW
@@ -39,6 +39,21 @@ inline void append(Data& data, const byte suffix) {
 /// Return a part (subdata) of the requested size of the input data.
 Data subData(const Data& data, size_t index, size_t length);
 
+/// Splits a stream of varint length-prefixed items (as used by batch C interfaces); returns false if malformed.
+bool readDelimited(const Data& stream, std::vector<Data>& items);
+
+/// Appends an item (Data or std::string) to a stream of varint length-prefixed items.
+template <typename T>
+inline void writeDelimited(const T& item, Data& stream) {
+    auto size = item.size();
+    while (size >= 0x80) {
+        stream.push_back(static_cast<byte>(size | 0x80));
+        size >>= 7;
+    }
+    stream.push_back(static_cast<byte>(size));
+    stream.insert(stream.end(), item.begin(), item.end());
+}
+
 /// Determines if a byte array has a specific prefix.
 template <typename T>
 inline bool has_prefix(const Data& data, T& prefix) {
@@ -24,6 +24,11 @@ void Entry::sign(TWCoinType coin, const TW::Data& dataIn, TW::Data& dataOut) con
     signTemplate<Signer, Bitcoin::Proto::SigningInput>(dataIn, dataOut);
 }
 
+void Entry::signBatch(TWCoinType coin, const std::vector<TW::Data>& inputs, size_t begin, size_t end,
+                      std::vector<TW::Data>& outputs, std::vector<std::string>& errors) const {
+    signBatchTemplate<Signer, Bitcoin::Proto::SigningInput>(inputs, begin, end, outputs, errors);
+}
+
 void Entry::plan(TWCoinType coin, const TW::Data& dataIn, TW::Data& dataOut) const {
     planTemplate<Signer, Bitcoin::Proto::SigningInput>(dataIn, dataOut);
 }
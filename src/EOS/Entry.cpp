@@ -25,3 +25,8 @@ string Entry::deriveAddress(TWCoinType coin, const PublicKey& publicKey, TW::byt
 void Entry::sign(TWCoinType coin, const TW::Data& dataIn, TW::Data& dataOut) const {
     signTemplate<Signer, Proto::SigningInput>(dataIn, dataOut);
 }
+
+void Entry::signBatch(TWCoinType coin, const std::vector<TW::Data>& inputs, size_t begin, size_t end,
+                      std::vector<TW::Data>& outputs, std::vector<std::string>& errors) const {
+    signBatchTemplate<Signer, Proto::SigningInput>(inputs, begin, end, outputs, errors);
+}
@@ -18,6 +18,8 @@ public:
     virtual bool validateAddress(TWCoinType coin, const std::string& address, TW::byte p2pkh, TW::byte p2sh, const char* hrp) const;
     virtual std::string deriveAddress(TWCoinType coin, const PublicKey& publicKey, TW::byte p2pkh, const char* hrp) const;
     virtual void sign(TWCoinType coin, const Data& dataIn, Data& dataOut) const;
+    virtual void signBatch(TWCoinType coin, const std::vector<Data>& inputs, size_t begin, size_t end,
+                           std::vector<Data>& outputs, std::vector<std::string>& errors) const;
 };
 
 } // namespace TW::EOS
@@ -13,5 +13,7 @@
 #include "ABI/Bytes.h"
 #include "ABI/ParamAddress.h"
 #include "ABI/Function.h"
+#include "ABI/FunctionLayout.h"
 #include "ABI/ParamFactory.h"
 #include "ABI/ParamStruct.h"
+#include "ABI/TypedDataSchema.h"
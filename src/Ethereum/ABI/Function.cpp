@@ -14,10 +14,8 @@ using namespace TW;
 using namespace TW::Ethereum::ABI;
 
 Data Function::getSignature() const {
-    auto typ = getType();
-    auto hash = Hash::keccak256(Data(typ.begin(), typ.end()));
-    auto signature = Data(hash.begin(), hash.begin() + 4);
-    return signature;
+    const auto hash = Hash::digest<Hash::HasherType::keccak256>(getType());
+    return Data(hash.begin(), hash.begin() + 4);
 }
 
 void Function::encode(Data& data) const {
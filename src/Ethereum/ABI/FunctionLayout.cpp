@@ -0,0 +1,619 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "FunctionLayout.h"
+#include "ValueEncoder.h"
+
+#include <Hash.h>
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace TW;
+using namespace TW::Ethereum::ABI;
+
+/// Parses a decimal number without sign or leading zeroes.
+static bool parseNumber(const std::string& string, size_t& number) {
+    if (string.empty() || string.size() > 9 || (string[0] == '0' && string.size() > 1)) {
+        return false;
+    }
+    number = 0;
+    for (auto c : string) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        number = number * 10 + (c - '0');
+    }
+    return true;
+}
+
+/// Splits the inside of a tuple type at top level commas.
+static std::vector<std::string> splitComponents(const std::string& string) {
+    std::vector<std::string> components;
+    if (string.empty()) {
+        return components;
+    }
+    int depth = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < string.size(); ++i) {
+        if (string[i] == '(') {
+            ++depth;
+        } else if (string[i] == ')') {
+            --depth;
+        } else if (string[i] == ',' && depth == 0) {
+            components.push_back(string.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    components.push_back(string.substr(start));
+    return components;
+}
+
+/// Size of the heads of all components of a tuple or fixed array.
+static size_t componentsHeadSize(const ParamType& type) {
+    if (type.kind == ParamType::Kind::fixedArray) {
+        return type.size * type.components[0].headSize;
+    }
+    if (type.components.empty()) {
+        return 0;
+    }
+    return type.headOffsets.back() + type.components.back().headSize;
+}
+
+/// Bound on the head size of a type, well above the calldata a block can hold.  Fixed arrays store an offset for
+/// each element, so this also bounds their length, and the memory a type string can make the parser allocate.
+static const size_t maxHeadSize = size_t(1) << 24;
+
+/// Parses the component types of a tuple, stopping as soon as their heads are too large.
+static std::vector<ParamType> parseComponents(const std::vector<std::string>& types) {
+    std::vector<ParamType> components;
+    components.reserve(types.size());
+    size_t headSize = 0;
+    for (const auto& type : types) {
+        components.push_back(ParamType::parse(type));
+        headSize += components.back().headSize;
+        if (headSize > maxHeadSize) {
+            throw std::invalid_argument("Tuple too large");
+        }
+    }
+    return components;
+}
+
+ParamType ParamType::parse(const std::string& type) {
+    ParamType result;
+    if (!type.empty() && type.back() == ']') {
+        const auto open = type.rfind('[');
+        if (open == std::string::npos) {
+            throw std::invalid_argument("Invalid type " + type);
+        }
+        auto element = parse(type.substr(0, open));
+        const auto length = type.substr(open + 1, type.size() - open - 2);
+        if (length.empty()) {
+            result.kind = Kind::array;
+            result.name = element.name + "[]";
+            result.dynamic = true;
+        } else {
+            if (!parseNumber(length, result.size) || result.size == 0 || result.size > maxHeadSize / element.headSize) {
+                throw std::invalid_argument("Invalid array length in " + type);
+            }
+            result.kind = Kind::fixedArray;
+            result.name = element.name + "[" + length + "]";
+            result.dynamic = element.dynamic;
+            for (size_t i = 0; i < result.size; ++i) {
+                result.headOffsets.push_back(i * element.headSize);
+            }
+            result.headSize = result.dynamic ? 32 : result.size * element.headSize;
+        }
+        result.components.push_back(std::move(element));
+        return result;
+    }
+
+    if (type.size() >= 2 && type.front() == '(' && type.back() == ')') {
+        auto components = parseComponents(splitComponents(type.substr(1, type.size() - 2)));
+        if (components.empty()) {
+            throw std::invalid_argument("Empty tuple");
+        }
+        return tuple(std::move(components));
+    }
+
+    size_t size = 0;
+    if (type == "address") {
+        result.kind = Kind::address;
+        result.size = 160;
+    } else if (type == "bool") {
+        result.kind = Kind::boolean;
+    } else if (type == "string") {
+        result.kind = Kind::string;
+        result.dynamic = true;
+    } else if (type == "bytes") {
+        result.kind = Kind::bytes;
+        result.dynamic = true;
+    } else if (type.compare(0, 5, "bytes") == 0 && parseNumber(type.substr(5), size) && size >= 1 && size <= 32) {
+        result.kind = Kind::fixedBytes;
+        result.size = size;
+    } else if (type == "uint" || type == "int") {
+        result.kind = type == "uint" ? Kind::uintN : Kind::intN;
+        result.size = 256;
+        result.name = type + "256";
+        return result;
+    } else if (type.compare(0, 4, "uint") == 0 && parseNumber(type.substr(4), size) && size >= 8 && size <= 256 &&
+               size % 8 == 0) {
+        result.kind = Kind::uintN;
+        result.size = size;
+    } else if (type.compare(0, 3, "int") == 0 && parseNumber(type.substr(3), size) && size >= 8 && size <= 256 &&
+               size % 8 == 0) {
+        result.kind = Kind::intN;
+        result.size = size;
+    } else {
+        throw std::invalid_argument("Unsupported type " + type);
+    }
+    result.name = type;
+    return result;
+}
+
+ParamType ParamType::tuple(std::vector<ParamType> components) {
+    ParamType result;
+    result.kind = Kind::tuple;
+    result.name = "(";
+    size_t offset = 0;
+    for (const auto& component : components) {
+        if (!result.headOffsets.empty()) {
+            result.name += ",";
+        }
+        result.name += component.name;
+        result.headOffsets.push_back(offset);
+        offset += component.headSize;
+        result.dynamic = result.dynamic || component.dynamic;
+    }
+    result.name += ")";
+    if (offset > maxHeadSize) {
+        throw std::invalid_argument("Tuple too large");
+    }
+    result.components = std::move(components);
+    result.headSize = result.dynamic ? 32 : offset;
+    return result;
+}
+
+ParamValue ParamValue::number(const uint256_t& value) {
+    ParamValue result;
+    result.value = value;
+    return result;
+}
+
+ParamValue ParamValue::signedNumber(const int256_t& value) {
+    return number(ValueEncoder::uint256FromInt256(value));
+}
+
+ParamValue ParamValue::boolean(bool value) {
+    return number(value ? 1 : 0);
+}
+
+ParamValue ParamValue::bytes(const byte* data, size_t size) {
+    ParamValue result;
+    result.kind = Kind::bytes;
+    result.data = data;
+    result.size = size;
+    return result;
+}
+
+ParamValue ParamValue::string(const std::string& value) {
+    return bytes(reinterpret_cast<const byte*>(value.data()), value.size());
+}
+
+ParamValue ParamValue::list(std::vector<ParamValue> elements) {
+    ParamValue result;
+    result.kind = Kind::list;
+    result.elements = std::move(elements);
+    return result;
+}
+
+namespace {
+
+/// Reads a 32-byte word which must hold a number less than 2^64.
+bool readSize(const byte* word, size_t& size) {
+    for (size_t i = 0; i < 24; ++i) {
+        if (word[i] != 0) {
+            return false;
+        }
+    }
+    uint64_t value = 0;
+    for (size_t i = 24; i < 32; ++i) {
+        value = (value << 8) | word[i];
+    }
+    size = static_cast<size_t>(value);
+    return size == value;
+}
+
+size_t readSizeUnchecked(const byte* word) {
+    size_t size = 0;
+    readSize(word, size);
+    return size;
+}
+
+/// Bounds checks encoded data before any ParamView is handed out.
+class Validator {
+  public:
+    Validator(const byte* begin, const byte* end)
+        : end(end), furthest(begin), budget(2 * (static_cast<size_t>(end - begin) / 32) + 2) {}
+
+    /// End of the last value checked so far, padding included as far as present.
+    const byte* getFurthest() const { return furthest; }
+
+    /// Checks a value whose head is at `head` within the tuple starting at `area`.
+    bool checkAt(const ParamType& type, const byte* area, const byte* head) {
+        if (static_cast<size_t>(end - head) < type.headSize) {
+            return false;
+        }
+        if (!type.dynamic) {
+            return checkValue(type, head);
+        }
+        size_t offset;
+        if (!readSize(head, offset) || offset > static_cast<size_t>(end - area)) {
+            return false;
+        }
+        return checkValue(type, area + offset);
+    }
+
+    /// Checks a value whose encoding starts at `data`.
+    bool checkValue(const ParamType& type, const byte* data) {
+        const auto available = static_cast<size_t>(end - data);
+        switch (type.kind) {
+        case ParamType::Kind::tuple:
+        case ParamType::Kind::fixedArray: {
+            if (available < componentsHeadSize(type)) {
+                return false;
+            }
+            reach(data + componentsHeadSize(type));
+            for (size_t i = 0; i < type.headOffsets.size(); ++i) {
+                const auto& component = type.kind == ParamType::Kind::tuple ? type.components[i] : type.components[0];
+                if (!checkAt(component, data, data + type.headOffsets[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default:
+            break;
+        }
+
+        if (budget == 0 || available < 32) {
+            return false;
+        }
+        --budget;
+        reach(data + 32);
+        switch (type.kind) {
+        case ParamType::Kind::bytes:
+        case ParamType::Kind::string: {
+            size_t length;
+            if (!readSize(data, length) || length > available - 32) {
+                return false;
+            }
+            reach(data + 32 + std::min(ValueEncoder::paddedTo32(length), available - 32));
+            return true;
+        }
+        case ParamType::Kind::array: {
+            size_t count;
+            const auto& element = type.components[0];
+            if (!readSize(data, count) || count > (available - 32) / element.headSize) {
+                return false;
+            }
+            const auto* elements = data + 32;
+            reach(elements + count * element.headSize);
+            for (size_t i = 0; i < count; ++i) {
+                if (!checkAt(element, elements, elements + i * element.headSize)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default:
+            return true;
+        }
+    }
+
+  private:
+    void reach(const byte* position) { furthest = std::max(furthest, position); }
+
+    const byte* end;
+    const byte* furthest;
+    /// Number of values left to check; bounds the work for offsets pointing to shared data.
+    size_t budget;
+};
+
+/// Returns the view of a value whose head is at `head` within the tuple starting at `area`.  The data must be valid.
+ParamView viewAt(const ParamType& type, const byte* area, const byte* head) {
+    const auto* data = type.dynamic ? area + readSizeUnchecked(head) : head;
+    switch (type.kind) {
+    case ParamType::Kind::bytes:
+    case ParamType::Kind::string:
+    case ParamType::Kind::array:
+        return ParamView(&type, data + 32, readSizeUnchecked(data));
+    case ParamType::Kind::tuple:
+    case ParamType::Kind::fixedArray:
+        return ParamView(&type, data, type.headOffsets.size());
+    default:
+        return ParamView(&type, data, 0);
+    }
+}
+
+/// Checks that a value matches a type and returns the size of its encoding, excluding the head for dynamic values.
+size_t encodedValueSize(const ParamType& type, const ParamValue& value);
+
+size_t encodedComponentsSize(const ParamType& type, const std::vector<ParamValue>& values) {
+    auto size = type.kind == ParamType::Kind::array ? values.size() * type.components[0].headSize
+                                                      : componentsHeadSize(type);
+    for (size_t i = 0; i < values.size(); ++i) {
+        const auto& component = type.kind == ParamType::Kind::tuple ? type.components[i] : type.components[0];
+        const auto valueSize = encodedValueSize(component, values[i]);
+        if (component.dynamic) {
+            size += valueSize;
+        }
+    }
+    return size;
+}
+
+void checkNumber(const ParamType& type, const ParamValue& value) {
+    if (value.kind != ParamValue::Kind::number) {
+        throw std::invalid_argument("Expected a number for " + type.name);
+    }
+    if (type.size == 256) {
+        return;
+    }
+    // intN values are stored in two's complement, the bits above the sign bit must match it
+    const auto magnitude = type.kind == ParamType::Kind::intN && bit_test(value.value, 255) ? ~value.value : value.value;
+    const auto bits = type.kind == ParamType::Kind::intN ? type.size - 1 : type.size;
+    if (magnitude >> bits != 0) {
+        throw std::invalid_argument("Value out of range for " + type.name);
+    }
+}
+
+size_t encodedValueSize(const ParamType& type, const ParamValue& value) {
+    switch (type.kind) {
+    case ParamType::Kind::uintN:
+    case ParamType::Kind::intN:
+        checkNumber(type, value);
+        return 32;
+    case ParamType::Kind::boolean:
+        if (value.kind != ParamValue::Kind::number || value.value > 1) {
+            throw std::invalid_argument("Expected a boolean");
+        }
+        return 32;
+    case ParamType::Kind::address:
+        if (value.kind != ParamValue::Kind::bytes || value.size != 20) {
+            throw std::invalid_argument("Expected 20 address bytes");
+        }
+        return 32;
+    case ParamType::Kind::fixedBytes:
+        if (value.kind != ParamValue::Kind::bytes || value.size > type.size) {
+            throw std::invalid_argument("Expected at most " + std::to_string(type.size) + " bytes");
+        }
+        return 32;
+    case ParamType::Kind::bytes:
+    case ParamType::Kind::string:
+        if (value.kind != ParamValue::Kind::bytes) {
+            throw std::invalid_argument("Expected bytes for " + type.name);
+        }
+        return 32 + ValueEncoder::paddedTo32(value.size);
+    case ParamType::Kind::array:
+        if (value.kind != ParamValue::Kind::list) {
+            throw std::invalid_argument("Expected a list for " + type.name);
+        }
+        return 32 + encodedComponentsSize(type, value.elements);
+    case ParamType::Kind::fixedArray:
+    case ParamType::Kind::tuple:
+        if (value.kind != ParamValue::Kind::list || value.elements.size() != type.headOffsets.size()) {
+            throw std::invalid_argument("Expected " + std::to_string(type.headOffsets.size()) + " values for " +
+                                        type.name);
+        }
+        return encodedComponentsSize(type, value.elements);
+    }
+    return 0;
+}
+
+/// Writes the encoding of a value, which was checked by encodedValueSize, into zeroed memory at `out`.  Returns the
+/// number of bytes written.
+size_t writeValue(const ParamType& type, const ParamValue& value, byte* out);
+
+size_t writeComponents(const ParamType& type, const std::vector<ParamValue>& values, byte* out) {
+    auto* tail = out + (type.kind == ParamType::Kind::array ? values.size() * type.components[0].headSize
+                                                             : componentsHeadSize(type));
+    auto* head = out;
+    for (size_t i = 0; i < values.size(); ++i) {
+        const auto& component = type.kind == ParamType::Kind::tuple ? type.components[i] : type.components[0];
+        if (component.dynamic) {
+            ValueEncoder::encodeUInt256(uint256_t(tail - out), head);
+            tail += writeValue(component, values[i], tail);
+        } else {
+            writeValue(component, values[i], head);
+        }
+        head += component.headSize;
+    }
+    return tail - out;
+}
+
+size_t writeValue(const ParamType& type, const ParamValue& value, byte* out) {
+    switch (type.kind) {
+    case ParamType::Kind::uintN:
+    case ParamType::Kind::intN:
+    case ParamType::Kind::boolean:
+        ValueEncoder::encodeUInt256(value.value, out);
+        return 32;
+    case ParamType::Kind::address:
+        std::memcpy(out + 12, value.data, 20);
+        return 32;
+    case ParamType::Kind::fixedBytes:
+        if (value.size > 0) {
+            std::memcpy(out, value.data, value.size);
+        }
+        return 32;
+    case ParamType::Kind::bytes:
+    case ParamType::Kind::string:
+        ValueEncoder::encodeUInt256(uint256_t(value.size), out);
+        if (value.size > 0) {
+            std::memcpy(out + 32, value.data, value.size);
+        }
+        return 32 + ValueEncoder::paddedTo32(value.size);
+    case ParamType::Kind::array:
+        ValueEncoder::encodeUInt256(uint256_t(value.elements.size()), out);
+        return 32 + writeComponents(type, value.elements, out + 32);
+    case ParamType::Kind::fixedArray:
+    case ParamType::Kind::tuple:
+        return writeComponents(type, value.elements, out);
+    }
+    return 0;
+}
+
+} // namespace
+
+uint256_t ParamView::getUInt256() const {
+    uint256_t value;
+    import_bits(value, data, data + 32);
+    if ((type->kind == ParamType::Kind::uintN || type->kind == ParamType::Kind::address) && type->size < 256) {
+        value &= (uint256_t(1) << type->size) - 1;
+    }
+    return value;
+}
+
+int256_t ParamView::getInt256() const {
+    uint256_t value;
+    import_bits(value, data, data + 32);
+    return ValueEncoder::int256FromUint256(value);
+}
+
+const byte* ParamView::bytesData() const {
+    return type->kind == ParamType::Kind::address ? data + 12 : data;
+}
+
+size_t ParamView::bytesSize() const {
+    switch (type->kind) {
+    case ParamType::Kind::address:
+        return 20;
+    case ParamType::Kind::fixedBytes:
+        return type->size;
+    default:
+        return count;
+    }
+}
+
+ParamView ParamView::operator[](size_t index) const {
+    if (type->kind == ParamType::Kind::array) {
+        const auto& element = type->components[0];
+        return viewAt(element, data, data + index * element.headSize);
+    }
+    const auto& component = type->kind == ParamType::Kind::tuple ? type->components[index] : type->components[0];
+    return viewAt(component, data, data + type->headOffsets[index]);
+}
+
+FunctionLayout::FunctionLayout(const std::string& name, const std::vector<std::string>& types)
+    : FunctionLayout(name, parseComponents(types)) {}
+
+FunctionLayout::FunctionLayout(const std::string& name, std::vector<ParamType> types)
+    : name(name), params(ParamType::tuple(std::move(types))) {
+    signature = name + params.name;
+    const auto hash = Hash::digest<Hash::HasherType::keccak256>(signature);
+    std::copy(hash.begin(), hash.begin() + selector.size(), selector.begin());
+}
+
+FunctionLayout FunctionLayout::parse(const std::string& signature) {
+    const auto open = signature.find('(');
+    if (open == std::string::npos || open == 0 || signature.back() != ')') {
+        throw std::invalid_argument("Invalid signature " + signature);
+    }
+    std::vector<std::string> types;
+    if (open + 2 < signature.size()) {
+        types = splitComponents(signature.substr(open + 1, signature.size() - open - 2));
+    }
+    return FunctionLayout(signature.substr(0, open), types);
+}
+
+namespace {
+
+/// Layouts by signature, most recently used first.
+struct LayoutCache {
+    using Entry = std::pair<std::string, std::shared_ptr<const FunctionLayout>>;
+
+    std::mutex mutex;
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+};
+
+} // namespace
+
+std::shared_ptr<const FunctionLayout> FunctionLayout::cached(const std::string& signature) {
+    static LayoutCache cache;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        const auto it = cache.index.find(signature);
+        if (it != cache.index.end()) {
+            cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Parsed outside of the lock
+    auto layout = std::make_shared<const FunctionLayout>(parse(signature));
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    const auto it = cache.index.find(signature);
+    if (it != cache.index.end()) {
+        // parsed by another thread meanwhile
+        cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+        return it->second->second;
+    }
+    if (cache.entries.size() >= cacheCapacity) {
+        cache.index.erase(cache.entries.back().first);
+        cache.entries.pop_back();
+    }
+    cache.entries.emplace_front(signature, std::move(layout));
+    cache.index.emplace(signature, cache.entries.begin());
+    return cache.entries.front().second;
+}
+
+size_t FunctionLayout::encodedSize(const std::vector<ParamValue>& values) const {
+    if (values.size() != params.components.size()) {
+        throw std::invalid_argument("Expected " + std::to_string(params.components.size()) + " values");
+    }
+    return selector.size() + encodedComponentsSize(params, values);
+}
+
+Data FunctionLayout::encode(const std::vector<ParamValue>& values) const {
+    Data data;
+    encode(values, data);
+    return data;
+}
+
+void FunctionLayout::encode(const std::vector<ParamValue>& values, Data& data) const {
+    const auto start = data.size();
+    data.resize(start + encodedSize(values));
+    std::copy(selector.begin(), selector.end(), data.begin() + start);
+    writeComponents(params, values, data.data() + start + selector.size());
+}
+
+std::optional<ParamView> FunctionLayout::decode(const byte* call, size_t size, size_t* used) const {
+    if (size < selector.size() || !std::equal(selector.begin(), selector.end(), call)) {
+        return {};
+    }
+    auto result = decodeParams(call + selector.size(), size - selector.size(), used);
+    if (result && used != nullptr) {
+        *used += selector.size();
+    }
+    return result;
+}
+
+std::optional<ParamView> FunctionLayout::decodeParams(const byte* data, size_t size, size_t* used) const {
+    auto validator = Validator(data, data + size);
+    if (!validator.checkValue(params, data)) {
+        return {};
+    }
+    if (used != nullptr) {
+        *used = validator.getFurthest() - data;
+    }
+    return ParamView(&params, data, params.components.size());
+}
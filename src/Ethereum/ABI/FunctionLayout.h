@@ -0,0 +1,202 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include <Data.h>
+#include <uint256.h>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TW::Ethereum::ABI {
+
+/// Compiled ABI type: the parsed form of a type string such as "uint256", "bytes32[]", "address[2]" or
+/// "(uint256,string)", with the canonical name, dynamism and head size computed once.
+class ParamType {
+  public:
+    enum class Kind { uintN, intN, address, boolean, fixedBytes, bytes, string, array, fixedArray, tuple };
+
+    Kind kind = Kind::tuple;
+
+    /// Bits of an integer, bytes of a fixed bytes type, length of a fixed array; 0 otherwise.
+    size_t size = 0;
+
+    /// Element type of arrays (one), component types of tuples.
+    std::vector<ParamType> components;
+
+    /// Offset of each component's head within a tuple or fixed array.
+    std::vector<size_t> headOffsets;
+
+    /// Canonical type string, e.g. "uint256" for "uint".
+    std::string name;
+
+    /// Whether the value is encoded in the tail, referenced by an offset.
+    bool dynamic = false;
+
+    /// Bytes taken in the head of the enclosing tuple: 32 for dynamic types, the whole encoding for static ones.
+    size_t headSize = 32;
+
+    /// Parses a type string.
+    ///
+    /// @throws std::invalid_argument if the type is not supported.
+    static ParamType parse(const std::string& type);
+
+    /// Tuple of the given component types.
+    static ParamType tuple(std::vector<ParamType> components);
+};
+
+/// Value to encode with a FunctionLayout.  Numbers are held by value; bytes and strings refer to memory which must
+/// outlive encoding.  Arrays and tuples hold their elements.
+class ParamValue {
+  public:
+    enum class Kind { number, bytes, list };
+
+    /// Unsigned integer, for uintN.
+    static ParamValue number(const uint256_t& value);
+
+    /// Signed integer, for intN.
+    static ParamValue signedNumber(const int256_t& value);
+
+    /// Boolean, for bool.
+    static ParamValue boolean(bool value);
+
+    /// Bytes, for address (20 bytes), bytesN (at most N bytes, padded on the right) and bytes.
+    static ParamValue bytes(const byte* data, size_t size);
+    static ParamValue bytes(const Data& data) { return bytes(data.data(), data.size()); }
+
+    /// String, for string.
+    static ParamValue string(const std::string& value);
+
+    /// Elements of an array, components of a tuple.
+    static ParamValue list(std::vector<ParamValue> elements);
+
+    Kind kind = Kind::number;
+    uint256_t value;
+    const byte* data = nullptr;
+    size_t size = 0;
+    std::vector<ParamValue> elements;
+};
+
+/// A decoded value: a view into the encoded data, nothing is copied.  Valid while both the data and the layout it
+/// was decoded with are.  Decoding validates all offsets and lengths, so accessing a view is unchecked.
+class ParamView {
+  public:
+    ParamView(const ParamType* type, const byte* data, size_t count) : type(type), data(data), count(count) {}
+
+    /// Type of the value.
+    const ParamType& getType() const { return *type; }
+
+    /// Integer value of uintN, intN (two's complement), bool and address.
+    uint256_t getUInt256() const;
+
+    /// Signed value of intN.
+    int256_t getInt256() const;
+
+    /// Value of bool.
+    bool getBool() const { return data[31] != 0; }
+
+    /// Content of address (20 bytes), bytesN (N bytes), bytes and string.
+    const byte* bytesData() const;
+    size_t bytesSize() const;
+
+    /// Content of address, bytesN, bytes and string, copied.
+    Data getBytes() const { return Data(bytesData(), bytesData() + bytesSize()); }
+
+    /// Content of a string.
+    std::string_view getString() const {
+        return std::string_view(reinterpret_cast<const char*>(data), count);
+    }
+
+    /// Number of elements of an array or components of a tuple.
+    size_t getCount() const { return count; }
+
+    /// Element of an array or component of a tuple; index must be less than getCount().
+    ParamView operator[](size_t index) const;
+
+  private:
+    const ParamType* type;
+    /// Start of the encoding; for bytes, strings and dynamic arrays, after the length.
+    const byte* data;
+    /// Length of bytes and strings, element count of arrays and tuples.
+    size_t count;
+};
+
+/// Compiled layout of a function's input parameters: canonical signature, selector and head offsets are computed
+/// once.  Encoding computes the exact size and writes into one buffer; decoding returns views into the calldata.
+/// Thread safe.
+class FunctionLayout {
+  public:
+    /// Compiles a function from its name and parameter types.
+    ///
+    /// @throws std::invalid_argument if a type is not supported.
+    FunctionLayout(const std::string& name, const std::vector<std::string>& types);
+
+    /// Compiles a function from parameter types which are already parsed.
+    FunctionLayout(const std::string& name, std::vector<ParamType> types);
+
+    /// Compiles a function from a signature such as "transfer(address,uint256)".
+    ///
+    /// @throws std::invalid_argument if the signature is invalid or a type is not supported.
+    static FunctionLayout parse(const std::string& signature);
+
+    /// Maximum number of layouts kept by cached().
+    static constexpr size_t cacheCapacity = 256;
+
+    /// Same as parse(), but returns the layout of an earlier call with the same signature if it is still cached, the
+    /// least recently used one being evicted first.  Views decoded with a layout are valid while it is held.  Thread safe.
+    ///
+    /// @throws std::invalid_argument if the signature is invalid or a type is not supported.
+    static std::shared_ptr<const FunctionLayout> cached(const std::string& signature);
+
+    /// Function name.
+    const std::string& getName() const { return name; }
+
+    /// Canonical signature, of the form "baz(int32,uint256)".
+    const std::string& getSignature() const { return signature; }
+
+    /// First 4 bytes of the Keccak256 hash of the signature.
+    const std::array<byte, 4>& getSelector() const { return selector; }
+
+    /// Parameter types, as a tuple.
+    const ParamType& getParams() const { return params; }
+
+    /// Size of the encoded call, selector included.
+    ///
+    /// @throws std::invalid_argument if the values don't match the parameter types.
+    size_t encodedSize(const std::vector<ParamValue>& values) const;
+
+    /// Encodes a call, selector included.
+    ///
+    /// @throws std::invalid_argument if the values don't match the parameter types.
+    Data encode(const std::vector<ParamValue>& values) const;
+
+    /// Encodes a call, selector included, appending to `data`.
+    ///
+    /// @throws std::invalid_argument if the values don't match the parameter types.
+    void encode(const std::vector<ParamValue>& values, Data& data) const;
+
+    /// Decodes a call, returning the parameters as a tuple view into `call`.  Empty if the selector doesn't match or
+    /// the data is malformed.  If `used` is given, it is set to the number of bytes up to the end of the last value,
+    /// which is less than `size` if there is trailing data.
+    std::optional<ParamView> decode(const byte* call, size_t size, size_t* used = nullptr) const;
+    std::optional<ParamView> decode(const Data& call) const { return decode(call.data(), call.size()); }
+
+    /// Decodes encoded parameters without a selector, such as return data with a layout of the output types.
+    std::optional<ParamView> decodeParams(const byte* data, size_t size, size_t* used = nullptr) const;
+
+  private:
+    std::string name;
+    ParamType params;
+    std::string signature;
+    std::array<byte, 4> selector;
+};
+
+} // namespace TW::Ethereum::ABI
@@ -0,0 +1,665 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "TypedDataSchema.h"
+#include "ValueEncoder.h"
+
+#include <Hashers.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+
+using namespace TW;
+using namespace TW::Ethereum::ABI;
+using json = nlohmann::json;
+
+static constexpr size_t wordSize = 32;
+static const size_t none = std::numeric_limits<size_t>::max();
+
+/// Splits the array suffixes off a member type, e.g. "Person[2][]" into "Person" and dimensions {0, 2}.
+static std::string splitDimensions(const std::string& type, std::vector<size_t>& dimensions) {
+    auto base = type;
+    while (!base.empty() && base.back() == ']') {
+        const auto open = base.rfind('[');
+        if (open == std::string::npos || open == 0) {
+            throw std::invalid_argument("Invalid type " + type);
+        }
+        const auto length = base.substr(open + 1, base.size() - open - 2);
+        if (length.empty()) {
+            dimensions.push_back(0);
+        } else {
+            if (length.size() > 6 || length.find_first_not_of("0123456789") != std::string::npos || length[0] == '0') {
+                throw std::invalid_argument("Invalid type " + type);
+            }
+            dimensions.push_back(std::stoul(length));
+        }
+        base.resize(open);
+    }
+    return base;
+}
+
+TypedDataSchema::TypedDataSchema(const json& typesJson) {
+    if (!typesJson.is_object()) {
+        throw std::invalid_argument("Expecting object");
+    }
+    // names first, as types may refer to types defined later, or to themselves
+    for (auto it = typesJson.begin(); it != typesJson.end(); ++it) {
+        if (it.key().empty()) {
+            throw std::invalid_argument("Missing type name");
+        }
+        indices.emplace(it.key(), types.size());
+        types.push_back(StructType{it.key(), {}, "", {}});
+    }
+    for (auto it = typesJson.begin(); it != typesJson.end(); ++it) {
+        auto& type = types[indices.at(it.key())];
+        if (!it.value().is_array()) {
+            throw std::invalid_argument("Expecting array, in " + type.name);
+        }
+        for (const auto& memberJson : it.value()) {
+            if (!memberJson.is_object() || !memberJson.contains("name") || !memberJson["name"].is_string() ||
+                !memberJson.contains("type") || !memberJson["type"].is_string()) {
+                throw std::invalid_argument("Expecting 'name' and 'type', in " + type.name);
+            }
+            Member member;
+            member.name = memberJson["name"].get<std::string>();
+            const auto typeString = memberJson["type"].get<std::string>();
+            if (member.name.empty() || typeString.empty()) {
+                throw std::invalid_argument("Expecting 'name' and 'type', in " + type.name);
+            }
+            const auto base = splitDimensions(typeString, member.type.dimensions);
+            const auto index = indices.find(base);
+            if (index != indices.end()) {
+                member.type.kind = ParamType::Kind::tuple;
+                member.type.size = index->second;
+                member.type.name = base;
+            } else {
+                try {
+                    const auto atomic = ParamType::parse(base);
+                    if (atomic.kind == ParamType::Kind::tuple || atomic.kind == ParamType::Kind::array ||
+                        atomic.kind == ParamType::Kind::fixedArray) {
+                        throw std::invalid_argument(base);
+                    }
+                    member.type.kind = atomic.kind;
+                    member.type.size = atomic.size;
+                    member.type.name = atomic.name;
+                } catch (const std::invalid_argument&) {
+                    throw std::invalid_argument("Unknown type " + base);
+                }
+            }
+            member.type.name += typeString.substr(base.size());
+            type.members.push_back(std::move(member));
+        }
+    }
+
+    // encoded type: the type itself, then the struct types it refers to, directly or not, sorted by name
+    for (size_t index = 0; index < types.size(); ++index) {
+        auto& type = types[index];
+        std::set<std::string> referenced;
+        std::vector<size_t> pending = {index};
+        while (!pending.empty()) {
+            const auto& current = types[pending.back()];
+            pending.pop_back();
+            for (const auto& member : current.members) {
+                if (member.type.kind == ParamType::Kind::tuple && member.type.size != index &&
+                    referenced.insert(types[member.type.size].name).second) {
+                    pending.push_back(member.type.size);
+                }
+            }
+        }
+        const auto encode = [](const StructType& structType) {
+            std::string encoded = structType.name + "(";
+            for (const auto& member : structType.members) {
+                if (encoded.back() != '(') {
+                    encoded += ",";
+                }
+                encoded += member.type.name + " " + member.name;
+            }
+            return encoded + ")";
+        };
+        type.encodedType = encode(type);
+        for (const auto& name : referenced) {
+            type.encodedType += encode(types[indices.at(name)]);
+        }
+        type.typeHash = Hash::Keccak256::hash(type.encodedType);
+    }
+}
+
+TypedDataSchema TypedDataSchema::parse(const std::string& typesJson) {
+    const auto types = json::parse(typesJson, nullptr, false);
+    if (types.is_discarded()) {
+        throw std::invalid_argument("Could not parse types Json");
+    }
+    return TypedDataSchema(types);
+}
+
+const TypedDataSchema::StructType& TypedDataSchema::find(const std::string& type) const {
+    const auto it = indices.find(type);
+    if (it == indices.end()) {
+        throw std::invalid_argument("Type not found, " + type);
+    }
+    return types[it->second];
+}
+
+const std::string& TypedDataSchema::encodeType(const std::string& type) const {
+    return find(type).encodedType;
+}
+
+Data TypedDataSchema::hashType(const std::string& type) const {
+    const auto& hash = find(type).typeHash;
+    return Data(hash.begin(), hash.end());
+}
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/// Returns the digits of a hex string, without the optional 0x prefix; throws if not all hex digits.
+static std::string_view hexDigits(std::string_view text) {
+    if (text.size() >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text.remove_prefix(2);
+    }
+    for (const auto c : text) {
+        if (hexDigit(c) < 0) {
+            throw std::invalid_argument("Invalid hex value");
+        }
+    }
+    return text;
+}
+
+/// Decodes hex digits into `out`; an odd number of digits is read as if it had a leading 0.  Returns the number of
+/// bytes written.
+static size_t decodeHex(std::string_view digits, byte* out) {
+    size_t size = 0;
+    if (digits.size() % 2 != 0) {
+        out[size++] = static_cast<byte>(hexDigit(digits[0]));
+        digits.remove_prefix(1);
+    }
+    for (size_t i = 0; i < digits.size(); i += 2) {
+        out[size++] = static_cast<byte>(hexDigit(digits[i]) << 4 | hexDigit(digits[i + 1]));
+    }
+    return size;
+}
+
+/// Parses an integer: decimal with an optional minus sign, or 0x-prefixed hex.  Sets `negative` for negative
+/// decimals, `value` to the magnitude; hex values are returned as is.
+static void parseInteger(std::string_view text, uint256_t& value, bool& negative) {
+    value = 0;
+    negative = false;
+    if (text.size() >= 3 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        const auto digits = hexDigits(text);
+        if (digits.size() > 64) {
+            throw std::invalid_argument("Integer out of range");
+        }
+        for (const auto c : digits) {
+            value = (value << 4) | hexDigit(c);
+        }
+        return;
+    }
+    if (!text.empty() && text[0] == '-') {
+        negative = true;
+        text.remove_prefix(1);
+    }
+    if (text.empty()) {
+        throw std::invalid_argument("Invalid integer");
+    }
+    static const uint256_t max = ~uint256_t(0);
+    for (const auto c : text) {
+        if (c < '0' || c > '9') {
+            throw std::invalid_argument("Invalid integer");
+        }
+        const auto digit = static_cast<unsigned>(c - '0');
+        if (value > (max - digit) / 10) {
+            throw std::invalid_argument("Integer out of range");
+        }
+        value = value * 10 + digit;
+    }
+}
+
+/// Streaming hasher of struct values: a SAX handler for the JSON parser.  Each struct being parsed has a buffer of
+/// its type hash and one word per member, filled in as members are parsed in any order; each array being parsed has
+/// an incremental hash of its elements.  Frames are reused from value to value.
+class TypedDataSchema::Hasher {
+  public:
+    explicit Hasher(const TypedDataSchema& schema) : schema(schema) {}
+
+    /// Hashes a struct value, writing the hash to `out`.
+    void hash(const StructType& type, const std::string& valueJson, byte* out) {
+        root.kind = ParamType::Kind::tuple;
+        root.size = static_cast<size_t>(&type - schema.types.data());
+        root.name = type.name;
+        depth = 0;
+        done = false;
+        result = out;
+        if (!json::sax_parse(valueJson, this)) {
+            throw std::invalid_argument("Could not parse Json");
+        }
+        if (!done) {
+            throw std::invalid_argument("Expecting object");
+        }
+    }
+
+    // SAX interface
+    bool null() {
+        const auto* type = expected();
+        if (type == nullptr) {
+            return true;
+        }
+        if (depth == 0 || dimension < type->dimensions.size() || type->kind != ParamType::Kind::tuple) {
+            throw std::invalid_argument("Missing value for " + type->name);
+        }
+        byte word[wordSize] = {0};
+        deliver(word);
+        return true;
+    }
+
+    bool boolean(bool value) {
+        const auto* type = atomic();
+        if (type == nullptr) {
+            return true;
+        }
+        if (type->kind != ParamType::Kind::boolean) {
+            throw std::invalid_argument("Expecting " + type->name);
+        }
+        byte word[wordSize] = {0};
+        word[wordSize - 1] = value ? 1 : 0;
+        deliver(word);
+        return true;
+    }
+
+    bool number_integer(json::number_integer_t value) {
+        return number(value < 0 ? uint256_t(-(value + 1)) + 1 : uint256_t(value), value < 0);
+    }
+
+    bool number_unsigned(json::number_unsigned_t value) { return number(uint256_t(value), false); }
+
+    bool number_float(json::number_float_t, const json::string_t& text) {
+        if (atomic() == nullptr) {
+            return true;
+        }
+        if (text.find_first_of(".eE") != std::string::npos) {
+            throw std::invalid_argument("Invalid integer " + text);
+        }
+        uint256_t value;
+        bool negative;
+        parseInteger(text, value, negative);
+        return number(value, negative);
+    }
+
+    bool string(json::string_t& value) {
+        const auto* type = atomic();
+        if (type == nullptr) {
+            return true;
+        }
+        byte word[wordSize] = {0};
+        switch (type->kind) {
+        case ParamType::Kind::uintN:
+        case ParamType::Kind::intN: {
+            uint256_t number;
+            bool negative;
+            parseInteger(value, number, negative);
+            if (type->kind == ParamType::Kind::intN && !negative && bit_test(number, 255)) {
+                // two's complement hex
+                number = uint256_t(0) - number;
+                negative = true;
+            }
+            encodeNumber(*type, number, negative, word);
+            break;
+        }
+        case ParamType::Kind::boolean:
+            if (value == "true" || value == "1") {
+                word[wordSize - 1] = 1;
+            } else if (value != "false" && value != "0") {
+                throw std::invalid_argument("Expecting bool");
+            }
+            break;
+        case ParamType::Kind::address: {
+            const auto digits = hexDigits(value);
+            if (digits.size() > 40) {
+                throw std::invalid_argument("Invalid address");
+            }
+            uint256_t number;
+            for (const auto c : digits) {
+                number = (number << 4) | hexDigit(c);
+            }
+            ValueEncoder::encodeUInt256(number, word);
+            break;
+        }
+        case ParamType::Kind::fixedBytes: {
+            const auto digits = hexDigits(value);
+            if ((digits.size() + 1) / 2 > type->size) {
+                throw std::invalid_argument("Invalid value for " + type->name);
+            }
+            decodeHex(digits, word);
+            break;
+        }
+        case ParamType::Kind::bytes: {
+            auto digits = hexDigits(value);
+            byte chunk[64];
+            while (!digits.empty()) {
+                // an odd first part, so that the rest is in pairs
+                const auto part = digits.substr(0, 2 * sizeof(chunk) - digits.size() % 2);
+                bytesHasher.update(chunk, decodeHex(part, chunk));
+                digits.remove_prefix(part.size());
+            }
+            const auto hash = bytesHasher.final();
+            std::memcpy(word, hash.data(), wordSize);
+            break;
+        }
+        case ParamType::Kind::string: {
+            const auto hash = Hash::Keccak256::hash(value);
+            std::memcpy(word, hash.data(), wordSize);
+            break;
+        }
+        default:
+            throw std::invalid_argument("Expecting " + type->name);
+        }
+        deliver(word);
+        return true;
+    }
+
+    bool binary(json::binary_t&) { throw std::invalid_argument("Unexpected binary value"); }
+
+    bool start_object(std::size_t) {
+        if (skip()) {
+            return true;
+        }
+        const auto* type = expected();
+        if (type == nullptr) {
+            push(Frame::Kind::skip);
+            return true;
+        }
+        if (dimension < type->dimensions.size() || type->kind != ParamType::Kind::tuple) {
+            throw std::invalid_argument("Unexpected object for " + type->name);
+        }
+        const auto& structType = schema.types[type->size];
+        auto& frame = push(Frame::Kind::structValue);
+        frame.structType = &structType;
+        frame.words.resize(wordSize * (1 + structType.members.size()));
+        std::memcpy(frame.words.data(), structType.typeHash.data(), wordSize);
+        std::fill(frame.words.begin() + wordSize, frame.words.end(), 0);
+        frame.seen.assign(structType.members.size(), false);
+        return true;
+    }
+
+    bool key(json::string_t& name) {
+        auto& frame = frames[depth - 1];
+        if (frame.kind == Frame::Kind::skip) {
+            return true;
+        }
+        frame.member = none;
+        const auto& members = frame.structType->members;
+        for (size_t i = 0; i < members.size(); ++i) {
+            if (members[i].name == name) {
+                frame.member = i;
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool end_object() {
+        if (unskip()) {
+            return true;
+        }
+        auto& frame = frames[depth - 1];
+        const auto& members = frame.structType->members;
+        for (size_t i = 0; i < members.size(); ++i) {
+            if (!frame.seen[i] && (!members[i].type.dimensions.empty() || members[i].type.kind != ParamType::Kind::tuple)) {
+                throw std::invalid_argument("Missing value for " + members[i].name + ", in " + frame.structType->name);
+            }
+        }
+        const auto hash = Hash::Keccak256::hash(frame.words);
+        --depth;
+        deliver(hash.data());
+        return true;
+    }
+
+    bool start_array(std::size_t) {
+        if (skip()) {
+            return true;
+        }
+        const auto* type = expected();
+        if (type == nullptr) {
+            push(Frame::Kind::skip);
+            return true;
+        }
+        if (dimension >= type->dimensions.size()) {
+            throw std::invalid_argument("Unexpected array for " + type->name);
+        }
+        const auto elementDimension = dimension;
+        auto& frame = push(Frame::Kind::array);
+        frame.element = type;
+        frame.dimension = elementDimension;
+        frame.count = 0;
+        frame.hasher = Hash::Keccak256();
+        return true;
+    }
+
+    bool end_array() {
+        if (unskip()) {
+            return true;
+        }
+        auto& frame = frames[depth - 1];
+        const auto length = frame.element->dimensions[frame.dimension];
+        if (length != 0 && frame.count != length) {
+            throw std::invalid_argument("Wrong number of elements for " + frame.element->name);
+        }
+        const auto hash = frame.hasher.final();
+        --depth;
+        deliver(hash.data());
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) { return false; }
+
+  private:
+    struct Frame {
+        enum class Kind { structValue, array, skip };
+        Kind kind = Kind::skip;
+
+        /// Struct: its type, type hash and member words, which members were set, and the member being parsed.
+        const StructType* structType = nullptr;
+        Data words;
+        std::vector<bool> seen;
+        size_t member = none;
+
+        /// Array: type and dimension of the array, hash of the elements so far.
+        const MemberType* element = nullptr;
+        size_t dimension = 0;
+        size_t count = 0;
+        Hash::Keccak256 hasher;
+
+        /// Skipped value: nesting depth.
+        size_t nesting = 0;
+    };
+
+    Frame& push(Frame::Kind kind) {
+        if (depth == frames.size()) {
+            frames.emplace_back();
+        }
+        auto& frame = frames[depth++];
+        frame.kind = kind;
+        frame.member = none;
+        frame.nesting = 0;
+        return frame;
+    }
+
+    /// Within a skipped value, counts nesting; returns whether skipping.
+    bool skip() {
+        if (depth > 0 && frames[depth - 1].kind == Frame::Kind::skip) {
+            ++frames[depth - 1].nesting;
+            return true;
+        }
+        return false;
+    }
+
+    /// At the end of an object or array within a skipped value; returns whether skipping.
+    bool unskip() {
+        auto& frame = frames[depth - 1];
+        if (frame.kind != Frame::Kind::skip) {
+            return false;
+        }
+        if (frame.nesting > 0) {
+            --frame.nesting;
+        } else {
+            --depth;
+            if (depth > 0) {
+                frames[depth - 1].member = none;
+            }
+        }
+        return true;
+    }
+
+    /// Type of the next value, with its array dimension in `dimension`; nullptr if the value is to be skipped.
+    const MemberType* expected() {
+        if (depth == 0) {
+            dimension = 0;
+            return &root;
+        }
+        const auto& frame = frames[depth - 1];
+        switch (frame.kind) {
+        case Frame::Kind::structValue:
+            if (frame.member == none) {
+                return nullptr;
+            }
+            dimension = 0;
+            return &frame.structType->members[frame.member].type;
+        case Frame::Kind::array:
+            dimension = frame.dimension + 1;
+            return frame.element;
+        default:
+            return nullptr;
+        }
+    }
+
+    /// Type of the next value, which must be atomic; nullptr if the value is to be skipped.
+    const MemberType* atomic() {
+        const auto* type = expected();
+        if (type == nullptr) {
+            return nullptr;
+        }
+        if (dimension < type->dimensions.size() || type->kind == ParamType::Kind::tuple) {
+            throw std::invalid_argument("Expecting " + (dimension < type->dimensions.size() ? "array" : type->name));
+        }
+        return type;
+    }
+
+    bool number(const uint256_t& value, bool negative) {
+        const auto* type = atomic();
+        if (type == nullptr) {
+            return true;
+        }
+        byte word[wordSize] = {0};
+        if (type->kind == ParamType::Kind::boolean && !negative && value <= 1) {
+            word[wordSize - 1] = static_cast<byte>(value);
+        } else {
+            encodeNumber(*type, value, negative, word);
+        }
+        deliver(word);
+        return true;
+    }
+
+    /// Encodes an integer of the given magnitude, checking it fits in the type.
+    static void encodeNumber(const MemberType& type, const uint256_t& value, bool negative, byte* word) {
+        if (type.kind == ParamType::Kind::uintN) {
+            if (negative || (type.size < 256 && value >> type.size != 0)) {
+                throw std::invalid_argument("Value out of range for " + type.name);
+            }
+            ValueEncoder::encodeUInt256(value, word);
+        } else if (type.kind == ParamType::Kind::intN) {
+            const auto limit = uint256_t(1) << (type.size - 1);
+            if (negative ? value > limit : value >= limit) {
+                throw std::invalid_argument("Value out of range for " + type.name);
+            }
+            ValueEncoder::encodeUInt256(negative ? uint256_t(0) - value : value, word);
+        } else {
+            throw std::invalid_argument("Expecting " + type.name);
+        }
+    }
+
+    /// Passes the word of a complete value to the enclosing struct or array.
+    void deliver(const byte* word) {
+        if (depth == 0) {
+            std::memcpy(result, word, wordSize);
+            done = true;
+            return;
+        }
+        auto& frame = frames[depth - 1];
+        if (frame.kind == Frame::Kind::structValue) {
+            std::memcpy(frame.words.data() + wordSize * (1 + frame.member), word, wordSize);
+            frame.seen[frame.member] = true;
+            frame.member = none;
+        } else {
+            frame.hasher.update(word, wordSize);
+            ++frame.count;
+        }
+    }
+
+    const TypedDataSchema& schema;
+    MemberType root;
+    std::vector<Frame> frames;
+    size_t depth = 0;
+    size_t dimension = 0;
+    bool done = false;
+    byte* result = nullptr;
+    Hash::Keccak256 bytesHasher;
+};
+
+Data TypedDataSchema::hashStruct(const std::string& type, const std::string& valueJson) const {
+    Data hash(wordSize);
+    Hasher(*this).hash(find(type), valueJson, hash.data());
+    return hash;
+}
+
+Data TypedDataSchema::hashMessage(const Data& domainSeparator, const std::string& primaryType,
+                                  const std::string& messageJson) const {
+    if (domainSeparator.size() != wordSize) {
+        throw std::invalid_argument("Invalid domain separator");
+    }
+    byte buffer[2 + 2 * wordSize] = {0x19, 0x01};
+    std::memcpy(buffer + 2, domainSeparator.data(), wordSize);
+    Hasher(*this).hash(find(primaryType), messageJson, buffer + 2 + wordSize);
+    const auto hash = Hash::Keccak256::hash(buffer, sizeof(buffer));
+    return Data(hash.begin(), hash.end());
+}
+
+std::vector<Data> TypedDataSchema::hashMessages(const Data& domainSeparator, const std::string& primaryType,
+                                                const std::vector<std::string>& messages, size_t threads) const {
+    if (domainSeparator.size() != wordSize) {
+        throw std::invalid_argument("Invalid domain separator");
+    }
+    const auto& type = find(primaryType);
+    std::vector<Data> hashes(messages.size());
+    parallelFor(messages.size(), threads, [&](size_t begin, size_t end) {
+        Hasher hasher(*this);
+        byte buffer[2 + 2 * wordSize] = {0x19, 0x01};
+        std::memcpy(buffer + 2, domainSeparator.data(), wordSize);
+        for (auto i = begin; i < end; ++i) {
+            try {
+                hasher.hash(type, messages[i], buffer + 2 + wordSize);
+            } catch (const std::invalid_argument&) {
+                continue;
+            }
+            const auto hash = Hash::Keccak256::hash(buffer, sizeof(buffer));
+            hashes[i] = Data(hash.begin(), hash.end());
+        }
+    });
+    return hashes;
+}
@@ -0,0 +1,112 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include "FunctionLayout.h"
+
+#include <Data.h>
+#include <Hash.h>
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TW::Ethereum::ABI {
+
+/// Compiled EIP712 struct types: the encoded type and type hash of each struct are computed once, and struct values
+/// are hashed directly from their JSON text in a single pass, without building a JSON tree or parameter objects.
+/// Member fields are matched by name, in any order; fields which are not members are ignored.
+///
+/// Encoding follows EIP712 (as eth-sig-util "v4"): referenced struct types are appended to the encoded type sorted by
+/// name; arrays, including empty ones, hash to the keccak256 of their encoded elements; a null or missing struct
+/// member is encoded as zero.  Values: integers as JSON numbers or decimal or 0x-prefixed hex strings (hex for intN
+/// is two's complement), bool as true/false, address and bytes as hex strings.
+///
+/// Thread safe.
+class TypedDataSchema {
+  public:
+    /// Compiles struct types given as a JSON object, as the "types" of a typed data message:
+    /// {"Person": [{"name": "name", "type": "string"}, {"name": "wallet", "type": "address"}], ...}.
+    ///
+    /// @throws std::invalid_argument if a type is malformed or refers to an unknown type.
+    explicit TypedDataSchema(const nlohmann::json& types);
+
+    /// Compiles struct types given as JSON text.
+    ///
+    /// @throws std::invalid_argument if the JSON is invalid or a type is malformed.
+    static TypedDataSchema parse(const std::string& typesJson);
+
+    /// Whether a struct type is defined.
+    bool hasType(const std::string& type) const { return indices.find(type) != indices.end(); }
+
+    /// Encoded type, of the form "Mail(Person from,Person to,string contents)Person(string name,address wallet)".
+    ///
+    /// @throws std::invalid_argument if the type is not defined.
+    const std::string& encodeType(const std::string& type) const;
+
+    /// Keccak256 hash of the encoded type.
+    ///
+    /// @throws std::invalid_argument if the type is not defined.
+    Data hashType(const std::string& type) const;
+
+    /// Hash of a struct value given as a JSON object.
+    ///
+    /// @throws std::invalid_argument if the type is not defined, or the JSON is invalid or doesn't match the type.
+    Data hashStruct(const std::string& type, const std::string& valueJson) const;
+
+    /// Domain separator: the hash of an "EIP712Domain" value.
+    ///
+    /// @throws std::invalid_argument as hashStruct.
+    Data domainSeparator(const std::string& domainJson) const { return hashStruct("EIP712Domain", domainJson); }
+
+    /// Hash to sign for a message: keccak256(0x1901 || domainSeparator || hashStruct(primaryType, message)).
+    ///
+    /// @throws std::invalid_argument as hashStruct.
+    Data hashMessage(const Data& domainSeparator, const std::string& primaryType, const std::string& messageJson) const;
+
+    /// Hashes messages of one primary type in one domain on the given number of threads (0 to use all cores).
+    /// Returns one hash per message, in order; empty for messages which are invalid.
+    ///
+    /// @throws std::invalid_argument if the primary type is not defined.
+    std::vector<Data> hashMessages(const Data& domainSeparator, const std::string& primaryType,
+                                   const std::vector<std::string>& messages, size_t threads = 0) const;
+
+  private:
+    /// Type of a struct member: an atomic type, or a struct when `kind` is tuple, `size` then being its index; in
+    /// arrays of the given dimensions.
+    struct MemberType {
+        ParamType::Kind kind = ParamType::Kind::tuple;
+        size_t size = 0;
+        /// Array lengths, outermost first; 0 for dynamic arrays.
+        std::vector<size_t> dimensions;
+        /// Canonical type string, e.g. "uint256[]" or "Person".
+        std::string name;
+    };
+
+    struct Member {
+        std::string name;
+        MemberType type;
+    };
+
+    struct StructType {
+        std::string name;
+        std::vector<Member> members;
+        std::string encodedType;
+        Hash::Digest<32> typeHash;
+    };
+
+    class Hasher;
+
+    const StructType& find(const std::string& type) const;
+
+    std::vector<StructType> types;
+    std::unordered_map<std::string, size_t> indices;
+};
+
+} // namespace TW::Ethereum::ABI
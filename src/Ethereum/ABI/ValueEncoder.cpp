@@ -46,7 +46,16 @@ inline Data paddedOnLeft(const Data& inout) {
 }
 
 void ValueEncoder::encodeUInt256(const uint256_t& value, Data& inout) {
-    append(inout, paddedOnLeft(store(value)));
+    inout.resize(inout.size() + encodedIntSize);
+    encodeUInt256(value, inout.data() + inout.size() - encodedIntSize);
+}
+
+void ValueEncoder::encodeUInt256(const uint256_t& value, byte* out) {
+    byte bytes[encodedIntSize];
+    const auto end = export_bits(value, bytes, 8);
+    const auto size = static_cast<size_t>(end - bytes);
+    std::fill(out, out + encodedIntSize - size, 0);
+    std::copy(bytes, end, out + encodedIntSize - size);
 }
 
 /// Encoding primitive: encode a number of bytes by taking hash
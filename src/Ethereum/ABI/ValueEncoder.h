@@ -26,6 +26,8 @@ public:
     static void encodeUInt32(uint32_t value, Data& inout);
     static void encodeInt256(const int256_t& value, Data& inout);
     static void encodeUInt256(const uint256_t& value, Data& inout);
+    /// Encode into 32 bytes at `out`, without allocating.
+    static void encodeUInt256(const uint256_t& value, byte* out);
     /// Encode the 20 bytes of an address
     static void encodeAddress(const Data& value, Data& inout);
     /// Encode a string by encoding its hash
@@ -13,10 +13,8 @@
 using namespace TW;
 using namespace TW::Ethereum;
 
-std::string Ethereum::checksumed(const Address& address, enum ChecksumType type) {
-    const auto addressString = hex(address.bytes);
-    const auto hash = hex(Hash::keccak256(addressString));
-
+/// Applies the case of the hex address from the hex hash of it.
+static std::string checksumed(const std::string& addressString, const std::string& hash) {
     std::string string = "0x";
     for (auto i = 0; i < std::min(addressString.size(), hash.size()); i += 1) {
         const auto a = addressString[i];
@@ -32,3 +30,25 @@ std::string Ethereum::checksumed(const Address& address, enum ChecksumType type)
 
     return string;
 }
+
+std::string Ethereum::checksumed(const Address& address, enum ChecksumType type) {
+    const auto addressString = hex(address.bytes);
+    const auto hash = hex(Hash::keccak256(addressString));
+    return ::checksumed(addressString, hash);
+}
+
+std::vector<std::string> Ethereum::checksumed(const std::vector<Address>& addresses, enum ChecksumType type) {
+    std::vector<std::string> addressStrings;
+    addressStrings.reserve(addresses.size());
+    for (const auto& address : addresses) {
+        addressStrings.push_back(hex(address.bytes));
+    }
+    const auto hashes = Hash::keccak256Multi(addressStrings);
+
+    std::vector<std::string> strings;
+    strings.reserve(addresses.size());
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        strings.push_back(::checksumed(addressStrings[i], hex(hashes[i])));
+    }
+    return strings;
+}
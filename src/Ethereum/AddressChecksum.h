@@ -8,6 +8,7 @@
 
 #include "Address.h"
 #include <string>
+#include <vector>
 
 namespace TW::Ethereum {
 
@@ -19,4 +20,7 @@ enum ChecksumType {
 
 std::string checksumed(const Address& address, enum ChecksumType type);
 
+/// Checksums several addresses, hashing them together.
+std::vector<std::string> checksumed(const std::vector<Address>& addresses, enum ChecksumType type);
+
 } // namespace TW::Ethereum
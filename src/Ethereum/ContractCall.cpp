@@ -99,4 +99,71 @@ optional<string> decodeCall(const Data& call, const json& abi) {
     return decoded.dump();
 }
 
+/// Value of a decoded parameter as a string, formatted as ParamFactory::getValue.
+static string viewValue(const ParamView& view) {
+    switch (view.getType().kind) {
+    case ParamType::Kind::uintN:
+        return toString(view.getUInt256());
+    case ParamType::Kind::intN:
+        return boost::lexical_cast<string>(view.getInt256());
+    case ParamType::Kind::boolean:
+        return view.getBool() ? "true" : "false";
+    case ParamType::Kind::string:
+        return string(view.getString());
+    case ParamType::Kind::address:
+    case ParamType::Kind::fixedBytes:
+    case ParamType::Kind::bytes:
+        return hexEncoded(view.getBytes());
+    default: {
+        auto values = json::array();
+        for (size_t i = 0; i < view.getCount(); ++i) {
+            // parse to prevent quotes on simple values
+            auto value = json::parse(viewValue(view[i]), nullptr, false);
+            values.push_back(value.is_discarded() ? json(viewValue(view[i])) : value);
+        }
+        return values.dump();
+    }
+    }
+}
+
+optional<string> decodeCall(const Data& call, const ContractRegistry& registry) {
+    const auto decoded = registry.decode(call);
+    if (decoded.function == nullptr) {
+        return {};
+    }
+    const auto& function = *decoded.function;
+    const auto& params = *decoded.params;
+    auto inputs = json::array();
+    for (size_t i = 0; i < params.getCount(); ++i) {
+        const auto value = params[i];
+        auto input = json{
+            {"name", function.inputNames[i]},
+            {"type", function.inputTypes[i]}
+        };
+        switch (value.getType().kind) {
+        case ParamType::Kind::array:
+        case ParamType::Kind::fixedArray:
+        case ParamType::Kind::tuple: {
+            vector<string> elements;
+            for (size_t j = 0; j < value.getCount(); ++j) {
+                elements.push_back(viewValue(value[j]));
+            }
+            input["value"] = json(elements);
+            break;
+        }
+        case ParamType::Kind::boolean:
+            input["value"] = json(value.getBool());
+            break;
+        default:
+            input["value"] = viewValue(value);
+        }
+        inputs.push_back(input);
+    }
+    auto result = json{
+        {"function", function.layout.getSignature()},
+        {"inputs", inputs},
+    };
+    return result.dump();
+}
+
 } // namespace TW::Ethereum::ABI
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "ContractRegistry.h"
 #include "Data.h"
 #include <nlohmann/json.hpp>
 #include <optional>
@@ -13,4 +14,7 @@
 
 namespace TW::Ethereum::ABI {
     std::optional<std::string> decodeCall(const Data& call, const nlohmann::json& abi);
+
+    /// Decodes a call with a registry of compiled ABIs, into the same JSON as decodeCall with an ABI.
+    std::optional<std::string> decodeCall(const Data& call, const ContractRegistry& registry);
 } // namespace TW::Ethereum::ABI
@@ -0,0 +1,119 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "ContractRegistry.h"
+
+#include "../BinaryCoding.h"
+#include "../Parallel.h"
+
+#include <stdexcept>
+
+using namespace TW;
+using namespace TW::Ethereum::ABI;
+using json = nlohmann::json;
+
+/// Returns the type string of an ABI parameter, spelling out tuple components.
+static std::string typeString(const json& param) {
+    const auto type = param.at("type").get<std::string>();
+    if (type.compare(0, 5, "tuple") != 0) {
+        return type;
+    }
+    std::string components = "(";
+    for (const auto& component : param.at("components")) {
+        if (components.size() > 1) {
+            components += ",";
+        }
+        components += typeString(component);
+    }
+    return components + ")" + type.substr(5);
+}
+
+size_t ContractRegistry::addAbi(const json& abi) {
+    size_t added = 0;
+    for (const auto& entry : abi) {
+        if (!entry.is_object() || entry.value("type", "function") != "function" || !entry.contains("name")) {
+            continue;
+        }
+        try {
+            std::vector<ParamType> types;
+            std::vector<std::string> names;
+            std::vector<std::string> typeNames;
+            for (const auto& input : entry.value("inputs", json::array())) {
+                types.push_back(ParamType::parse(typeString(input)));
+                names.push_back(input.value("name", ""));
+                typeNames.push_back(input.at("type").get<std::string>());
+            }
+            auto layout = FunctionLayout(entry.at("name").get<std::string>(), std::move(types));
+            added += add(RegistryFunction{std::move(layout), std::move(names), std::move(typeNames)});
+        } catch (const std::exception&) {
+            // unsupported type or malformed entry
+        }
+    }
+    return added;
+}
+
+bool ContractRegistry::addFunction(const std::string& name, const std::vector<std::string>& types,
+                                   const std::vector<std::string>& names) {
+    auto function = RegistryFunction{FunctionLayout(name, types), names, types};
+    function.inputNames.resize(types.size());
+    return add(std::move(function));
+}
+
+bool ContractRegistry::add(RegistryFunction function) {
+    auto& candidates = bySelector[decode32BE(function.layout.getSelector().data())];
+    for (const auto* candidate : candidates) {
+        if (candidate->layout.getSignature() == function.layout.getSignature()) {
+            return false;
+        }
+    }
+    functions.push_back(std::move(function));
+    candidates.push_back(&functions.back());
+    return true;
+}
+
+std::vector<const RegistryFunction*> ContractRegistry::find(const Selector& selector) const {
+    const auto it = bySelector.find(decode32BE(selector.data()));
+    if (it == bySelector.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+DecodedCall ContractRegistry::decode(const byte* call, size_t size) const {
+    DecodedCall result;
+    if (size < 4) {
+        return result;
+    }
+    const auto it = bySelector.find(decode32BE(call));
+    if (it == bySelector.end()) {
+        return result;
+    }
+    auto exact = false;
+    for (const auto* function : it->second) {
+        size_t used = 0;
+        const auto params = function->layout.decode(call, size, &used);
+        if (!params) {
+            continue;
+        }
+        ++result.matches;
+        if (result.function == nullptr || (!exact && used == size)) {
+            result.function = function;
+            result.params = params;
+            exact = used == size;
+        }
+    }
+    return result;
+}
+
+std::vector<DecodedCall> ContractRegistry::decode(const std::vector<Data>& calls, size_t threads) const {
+    std::vector<DecodedCall> results(calls.size());
+    parallelFor(calls.size(), threads, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            results[i] = decode(calls[i]);
+        }
+    });
+    return results;
+}
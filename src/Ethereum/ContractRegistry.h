@@ -0,0 +1,96 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include "ABI/FunctionLayout.h"
+#include "Data.h"
+
+#include <nlohmann/json.hpp>
+
+#include <deque>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TW::Ethereum::ABI {
+
+/// A contract function in a ContractRegistry.
+struct RegistryFunction {
+    /// Compiled input parameters.
+    FunctionLayout layout;
+
+    /// Input names, as given in the ABI.
+    std::vector<std::string> inputNames;
+
+    /// Input types, as given in the ABI ("tuple" for tuples).
+    std::vector<std::string> inputTypes;
+};
+
+/// Result of decoding one call with a ContractRegistry.
+struct DecodedCall {
+    /// Function the call was decoded with, nullptr if none matched.
+    const RegistryFunction* function = nullptr;
+
+    /// Parameters, views into the calldata; empty if no function matched.
+    std::optional<ParamView> params;
+
+    /// Number of registered functions whose parameters decode the call; more than one if the selector collides.
+    size_t matches = 0;
+};
+
+/// Functions of many contract ABIs, compiled and indexed by selector once, for decoding calls without parsing JSON or
+/// building Function objects per call.  A function signature is stored once however many ABIs contain it.  Functions
+/// with different signatures but the same selector are all kept; a call is decoded with the one whose parameters span
+/// the calldata exactly, else with the first added whose parameters decode at all.
+///
+/// Decoding is thread safe; adding functions is not, and must not happen concurrently with decoding.  Results refer
+/// to the registry and to the calldata, which must outlive them.
+class ContractRegistry {
+  public:
+    using Selector = std::array<byte, 4>;
+
+    ContractRegistry() = default;
+
+    /// Not copyable, the selector index points into the functions; moves keep the functions in place.
+    ContractRegistry(const ContractRegistry&) = delete;
+    ContractRegistry& operator=(const ContractRegistry&) = delete;
+    ContractRegistry(ContractRegistry&&) = default;
+    ContractRegistry& operator=(ContractRegistry&&) = default;
+
+    /// Adds the functions of a JSON ABI: either a standard ABI array, or an object of functions keyed by selector as
+    /// used by decodeCall.  Functions with types which are not supported are skipped.  Returns the number of
+    /// functions added, not counting ones already present.
+    size_t addAbi(const nlohmann::json& abi);
+
+    /// Adds a function with the given input names, if not already present.
+    ///
+    /// @throws std::invalid_argument if a type is not supported.
+    bool addFunction(const std::string& name, const std::vector<std::string>& types,
+                     const std::vector<std::string>& names = {});
+
+    /// Number of functions.
+    size_t size() const { return functions.size(); }
+
+    /// Functions with a selector, in the order added.
+    std::vector<const RegistryFunction*> find(const Selector& selector) const;
+
+    /// Decodes a call.
+    DecodedCall decode(const byte* call, size_t size) const;
+    DecodedCall decode(const Data& call) const { return decode(call.data(), call.size()); }
+
+    /// Decodes calls on the given number of threads (0 to use all cores).  Returns one result per call, in order.
+    std::vector<DecodedCall> decode(const std::vector<Data>& calls, size_t threads = 0) const;
+
+  private:
+    bool add(RegistryFunction function);
+
+    std::deque<RegistryFunction> functions;
+    std::unordered_map<uint32_t, std::vector<const RegistryFunction*>> bySelector;
+};
+
+} // namespace TW::Ethereum::ABI
@@ -7,6 +7,8 @@
 #include "Entry.h"
 
 #include "Address.h"
+#include "AddressChecksum.h"
+#include "../Hash.h"
 #include "Signer.h"
 
 using namespace TW::Ethereum;
@@ -25,10 +27,43 @@ string Entry::deriveAddress(TWCoinType coin, const PublicKey& publicKey, TW::byt
     return Address(publicKey).string();
 }
 
+void Entry::deriveAddresses(TWCoinType coin, const std::vector<PublicKey>& publicKeys, TW::byte, const char*,
+                            std::vector<std::string>& addresses) const {
+    // as Address(publicKey): Keccak of the extended key without its type byte, all keys at once
+    std::vector<const TW::byte*> data;
+    std::vector<size_t> sizes;
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < publicKeys.size(); ++i) {
+        if (publicKeys[i].type != TWPublicKeyTypeSECP256k1Extended) {
+            continue;
+        }
+        data.push_back(publicKeys[i].bytes.data() + 1);
+        sizes.push_back(publicKeys[i].bytes.size() - 1);
+        indices.push_back(i);
+    }
+    std::vector<TW::Hash::Digest<TW::Hash::sha256Size>> hashes(indices.size());
+    TW::Hash::keccak256Multi(data.data(), sizes.data(), indices.size(), hashes.data());
+
+    std::vector<Address> derived;
+    derived.reserve(hashes.size());
+    for (const auto& hash : hashes) {
+        derived.emplace_back(TW::Data(hash.end() - Address::size, hash.end()));
+    }
+    auto strings = checksumed(derived, ChecksumType::eip55);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        addresses[indices[i]] = std::move(strings[i]);
+    }
+}
+
 void Entry::sign(TWCoinType coin, const TW::Data& dataIn, TW::Data& dataOut) const {
     signTemplate<Signer, Proto::SigningInput>(dataIn, dataOut);
 }
 
+void Entry::signBatch(TWCoinType coin, const std::vector<TW::Data>& inputs, size_t begin, size_t end,
+                      std::vector<TW::Data>& outputs, std::vector<std::string>& errors) const {
+    signBatchTemplate<Signer, Proto::SigningInput>(inputs, begin, end, outputs, errors);
+}
+
 string Entry::signJSON(TWCoinType coin, const std::string& json, const Data& key) const { 
     return Signer::signJSON(json, key);
 }
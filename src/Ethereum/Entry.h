@@ -37,7 +37,11 @@ public:
     virtual bool validateAddress(TWCoinType coin, const std::string& address, TW::byte p2pkh, TW::byte p2sh, const char* hrp) const;
     virtual std::string normalizeAddress(TWCoinType coin, const std::string& address) const;
     virtual std::string deriveAddress(TWCoinType coin, const PublicKey& publicKey, TW::byte p2pkh, const char* hrp) const;
+    virtual void deriveAddresses(TWCoinType coin, const std::vector<PublicKey>& publicKeys, TW::byte p2pkh, const char* hrp,
+                                 std::vector<std::string>& addresses) const;
     virtual void sign(TWCoinType coin, const Data& dataIn, Data& dataOut) const;
+    virtual void signBatch(TWCoinType coin, const std::vector<Data>& inputs, size_t begin, size_t end,
+                           std::vector<Data>& outputs, std::vector<std::string>& errors) const;
     virtual bool supportsJSONSigning() const { return true; }
     virtual std::string signJSON(TWCoinType coin, const std::string& json, const Data& key) const;
 };
@@ -10,39 +10,93 @@
 #include "../uint256.h"
 #include "../BinaryCoding.h"
 
+#include <cstring>
 #include <tuple>
 
 using namespace TW;
 using namespace TW::Ethereum;
 
-Data RLP::encode(const uint256_t& value) noexcept {
-    using boost::multiprecision::cpp_int;
+/// Number of bytes of a length, at least 1.
+static size_t lengthSize(uint64_t length) noexcept {
+    size_t size = 1;
+    while (length >>= 8) {
+        ++size;
+    }
+    return size;
+}
 
-    Data bytes;
-    export_bits(value, std::back_inserter(bytes), 8);
+size_t RLPSizer::headerSize(uint64_t payloadSize) noexcept {
+    return payloadSize < 56 ? 1 : 1 + lengthSize(payloadSize);
+}
 
-    if (bytes.empty() || (bytes.size() == 1 && bytes[0] == 0)) {
-        return {0x80};
+size_t RLPSizer::encodedSize(const uint256_t& number) noexcept {
+    if (number < 0x80) {
+        return 1;
     }
+    return 1 + msb(number) / 8 + 1;
+}
 
-    return encode(bytes);
+RLPWriter& RLPWriter::add(const uint256_t& number) noexcept {
+    if (number == 0) {
+        *position++ = 0x80;
+    } else if (number < 0x80) {
+        *position++ = static_cast<byte>(number);
+    } else {
+        auto* header = position++;
+        position = export_bits(number, position, 8);
+        *header = static_cast<byte>(0x80 + (position - header - 1));
+    }
+    return *this;
+}
+
+RLPWriter& RLPWriter::add(const byte* data, size_t size) noexcept {
+    if (size == 1 && data[0] <= 0x7f) {
+        // Fits in single byte, no header
+        *position++ = data[0];
+        return *this;
+    }
+    addHeader(size, 0x80);
+    return addEncoded(data, size);
+}
+
+RLPWriter& RLPWriter::addEncoded(const byte* data, size_t size) noexcept {
+    if (size > 0) {
+        std::memcpy(position, data, size);
+        position += size;
+    }
+    return *this;
+}
+
+RLPWriter& RLPWriter::addHeader(uint64_t payloadSize, uint8_t smallTag) noexcept {
+    if (payloadSize < 56) {
+        *position++ = static_cast<byte>(smallTag + payloadSize);
+        return *this;
+    }
+    const auto size = lengthSize(payloadSize);
+    *position++ = static_cast<byte>(smallTag + 55 + size);
+    for (auto i = size; i > 0; --i) {
+        position[i - 1] = static_cast<byte>(payloadSize);
+        payloadSize >>= 8;
+    }
+    position += size;
+    return *this;
+}
+
+Data RLP::encode(const uint256_t& value) noexcept {
+    Data encoded(RLPSizer::encodedSize(value));
+    RLPWriter(encoded.data()).add(value);
+    return encoded;
 }
 
 Data RLP::encodeList(const Data& encoded) noexcept {
-    auto result = encodeHeader(encoded.size(), 0xc0, 0xf7);
-    result.reserve(result.size() + encoded.size());
-    result.insert(result.end(), encoded.begin(), encoded.end());
+    Data result(RLPSizer::headerSize(encoded.size()) + encoded.size());
+    RLPWriter(result.data()).addHeader(encoded.size(), 0xc0).addEncoded(encoded);
     return result;
 }
 
 Data RLP::encode(const Data& data) noexcept {
-    if (data.size() == 1 && data[0] <= 0x7f) {
-        // Fits in single byte, no header
-        return data;
-    }
-
-    auto encoded = encodeHeader(data.size(), 0x80, 0xb7);
-    encoded.insert(encoded.end(), data.begin(), data.end());
+    Data encoded(RLPSizer::encodedSize(data.data(), data.size()));
+    RLPWriter(encoded.data()).add(data);
     return encoded;
 }
 
@@ -50,13 +104,9 @@ Data RLP::encodeHeader(uint64_t size, uint8_t smallTag, uint8_t largeTag) noexce
     if (size < 56) {
         return {static_cast<uint8_t>(smallTag + size)};
     }
-
-    const auto sizeData = putVarInt(size);
-
-    auto header = Data();
-    header.reserve(1 + sizeData.size());
-    header.push_back(largeTag + static_cast<uint8_t>(sizeData.size()));
-    header.insert(header.end(), sizeData.begin(), sizeData.end());
+    Data header(RLPSizer::headerSize(size));
+    RLPWriter(header.data()).addHeader(size, smallTag);
+    header[0] = static_cast<uint8_t>(largeTag + header.size() - 1);
     return header;
 }
 
@@ -190,3 +240,70 @@ RLP::DecodedItem RLP::decode(const Data& input) {
     item.remainder = Data(input.begin() + 1 + lenOfListLen + listLen, input.end());
     return item;
 }
+
+uint256_t RLPItem::toUInt256() const {
+    if (isList || size > 32) {
+        throw std::invalid_argument("Expecting number");
+    }
+    uint256_t value;
+    if (size > 0) {
+        import_bits(value, data, data + size, 8);
+    }
+    return value;
+}
+
+RLPItem RLPReader::next() {
+    if (position == last) {
+        throw std::invalid_argument("can't decode empty rlp data");
+    }
+    const auto available = static_cast<size_t>(last - position - 1);
+    const auto prefix = *position;
+    RLPItem item;
+    size_t headerSize = 1;
+    if (prefix <= 0x7f) {
+        // a single byte, its own encoding
+        item.data = position;
+        item.size = 1;
+        position += 1;
+        return item;
+    }
+    if (prefix <= 0xb7) {
+        // short string
+        item.size = prefix - 0x80;
+        if (item.size == 1 && available >= 1 && position[1] <= 0x7f) {
+            throw std::invalid_argument("single byte below 128 must be encoded as itself");
+        }
+    } else if (prefix <= 0xbf || prefix >= 0xf8) {
+        // long string or list: length of the length, then the length
+        const auto sizeOfLength = static_cast<size_t>(prefix - (prefix <= 0xbf ? 0xb7 : 0xf7));
+        if (available < sizeOfLength) {
+            throw std::invalid_argument("Not enough data for varInt");
+        }
+        if (sizeOfLength >= 2 && position[1] == 0) {
+            throw std::invalid_argument("multi-byte length must have no leading zero");
+        }
+        uint64_t length = 0;
+        for (size_t i = 0; i < sizeOfLength; ++i) {
+            length = length << 8 | position[1 + i];
+        }
+        if (length < 56) {
+            throw std::invalid_argument("length below 56 must be encoded in one byte");
+        }
+        if (length > available - sizeOfLength) {
+            throw std::invalid_argument("Invalid rlp encoding length");
+        }
+        headerSize += sizeOfLength;
+        item.size = static_cast<size_t>(length);
+        item.isList = prefix >= 0xf8;
+    } else {
+        // short list
+        item.size = prefix - 0xc0;
+        item.isList = true;
+    }
+    if (item.size > available - (headerSize - 1)) {
+        throw std::invalid_argument("Invalid rlp encoding length");
+    }
+    item.data = position + headerSize;
+    position = item.data + item.size;
+    return item;
+}
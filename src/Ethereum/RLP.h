@@ -10,12 +10,112 @@
 #include "../Data.h"
 #include "../uint256.h"
 
+#include <array>
+#include <cassert>
 #include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace TW::Ethereum {
 
+/// First pass of two-pass RLP encoding: adds up the encoded size of items, without encoding them.  Has the same
+/// interface as RLPWriter, so that the same function can add items to either; see RLP::writeList.
+class RLPSizer {
+  public:
+    /// Size of the header of a string or list with the given payload size.
+    static size_t headerSize(uint64_t payloadSize) noexcept;
+
+    /// Encoded size of a number.
+    static size_t encodedSize(const uint256_t& number) noexcept;
+
+    /// Encoded size of a string.
+    static size_t encodedSize(const byte* data, size_t size) noexcept {
+        return size == 1 && data[0] <= 0x7f ? 1 : headerSize(size) + size;
+    }
+
+    RLPSizer& add(const uint256_t& number) noexcept {
+        total += encodedSize(number);
+        return *this;
+    }
+
+    RLPSizer& add(const byte* data, size_t size) noexcept {
+        total += encodedSize(data, size);
+        return *this;
+    }
+
+    RLPSizer& add(const Data& data) noexcept { return add(data.data(), data.size()); }
+
+    template <std::size_t N>
+    RLPSizer& add(const std::array<uint8_t, N>& data) noexcept {
+        return add(data.data(), N);
+    }
+
+    /// Adds an item which is already encoded.
+    RLPSizer& addEncoded(const byte* data, size_t size) noexcept {
+        total += size;
+        return *this;
+    }
+
+    RLPSizer& addEncoded(const Data& encoded) noexcept { return addEncoded(encoded.data(), encoded.size()); }
+
+    /// Adds a list; `items` is called with an RLPSizer to add its items.
+    template <typename F>
+    RLPSizer& addList(F&& items) {
+        RLPSizer list;
+        items(list);
+        total += headerSize(list.total) + list.total;
+        return *this;
+    }
+
+    /// Encoded size of the items added.
+    size_t size() const noexcept { return total; }
+
+  private:
+    size_t total = 0;
+};
+
+/// Second pass of two-pass RLP encoding: writes items into a buffer which was sized with RLPSizer.
+class RLPWriter {
+  public:
+    explicit RLPWriter(byte* out) noexcept : position(out) {}
+
+    RLPWriter& add(const uint256_t& number) noexcept;
+
+    RLPWriter& add(const byte* data, size_t size) noexcept;
+
+    RLPWriter& add(const Data& data) noexcept { return add(data.data(), data.size()); }
+
+    template <std::size_t N>
+    RLPWriter& add(const std::array<uint8_t, N>& data) noexcept {
+        return add(data.data(), N);
+    }
+
+    /// Adds an item which is already encoded.
+    RLPWriter& addEncoded(const byte* data, size_t size) noexcept;
+
+    RLPWriter& addEncoded(const Data& encoded) noexcept { return addEncoded(encoded.data(), encoded.size()); }
+
+    /// Adds a list; `items` is called with an RLPSizer and then with this writer, and must add the same items to both.
+    template <typename F>
+    RLPWriter& addList(F&& items) {
+        RLPSizer list;
+        items(list);
+        addHeader(list.size(), 0xc0);
+        items(*this);
+        return *this;
+    }
+
+    /// Writes the header of a string (tag 0x80) or list (tag 0xc0) with the given payload size.
+    RLPWriter& addHeader(uint64_t payloadSize, uint8_t smallTag) noexcept;
+
+    /// Position after the last item written.
+    byte* end() const noexcept { return position; }
+
+  private:
+    byte* position;
+};
+
 /// Implementation of Ethereum's RLP encoding.
 ///
 /// - SeeAlso: https://github.com/ethereum/wiki/wiki/RLP
@@ -88,6 +188,28 @@ struct RLP {
     /// Encodes a list header.
     static Data encodeHeader(uint64_t size, uint8_t smallTag, uint8_t largeTag) noexcept;
 
+    /// Encodes a list in two passes, into one buffer of exactly the encoded size, with no intermediate buffers.
+    /// `items` is called with an RLPSizer, then with an RLPWriter, and must add the same items to both:
+    /// `RLP::writeList([&](auto& rlp) { rlp.add(nonce).add(to).addList([](auto&) {}); })`.
+    template <typename F>
+    static Data writeList(F&& items) {
+        Data encoded;
+        writeList(items, encoded);
+        return encoded;
+    }
+
+    /// Encodes a list in two passes, appending to `encoded`.
+    template <typename F>
+    static void writeList(F&& items, Data& encoded) {
+        RLPSizer sizer;
+        sizer.addList(items);
+        const auto offset = encoded.size();
+        encoded.resize(offset + sizer.size());
+        RLPWriter writer(encoded.data() + offset);
+        writer.addList(items);
+        assert(writer.end() == encoded.data() + encoded.size());
+    }
+
     struct DecodedItem {
         std::vector<Data> decoded;
         Data remainder;
@@ -103,4 +225,58 @@ struct RLP {
     static uint64_t parseVarInt(size_t size, const Data& data, size_t index);
 };
 
+class RLPReader;
+
+/// An RLP item within encoded data, a string or a list; refers to the data, nothing is copied.
+struct RLPItem {
+    bool isList = false;
+
+    /// Content of a string, encoded items of a list.
+    const byte* data = nullptr;
+    size_t size = 0;
+
+    /// Content of a string, copied.
+    Data toData() const { return Data(data, data + size); }
+
+    /// Content of a string as a big endian number.
+    ///
+    /// @throws std::invalid_argument if it is a list or longer than 32 bytes.
+    uint256_t toUInt256() const;
+
+    /// Reader of the items of a list.
+    ///
+    /// @throws std::invalid_argument if it is a string.
+    RLPReader items() const;
+};
+
+/// Reads consecutive RLP items from encoded data without copying, checking that lengths are consistent and encoded
+/// canonically, as RLP::decode does.  Nested lists are read with RLPItem::items().
+class RLPReader {
+  public:
+    RLPReader(const byte* data, size_t size) noexcept : position(data), last(data + size) {}
+    explicit RLPReader(const Data& data) noexcept : RLPReader(data.data(), data.size()) {}
+
+    /// Whether all items were read.
+    bool atEnd() const noexcept { return position == last; }
+
+    /// Reads the next item.
+    ///
+    /// @throws std::invalid_argument if the encoding is invalid or all items were read.
+    RLPItem next();
+
+    /// Number of bytes not read yet.
+    size_t remaining() const noexcept { return static_cast<size_t>(last - position); }
+
+  private:
+    const byte* position;
+    const byte* last;
+};
+
+inline RLPReader RLPItem::items() const {
+    if (!isList) {
+        throw std::invalid_argument("Expecting list");
+    }
+    return RLPReader(data, size);
+}
+
 } // namespace TW::Ethereum
@@ -16,8 +16,6 @@ using namespace TW::Ethereum;
 using namespace TW;
 
 
-static const Data EmptyListEncoded = parse_hex("c0");
-
 std::shared_ptr<TransactionNonTyped> TransactionNonTyped::buildNativeTransfer(const uint256_t& nonce,
     const uint256_t& gasPrice, const uint256_t& gasLimit,
     const Data& toAddress, const uint256_t& amount, const Data& data) {
@@ -49,31 +47,17 @@ std::shared_ptr<TransactionNonTyped> TransactionNonTyped::buildERC1155Transfer(c
 }
 
 Data TransactionNonTyped::preHash(const uint256_t chainID) const {
-    Data encoded;
-    append(encoded, RLP::encode(nonce));
-    append(encoded, RLP::encode(gasPrice));
-    append(encoded, RLP::encode(gasLimit));
-    append(encoded, RLP::encode(to));
-    append(encoded, RLP::encode(amount));
-    append(encoded, RLP::encode(payload));
-    append(encoded, RLP::encode(chainID));
-    append(encoded, RLP::encode(0));
-    append(encoded, RLP::encode(0));
-    return Hash::keccak256(RLP::encodeList(encoded));
+    return Hash::keccak256(RLP::writeList([&](auto& rlp) {
+        rlp.add(nonce).add(gasPrice).add(gasLimit).add(to).add(amount).add(payload);
+        rlp.add(chainID).add(0).add(0);
+    }));
 }
 
 Data TransactionNonTyped::encoded(const Signature& signature, const uint256_t chainID) const {
-    Data encoded;
-    append(encoded, RLP::encode(nonce));
-    append(encoded, RLP::encode(gasPrice));
-    append(encoded, RLP::encode(gasLimit));
-    append(encoded, RLP::encode(to));
-    append(encoded, RLP::encode(amount));
-    append(encoded, RLP::encode(payload));
-    append(encoded, RLP::encode(signature.v));
-    append(encoded, RLP::encode(signature.r));
-    append(encoded, RLP::encode(signature.s));
-    return RLP::encodeList(encoded);
+    return RLP::writeList([&](auto& rlp) {
+        rlp.add(nonce).add(gasPrice).add(gasLimit).add(to).add(amount).add(payload);
+        rlp.add(signature.v).add(signature.r).add(signature.s);
+    });
 }
 
 Data TransactionNonTyped::buildERC20TransferCall(const Data& to, const uint256_t& amount) {
@@ -121,41 +105,23 @@ Data TransactionNonTyped::buildERC1155TransferFromCall(const Data& from, const D
 }
 
 Data TransactionEip1559::preHash(const uint256_t chainID) const {
-    Data encoded;
-    append(encoded, RLP::encode(chainID));
-    append(encoded, RLP::encode(nonce));
-    append(encoded, RLP::encode(maxInclusionFeePerGas));
-    append(encoded, RLP::encode(maxFeePerGas));
-    append(encoded, RLP::encode(gasLimit));
-    append(encoded, RLP::encode(to));
-    append(encoded, RLP::encode(amount));
-    append(encoded, RLP::encode(payload));
-    append(encoded, EmptyListEncoded); // empty accessList
-
-    Data envelope;
-    append(envelope, static_cast<uint8_t>(type));
-    append(envelope, RLP::encodeList(encoded));
+    Data envelope = {static_cast<uint8_t>(type)};
+    RLP::writeList([&](auto& rlp) {
+        rlp.add(chainID).add(nonce).add(maxInclusionFeePerGas).add(maxFeePerGas).add(gasLimit);
+        rlp.add(to).add(amount).add(payload);
+        rlp.addList([](auto&) {}); // empty accessList
+    }, envelope);
     return Hash::keccak256(envelope);
 }
 
 Data TransactionEip1559::encoded(const Signature& signature, const uint256_t chainID) const {
-    Data encoded;
-    append(encoded, RLP::encode(chainID));
-    append(encoded, RLP::encode(nonce));
-    append(encoded, RLP::encode(maxInclusionFeePerGas));
-    append(encoded, RLP::encode(maxFeePerGas));
-    append(encoded, RLP::encode(gasLimit));
-    append(encoded, RLP::encode(to));
-    append(encoded, RLP::encode(amount));
-    append(encoded, RLP::encode(payload));
-    append(encoded, EmptyListEncoded); // empty accessList
-    append(encoded, RLP::encode(signature.v));
-    append(encoded, RLP::encode(signature.r));
-    append(encoded, RLP::encode(signature.s));
-
-    Data envelope;
-    append(envelope, static_cast<uint8_t>(type));
-    append(envelope, RLP::encodeList(encoded));
+    Data envelope = {static_cast<uint8_t>(type)};
+    RLP::writeList([&](auto& rlp) {
+        rlp.add(chainID).add(nonce).add(maxInclusionFeePerGas).add(maxFeePerGas).add(gasLimit);
+        rlp.add(to).add(amount).add(payload);
+        rlp.addList([](auto&) {}); // empty accessList
+        rlp.add(signature.v).add(signature.r).add(signature.s);
+    }, envelope);
     return envelope;
 }
 
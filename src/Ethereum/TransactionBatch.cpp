@@ -0,0 +1,119 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "TransactionBatch.h"
+#include "RLP.h"
+#include "Signer.h"
+
+#include "../Hash.h"
+#include "../Parallel.h"
+
+using namespace TW;
+using namespace TW::Ethereum;
+
+// Field order, legacy: nonce, gasPrice, gasLimit, to, amount, payload, then chainID, 0, 0 (pre-hash) or v, r, s.
+template <>
+TransactionBatch<TransactionNonTyped>::TransactionBatch(const TransactionNonTyped& transaction,
+                                                        const uint256_t& chainID)
+    : chainID(chainID), replayProtection(transaction.usesReplayProtection()) {
+    append(fees, RLP::encode(transaction.gasPrice));
+    append(fees, RLP::encode(transaction.gasLimit));
+    append(tail, RLP::encode(transaction.payload));
+    append(preHashTail, RLP::encode(chainID));
+    append(preHashTail, RLP::encode(0));
+    append(preHashTail, RLP::encode(0));
+}
+
+// Field order, EIP1559: chainID, nonce, maxInclusionFeePerGas, maxFeePerGas, gasLimit, to, amount, payload,
+// accessList, then v, r, s (signed only).
+template <>
+TransactionBatch<TransactionEip1559>::TransactionBatch(const TransactionEip1559& transaction,
+                                                       const uint256_t& chainID)
+    : chainID(chainID), replayProtection(transaction.usesReplayProtection()) {
+    envelope = {static_cast<uint8_t>(transaction.type)};
+    append(head, RLP::encode(chainID));
+    append(fees, RLP::encode(transaction.maxInclusionFeePerGas));
+    append(fees, RLP::encode(transaction.maxFeePerGas));
+    append(fees, RLP::encode(transaction.gasLimit));
+    append(tail, RLP::encode(transaction.payload));
+    append(tail, RLP::encodeList(Data())); // empty accessList
+}
+
+template <typename Transaction>
+void TransactionBatch<Transaction>::write(const uint256_t& nonce, const BatchTransfer& transfer,
+                                          const Signature* signature, Data& out) const {
+    append(out, envelope);
+    RLP::writeList([&](auto& rlp) {
+        rlp.addEncoded(head).add(nonce).addEncoded(fees).add(transfer.to).add(transfer.amount).addEncoded(tail);
+        if (signature == nullptr) {
+            rlp.addEncoded(preHashTail);
+        } else {
+            rlp.add(signature->v).add(signature->r).add(signature->s);
+        }
+    }, out);
+}
+
+template <typename Transaction>
+Data TransactionBatch<Transaction>::preHash(const uint256_t& nonce, const BatchTransfer& transfer) const {
+    Data unsignedTransaction;
+    write(nonce, transfer, nullptr, unsignedTransaction);
+    return Hash::keccak256(unsignedTransaction);
+}
+
+template <typename Transaction>
+Data TransactionBatch<Transaction>::encoded(const uint256_t& nonce, const BatchTransfer& transfer,
+                                            const Signature& signature) const {
+    Data encoded;
+    write(nonce, transfer, &signature, encoded);
+    return encoded;
+}
+
+template <typename Transaction>
+template <typename F>
+void TransactionBatch<Transaction>::forEachPreHash(const uint256_t& firstNonce,
+                                                   const std::vector<BatchTransfer>& transfers, size_t threads,
+                                                   F&& f) const {
+    parallelFor(transfers.size(), threads, [&](size_t begin, size_t end) {
+        std::vector<Data> unsignedTransactions(end - begin);
+        for (auto i = begin; i < end; ++i) {
+            write(firstNonce + i, transfers[i], nullptr, unsignedTransactions[i - begin]);
+        }
+        f(begin, end, Hash::keccak256Multi(unsignedTransactions));
+    });
+}
+
+template <typename Transaction>
+std::vector<Data> TransactionBatch<Transaction>::preHashes(const uint256_t& firstNonce,
+                                                           const std::vector<BatchTransfer>& transfers,
+                                                           size_t threads) const {
+    std::vector<Data> hashes(transfers.size());
+    forEachPreHash(firstNonce, transfers, threads, [&](size_t begin, size_t end, const auto& digests) {
+        for (auto i = begin; i < end; ++i) {
+            hashes[i] = Data(digests[i - begin].begin(), digests[i - begin].end());
+        }
+    });
+    return hashes;
+}
+
+template <typename Transaction>
+std::vector<BatchSignedTransaction> TransactionBatch<Transaction>::sign(const PrivateKey& privateKey,
+                                                                        const uint256_t& firstNonce,
+                                                                        const std::vector<BatchTransfer>& transfers,
+                                                                        size_t threads) const {
+    std::vector<BatchSignedTransaction> signedTransactions(transfers.size());
+    forEachPreHash(firstNonce, transfers, threads, [&](size_t begin, size_t end, const auto& digests) {
+        for (auto i = begin; i < end; ++i) {
+            const auto hash = Data(digests[i - begin].begin(), digests[i - begin].end());
+            auto& signedTransaction = signedTransactions[i];
+            signedTransaction.signature = Signer::sign(privateKey, hash, replayProtection, chainID);
+            write(firstNonce + i, transfers[i], &signedTransaction.signature, signedTransaction.encoded);
+        }
+    });
+    return signedTransactions;
+}
+
+template class TW::Ethereum::TransactionBatch<TransactionNonTyped>;
+template class TW::Ethereum::TransactionBatch<TransactionEip1559>;
@@ -0,0 +1,92 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include "Transaction.h"
+#include "../Data.h"
+#include "../PrivateKey.h"
+#include "../uint256.h"
+
+#include <vector>
+
+namespace TW::Ethereum {
+
+/// Fields which vary between the transactions of a batch.
+struct BatchTransfer {
+    // Public key hash (Address.bytes)
+    Data to;
+    uint256_t amount;
+};
+
+/// A signed transaction of a batch.
+struct BatchSignedTransaction {
+    Signature signature;
+    Data encoded;
+};
+
+/// Builds and signs runs of transactions from one sender which differ only in nonce, recipient and amount.
+/// `Transaction` is TransactionNonTyped or TransactionEip1559.  The shared fields (chain ID, fees, gas limit, payload,
+/// access list) are RLP encoded once, from a template transaction; each transaction then only encodes its nonce,
+/// recipient and amount.  Pre-hashes, signatures and encoded transactions are the same as from
+/// Transaction::preHash, Signer::sign and Transaction::encoded.
+///
+/// Thread safe.
+template <typename Transaction>
+class TransactionBatch {
+  public:
+    /// Takes the shared fields from `transaction`; its nonce, recipient and amount are not used.
+    TransactionBatch(const Transaction& transaction, const uint256_t& chainID);
+
+    /// Pre-sign hash of one transaction.
+    Data preHash(const uint256_t& nonce, const BatchTransfer& transfer) const;
+
+    /// Encoded signed transaction.
+    Data encoded(const uint256_t& nonce, const BatchTransfer& transfer, const Signature& signature) const;
+
+    /// Pre-hashes of transfers with consecutive nonces starting at `firstNonce`, in order, computed on the given
+    /// number of threads (0 to use all cores).
+    std::vector<Data> preHashes(const uint256_t& firstNonce, const std::vector<BatchTransfer>& transfers,
+                                size_t threads = 0) const;
+
+    /// Signs transfers with consecutive nonces starting at `firstNonce`, on the given number of threads (0 to use
+    /// all cores).  Returns the signed transactions in order.
+    std::vector<BatchSignedTransaction> sign(const PrivateKey& privateKey, const uint256_t& firstNonce,
+                                             const std::vector<BatchTransfer>& transfers, size_t threads = 0) const;
+
+  private:
+    /// Appends the encoded transaction, with its signature, or else with the fields which replace it in the
+    /// pre-hash.
+    void write(const uint256_t& nonce, const BatchTransfer& transfer, const Signature* signature, Data& out) const;
+
+    /// Calls f(begin, end, digests) concurrently for chunks of the transfers, with the pre-hashes of the chunk.
+    template <typename F>
+    void forEachPreHash(const uint256_t& firstNonce, const std::vector<BatchTransfer>& transfers, size_t threads,
+                        F&& f) const;
+
+    uint256_t chainID;
+    bool replayProtection;
+    /// Transaction type byte of typed transactions.
+    Data envelope;
+    /// Encoded fields before the nonce.
+    Data head;
+    /// Encoded fields between the nonce and the recipient.
+    Data fees;
+    /// Encoded fields after the amount.
+    Data tail;
+    /// Encoded fields after the tail in the pre-hash, in place of the signature.
+    Data preHashTail;
+};
+
+template <>
+TransactionBatch<TransactionNonTyped>::TransactionBatch(const TransactionNonTyped& transaction, const uint256_t& chainID);
+template <>
+TransactionBatch<TransactionEip1559>::TransactionBatch(const TransactionEip1559& transaction, const uint256_t& chainID);
+
+extern template class TransactionBatch<TransactionNonTyped>;
+extern template class TransactionBatch<TransactionEip1559>;
+
+} // namespace TW::Ethereum
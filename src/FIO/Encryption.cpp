@@ -90,14 +90,17 @@ Data Encryption::checkDecrypt(const Data& secret, const Data& message) {
 Data Encryption::getSharedSecret(const PrivateKey& privateKey1, const PublicKey& publicKey2) {
     // See https://github.com/fioprotocol/fiojs/blob/master/src/ecc/key_private.js
     
-    curve_point KBP;
-	assert(ecdsa_read_pubkey(&secp256k1, publicKey2.bytes.data(), &KBP));
-
     bignum256 privBN;
     bn_read_be(privateKey1.bytes.data(), &privBN);
     
     curve_point P;
-    point_multiply(&secp256k1, &privBN, &KBP, &P);
+    if (const auto& prepared = publicKey2.prepared(); prepared && prepared->curve == &secp256k1) {
+        point_multiply_prepared(prepared.get(), &privBN, &P);
+    } else {
+        curve_point KBP;
+        assert(ecdsa_read_pubkey(&secp256k1, publicKey2.bytes.data(), &KBP));
+        point_multiply(&secp256k1, &privBN, &KBP, &P);
+    }
 
     Data S(32);
     bn_write_be(&P.x, S.data());
@@ -0,0 +1,62 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "HDNodeCache.h"
+
+#include <TrezorCrypto/memzero.h>
+
+using namespace TW;
+
+HDNodeCache::~HDNodeCache() {
+    clear();
+}
+
+bool HDNodeCache::get(TWCurve curve, const std::vector<uint32_t>& path, HDNode& node) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = index.find(Key(curve, path));
+    if (it == index.end()) {
+        return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    node = it->second->second;
+    return true;
+}
+
+void HDNodeCache::put(TWCurve curve, const std::vector<uint32_t>& path, const HDNode& node) {
+    if (capacity == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = Key(curve, path);
+    const auto it = index.find(key);
+    if (it != index.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    if (entries.size() >= capacity) {
+        evict(std::prev(entries.end()));
+    }
+    entries.emplace_front(std::move(key), node);
+    index.emplace(entries.front().first, entries.begin());
+}
+
+void HDNodeCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!entries.empty()) {
+        evict(entries.begin());
+    }
+}
+
+size_t HDNodeCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+void HDNodeCache::evict(std::list<Entry>::iterator entry) {
+    index.erase(entry->first);
+    memzero(&entry->second, sizeof(HDNode));
+    entries.erase(entry);
+}
@@ -0,0 +1,58 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include <TrustWalletCore/TWCurve.h>
+#include <TrezorCrypto/bip32.h>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace TW {
+
+/// Cache of intermediate HD derivation nodes, by curve and derivation path prefix, least recently used evicted first.
+/// Holds private key material: nodes are zeroed on eviction and destruction.  Thread safe.
+class HDNodeCache {
+  public:
+    static constexpr size_t defaultCapacity = 64;
+
+    explicit HDNodeCache(size_t capacity = defaultCapacity) : capacity(capacity) {}
+    ~HDNodeCache();
+
+    HDNodeCache(const HDNodeCache&) = delete;
+    HDNodeCache& operator=(const HDNodeCache&) = delete;
+
+    /// Looks up the node of a path; returns whether it was found.
+    bool get(TWCurve curve, const std::vector<uint32_t>& path, HDNode& node);
+
+    /// Stores the node of a path, evicting the least recently used one if full.
+    void put(TWCurve curve, const std::vector<uint32_t>& path, const HDNode& node);
+
+    /// Removes (and zeroes) all nodes.
+    void clear();
+
+    /// Number of cached nodes.
+    size_t size() const;
+
+  private:
+    using Key = std::pair<TWCurve, std::vector<uint32_t>>;
+    using Entry = std::pair<Key, HDNode>;
+
+    const size_t capacity;
+    mutable std::mutex mutex;
+    /// Most recently used first
+    std::list<Entry> entries;
+    std::map<Key, std::list<Entry>::iterator> index;
+
+    void evict(std::list<Entry>::iterator entry);
+};
+
+} // namespace TW
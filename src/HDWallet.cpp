@@ -11,7 +11,9 @@
 #include "Bitcoin/SegwitAddress.h"
 #include "Bitcoin/CashAddress.h"
 #include "Coin.h"
+#include "HDNodeCache.h"
 #include "Mnemonic.h"
+#include "Parallel.h"
 
 #include <TrustWalletCore/TWHRP.h>
 #include <TrustWalletCore/TWPublicKeyType.h>
@@ -19,18 +21,24 @@
 #include <TrezorCrypto/bip32.h>
 #include <TrezorCrypto/bip39.h>
 #include <TrezorCrypto/curves.h>
+#include <TrezorCrypto/memzero.h>
 
 #include <array>
+#include <utility>
 
 using namespace TW;
 
 namespace {
 
-uint32_t fingerprint(HDNode *node, Hash::Hasher hasher);
-std::string serialize(const HDNode *node, uint32_t fingerprint, uint32_t version, bool use_public, Hash::Hasher hasher);
-bool deserialize(const std::string& extended, TWCurve curve, Hash::Hasher hasher, HDNode *node);
-HDNode getNode(const HDWallet& wallet, TWCurve curve, const DerivationPath& derivationPath);
+uint32_t fingerprint(HDNode *node, Hash::HasherType hasher);
+std::string serialize(const HDNode *node, uint32_t fingerprint, uint32_t version, bool use_public, Hash::HasherType hasher);
+bool deserialize(const std::string& extended, TWCurve curve, Hash::HasherType hasher, HDNode *node);
+HDNode getNode(const HDWallet& wallet, HDNodeCache& cache, TWCurve curve, const DerivationPath& derivationPath);
 HDNode getMasterNode(const HDWallet& wallet, TWCurve curve);
+PrivateKey privateKeyFromNode(const HDNode& node, HDWallet::PrivateKeyType privateKeyType);
+std::optional<PublicKey> publicKeyFromNode(const HDNode& node, TWCurve curve, TWPublicKeyType keyType);
+void checkIndexRange(uint32_t startIndex, uint32_t count);
+bool isHardenedOnly(TWCurve curve);
 
 const char* curveName(TWCurve curve);
 } // namespace
@@ -69,6 +77,21 @@ HDWallet::HDWallet(const Data& entropy, const std::string& passphrase)
     updateSeedAndEntropy();
 }
 
+HDWallet::HDWallet(HDWallet&& other)
+    : seed(other.seed), mnemonic(std::move(other.mnemonic)), passphrase(std::move(other.passphrase)),
+      entropy(std::move(other.entropy)), nodeCache(std::exchange(other.nodeCache, std::make_shared<HDNodeCache>())) {}
+
+HDWallet& HDWallet::operator=(HDWallet&& other) {
+    if (this != &other) {
+        seed = other.seed;
+        mnemonic = std::move(other.mnemonic);
+        passphrase = std::move(other.passphrase);
+        entropy = std::move(other.entropy);
+        nodeCache = std::exchange(other.nodeCache, std::make_shared<HDNodeCache>());
+    }
+    return *this;
+}
+
 HDWallet::~HDWallet() {
     std::fill(seed.begin(), seed.end(), 0);
     std::fill(mnemonic.begin(), mnemonic.end(), 0);
@@ -85,39 +108,27 @@ void HDWallet::updateSeedAndEntropy() {
     auto entropyBytes = mnemonic_to_bits(mnemonic.c_str(), entropyRaw.data()) / 8;
     // copy to truncate
     entropy = data(entropyRaw.data(), entropyBytes);
+
+    // nodes of the previous seed are not valid anymore
+    nodeCache = std::make_shared<HDNodeCache>();
 }
 
 PrivateKey HDWallet::getMasterKey(TWCurve curve) const {
-    auto node = getMasterNode(*this, curve);
+    auto node = getNode(*this, *nodeCache, curve, DerivationPath());
     auto data = Data(node.private_key, node.private_key + PrivateKey::size);
     return PrivateKey(data);
 }
 
 PrivateKey HDWallet::getMasterKeyExtension(TWCurve curve) const {
-    auto node = getMasterNode(*this, curve);
+    auto node = getNode(*this, *nodeCache, curve, DerivationPath());
     auto data = Data(node.private_key_extension, node.private_key_extension + PrivateKey::size);
     return PrivateKey(data);
 }
 
 PrivateKey HDWallet::getKey(TWCoinType coin, const DerivationPath& derivationPath) const {
     const auto curve = TWCoinTypeCurve(coin);
-    const auto privateKeyType = getPrivateKeyType(curve);
-    auto node = getNode(*this, curve, derivationPath);
-    switch (privateKeyType) {
-        case PrivateKeyTypeExtended96:
-            {
-                auto pkData = Data(node.private_key, node.private_key + PrivateKey::size);
-                auto extData = Data(node.private_key_extension, node.private_key_extension + PrivateKey::size);
-                auto chainCode = Data(node.chain_code, node.chain_code + PrivateKey::size);
-                return PrivateKey(pkData, extData, chainCode);
-            }
-
-        case PrivateKeyTypeDefault32:
-        default:
-            // default path
-            auto data = Data(node.private_key, node.private_key + PrivateKey::size);
-            return PrivateKey(data);
-    }
+    auto node = getNode(*this, *nodeCache, curve, derivationPath);
+    return privateKeyFromNode(node, getPrivateKeyType(curve));
 }
 
 std::string HDWallet::deriveAddress(TWCoinType coin) const {
@@ -125,6 +136,53 @@ std::string HDWallet::deriveAddress(TWCoinType coin) const {
     return TW::deriveAddress(coin, getKey(coin, derivationPath));
 }
 
+std::vector<std::string> HDWallet::deriveAddresses(TWCoinType coin, uint32_t account, uint32_t change, uint32_t startIndex, uint32_t count, size_t threads) const {
+    checkIndexRange(startIndex, count);
+    const auto curve = TWCoinTypeCurve(coin);
+    const auto privateKeyType = getPrivateKeyType(curve);
+    auto derivationPath = DerivationPath(TW::purpose(coin), TW::slip44Id(coin), account, change, startIndex);
+    if (isHardenedOnly(curve)) {
+        derivationPath.indices[3].hardened = true;
+        derivationPath.indices[4].hardened = true;
+    }
+    const auto hardened = derivationPath.indices.back().hardened;
+    derivationPath.indices.pop_back();
+    auto parent = getNode(*this, *nodeCache, curve, derivationPath);
+    if (privateKeyType == PrivateKeyTypeDefault32 && parent.curve->params != nullptr) {
+        hdnode_fill_public_key(&parent);
+    }
+
+    const auto keyType = TW::publicKeyType(coin);
+    std::vector<std::string> addresses(count);
+    parallelFor(count, threads, [&](size_t begin, size_t end) {
+        // public keys of the chunk first, then all addresses at once
+        std::vector<PublicKey> publicKeys;
+        std::vector<size_t> indices;
+        for (auto i = begin; i < end; ++i) {
+            auto node = parent;
+            const auto index = DerivationPathIndex(startIndex + static_cast<uint32_t>(i), hardened).derivationIndex();
+            const auto derived = privateKeyType == PrivateKeyTypeExtended96
+                ? hdnode_private_ckd_cardano(&node, index)
+                : hdnode_private_ckd(&node, index);
+            try {
+                if (derived) {
+                    publicKeys.push_back(privateKeyFromNode(node, privateKeyType).getPublicKey(keyType));
+                    indices.push_back(i);
+                }
+            } catch (...) {
+                // left empty
+            }
+            memzero(&node, sizeof(node));
+        }
+        auto derived = TW::deriveAddresses(coin, publicKeys);
+        for (size_t j = 0; j < indices.size(); ++j) {
+            addresses[indices[j]] = std::move(derived[j]);
+        }
+    });
+    memzero(&parent, sizeof(parent));
+    return addresses;
+}
+
 std::string HDWallet::getExtendedPrivateKey(TWPurpose purpose, TWCoinType coin, TWHDVersion version) const {
     if (version == TWHDVersionNone) {
         return "";
@@ -132,10 +190,10 @@ std::string HDWallet::getExtendedPrivateKey(TWPurpose purpose, TWCoinType coin,
     
     const auto curve = TWCoinTypeCurve(coin);
     auto derivationPath = TW::DerivationPath({DerivationPathIndex(purpose, true), DerivationPathIndex(coin, true)});
-    auto node = getNode(*this, curve, derivationPath);
-    auto fingerprintValue = fingerprint(&node, publicKeyHasher(coin));
+    auto node = getNode(*this, *nodeCache, curve, derivationPath);
+    auto fingerprintValue = fingerprint(&node, publicKeyHasherType(coin));
     hdnode_private_ckd(&node, 0x80000000);
-    return serialize(&node, fingerprintValue, version, false, base58Hasher(coin));
+    return serialize(&node, fingerprintValue, version, false, base58HasherType(coin));
 }
 
 std::string HDWallet::getExtendedPublicKey(TWPurpose purpose, TWCoinType coin, TWHDVersion version) const {
@@ -145,16 +203,16 @@ std::string HDWallet::getExtendedPublicKey(TWPurpose purpose, TWCoinType coin, T
     
     const auto curve = TWCoinTypeCurve(coin);
     auto derivationPath = TW::DerivationPath({DerivationPathIndex(purpose, true), DerivationPathIndex(coin, true)});
-    auto node = getNode(*this, curve, derivationPath);
-    auto fingerprintValue = fingerprint(&node, publicKeyHasher(coin));
+    auto node = getNode(*this, *nodeCache, curve, derivationPath);
+    auto fingerprintValue = fingerprint(&node, publicKeyHasherType(coin));
     hdnode_private_ckd(&node, 0x80000000);
     hdnode_fill_public_key(&node);
-    return serialize(&node, fingerprintValue, version, true, base58Hasher(coin));
+    return serialize(&node, fingerprintValue, version, true, base58HasherType(coin));
 }
 
 std::optional<PublicKey> HDWallet::getPublicKeyFromExtended(const std::string& extended, TWCoinType coin, const DerivationPath& path) {
     const auto curve = TW::curve(coin);
-    const auto hasher = TW::base58Hasher(coin);
+    const auto hasher = TW::base58HasherType(coin);
 
     auto node = HDNode{};
     if (!deserialize(extended, curve, hasher, &node)) {
@@ -166,31 +224,54 @@ std::optional<PublicKey> HDWallet::getPublicKeyFromExtended(const std::string& e
     hdnode_public_ckd(&node, path.change());
     hdnode_public_ckd(&node, path.address());
     hdnode_fill_public_key(&node);
+    return publicKeyFromNode(node, curve, TW::publicKeyType(coin));
+}
 
-    // These public key type are not applicable.  Handled above, as node.curve->params is null
-    assert(curve != TWCurveED25519 && curve != TWCurveED25519Blake2bNano && curve != TWCurveED25519Extended && curve != TWCurveCurve25519);
-    TWPublicKeyType keyType = TW::publicKeyType(coin);
-    if (curve == TWCurveSECP256k1) {
-        auto pubkey = PublicKey(Data(node.public_key, node.public_key + 33), TWPublicKeyTypeSECP256k1);
-        if (keyType == TWPublicKeyTypeSECP256k1Extended) {
-            return pubkey.extended();
-        } else {
-            return pubkey;
+std::optional<std::vector<std::string>> HDWallet::deriveAddressesFromExtended(const std::string& extended, TWCoinType coin, uint32_t change, uint32_t startIndex, uint32_t count, size_t threads) {
+    checkIndexRange(startIndex, count);
+    const auto curve = TW::curve(coin);
+    const auto hasher = TW::base58HasherType(coin);
+    const auto keyType = TW::publicKeyType(coin);
+
+    auto parent = HDNode{};
+    if (!deserialize(extended, curve, hasher, &parent)) {
+        return {};
+    }
+    if (parent.curve->params == nullptr) {
+        return {};
+    }
+    if (!hdnode_public_ckd(&parent, change)) {
+        return {};
+    }
+
+    std::vector<std::string> addresses(count);
+    parallelFor(count, threads, [&](size_t begin, size_t end) {
+        // public keys of the chunk first, then all addresses at once
+        std::vector<PublicKey> publicKeys;
+        std::vector<size_t> indices;
+        for (auto i = begin; i < end; ++i) {
+            auto node = parent;
+            if (!hdnode_public_ckd(&node, startIndex + static_cast<uint32_t>(i))) {
+                continue;
+            }
+            hdnode_fill_public_key(&node);
+            auto publicKey = publicKeyFromNode(node, curve, keyType);
+            if (publicKey) {
+                publicKeys.push_back(std::move(*publicKey));
+                indices.push_back(i);
+            }
         }
-    } else if (curve == TWCurveNIST256p1) {
-        auto pubkey = PublicKey(Data(node.public_key, node.public_key + 33), TWPublicKeyTypeNIST256p1);
-        if (keyType == TWPublicKeyTypeNIST256p1Extended) {
-            return pubkey.extended();
-        } else {
-            return pubkey;
+        auto derived = TW::deriveAddresses(coin, publicKeys);
+        for (size_t j = 0; j < indices.size(); ++j) {
+            addresses[indices[j]] = std::move(derived[j]);
         }
-    }
-    return {};
+    });
+    return addresses;
 }
 
 std::optional<PrivateKey> HDWallet::getPrivateKeyFromExtended(const std::string& extended, TWCoinType coin, const DerivationPath& path) {
     const auto curve = TW::curve(coin);
-    const auto hasher = TW::base58Hasher(coin);
+    const auto hasher = TW::base58HasherType(coin);
 
     auto node = HDNode{};
     if (!deserialize(extended, curve, hasher, &node)) {
@@ -215,13 +296,14 @@ HDWallet::PrivateKeyType HDWallet::getPrivateKeyType(TWCurve curve) {
 
 namespace {
 
-uint32_t fingerprint(HDNode *node, Hash::Hasher hasher) {
+uint32_t fingerprint(HDNode *node, Hash::HasherType hasher) {
     hdnode_fill_public_key(node);
-    auto digest = hasher(node->public_key, 33);
+    std::array<byte, Hash::maxDigestSize> digest;
+    Hash::hash(hasher, node->public_key, 33, digest.data());
     return ((uint32_t) digest[0] << 24) + (digest[1] << 16) + (digest[2] << 8) + digest[3];
 }
 
-std::string serialize(const HDNode *node, uint32_t fingerprint, uint32_t version, bool use_public, Hash::Hasher hasher) {
+std::string serialize(const HDNode *node, uint32_t fingerprint, uint32_t version, bool use_public, Hash::HasherType hasher) {
     Data node_data;
     node_data.reserve(78);
 
@@ -240,7 +322,7 @@ std::string serialize(const HDNode *node, uint32_t fingerprint, uint32_t version
     return Base58::bitcoin.encodeCheck(node_data, hasher);
 }
 
-bool deserialize(const std::string& extended, TWCurve curve, Hash::Hasher hasher, HDNode* node) {
+bool deserialize(const std::string& extended, TWCurve curve, Hash::HasherType hasher, HDNode* node) {
     memset(node, 0, sizeof(HDNode));
     const char* curveNameStr = curveName(curve);
     if (curveNameStr == nullptr || ::strlen(curveNameStr) == 0) {
@@ -271,24 +353,108 @@ bool deserialize(const std::string& extended, TWCurve curve, Hash::Hasher hasher
     return true;
 }
 
-HDNode getNode(const HDWallet& wallet, TWCurve curve, const DerivationPath& derivationPath) {
+HDNode getNode(const HDWallet& wallet, HDNodeCache& cache, TWCurve curve, const DerivationPath& derivationPath) {
     const auto privateKeyType = HDWallet::getPrivateKeyType(curve);
-    auto node = getMasterNode(wallet, curve);
+    std::vector<uint32_t> path;
+    path.reserve(derivationPath.indices.size());
     for (auto& index : derivationPath.indices) {
+        path.push_back(index.derivationIndex());
+    }
+
+    // Start from the longest cached prefix of the parent path, or from the master node
+    auto node = HDNode();
+    auto prefix = std::vector<uint32_t>(path.begin(), path.end() - (path.empty() ? 0 : 1));
+    while (!cache.get(curve, prefix, node)) {
+        if (prefix.empty()) {
+            node = getMasterNode(wallet, curve);
+            cache.put(curve, prefix, node);
+            break;
+        }
+        prefix.pop_back();
+    }
+
+    // Derive the remaining steps, caching all nodes but the last one
+    for (auto i = prefix.size(); i < path.size(); ++i) {
         switch (privateKeyType) {
             case HDWallet::PrivateKeyTypeExtended96:
                 // special handling for extended
-                hdnode_private_ckd_cardano(&node, index.derivationIndex());
+                hdnode_private_ckd_cardano(&node, path[i]);
                 break;
             case HDWallet::PrivateKeyTypeDefault32:
             default:
-                hdnode_private_ckd(&node, index.derivationIndex());
+                hdnode_private_ckd(&node, path[i]);
                 break;
         }
+        if (i + 1 < path.size()) {
+            if (privateKeyType == HDWallet::PrivateKeyTypeDefault32 && (path[i + 1] & 0x80000000) == 0 && node.curve->params != nullptr) {
+                // needed by every non-hardened child derivation, computed once for the cached node
+                hdnode_fill_public_key(&node);
+            }
+            prefix.push_back(path[i]);
+            cache.put(curve, prefix, node);
+        }
     }
     return node;
 }
 
+PrivateKey privateKeyFromNode(const HDNode& node, HDWallet::PrivateKeyType privateKeyType) {
+    switch (privateKeyType) {
+        case HDWallet::PrivateKeyTypeExtended96:
+            {
+                auto pkData = Data(node.private_key, node.private_key + PrivateKey::size);
+                auto extData = Data(node.private_key_extension, node.private_key_extension + PrivateKey::size);
+                auto chainCode = Data(node.chain_code, node.chain_code + PrivateKey::size);
+                return PrivateKey(pkData, extData, chainCode);
+            }
+
+        case HDWallet::PrivateKeyTypeDefault32:
+        default:
+            // default path
+            auto data = Data(node.private_key, node.private_key + PrivateKey::size);
+            return PrivateKey(data);
+    }
+}
+
+std::optional<PublicKey> publicKeyFromNode(const HDNode& node, TWCurve curve, TWPublicKeyType keyType) {
+    // These public key type are not applicable.  Handled by callers, as node.curve->params is null
+    assert(curve != TWCurveED25519 && curve != TWCurveED25519Blake2bNano && curve != TWCurveED25519Extended && curve != TWCurveCurve25519);
+    if (curve == TWCurveSECP256k1) {
+        auto pubkey = PublicKey(Data(node.public_key, node.public_key + 33), TWPublicKeyTypeSECP256k1);
+        if (keyType == TWPublicKeyTypeSECP256k1Extended) {
+            return pubkey.extended();
+        } else {
+            return pubkey;
+        }
+    } else if (curve == TWCurveNIST256p1) {
+        auto pubkey = PublicKey(Data(node.public_key, node.public_key + 33), TWPublicKeyTypeNIST256p1);
+        if (keyType == TWPublicKeyTypeNIST256p1Extended) {
+            return pubkey.extended();
+        } else {
+            return pubkey;
+        }
+    }
+    return {};
+}
+
+void checkIndexRange(uint32_t startIndex, uint32_t count) {
+    // non-hardened indices only
+    if (startIndex >= 0x80000000 || count > 0x80000000 - startIndex) {
+        throw std::invalid_argument("Invalid address index range");
+    }
+}
+
+bool isHardenedOnly(TWCurve curve) {
+    // ed25519 keys other than Cardano ones have no public (non-hardened) derivation
+    switch (curve) {
+    case TWCurveED25519:
+    case TWCurveED25519Blake2bNano:
+    case TWCurveCurve25519:
+        return true;
+    default:
+        return false;
+    }
+}
+
 HDNode getMasterNode(const HDWallet& wallet, TWCurve curve) {
     const auto privateKeyType = HDWallet::getPrivateKeyType(curve);
     auto node = HDNode();
@@ -18,11 +18,15 @@
 #include <TrustWalletCore/TWPurpose.h>
 
 #include <array>
+#include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace TW {
 
+class HDNodeCache;
+
 class HDWallet {
   public:
     static constexpr size_t seedSize = 64;
@@ -42,6 +46,10 @@ class HDWallet {
     /// Entropy is the binary 1-to-1 representation of the mnemonic (11 bits from each word)
     TW::Data entropy;
 
+    /// Intermediate derivation nodes, so keys sharing a path prefix (e.g. addresses of one account) derive only the
+    /// remaining steps.  Shared by copies, which have the same seed.
+    std::shared_ptr<HDNodeCache> nodeCache;
+
   public:
     const std::array<byte, seedSize>& getSeed() const { return seed; }
     const std::string& getMnemonic() const { return mnemonic; }
@@ -62,9 +70,10 @@ class HDWallet {
     HDWallet(const Data& entropy, const std::string& passphrase);
 
     HDWallet(const HDWallet& other) = default;
-    HDWallet(HDWallet&& other) = default;
+    /// Moves leave `other` with an empty cache, so that it stays usable.
+    HDWallet(HDWallet&& other);
     HDWallet& operator=(const HDWallet& other) = default;
-    HDWallet& operator=(HDWallet&& other) = default;
+    HDWallet& operator=(HDWallet&& other);
 
     virtual ~HDWallet();
 
@@ -80,6 +89,12 @@ class HDWallet {
     /// Derives the address for a coin.
     std::string deriveAddress(TWCoinType coin) const;
 
+    /// Derives the addresses of a range of address indices, on the BIP44 path of the coin with the given account and change.
+    /// The parent node is derived once, the addresses on the given number of threads (0 for all cores).
+    /// For ed25519, ed25519-blake2b-nano and curve25519 coins, which only have hardened derivation, change and address
+    /// indices are hardened.  An address which cannot be derived is empty.  Throws on an invalid index range.
+    std::vector<std::string> deriveAddresses(TWCoinType coin, uint32_t account, uint32_t change, uint32_t startIndex, uint32_t count, size_t threads = 1) const;
+
     /// Returns the extended private key.
     std::string getExtendedPrivateKey(TWPurpose purpose, TWCoinType coin, TWHDVersion version) const;
 
@@ -89,6 +104,10 @@ class HDWallet {
     /// Computes the public key from an exteded public key representation.
     static std::optional<PublicKey> getPublicKeyFromExtended(const std::string& extended, TWCoinType coin, const DerivationPath& path);
 
+    /// Derives the addresses of a range of address indices from an extended (account) public key, as deriveAddresses().
+    /// Returns nothing if the extended key is invalid or the change node cannot be derived.  Throws on an invalid index range.
+    static std::optional<std::vector<std::string>> deriveAddressesFromExtended(const std::string& extended, TWCoinType coin, uint32_t change, uint32_t startIndex, uint32_t count, size_t threads = 1);
+
     /// Computes the private key from an exteded private key representation.
     static std::optional<PrivateKey> getPrivateKeyFromExtended(const std::string& extended, TWCoinType coin, const DerivationPath& path);
 
@@ -16,10 +16,88 @@
 #include <TrezorCrypto/sha3.h>
 #include <TrezorCrypto/hmac.h>
 
+#include <algorithm>
 #include <string>
 
 using namespace TW;
 
+void Hash::hash(HasherType type, const byte* data, size_t size, byte* digest) {
+    // intermediate hash of the composites
+    Digest<sha512Size> inner;
+    GROESTL512_CTX ctx;
+    switch (type) {
+    case HasherType::sha1:
+        sha1_Raw(data, size, digest);
+        break;
+    case HasherType::sha256:
+        sha256_Raw(data, size, digest);
+        break;
+    case HasherType::sha512:
+        sha512_Raw(data, size, digest);
+        break;
+    case HasherType::sha512_256:
+        sha512_256_Raw(data, size, digest);
+        break;
+    case HasherType::keccak256:
+        keccak_256(data, size, digest);
+        break;
+    case HasherType::keccak512:
+        keccak_512(data, size, digest);
+        break;
+    case HasherType::sha3_256:
+        ::sha3_256(data, size, digest);
+        break;
+    case HasherType::sha3_512:
+        ::sha3_512(data, size, digest);
+        break;
+    case HasherType::ripemd:
+        ::ripemd160(data, static_cast<uint32_t>(size), digest);
+        break;
+    case HasherType::blake256:
+        ::blake256(data, size, digest);
+        break;
+    case HasherType::groestl512:
+        groestl512_Init(&ctx);
+        groestl512_Update(&ctx, data, size);
+        groestl512_Final(&ctx, digest);
+        break;
+    case HasherType::sha256d:
+        sha256_Raw(data, size, inner.data());
+        sha256_Raw(inner.data(), sha256Size, digest);
+        break;
+    case HasherType::sha256ripemd:
+        sha256_Raw(data, size, inner.data());
+        ::ripemd160(inner.data(), sha256Size, digest);
+        break;
+    case HasherType::sha3_256ripemd:
+        ::sha3_256(data, size, inner.data());
+        ::ripemd160(inner.data(), sha256Size, digest);
+        break;
+    case HasherType::blake256d:
+        ::blake256(data, size, inner.data());
+        ::blake256(inner.data(), sha256Size, digest);
+        break;
+    case HasherType::blake256ripemd:
+        ::blake256(data, size, inner.data());
+        ::ripemd160(inner.data(), sha256Size, digest);
+        break;
+    case HasherType::groestl512d:
+        groestl512_Init(&ctx);
+        groestl512_Update(&ctx, data, size);
+        groestl512_Final(&ctx, inner.data());
+        groestl512_Init(&ctx);
+        groestl512_Update(&ctx, inner.data(), sha512Size);
+        groestl512_Final(&ctx, digest);
+        break;
+    }
+}
+
+Data Hash::hash(HasherType type, const byte* data, size_t size) {
+    Data result(digestSize(type));
+    hash(type, data, size, result.data());
+    return result;
+}
+
 Data Hash::sha1(const byte* data, size_t size) {
     Data result(sha1Size);
     sha1_Raw(data, size, result.data());
@@ -127,3 +205,36 @@ Data Hash::hmac256(const Data& key, const Data& message) {
     hmac_sha256(key.data(), static_cast<uint32_t>(key.size()), message.data(), static_cast<uint32_t>(message.size()), hmac.data());
     return hmac;
 }
+
+// The digests are written through C arrays of the same size
+static_assert(sizeof(Hash::Digest<Hash::sha256Size>) == SHA256_DIGEST_LENGTH, "unexpected std::array layout");
+static_assert(sizeof(Hash::Digest<Hash::ripemdSize>) == RIPEMD160_DIGEST_LENGTH, "unexpected std::array layout");
+
+void Hash::sha256Multi(const byte* const* data, const size_t* sizes, size_t count, Digest<sha256Size>* digests) {
+    sha256_Raw_multi(data, sizes, count, reinterpret_cast<byte(*)[SHA256_DIGEST_LENGTH]>(digests));
+}
+
+void Hash::keccak256Multi(const byte* const* data, const size_t* sizes, size_t count, Digest<sha256Size>* digests) {
+    keccak_256_multi(data, sizes, count, reinterpret_cast<byte(*)[SHA3_256_DIGEST_LENGTH]>(digests));
+}
+
+void Hash::ripemdMulti(const byte* const* data, const size_t* sizes, size_t count, Digest<ripemdSize>* digests) {
+    ::ripemd160_multi(data, sizes, count, reinterpret_cast<byte(*)[RIPEMD160_DIGEST_LENGTH]>(digests));
+}
+
+void Hash::sha256ripemdMulti(const byte* const* data, const size_t* sizes, size_t count, Digest<ripemdSize>* digests) {
+    // in chunks, to keep the intermediate hashes on the stack
+    constexpr size_t chunk = 32;
+    Digest<sha256Size> hashes[chunk];
+    const byte* hashData[chunk];
+    size_t hashSizes[chunk];
+    for (size_t i = 0; i < count; i += chunk) {
+        const auto n = std::min(chunk, count - i);
+        sha256Multi(data + i, sizes + i, n, hashes);
+        for (size_t j = 0; j < n; ++j) {
+            hashData[j] = hashes[j].data();
+            hashSizes[j] = sha256Size;
+        }
+        ripemdMulti(hashData, hashSizes, n, digests + i);
+    }
+}
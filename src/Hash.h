@@ -8,7 +8,9 @@
 
 #include "Data.h"
 
+#include <array>
 #include <functional>
+#include <vector>
 
 namespace TW::Hash {
 
@@ -29,6 +31,76 @@ static const size_t sha512Size = 64;
 /// Number of bytes in a RIPEMD160 hash.
 static const size_t ripemdSize = 20;
 
+/// Fixed size digest.
+template <size_t N>
+using Digest = std::array<byte, N>;
+
+/// Hash functions which can be selected by value, at compile time or from data such as CoinInfo, and computed into a
+/// fixed size digest without allocating.
+enum class HasherType {
+    sha1,
+    sha256,
+    sha512,
+    sha512_256,
+    keccak256,
+    keccak512,
+    sha3_256,
+    sha3_512,
+    ripemd,
+    blake256,
+    groestl512,
+    sha256d,
+    sha256ripemd,
+    sha3_256ripemd,
+    blake256d,
+    blake256ripemd,
+    groestl512d,
+};
+
+/// Number of bytes in the digest of a hash function.
+constexpr size_t digestSize(HasherType type) {
+    switch (type) {
+    case HasherType::sha1:
+        return sha1Size;
+    case HasherType::ripemd:
+    case HasherType::sha256ripemd:
+    case HasherType::sha3_256ripemd:
+    case HasherType::blake256ripemd:
+        return ripemdSize;
+    case HasherType::sha512:
+    case HasherType::keccak512:
+    case HasherType::sha3_512:
+    case HasherType::groestl512:
+    case HasherType::groestl512d:
+        return sha512Size;
+    default:
+        return sha256Size;
+    }
+}
+
+/// Number of bytes in the largest digest of a HasherType.
+static const size_t maxDigestSize = sha512Size;
+
+/// Computes a hash into `digest`, which must have room for digestSize(type) bytes.
+void hash(HasherType type, const byte* data, size_t size, byte* digest);
+
+/// Computes a hash.
+Data hash(HasherType type, const byte* data, size_t size);
+
+/// Computes a hash into a fixed size digest, for a hash function known at compile time.
+template <HasherType type>
+Digest<digestSize(type)> digest(const byte* data, size_t size) {
+    Digest<digestSize(type)> result;
+    hash(type, data, size, result.data());
+    return result;
+}
+
+/// Computes a hash into a fixed size digest, for a hash function known at compile time.
+template <HasherType type, typename T>
+Digest<digestSize(type)> digest(const T& data) {
+    return digest<type>(reinterpret_cast<const byte*>(data.data()), data.size());
+}
+
 /// Computes the SHA1 hash.
 Data sha1(const byte* data, size_t size);
 
@@ -93,6 +165,12 @@ Data hash(Hasher hasher, const T& data) {
     return hasher(reinterpret_cast<const byte*>(data.data()), data.size());
 }
 
+/// Computes requested hash for data.
+template <typename T>
+Data hash(HasherType type, const T& data) {
+    return hash(type, reinterpret_cast<const byte*>(data.data()), data.size());
+}
+
 /// Computes the SHA1 hash.
 template <typename T>
 Data sha1(const T& data) {
@@ -170,37 +248,106 @@ Data groestl512(const T& data) {
     return groestl512(reinterpret_cast<const byte*>(data.data()), data.size());
 }
 
+// Composite hashes, computed with a single allocation.
+
 /// Computes the SHA256 hash of the SHA256 hash.
 inline Data sha256d(const byte* data, size_t size) {
-    return sha256(sha256(data, size));
+    return hash(HasherType::sha256d, data, size);
 }
 
 /// Computes the ripemd hash of the SHA256 hash.
 inline Data sha256ripemd(const byte* data, size_t size) {
-    return ripemd(sha256(data, size));
+    return hash(HasherType::sha256ripemd, data, size);
 }
 
 /// Computes the ripemd hash of the SHA256 hash.
 inline Data sha3_256ripemd(const byte* data, size_t size) {
-    return ripemd(sha3_256(data, size));
+    return hash(HasherType::sha3_256ripemd, data, size);
 }
 
 /// Computes the Blake256 hash of the Blake256 hash.
 inline Data blake256d(const byte* data, size_t size) {
-    return blake256(blake256(data, size));
+    return hash(HasherType::blake256d, data, size);
 }
 
 /// Computes the ripemd hash of the Blake256 hash.
 inline Data blake256ripemd(const byte* data, size_t size) {
-    return ripemd(blake256(data, size));
+    return hash(HasherType::blake256ripemd, data, size);
 }
 
 /// Computes the Groestl512 hash of the Groestl512 hash.
 inline Data groestl512d(const byte* data, size_t size) {
-    return groestl512(groestl512(data, size));
+    return hash(HasherType::groestl512d, data, size);
+}
+
+/// Returns the function computing a hash, for APIs taking a Hasher.
+constexpr HasherSimpleType hasher(HasherType type) {
+    switch (type) {
+    case HasherType::sha1: return sha1;
+    case HasherType::sha256: return sha256;
+    case HasherType::sha512: return sha512;
+    case HasherType::sha512_256: return sha512_256;
+    case HasherType::keccak256: return keccak256;
+    case HasherType::keccak512: return keccak512;
+    case HasherType::sha3_256: return sha3_256;
+    case HasherType::sha3_512: return sha3_512;
+    case HasherType::ripemd: return ripemd;
+    case HasherType::blake256: return blake256;
+    case HasherType::groestl512: return groestl512;
+    case HasherType::sha256d: return sha256d;
+    case HasherType::sha256ripemd: return sha256ripemd;
+    case HasherType::sha3_256ripemd: return sha3_256ripemd;
+    case HasherType::blake256d: return blake256d;
+    case HasherType::blake256ripemd: return blake256ripemd;
+    case HasherType::groestl512d: return groestl512d;
+    }
+    return nullptr;
 }
 
 /// Compute the SHA256-based HMAC of a message
 Data hmac256(const Data& key, const Data& message);
 
+// Multi-buffer versions: hash several independent messages at once, one per SIMD lane, into caller-provided
+// fixed size digests.  Faster than hashing one by one for many short messages, such as public keys.
+
+/// Computes the SHA256 hashes of `count` messages: `digests[i]` is the hash of `sizes[i]` bytes at `data[i]`.
+void sha256Multi(const byte* const* data, const size_t* sizes, size_t count, Digest<sha256Size>* digests);
+
+/// Computes the Keccak SHA256 hashes of `count` messages, as sha256Multi.
+void keccak256Multi(const byte* const* data, const size_t* sizes, size_t count, Digest<sha256Size>* digests);
+
+/// Computes the RIPEMD160 hashes of `count` messages, as sha256Multi.
+void ripemdMulti(const byte* const* data, const size_t* sizes, size_t count, Digest<ripemdSize>* digests);
+
+/// Computes the ripemd hashes of the SHA256 hashes of `count` messages, as sha256Multi.
+void sha256ripemdMulti(const byte* const* data, const size_t* sizes, size_t count, Digest<ripemdSize>* digests);
+
+/// Computes the SHA256 hashes of several messages.
+template <typename T>
+std::vector<Digest<sha256Size>> sha256Multi(const std::vector<T>& messages) {
+    std::vector<const byte*> data;
+    std::vector<size_t> sizes;
+    for (const auto& message : messages) {
+        data.push_back(reinterpret_cast<const byte*>(message.data()));
+        sizes.push_back(message.size());
+    }
+    std::vector<Digest<sha256Size>> digests(messages.size());
+    sha256Multi(data.data(), sizes.data(), messages.size(), digests.data());
+    return digests;
+}
+
+/// Computes the Keccak SHA256 hashes of several messages.
+template <typename T>
+std::vector<Digest<sha256Size>> keccak256Multi(const std::vector<T>& messages) {
+    std::vector<const byte*> data;
+    std::vector<size_t> sizes;
+    for (const auto& message : messages) {
+        data.push_back(reinterpret_cast<const byte*>(message.data()));
+        sizes.push_back(message.size());
+    }
+    std::vector<Digest<sha256Size>> digests(messages.size());
+    keccak256Multi(data.data(), sizes.data(), messages.size(), digests.data());
+    return digests;
+}
+
 } // namespace TW::Hash
@@ -0,0 +1,263 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include "Hash.h"
+
+#include <TrezorCrypto/blake256.h>
+#include <TrezorCrypto/blake2b.h>
+#include <TrezorCrypto/groestl.h>
+#include <TrezorCrypto/memzero.h>
+#include <TrezorCrypto/ripemd160.h>
+#include <TrezorCrypto/sha2.h>
+#include <TrezorCrypto/sha3.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace TW::Hash {
+
+/// Incremental hashing: data is added with update() in any number of pieces, final() returns the digest.  Nothing is
+/// allocated; the state lives in the object.  `Impl` provides reset(), append() and finish().
+template <typename Impl, size_t N>
+class IncrementalHasher {
+  public:
+    /// Number of bytes in the digest.
+    static constexpr size_t digestLength = N;
+
+    /// Adds data to the hash.
+    Impl& update(const byte* data, size_t size) {
+        impl().append(data, size);
+        return impl();
+    }
+
+    /// Adds data to the hash.
+    template <typename T>
+    Impl& update(const T& data) {
+        return update(reinterpret_cast<const byte*>(data.data()), data.size());
+    }
+
+    /// Returns the digest of the data added since construction or the last final(), and starts over.
+    Digest<N> final() {
+        Digest<N> digest;
+        impl().finish(digest.data());
+        impl().reset();
+        return digest;
+    }
+
+    /// Computes the hash of data in one call, with a default constructed hasher.
+    static Digest<N> hash(const byte* data, size_t size) {
+        Impl hasher;
+        hasher.update(data, size);
+        return hasher.final();
+    }
+
+    /// Computes the hash of data in one call, with a default constructed hasher.
+    template <typename T>
+    static Digest<N> hash(const T& data) {
+        return hash(reinterpret_cast<const byte*>(data.data()), data.size());
+    }
+
+  private:
+    Impl& impl() { return static_cast<Impl&>(*this); }
+};
+
+/// Incremental SHA1.
+class Sha1 : public IncrementalHasher<Sha1, sha1Size> {
+  public:
+    Sha1() { reset(); }
+    ~Sha1() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Sha1, sha1Size>;
+    void reset() { sha1_Init(&context); }
+    void append(const byte* data, size_t size) { sha1_Update(&context, data, size); }
+    void finish(byte* digest) { sha1_Final(&context, digest); }
+    SHA1_CTX context;
+};
+
+/// Incremental SHA256.
+class Sha256 : public IncrementalHasher<Sha256, sha256Size> {
+  public:
+    Sha256() { reset(); }
+    ~Sha256() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Sha256, sha256Size>;
+    void reset() { sha256_Init(&context); }
+    void append(const byte* data, size_t size) { sha256_Update(&context, data, size); }
+    void finish(byte* digest) { sha256_Final(&context, digest); }
+    SHA256_CTX context;
+};
+
+/// Incremental SHA512.
+class Sha512 : public IncrementalHasher<Sha512, sha512Size> {
+  public:
+    Sha512() { reset(); }
+    ~Sha512() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Sha512, sha512Size>;
+    void reset() { sha512_Init(&context); }
+    void append(const byte* data, size_t size) { sha512_Update(&context, data, size); }
+    void finish(byte* digest) { sha512_Final(&context, digest); }
+    SHA512_CTX context;
+};
+
+/// Incremental SHA512/256.
+class Sha512_256 : public IncrementalHasher<Sha512_256, sha256Size> {
+  public:
+    Sha512_256() { reset(); }
+    ~Sha512_256() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Sha512_256, sha256Size>;
+    void reset() { sha512_256_Init(&context); }
+    void append(const byte* data, size_t size) { sha512_Update(&context, data, size); }
+    void finish(byte* digest) {
+        byte full[sha512Size];
+        sha512_Final(&context, full);
+        std::memcpy(digest, full, sha256Size);
+        memzero(full, sizeof(full));
+    }
+    SHA512_CTX context;
+};
+
+/// Incremental Keccak SHA256.
+class Keccak256 : public IncrementalHasher<Keccak256, sha256Size> {
+  public:
+    Keccak256() { reset(); }
+    ~Keccak256() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Keccak256, sha256Size>;
+    void reset() { keccak_256_Init(&context); }
+    void append(const byte* data, size_t size) { keccak_Update(&context, data, size); }
+    void finish(byte* digest) { keccak_Final(&context, digest); }
+    SHA3_CTX context;
+};
+
+/// Incremental Keccak SHA512.
+class Keccak512 : public IncrementalHasher<Keccak512, sha512Size> {
+  public:
+    Keccak512() { reset(); }
+    ~Keccak512() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Keccak512, sha512Size>;
+    void reset() { keccak_512_Init(&context); }
+    void append(const byte* data, size_t size) { keccak_Update(&context, data, size); }
+    void finish(byte* digest) { keccak_Final(&context, digest); }
+    SHA3_CTX context;
+};
+
+/// Incremental version 3 SHA256.
+class Sha3_256 : public IncrementalHasher<Sha3_256, sha256Size> {
+  public:
+    Sha3_256() { reset(); }
+    ~Sha3_256() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Sha3_256, sha256Size>;
+    void reset() { sha3_256_Init(&context); }
+    void append(const byte* data, size_t size) { sha3_Update(&context, data, size); }
+    void finish(byte* digest) { sha3_Final(&context, digest); }
+    SHA3_CTX context;
+};
+
+/// Incremental version 3 SHA512.
+class Sha3_512 : public IncrementalHasher<Sha3_512, sha512Size> {
+  public:
+    Sha3_512() { reset(); }
+    ~Sha3_512() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Sha3_512, sha512Size>;
+    void reset() { sha3_512_Init(&context); }
+    void append(const byte* data, size_t size) { sha3_Update(&context, data, size); }
+    void finish(byte* digest) { sha3_Final(&context, digest); }
+    SHA3_CTX context;
+};
+
+/// Incremental RIPEMD160.
+class Ripemd160 : public IncrementalHasher<Ripemd160, ripemdSize> {
+  public:
+    Ripemd160() { reset(); }
+    ~Ripemd160() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Ripemd160, ripemdSize>;
+    void reset() { ripemd160_Init(&context); }
+    void append(const byte* data, size_t size) { ripemd160_Update(&context, data, static_cast<uint32_t>(size)); }
+    void finish(byte* digest) { ripemd160_Final(&context, digest); }
+    RIPEMD160_CTX context;
+};
+
+/// Incremental Blake256.
+class Blake256 : public IncrementalHasher<Blake256, sha256Size> {
+  public:
+    Blake256() { reset(); }
+    ~Blake256() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Blake256, sha256Size>;
+    void reset() { blake256_Init(&context); }
+    void append(const byte* data, size_t size) { blake256_Update(&context, data, size); }
+    void finish(byte* digest) { blake256_Final(&context, digest); }
+    BLAKE256_CTX context;
+};
+
+/// Incremental Groestl512.
+class Groestl512 : public IncrementalHasher<Groestl512, sha512Size> {
+  public:
+    Groestl512() { reset(); }
+    ~Groestl512() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Groestl512, sha512Size>;
+    void reset() { groestl512_Init(&context); }
+    void append(const byte* data, size_t size) { groestl512_Update(&context, data, size); }
+    void finish(byte* digest) { groestl512_Final(&context, digest); }
+    GROESTL512_CTX context;
+};
+
+/// Incremental Blake2b with an `N` byte digest, optionally personalized.
+template <size_t N>
+class Blake2b : public IncrementalHasher<Blake2b<N>, N> {
+    static_assert(N > 0 && N <= BLAKE2B_OUTBYTES, "invalid Blake2b digest size");
+
+  public:
+    Blake2b() { reset(); }
+
+    /// Personalized hash; `personal` must have BLAKE2B_PERSONALBYTES bytes.
+    explicit Blake2b(const Data& personal) : personalized(true) {
+        if (personal.size() != BLAKE2B_PERSONALBYTES) {
+            throw std::invalid_argument("Invalid Blake2b personalization");
+        }
+        std::memcpy(this->personal, personal.data(), BLAKE2B_PERSONALBYTES);
+        reset();
+    }
+
+    ~Blake2b() { memzero(&context, sizeof(context)); }
+
+  private:
+    friend class IncrementalHasher<Blake2b<N>, N>;
+    void reset() {
+        if (personalized) {
+            blake2b_InitPersonal(&context, N, personal, BLAKE2B_PERSONALBYTES);
+        } else {
+            blake2b_Init(&context, N);
+        }
+    }
+    void append(const byte* data, size_t size) { blake2b_Update(&context, data, size); }
+    void finish(byte* digest) { blake2b_Final(&context, digest, N); }
+    blake2b_state context;
+    bool personalized = false;
+    byte personal[BLAKE2B_PERSONALBYTES] = {};
+};
+
+} // namespace TW::Hash
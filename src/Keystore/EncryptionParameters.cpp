@@ -5,16 +5,17 @@
 // file LICENSE at the root of the source code distribution tree.
 
 #include "EncryptionParameters.h"
+#include "Scrypt.h"
 
 #include "../Hash.h"
 #include "../HexCoding.h"
 
 #include <TrezorCrypto/aes.h>
 #include <TrezorCrypto/pbkdf2.h>
-#include <TrezorCrypto/scrypt.h>
 
 #include <boost/variant/get.hpp>
 #include <cassert>
+#include <stdexcept>
 
 using namespace TW;
 using namespace TW::Keystore;
@@ -28,12 +29,10 @@ static Data computeMAC(Iter begin, Iter end, const Data& key) {
     return Hash::keccak256(data);
 }
 
-EncryptionParameters::EncryptionParameters(const Data& password, const Data& data) : mac() {
-    auto scryptParams = boost::get<ScryptParameters>(kdfParams);
-    auto derivedKey = Data(scryptParams.desiredKeyLength);
-    scrypt(reinterpret_cast<const byte*>(password.data()), password.size(), scryptParams.salt.data(),
-           scryptParams.salt.size(), scryptParams.n, scryptParams.r, scryptParams.p, derivedKey.data(),
-           scryptParams.desiredKeyLength);
+EncryptionParameters::EncryptionParameters(const Data& password, const Data& data, const ScryptParameters& scryptParams,
+                                           ScryptScratch* scratch, size_t threads)
+    : kdfParams(scryptParams), mac() {
+    auto derivedKey = scrypt(password, scryptParams, scryptParams.desiredKeyLength, scratch, threads);
 
     aes_encrypt_ctx ctx;
     auto result = aes_encrypt_key128(derivedKey.data(), &ctx);
@@ -51,28 +50,45 @@ EncryptionParameters::~EncryptionParameters() {
     std::fill(encrypted.begin(), encrypted.end(), 0);
 }
 
-Data EncryptionParameters::decrypt(const Data& password) const {
+Data EncryptionParameters::decrypt(const Data& password, ScryptScratch* scratch) const {
+    return decryptWithKey(deriveKey(password, scratch));
+}
+
+Data EncryptionParameters::deriveKey(const Data& password, ScryptScratch* scratch, size_t threads) const {
     auto derivedKey = Data();
-    auto mac = Data();
 
     if (kdfParams.which() == 0) {
         auto scryptParams = boost::get<ScryptParameters>(kdfParams);
-        derivedKey.resize(scryptParams.defaultDesiredKeyLength);
-        scrypt(password.data(), password.size(), scryptParams.salt.data(),
-            scryptParams.salt.size(), scryptParams.n, scryptParams.r, scryptParams.p, derivedKey.data(),
-            scryptParams.defaultDesiredKeyLength);
-        mac = computeMAC(derivedKey.end() - 16, derivedKey.end(), encrypted);
+        try {
+            derivedKey = scrypt(password, scryptParams, scryptParams.defaultDesiredKeyLength, scratch, threads);
+        } catch (const std::invalid_argument&) {
+            throw DecryptionError::invalidKeyFile;
+        }
     } else if (kdfParams.which() == 1) {
         auto pbkdf2Params = boost::get<PBKDF2Parameters>(kdfParams);
         derivedKey.resize(pbkdf2Params.defaultDesiredKeyLength);
         pbkdf2_hmac_sha256(password.data(), static_cast<int>(password.size()), pbkdf2Params.salt.data(),
             static_cast<int>(pbkdf2Params.salt.size()), pbkdf2Params.iterations, derivedKey.data(),
             pbkdf2Params.defaultDesiredKeyLength);
-        mac = computeMAC(derivedKey.end() - 16, derivedKey.end(), encrypted);
     } else {
         throw DecryptionError::unsupportedKDF;
     }
+    return derivedKey;
+}
+
+size_t EncryptionParameters::kdfMemory() const {
+    if (kdfParams.which() == 0) {
+        const auto& scryptParams = boost::get<ScryptParameters>(kdfParams);
+        return size_t(128) * scryptParams.r * scryptParams.n;
+    }
+    return 0;
+}
 
+Data EncryptionParameters::decryptWithKey(const Data& derivedKey) const {
+    if (derivedKey.size() < 16) {
+        throw DecryptionError::invalidPassword;
+    }
+    auto mac = computeMAC(derivedKey.end() - 16, derivedKey.end(), encrypted);
     if (mac != this->mac) {
         throw DecryptionError::invalidPassword;
     }
@@ -17,6 +17,8 @@
 
 namespace TW::Keystore {
 
+class ScryptScratch;
+
 /// Errors thrown when decrypting a key.
 enum class DecryptionError {
     unsupportedKDF,
@@ -53,14 +55,35 @@ struct EncryptionParameters {
         , mac(std::move(mac)) {}
 
     /// Initializes `EncryptionParameters` by encrypting data with a password
-    /// using standard values.
-    EncryptionParameters(const Data& password, const Data& data);
+    /// using standard values, with scrypt working memory from `scratch` if given.
+    EncryptionParameters(const Data& password, const Data& data, ScryptScratch* scratch = nullptr)
+        : EncryptionParameters(password, data, ScryptParameters(), scratch) {}
+
+    /// Initializes `EncryptionParameters` by encrypting data with a password
+    /// using the given scrypt parameters, on up to `threads` threads (0 for all cores).
+    EncryptionParameters(const Data& password, const Data& data, const ScryptParameters& scryptParams,
+                         ScryptScratch* scratch = nullptr, size_t threads = 0);
 
     /// Initializes `EncryptionParameters` with a JSON object.
     EncryptionParameters(const nlohmann::json& json);
 
-    /// Decrypts the payload with the given password.
-    Data decrypt(const Data& password) const;
+    /// Decrypts the payload with the given password, with scrypt working memory
+    /// from `scratch` if given.
+    Data decrypt(const Data& password, ScryptScratch* scratch = nullptr) const;
+
+    /// Runs the key derivation function on a password, for decryptWithKey.  Scrypt
+    /// lanes run on up to `threads` threads (0 for all cores).
+    ///
+    /// @throws DecryptionError
+    Data deriveKey(const Data& password, ScryptScratch* scratch = nullptr, size_t threads = 0) const;
+
+    /// Decrypts the payload with a key returned by deriveKey.
+    ///
+    /// @throws DecryptionError::invalidPassword if the key does not match.
+    Data decryptWithKey(const Data& derivedKey) const;
+
+    /// Bytes of working memory the key derivation function needs per thread.
+    size_t kdfMemory() const;
 
     /// Saves `this` as a JSON object.
     nlohmann::json json() const;
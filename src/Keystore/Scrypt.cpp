@@ -0,0 +1,101 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "Scrypt.h"
+
+#include "../Parallel.h"
+
+#include <TrezorCrypto/memzero.h>
+#include <TrezorCrypto/pbkdf2.h>
+#include <TrezorCrypto/scrypt.h>
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace TW;
+using namespace TW::Keystore;
+
+ScryptScratch::~ScryptScratch() {
+    clear();
+}
+
+void ScryptScratch::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto* buffer : buffers) {
+        scrypt_scratch_free(buffer);
+        delete buffer;
+    }
+    buffers.clear();
+}
+
+size_t ScryptScratch::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buffers.size();
+}
+
+scrypt_scratch* ScryptScratch::acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (buffers.empty()) {
+        return new scrypt_scratch{};
+    }
+    auto* buffer = buffers.back();
+    buffers.pop_back();
+    return buffer;
+}
+
+void ScryptScratch::release(scrypt_scratch* buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffers.push_back(buffer);
+}
+
+Data TW::Keystore::scrypt(const Data& password, const ScryptParameters& params, size_t keyLength,
+                          ScryptScratch* scratch, size_t threads) {
+    const uint64_t n = params.n;
+    const uint32_t r = params.r;
+    const uint32_t p = params.p;
+    if (r == 0 || p == 0 || n < 2 || (n & (n - 1)) != 0 || uint64_t(r) * p >= (1 << 30) ||
+        n > SIZE_MAX / 128 / r) {
+        throw std::invalid_argument("Invalid scrypt parameters");
+    }
+    const size_t laneSize = 128 * size_t(r);
+    const size_t laneMemory = laneSize * n;
+
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads = std::min(threads, std::max(scryptMaxParallelMemory / laneMemory, size_t(1)));
+
+    ScryptScratch local;
+    auto& pool = scratch != nullptr ? *scratch : local;
+
+    // 1: (B_0 ... B_{p-1}) <-- PBKDF2(P, S, 1, p * MFLen)
+    auto blocks = Data(laneSize * p);
+    pbkdf2_hmac_sha256(password.data(), static_cast<int>(password.size()), params.salt.data(),
+                       static_cast<int>(params.salt.size()), 1, blocks.data(), static_cast<int>(blocks.size()));
+
+    // 2: B_i <-- MF(B_i, N), each lane on its own buffer
+    std::atomic<bool> failed{false};
+    parallelFor(p, threads, [&](size_t begin, size_t end) {
+        auto* buffer = pool.acquire();
+        for (auto i = begin; i < end; ++i) {
+            if (scrypt_smix(blocks.data() + i * laneSize, r, n, buffer) != 0) {
+                failed = true;
+            }
+        }
+        pool.release(buffer);
+    });
+    if (failed) {
+        memzero(blocks.data(), blocks.size());
+        throw std::invalid_argument("scrypt failed");
+    }
+
+    // 5: DK <-- PBKDF2(P, B, 1, dkLen)
+    auto key = Data(keyLength);
+    pbkdf2_hmac_sha256(password.data(), static_cast<int>(password.size()), blocks.data(),
+                       static_cast<int>(blocks.size()), 1, key.data(), static_cast<int>(keyLength));
+    memzero(blocks.data(), blocks.size());
+    return key;
+}
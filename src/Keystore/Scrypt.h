@@ -0,0 +1,61 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include "ScryptParameters.h"
+#include "../Data.h"
+
+#include <mutex>
+#include <vector>
+
+struct scrypt_scratch;
+
+namespace TW::Keystore {
+
+/// Scrypt working memory (128·r·N bytes per lane) kept between calls, so that unlocking several keystores with the
+/// same parameters allocates it only once.  Holds one buffer per lane run concurrently; wiped when cleared or
+/// destroyed.  Thread safe.
+class ScryptScratch {
+  public:
+    ScryptScratch() = default;
+    ~ScryptScratch();
+
+    ScryptScratch(const ScryptScratch&) = delete;
+    ScryptScratch& operator=(const ScryptScratch&) = delete;
+
+    /// Wipes and releases all buffers.
+    void clear();
+
+    /// Number of buffers held.
+    size_t size() const;
+
+  private:
+    friend Data scrypt(const Data& password, const ScryptParameters& params, size_t keyLength,
+                       ScryptScratch* scratch, size_t threads);
+
+    /// Takes a buffer out of the pool, or a new empty one.
+    scrypt_scratch* acquire();
+
+    /// Returns a buffer taken with acquire.
+    void release(scrypt_scratch* buffer);
+
+    mutable std::mutex mutex;
+    std::vector<scrypt_scratch*> buffers;
+};
+
+/// Upper bound on the working memory of the lanes run concurrently by scrypt.
+static constexpr size_t scryptMaxParallelMemory = 256 * 1024 * 1024;
+
+/// Derives a `keyLength` byte key from a password with scrypt.  The p lanes run on up to `threads` threads (0 for all
+/// cores), fewer if their working memory would exceed scryptMaxParallelMemory.  Buffers come from `scratch` if given,
+/// otherwise they are allocated for this call only.  Same output as TrezorCrypto's scrypt.
+///
+/// @throws std::invalid_argument if scrypt rejects the parameters or runs out of memory.
+Data scrypt(const Data& password, const ScryptParameters& params, size_t keyLength, ScryptScratch* scratch = nullptr,
+            size_t threads = 0);
+
+} // namespace TW::Keystore
@@ -0,0 +1,209 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "StoredKeyBulk.h"
+
+#include "../Parallel.h"
+
+#include <TrezorCrypto/memzero.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+using namespace TW;
+using namespace TW::Keystore;
+
+static std::string errorString(DecryptionError error) {
+    switch (error) {
+    case DecryptionError::unsupportedKDF:
+        return "Unsupported KDF";
+    case DecryptionError::unsupportedCipher:
+        return "Unsupported cipher";
+    case DecryptionError::unsupportedCoin:
+        return "Unsupported coin";
+    case DecryptionError::invalidKeyFile:
+        return "Invalid key file";
+    case DecryptionError::invalidCipher:
+        return "Invalid cipher";
+    case DecryptionError::invalidPassword:
+        return "Invalid password";
+    }
+    return "Decryption error";
+}
+
+/// Runs f on one result, storing any error in it.
+template <typename F>
+static void guarded(BulkKey& result, F&& f) {
+    try {
+        f();
+    } catch (DecryptionError error) {
+        result.error = errorString(error);
+    } catch (const std::exception& error) {
+        result.error = error.what();
+    } catch (...) {
+        result.error = "Unknown error";
+    }
+}
+
+/// Loads all key files, then calls process(result, scratch) for each loaded one.  Keys are grouped by KDF memory, largest
+/// first, and each group runs on as many threads as fit within maxMemory given `extraMemory` more per worker.
+template <typename F>
+static std::vector<BulkKey> bulk(const std::vector<std::string>& paths, const BulkOptions& options, size_t extraMemory,
+                                 F&& process) {
+    auto threads = options.threads;
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    std::vector<BulkKey> results(paths.size());
+    parallelFor(paths.size(), threads, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            results[i].path = paths[i];
+            guarded(results[i], [&] { results[i].key = StoredKey::load(paths[i]); });
+        }
+    });
+
+    std::map<size_t, std::vector<size_t>, std::greater<size_t>> groups;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].key) {
+            groups[results[i].key->payload.kdfMemory()].push_back(i);
+        }
+    }
+
+    for (const auto& [memory, indices] : groups) {
+        const auto perWorker = memory + extraMemory;
+        const auto workers = perWorker == 0 ? threads : std::min(threads, std::max(options.maxMemory / perWorker, size_t(1)));
+        ScryptScratch scratch;
+        parallelFor(indices.size(), workers, [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                auto& result = results[indices[i]];
+                guarded(result, [&] { process(result, scratch); });
+            }
+        });
+    }
+    return results;
+}
+
+std::vector<std::string> TW::Keystore::listStoredKeyFiles(const std::string& directory) {
+    auto* dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        throw std::invalid_argument("Can't open directory");
+    }
+    std::vector<std::string> paths;
+    const std::string suffix = ".json";
+    for (auto* entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            paths.push_back(directory + "/" + name);
+        }
+    }
+    closedir(dir);
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+std::vector<BulkKey> TW::Keystore::unlockStoredKeys(const std::vector<std::string>& paths, const Data& password,
+                                                    const BulkOptions& options) {
+    return bulk(paths, options, 0, [&](BulkKey& result, ScryptScratch& scratch) {
+        result.data = result.key->payload.decryptWithKey(result.key->payload.deriveKey(password, &scratch, 1));
+    });
+}
+
+/// Replaces the file at `path` with `contents`: writes a new file next to it, with the same permissions, syncs it,
+/// renames it over the old one and syncs the directory.
+static void replaceFile(const std::string& path, const std::string& contents) {
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0) {
+        throw std::runtime_error("Can't read file");
+    }
+    const auto mode = status.st_mode & 07777;
+    const auto temporary = path + ".tmp";
+    // left over from an interrupted run
+    std::remove(temporary.c_str());
+    const auto fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+    if (fd < 0) {
+        throw std::runtime_error("Can't write file");
+    }
+    // the mode given to open is masked by the umask
+    auto written = fchmod(fd, mode) == 0;
+    for (size_t offset = 0; written && offset < contents.size();) {
+        const auto count = write(fd, contents.data() + offset, contents.size() - offset);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        written = count > 0;
+        offset += written ? static_cast<size_t>(count) : 0;
+    }
+    written = written && fsync(fd) == 0;
+    written = close(fd) == 0 && written;
+    if (!written) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Can't write file");
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Can't replace file");
+    }
+
+    // the rename is durable only once the directory entry is
+    const auto slash = path.rfind('/');
+    const auto directory = slash == std::string::npos ? std::string(".") : path.substr(0, std::max(slash, size_t(1)));
+    const auto directoryFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directoryFd < 0) {
+        throw std::runtime_error("Can't sync directory");
+    }
+    const auto synced = fsync(directoryFd) == 0;
+    close(directoryFd);
+    if (!synced) {
+        throw std::runtime_error("Can't sync directory");
+    }
+}
+
+/// Zeroes a buffer when leaving the scope, exceptions included.
+class WipeGuard {
+  public:
+    explicit WipeGuard(Data& data) : data(data) {}
+    WipeGuard(const WipeGuard&) = delete;
+    WipeGuard& operator=(const WipeGuard&) = delete;
+    ~WipeGuard() { memzero(data.data(), data.size()); }
+
+  private:
+    Data& data;
+};
+
+std::vector<BulkKey> TW::Keystore::reencryptStoredKeys(const std::vector<std::string>& paths, const Data& password,
+                                                       const Data& newPassword, const ScryptParameters& newParams,
+                                                       const BulkOptions& options) {
+    if (newParams.r == 0 || newParams.p == 0 || newParams.validate()) {
+        throw std::invalid_argument("Invalid scrypt parameters");
+    }
+    const auto newMemory = size_t(128) * newParams.r * newParams.n;
+    ScryptScratch newScratch;
+    return bulk(paths, options, newMemory, [&](BulkKey& result, ScryptScratch& scratch) {
+        auto& key = *result.key;
+        auto data = key.payload.decryptWithKey(key.payload.deriveKey(password, &scratch, 1));
+        const auto wipe = WipeGuard(data);
+
+        auto params = ScryptParameters();
+        params.n = newParams.n;
+        params.r = newParams.r;
+        params.p = newParams.p;
+        auto updated = key;
+        updated.payload = EncryptionParameters(newPassword, data, params, &newScratch, 1);
+
+        replaceFile(result.path, updated.json().dump());
+        key = std::move(updated);
+    });
+}
@@ -0,0 +1,72 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include "Scrypt.h"
+#include "StoredKey.h"
+#include "../Data.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TW::Keystore {
+
+/// Outcome for one key file of a bulk operation.
+struct BulkKey {
+    /// Path of the key file.
+    std::string path;
+
+    /// The key, if the file could be loaded (re-encrypted after reencryptStoredKeys).
+    std::optional<StoredKey> key;
+
+    /// Decrypted payload (private key or mnemonic phrase) after unlockStoredKeys, empty otherwise.
+    Data data;
+
+    /// Empty on success, otherwise what went wrong with this file.
+    std::string error;
+
+    BulkKey() = default;
+    BulkKey(const BulkKey& other) = default;
+    BulkKey(BulkKey&& other) = default;
+    BulkKey& operator=(const BulkKey& other) = default;
+    BulkKey& operator=(BulkKey&& other) = default;
+    ~BulkKey() { std::fill(data.begin(), data.end(), 0); }
+};
+
+/// Scheduling of bulk operations.
+struct BulkOptions {
+    /// Number of worker threads, 0 to use all cores.
+    size_t threads = 0;
+
+    /// Upper bound on the KDF working memory (128·r·n bytes per scrypt worker) of all workers together.
+    size_t maxMemory = scryptMaxParallelMemory;
+};
+
+/// Lists the key files (`*.json`) of a directory, sorted by name.
+///
+/// @throws std::invalid_argument if the directory can't be read.
+std::vector<std::string> listStoredKeyFiles(const std::string& directory);
+
+/// Loads key files and decrypts them with one password.  Key derivations run concurrently, files with the same KDF
+/// parameters together, each scrypt on one thread with scratch memory reused within the group; as many workers as
+/// the memory bound allows.  Returns one result per path, in order.
+std::vector<BulkKey> unlockStoredKeys(const std::vector<std::string>& paths, const Data& password,
+                                      const BulkOptions& options = {});
+
+/// Decrypts key files with `password` and rewrites them encrypted with `newPassword` and the n, r and p of
+/// `newParams`, with a fresh salt and IV per file; a file is replaced only once its new contents are written and
+/// synced, keeping its permissions.
+/// Scheduled like unlockStoredKeys, counting both the old and new KDF memory per worker.  Returns one result per
+/// path, in order, without decrypted data.
+///
+/// @throws std::invalid_argument if `newParams` are not valid scrypt parameters.
+std::vector<BulkKey> reencryptStoredKeys(const std::vector<std::string>& paths, const Data& password,
+                                         const Data& newPassword, const ScryptParameters& newParams,
+                                         const BulkOptions& options = {});
+
+} // namespace TW::Keystore
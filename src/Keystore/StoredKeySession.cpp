@@ -0,0 +1,131 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "StoredKeySession.h"
+
+#include "../Coin.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace TW;
+using namespace TW::Keystore;
+
+StoredKeySession::StoredKeySession(StoredKey& key, const Data& password, Clock::duration ttl)
+    : key(key) {
+    derivedKey = key.payload.deriveKey(password);
+    auto data = Data();
+    auto mnemonic = std::string();
+    try {
+        data = key.payload.decryptWithKey(derivedKey);
+        if (key.type == StoredKeyType::mnemonicPhrase) {
+            mnemonic.assign(reinterpret_cast<const char*>(data.data()), data.size());
+            hdWallet.emplace(mnemonic, "");
+        }
+    } catch (...) {
+        std::fill(data.begin(), data.end(), 0);
+        std::fill(mnemonic.begin(), mnemonic.end(), 0);
+        wipe();
+        throw;
+    }
+    std::fill(data.begin(), data.end(), 0);
+    std::fill(mnemonic.begin(), mnemonic.end(), 0);
+    expiry = Clock::now() + ttl;
+}
+
+StoredKeySession::~StoredKeySession() {
+    wipe();
+}
+
+bool StoredKeySession::isUnlocked() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !derivedKey.empty() && Clock::now() < expiry;
+}
+
+void StoredKeySession::extend(Clock::duration ttl) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!derivedKey.empty() && Clock::now() < expiry) {
+        expiry = Clock::now() + ttl;
+    }
+}
+
+void StoredKeySession::lock() {
+    std::lock_guard<std::mutex> lock(mutex);
+    wipe();
+}
+
+void StoredKeySession::checkUnlocked() {
+    if (!derivedKey.empty() && Clock::now() >= expiry) {
+        wipe();
+    }
+    if (derivedKey.empty()) {
+        throw std::runtime_error("Session is locked");
+    }
+}
+
+void StoredKeySession::wipe() {
+    std::fill(derivedKey.begin(), derivedKey.end(), 0);
+    derivedKey.clear();
+    hdWallet.reset();
+}
+
+Data StoredKeySession::decrypt() {
+    std::lock_guard<std::mutex> lock(mutex);
+    checkUnlocked();
+    return key.payload.decryptWithKey(derivedKey);
+}
+
+const HDWallet StoredKeySession::wallet() {
+    std::lock_guard<std::mutex> lock(mutex);
+    checkUnlocked();
+    if (!hdWallet) {
+        throw std::invalid_argument("Invalid account requested.");
+    }
+    return *hdWallet;
+}
+
+std::optional<const Account> StoredKeySession::account(TWCoinType coin) {
+    std::lock_guard<std::mutex> lock(mutex);
+    checkUnlocked();
+    if (!hdWallet) {
+        return key.account(coin);
+    }
+    return key.account(coin, &*hdWallet);
+}
+
+const PrivateKey StoredKeySession::privateKey(TWCoinType coin) {
+    std::lock_guard<std::mutex> lock(mutex);
+    checkUnlocked();
+    if (hdWallet) {
+        const auto account = key.account(coin, &*hdWallet);
+        return hdWallet->getKey(coin, account->derivationPath);
+    }
+    auto data = key.payload.decryptWithKey(derivedKey);
+    const auto privateKey = PrivateKey(data);
+    std::fill(data.begin(), data.end(), 0);
+    return privateKey;
+}
+
+void StoredKeySession::fixAddresses() {
+    std::lock_guard<std::mutex> lock(mutex);
+    checkUnlocked();
+    std::optional<PrivateKey> privateKey;
+    if (!hdWallet) {
+        auto data = key.payload.decryptWithKey(derivedKey);
+        privateKey.emplace(data);
+        std::fill(data.begin(), data.end(), 0);
+    }
+    for (auto& account : key.accounts) {
+        if (!account.address.empty() && TW::validateAddress(account.coin, account.address)) {
+            continue;
+        }
+        if (hdWallet) {
+            account.address = TW::deriveAddress(account.coin, hdWallet->getKey(account.coin, account.derivationPath));
+        } else {
+            account.address = TW::deriveAddress(account.coin, *privateKey);
+        }
+    }
+}
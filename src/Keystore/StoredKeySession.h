@@ -0,0 +1,93 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include "StoredKey.h"
+#include "../Data.h"
+#include "../HDWallet.h"
+#include "../PrivateKey.h"
+
+#include <TrustWalletCore/TWCoinType.h>
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+
+namespace TW::Keystore {
+
+/// A stored key unlocked with its password for a limited time.  The key derivation function runs once, when the
+/// session is created; the derived key and, for mnemonic keys, the wallet seed are kept until the session is locked or
+/// expires, so that key and account operations only derive along HD paths.  Locking wipes them.
+///
+/// The session refers to the stored key, which must outlive it.  Thread safe, except that account operations modify
+/// the stored key.
+class StoredKeySession {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Unlocks a stored key for `ttl`, counted from when unlocking completes.
+    ///
+    /// @throws DecryptionError if the password is wrong or the key can't be decrypted.
+    StoredKeySession(StoredKey& key, const Data& password, Clock::duration ttl);
+
+    StoredKeySession(const StoredKeySession&) = delete;
+    StoredKeySession& operator=(const StoredKeySession&) = delete;
+
+    ~StoredKeySession();
+
+    /// Whether the session is neither locked nor expired.
+    bool isUnlocked() const;
+
+    /// Keeps an unlocked session open until `ttl` from now; no effect once locked or expired.
+    void extend(Clock::duration ttl);
+
+    /// Wipes the cached secrets; further operations throw.
+    void lock();
+
+    /// Returns the decrypted payload, the private key or mnemonic phrase.
+    ///
+    /// @throws std::runtime_error if the session is locked.
+    Data decrypt();
+
+    /// Returns the HD wallet of a mnemonic key, as StoredKey::wallet.
+    ///
+    /// @throws std::invalid_argument if the key is not a mnemonic phrase.
+    /// @throws std::runtime_error if the session is locked.
+    const HDWallet wallet();
+
+    /// Returns the account for a coin, creating it if necessary, as StoredKey::account.
+    ///
+    /// @throws std::runtime_error if the session is locked.
+    std::optional<const Account> account(TWCoinType coin);
+
+    /// Returns the private key for a coin, creating an account if necessary, as StoredKey::privateKey.
+    ///
+    /// @throws std::runtime_error if the session is locked.
+    const PrivateKey privateKey(TWCoinType coin);
+
+    /// Fills in all empty and invalid addresses, as StoredKey::fixAddresses.
+    ///
+    /// @throws std::runtime_error if the session is locked.
+    void fixAddresses();
+
+  private:
+    /// Locks the session if it has expired; throws if it is locked.  Called with the mutex held.
+    void checkUnlocked();
+
+    /// Wipes the cached secrets.  Called with the mutex held.
+    void wipe();
+
+    StoredKey& key;
+    mutable std::mutex mutex;
+    Clock::time_point expiry;
+    /// Output of the key derivation function, empty once locked.
+    Data derivedKey;
+    /// Wallet of a mnemonic key, holding the seed.
+    std::optional<HDWallet> hdWallet;
+};
+
+} // namespace TW::Keystore
@@ -0,0 +1,49 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace TW {
+
+/// Calls f(begin, end) for consecutive chunks of the range [0, count), on the given number of threads
+/// (0 to use all cores, 1 to run on the calling thread only).  The calling thread is one of the workers.
+/// Chunks are small enough to balance uneven per-item times; f is called concurrently on disjoint chunks.
+template <typename F>
+void parallelFor(size_t count, size_t threads, F&& f) {
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads = std::min(threads, count);
+    if (threads <= 1) {
+        if (count > 0) {
+            f(size_t(0), count);
+        }
+        return;
+    }
+
+    const size_t chunk = std::max(count / (threads * 8), size_t(1));
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (auto begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk)) {
+            f(begin, std::min(begin + chunk, count));
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+} // namespace TW
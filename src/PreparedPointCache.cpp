@@ -0,0 +1,66 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "PreparedPointCache.h"
+
+using namespace TW;
+
+PreparedPointCache& PreparedPointCache::shared() {
+    static PreparedPointCache cache;
+    return cache;
+}
+
+std::shared_ptr<const ecdsa_prepared_point> PreparedPointCache::get(const ecdsa_curve* curve, const Data& compressedKey) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = index.find(Key(curve, compressedKey));
+    if (it == index.end()) {
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+std::shared_ptr<const ecdsa_prepared_point> PreparedPointCache::prepare(const ecdsa_curve* curve, const Data& compressedKey) {
+    if (auto cached = get(curve, compressedKey)) {
+        return cached;
+    }
+
+    // Prepared outside of the lock, it takes a few ECDH multiplications
+    auto prepared = std::make_shared<ecdsa_prepared_point>();
+    if (compressedKey.size() != 33 || ecdsa_prepare_point(curve, compressedKey.data(), prepared.get()) != 0) {
+        return nullptr;
+    }
+    if (capacity == 0) {
+        return prepared;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = Key(curve, compressedKey);
+    const auto it = index.find(key);
+    if (it != index.end()) {
+        // prepared by another thread meanwhile
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->second;
+    }
+    if (entries.size() >= capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.emplace_front(std::move(key), std::move(prepared));
+    index.emplace(entries.front().first, entries.begin());
+    return entries.front().second;
+}
+
+void PreparedPointCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    index.clear();
+    entries.clear();
+}
+
+size_t PreparedPointCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
@@ -0,0 +1,59 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#pragma once
+
+#include "Data.h"
+
+#include <TrezorCrypto/ecdsa.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace TW {
+
+/// Cache of public keys prepared for repeated multiplication (about 37 KB each), by curve and compressed key, least
+/// recently used evicted first.  Thread safe.
+class PreparedPointCache {
+  public:
+    static constexpr size_t defaultCapacity = 32;
+
+    explicit PreparedPointCache(size_t capacity = defaultCapacity) : capacity(capacity) {}
+
+    PreparedPointCache(const PreparedPointCache&) = delete;
+    PreparedPointCache& operator=(const PreparedPointCache&) = delete;
+
+    /// The cache used by PublicKey::prepare and PublicKey::prepared.
+    static PreparedPointCache& shared();
+
+    /// Looks up the prepared point of a compressed public key; nullptr if it is not cached.
+    std::shared_ptr<const ecdsa_prepared_point> get(const ecdsa_curve* curve, const Data& compressedKey);
+
+    /// Returns the prepared point of a compressed public key, preparing and storing it if it is not cached, evicting
+    /// the least recently used one if full; nullptr if the key is not valid.
+    std::shared_ptr<const ecdsa_prepared_point> prepare(const ecdsa_curve* curve, const Data& compressedKey);
+
+    /// Removes all prepared points.
+    void clear();
+
+    /// Number of cached prepared points.
+    size_t size() const;
+
+  private:
+    using Key = std::pair<const ecdsa_curve*, Data>;
+    using Entry = std::pair<Key, std::shared_ptr<const ecdsa_prepared_point>>;
+
+    const size_t capacity;
+    mutable std::mutex mutex;
+    /// Most recently used first
+    std::list<Entry> entries;
+    std::map<Key, std::list<Entry>::iterator> index;
+};
+
+} // namespace TW
@@ -152,8 +152,10 @@ Data PrivateKey::getSharedKey(const PublicKey& pubKey, TWCurve curve) const {
     }
 
     Data result(PublicKey::secp256k1ExtendedSize);
-    bool success = ecdh_multiply(&secp256k1, bytes.data(),
-                                 pubKey.bytes.data(), result.data()) == 0;
+    const auto& prepared = pubKey.prepared();
+    const auto usePrepared = prepared && prepared->curve == &secp256k1;
+    bool success = usePrepared ? ecdh_multiply_prepared(prepared.get(), bytes.data(), result.data()) == 0
+                               : ecdh_multiply(&secp256k1, bytes.data(), pubKey.bytes.data(), result.data()) == 0;
 
     if (success) {
         PublicKey sharedKey(result, TWPublicKeyTypeSECP256k1Extended);
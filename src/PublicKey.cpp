@@ -6,6 +6,7 @@
 
 #include "PublicKey.h"
 #include "Data.h"
+#include "PreparedPointCache.h"
 
 #include <TrezorCrypto/ecdsa.h>
 #include <TrezorCrypto/ed25519-donna/ed25519-blake2b.h>
@@ -88,29 +89,29 @@ PublicKey PublicKey::compressed() const {
     newBytes[0] = 0x02 | (bytes[64] & 0x01);
 
     assert(type == TWPublicKeyTypeSECP256k1Extended || type == TWPublicKeyTypeNIST256p1Extended);
-    switch (type) {
-    case TWPublicKeyTypeSECP256k1Extended:
-        std::copy(bytes.begin() + 1, bytes.begin() + secp256k1Size, newBytes.begin() + 1);
-        return PublicKey(newBytes, TWPublicKeyTypeSECP256k1);
-
-    case TWPublicKeyTypeNIST256p1Extended:
-    default:
-        std::copy(bytes.begin() + 1, bytes.begin() + secp256k1Size, newBytes.begin() + 1);
-        return PublicKey(newBytes, TWPublicKeyTypeNIST256p1);
-    }
+    std::copy(bytes.begin() + 1, bytes.begin() + secp256k1Size, newBytes.begin() + 1);
+    auto key = PublicKey(newBytes, type == TWPublicKeyTypeSECP256k1Extended ? TWPublicKeyTypeSECP256k1 : TWPublicKeyTypeNIST256p1);
+    key.preparedPoint = preparedPoint;
+    return key;
 }
 
 PublicKey PublicKey::extended() const {
     Data newBytes(secp256k1ExtendedSize);
     switch (type) {
-    case TWPublicKeyTypeSECP256k1:
+    case TWPublicKeyTypeSECP256k1: {
         ecdsa_uncompress_pubkey(&secp256k1, bytes.data(), newBytes.data());
-        return PublicKey(newBytes, TWPublicKeyTypeSECP256k1Extended);
+        auto key = PublicKey(newBytes, TWPublicKeyTypeSECP256k1Extended);
+        key.preparedPoint = preparedPoint;
+        return key;
+    }
     case TWPublicKeyTypeSECP256k1Extended:
         return *this;
-    case TWPublicKeyTypeNIST256p1:
+    case TWPublicKeyTypeNIST256p1: {
         ecdsa_uncompress_pubkey(&nist256p1, bytes.data(), newBytes.data());
-        return PublicKey(newBytes, TWPublicKeyTypeNIST256p1Extended);
+        auto key = PublicKey(newBytes, TWPublicKeyTypeNIST256p1Extended);
+        key.preparedPoint = preparedPoint;
+        return key;
+    }
     case TWPublicKeyTypeNIST256p1Extended:
         return *this;
     case TWPublicKeyTypeED25519:
@@ -121,14 +122,30 @@ PublicKey PublicKey::extended() const {
     }
 }
 
+/// The curve of secp256k1 and nist256p1 keys, nullptr for other ones
+static const ecdsa_curve* ecdsaCurve(TWPublicKeyType type) {
+    switch (type) {
+    case TWPublicKeyTypeSECP256k1:
+    case TWPublicKeyTypeSECP256k1Extended:
+        return &secp256k1;
+    case TWPublicKeyTypeNIST256p1:
+    case TWPublicKeyTypeNIST256p1Extended:
+        return &nist256p1;
+    default:
+        return nullptr;
+    }
+}
+
 bool PublicKey::verify(const Data& signature, const Data& message) const {
     switch (type) {
     case TWPublicKeyTypeSECP256k1:
     case TWPublicKeyTypeSECP256k1Extended:
-        return ecdsa_verify_digest(&secp256k1, bytes.data(), signature.data(), message.data()) == 0;
     case TWPublicKeyTypeNIST256p1:
     case TWPublicKeyTypeNIST256p1Extended:
-        return ecdsa_verify_digest(&nist256p1, bytes.data(), signature.data(), message.data()) == 0;
+        if (preparedPoint != nullptr) {
+            return ecdsa_verify_digest_prepared(preparedPoint.get(), signature.data(), message.data()) == 0;
+        }
+        return ecdsa_verify_digest(ecdsaCurve(type), bytes.data(), signature.data(), message.data()) == 0;
     case TWPublicKeyTypeED25519:
         return ed25519_sign_open(message.data(), message.size(), bytes.data(), signature.data()) == 0;
     case TWPublicKeyTypeED25519Blake2b:
@@ -153,6 +170,125 @@ bool PublicKey::verify(const Data& signature, const Data& message) const {
     }
 }
 
+/// Verifies the signatures of the keys of a curve together, for PublicKey::verifyBatch
+static void verifyCurveBatch(const ecdsa_curve* curve, TWPublicKeyType type, TWPublicKeyType extendedType,
+                             const std::vector<PublicKey>& publicKeys, const std::vector<Data>& signatures,
+                             const std::vector<Data>& messages, std::vector<bool>& results) {
+    std::vector<size_t> items;
+    std::vector<const uint8_t*> keys, sigs, digests;
+    for (size_t i = 0; i < publicKeys.size(); ++i) {
+        if (publicKeys[i].type != type && publicKeys[i].type != extendedType) {
+            continue;
+        }
+        if (signatures[i].size() < 64 || messages[i].size() < 32) {
+            results[i] = false;
+            continue;
+        }
+        items.push_back(i);
+        keys.push_back(publicKeys[i].bytes.data());
+        sigs.push_back(signatures[i].data());
+        digests.push_back(messages[i].data());
+    }
+    std::vector<int> codes(items.size());
+    ecdsa_verify_digest_batch(curve, items.size(), keys.data(), sigs.data(), digests.data(), codes.data());
+    for (size_t j = 0; j < items.size(); ++j) {
+        results[items[j]] = codes[j] == 0;
+    }
+}
+
+/// Verifies the ed25519 signatures together, for PublicKey::verifyBatch; with blake2b the ed25519-blake2b ones.
+/// Curve25519 keys and signatures are converted to their ed25519 form as in verify().
+static void verifyEd25519Batch(bool blake2b, const std::vector<PublicKey>& publicKeys, const std::vector<Data>& signatures,
+                               const std::vector<Data>& messages, std::vector<bool>& results) {
+    std::vector<size_t> items;
+    for (size_t i = 0; i < publicKeys.size(); ++i) {
+        const auto type = publicKeys[i].type;
+        if (blake2b ? type != TWPublicKeyTypeED25519Blake2b : type != TWPublicKeyTypeED25519 && type != TWPublicKeyTypeCURVE25519) {
+            continue;
+        }
+        if (signatures[i].size() < 64) {
+            results[i] = false;
+            continue;
+        }
+        items.push_back(i);
+    }
+
+    std::vector<Data> converted;
+    converted.reserve(2 * items.size());
+    std::vector<const uint8_t*> keys, sigs, msgs;
+    std::vector<size_t> lengths;
+    for (auto i : items) {
+        if (publicKeys[i].type == TWPublicKeyTypeCURVE25519) {
+            auto key = Data(PublicKey::ed25519Size);
+            curve25519_pk_to_ed25519(key.data(), publicKeys[i].bytes.data());
+            key[31] &= 0x7F;
+            key[31] |= signatures[i][63] & 0x80;
+            auto sig = Data(signatures[i].begin(), signatures[i].begin() + 64);
+            sig[63] &= 127;
+            converted.push_back(std::move(key));
+            keys.push_back(converted.back().data());
+            converted.push_back(std::move(sig));
+            sigs.push_back(converted.back().data());
+        } else {
+            keys.push_back(publicKeys[i].bytes.data());
+            sigs.push_back(signatures[i].data());
+        }
+        msgs.push_back(messages[i].data());
+        lengths.push_back(messages[i].size());
+    }
+
+    std::vector<int> valid(items.size());
+    if (blake2b) {
+        ed25519_sign_open_batch_blake2b(msgs.data(), lengths.data(), keys.data(), sigs.data(), items.size(), valid.data());
+    } else {
+        ed25519_sign_open_batch(msgs.data(), lengths.data(), keys.data(), sigs.data(), items.size(), valid.data());
+    }
+    for (size_t j = 0; j < items.size(); ++j) {
+        results[items[j]] = valid[j] != 0;
+    }
+}
+
+std::vector<bool> PublicKey::verifyBatch(const std::vector<PublicKey>& publicKeys, const std::vector<Data>& signatures, const std::vector<Data>& messages) {
+    if (signatures.size() != publicKeys.size() || messages.size() != publicKeys.size()) {
+        throw std::invalid_argument("Invalid batch sizes");
+    }
+    std::vector<bool> results(publicKeys.size(), false);
+    verifyCurveBatch(&secp256k1, TWPublicKeyTypeSECP256k1, TWPublicKeyTypeSECP256k1Extended, publicKeys, signatures, messages, results);
+    verifyCurveBatch(&nist256p1, TWPublicKeyTypeNIST256p1, TWPublicKeyTypeNIST256p1Extended, publicKeys, signatures, messages, results);
+    verifyEd25519Batch(false, publicKeys, signatures, messages, results);
+    verifyEd25519Batch(true, publicKeys, signatures, messages, results);
+    for (size_t i = 0; i < publicKeys.size(); ++i) {
+        switch (publicKeys[i].type) {
+        case TWPublicKeyTypeSECP256k1:
+        case TWPublicKeyTypeSECP256k1Extended:
+        case TWPublicKeyTypeNIST256p1:
+        case TWPublicKeyTypeNIST256p1Extended:
+        case TWPublicKeyTypeED25519:
+        case TWPublicKeyTypeED25519Blake2b:
+        case TWPublicKeyTypeCURVE25519:
+            break;
+        case TWPublicKeyTypeED25519Extended:
+            // not verifiable, verify() throws
+            results[i] = false;
+            break;
+        default:
+            results[i] = publicKeys[i].verify(signatures[i], messages[i]);
+        }
+    }
+    return results;
+}
+
+std::shared_ptr<const ecdsa_prepared_point> PublicKey::prepare() {
+    const auto curve = ecdsaCurve(type);
+    if (curve == nullptr) {
+        return nullptr;
+    }
+    if (preparedPoint == nullptr) {
+        preparedPoint = PreparedPointCache::shared().prepare(curve, compressed().bytes);
+    }
+    return preparedPoint;
+}
+
 bool PublicKey::verifySchnorr(const Data& signature, const Data& message) const {
     switch (type) {
     case TWPublicKeyTypeSECP256k1:
@@ -12,7 +12,11 @@
 #include <TrustWalletCore/TWPublicKeyType.h>
 
 #include <cassert>
+#include <memory>
 #include <stdexcept>
+#include <vector>
+
+struct ecdsa_prepared_point;
 
 namespace TW {
 
@@ -61,6 +65,26 @@ class PublicKey {
     /// Verifies a signature for the provided message.
     bool verify(const Data& signature, const Data& message) const;
 
+    /// Verifies many signatures, each of the message and by the public key at the same index, as verify() does.
+    ///
+    /// secp256k1 and nist256p1 signatures are verified together, sharing modular inversions; ed25519, ed25519-blake2b and
+    /// curve25519 ones with a randomized multi-scalar check that falls back to one at a time if it fails; other ones, and ed25519
+    /// signatures whose R or public key is not in the prime order subgroup, one at a time, so that results always match verify().
+    /// Signatures by ed25519-extended keys, which verify() does not support, are invalid.
+    /// @throws std::invalid_argument if the numbers of public keys, signatures and messages differ.
+    static std::vector<bool> verifyBatch(const std::vector<PublicKey>& publicKeys, const std::vector<Data>& signatures, const std::vector<Data>& messages);
+
+    /// Prepares this secp256k1 or nist256p1 key for repeated ECDH and verification: its multiples are computed once,
+    /// at the cost of a few ECDH multiplications, or taken from PreparedPointCache::shared() if a key with the same
+    /// bytes was prepared recently.  verify(), PrivateKey::getSharedKey and FIO encryption then use them, for this key,
+    /// its copies and its compressed() and extended() forms.  The bytes of a prepared key must not change.
+    ///
+    /// @returns nullptr for other key types.
+    std::shared_ptr<const ecdsa_prepared_point> prepare();
+
+    /// Returns the prepared multiples of this key if it was prepared, nullptr otherwise.
+    const std::shared_ptr<const ecdsa_prepared_point>& prepared() const { return preparedPoint; }
+
     /// Verifies a schnorr signature for the provided message.
     bool verifySchnorr(const Data& signature, const Data& message) const;
 
@@ -75,6 +99,10 @@ class PublicKey {
 
     /// Check if this key makes a valid ED25519 key (it is on the curve)
     bool isValidED25519() const;
+
+  private:
+    /// Multiples of the key, set by prepare().
+    std::shared_ptr<const ecdsa_prepared_point> preparedPoint;
 };
 
 inline bool operator==(const PublicKey& lhs, const PublicKey& rhs) {
@@ -5,58 +5,154 @@
 // file LICENSE at the root of the source code distribution tree.
 
 #include "Address.h"
-#include "../Base32.h"
-#include "../HexCoding.h"
-#include "../Crc.h"
+#include "../Hash.h"
 
-#include <boost/algorithm/string.hpp>
-#include <array>
+#include <TrezorCrypto/sha2.h>
+
+#include <algorithm>
+#include <cctype>
 
 using namespace TW::Stacks;
-using namespace boost::algorithm;
 
 const char* Address::BASE32_ALPHABET_CROCKFORD = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
 
-TW::Data Address::deconstruct(const std::string& string) {
-    if ((string.length() < (checksumSize + 2)) || (string.length() > size)) {
-        return {};
+static const TW::byte INVALID_DIGIT = 0xff;
+
+/// Value of each character in the Crockford alphabet, case insensitive, with 'O' read as '0' and 'L', 'I' as '1'.
+static const auto C32_DIGITS = [] {
+    std::array<TW::byte, 256> digits{};
+    digits.fill(INVALID_DIGIT);
+    const std::string alphabet = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+    for (size_t i = 0; i < alphabet.size(); ++i) {
+        digits[static_cast<TW::byte>(alphabet[i])] = static_cast<TW::byte>(i);
+        digits[static_cast<TW::byte>(std::tolower(alphabet[i]))] = static_cast<TW::byte>(i);
+    }
+    for (auto c : {'O', 'o'}) {
+        digits[static_cast<TW::byte>(c)] = 0;
+    }
+    for (auto c : {'L', 'l', 'I', 'i'}) {
+        digits[static_cast<TW::byte>(c)] = 1;
+    }
+    return digits;
+}();
+
+/// First bytes of the double SHA-256 of prefix and public key hash
+static void checksum(const std::array<TW::byte, 21>& bytes, TW::byte* out) {
+    std::array<TW::byte, SHA256_DIGEST_LENGTH> digest;
+    sha256_Raw(bytes.data(), bytes.size(), digest.data());
+    sha256_Raw(digest.data(), digest.size(), digest.data());
+    std::copy(digest.begin(), digest.begin() + 4, out);
+}
+
+bool Address::decode(const std::string& string, std::array<byte, bytesSize>& bytes) {
+    static_assert(bytesSize == 21 && checksumSize == 4);
+    const auto length = string.length();
+    if ((length < (checksumSize + 2)) || (length > size) || (string[0] != 'S' && string[0] != 's')) {
+        return false;
+    }
+    const auto version = C32_DIGITS[static_cast<byte>(string[1])];
+    if (version == INVALID_DIGIT) {
+        return false;
     }
 
-    // Check that it decodes correctly
-    Data data;
-    auto normalise = to_upper_copy(string);
-    auto pad = size - normalise.length();
-    if (pad) {
-        normalise.insert(2, std::string(pad, '0'));
+    // Public key hash and checksum, decoded from the last digit; digits beyond their 192 bits are ignored
+    std::array<byte, bytesSize - 1 + checksumSize> payload{};
+    uint32_t accumulator = 0;
+    auto bits = 0;
+    auto index = payload.size();
+    for (auto i = length; i > 2; --i) {
+        const auto digit = C32_DIGITS[static_cast<byte>(string[i - 1])];
+        if (digit == INVALID_DIGIT) {
+            return false;
+        }
+        accumulator |= static_cast<uint32_t>(digit) << bits;
+        bits += 5;
+        if (bits >= 8) {
+            if (index > 0) {
+                payload[--index] = static_cast<byte>(accumulator);
+            }
+            accumulator >>= 8;
+            bits -= 8;
+        }
     }
-    replace_all(normalise, "O", "0");
-    replace_all(normalise, "L", "1");
-    replace_all(normalise, "I", "1");
-    if ((normalise[0] != 'S') || !Base32::decode(normalise.substr(1), data, BASE32_ALPHABET_CROCKFORD)) {
-        return {};
+    if (bits > 0 && index > 0) {
+        payload[--index] = static_cast<byte>(accumulator);
     }
 
     // Verify that checksums match
-    data[0] >>= 3;
-    auto checksum = Hash::sha256(Hash::sha256(&data[0], bytesSize));
-    if (!std::equal(data.end() - checksumSize, data.end(), checksum.begin())) {
-	return {};
+    bytes[0] = version;
+    std::copy(payload.begin(), payload.begin() + bytesSize - 1, bytes.begin() + 1);
+    std::array<byte, checksumSize> expected;
+    checksum(bytes, expected.data());
+    return std::equal(expected.begin(), expected.end(), payload.end() - checksumSize);
+}
+
+size_t Address::encode(const std::array<byte, bytesSize>& bytes, char* out) {
+    std::array<byte, bytesSize - 1 + checksumSize> payload;
+    std::copy(bytes.begin() + 1, bytes.end(), payload.begin());
+    checksum(bytes, payload.data() + bytesSize - 1);
+
+    // Digits of the payload as a number, from the last one, into the end of a buffer
+    std::array<char, size> digits;
+    auto index = digits.size();
+    uint32_t accumulator = 0;
+    auto bits = 0;
+    for (auto i = payload.size(); i > 0; --i) {
+        accumulator |= static_cast<uint32_t>(payload[i - 1]) << bits;
+        bits += 8;
+        while (bits >= 5) {
+            digits[--index] = BASE32_ALPHABET_CROCKFORD[accumulator & 0x1f];
+            accumulator >>= 5;
+            bits -= 5;
+        }
     }
-    return Data(data.begin(), data.begin() + bytesSize);
+    if (bits > 0) {
+        digits[--index] = BASE32_ALPHABET_CROCKFORD[accumulator & 0x1f];
+    }
+    // no leading zero digits, but one '0' for each leading zero byte
+    while (index < digits.size() && digits[index] == '0') {
+        ++index;
+    }
+    for (size_t i = 0; i < payload.size() && !payload[i]; ++i) {
+        digits[--index] = '0';
+    }
+
+    out[0] = 'S';
+    out[1] = BASE32_ALPHABET_CROCKFORD[bytes[0] & 0x1f];
+    std::copy(digits.begin() + index, digits.end(), out + 2);
+    return 2 + digits.size() - index;
 }
 
 bool Address::isValid(const std::string& string, const std::vector<TW::byte>& validPrefixes) {
-    auto data = deconstruct(string);
-    return data.size() && (!validPrefixes.size() || std::find(validPrefixes.begin(), validPrefixes.end(), data[0]) != validPrefixes.end()); 
+    std::array<byte, bytesSize> bytes;
+    return decode(string, bytes) && (!validPrefixes.size() || std::find(validPrefixes.begin(), validPrefixes.end(), bytes[0]) != validPrefixes.end());
+}
+
+std::vector<bool> Address::isValidBulk(const std::vector<std::string>& strings, const std::vector<TW::byte>& validPrefixes) {
+    std::vector<bool> valid;
+    valid.reserve(strings.size());
+    for (const auto& string : strings) {
+        valid.push_back(isValid(string, validPrefixes));
+    }
+    return valid;
+}
+
+std::vector<std::string> Address::stringsBulk(const std::vector<PublicKey>& publicKeys, TW::byte prefix) {
+    std::vector<std::string> strings;
+    strings.reserve(publicKeys.size());
+    char buffer[size];
+    for (const auto& publicKey : publicKeys) {
+        const auto length = encode(Address(publicKey, prefix).bytes, buffer);
+        strings.emplace_back(buffer, length);
+    }
+    return strings;
 }
 
 Address::Address(const std::string& string) {
     // Ensure address is valid
-    auto data = deconstruct(string);
-    if (!data.size()) {
+    if (!decode(string, bytes)) {
         throw std::invalid_argument("Invalid address data");
     }
-    std::copy(data.begin(), data.end(), bytes.begin());
 }
 
 Address::Address(const PublicKey& publicKey, TW::byte prefix) {
@@ -69,16 +165,7 @@ Address::Address(const PublicKey& publicKey, TW::byte prefix) {
 }
 
 std::string Address::string() const {
-    static_assert((8 * (bytesSize + checksumSize)) % 5 == 0);
-    auto data = Data(bytes.begin(), bytes.end());
-    auto checksum = Hash::sha256(Hash::sha256(data));
-    data.insert(data.end(), checksum.begin(), checksum.begin() + checksumSize);
-    TW::byte prefix = data[0] << 3;
-    data[0] = 0;
-    auto encoded = Base32::encode(data, BASE32_ALPHABET_CROCKFORD);
-    encoded.erase(0, encoded.find_first_not_of('0'));
-    for (int i = 1; i < data.size() && !data[i]; i++) {
-       encoded.insert(0, "0");
-    }
-    return std::string("S") + Base32::encode({prefix}, BASE32_ALPHABET_CROCKFORD)[0] + encoded;
+    char buffer[size];
+    const auto length = encode(bytes, buffer);
+    return std::string(buffer, length);
 }
@@ -9,6 +9,7 @@
 #include "../Data.h"
 #include "../PublicKey.h"
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -27,7 +28,11 @@ class Address {
     // Size of checksum.
     static const size_t checksumSize = 4;
 
-    static TW::Data deconstruct(const std::string& string);
+    /// Decodes and verifies the checksum of a c32check address string, without allocating.
+    static bool decode(const std::string& string, std::array<byte, bytesSize>& bytes);
+
+    /// Encodes prefix and public key hash into out (at least size chars); returns the string length.
+    static size_t encode(const std::array<byte, bytesSize>& bytes, char* out);
 
   public:
     static const TW::byte VersionMainnetP2PKH = 22;
@@ -38,6 +43,12 @@ class Address {
     /// Determines whether a string makes a valid address.
     static bool isValid(const std::string& string, const std::vector<TW::byte>& validPrefixes = {});
 
+    /// Determines for each string whether it makes a valid address.
+    static std::vector<bool> isValidBulk(const std::vector<std::string>& strings, const std::vector<TW::byte>& validPrefixes = {});
+
+    /// Returns the address strings of the public keys.
+    static std::vector<std::string> stringsBulk(const std::vector<PublicKey>& publicKeys, TW::byte prefix = VersionMainnetP2PKH);
+
     /// Initializes a Stacks address with a string representation.
     explicit Address(const std::string& string);
 
@@ -13,12 +13,20 @@
 #include "../HexCoding.h"
 
 #include <algorithm>
+#include <optional>
 
 using namespace TW;
 using namespace TW::Stacks;
 
 static const auto PRIVATE_KEY_LENGTH = 32;
 
+static const auto COMPRESSED_PUBLIC_KEY_LENGTH = 33;
+static const auto UNCOMPRESSED_PUBLIC_KEY_LENGTH = 65;
+
+static const auto HASH160_LENGTH = 20;
+
+static const auto SIGHASH_LENGTH = 32;
+
 static const auto RECOVERABLE_ECSDA_SIG_LENGTH_BYTES = 65;
 
 static const auto MEMO_MAX_LENGTH_BYTES = 34;
@@ -28,15 +36,67 @@ static const auto MAINNET_TRANSACTION_VERSION = 0x00;
 static const auto MAINNET_CHAIN_ID = 0x01;
 
 static const auto ADDRESSHASHMODE_SERIALIZEP2PKH = 0x00;
+static const auto ADDRESSHASHMODE_SERIALIZEP2SH = 0x01;
+static const auto ADDRESSHASHMODE_SERIALIZEP2WSH = 0x03;
 
 static const auto AUTHTYPE_STANDARD = 0x04;
-
+static const auto AUTHTYPE_SPONSORED = 0x05;
+
+static const auto AUTHFIELD_PUBLICKEY_COMPRESSED = 0x00;
+static const auto AUTHFIELD_PUBLICKEY_UNCOMPRESSED = 0x01;
+static const auto AUTHFIELD_SIGNATURE_COMPRESSED = 0x02;
+static const auto AUTHFIELD_SIGNATURE_UNCOMPRESSED = 0x03;
+
+static const auto CLARITYTYPE_INT = 0x00;
+static const auto CLARITYTYPE_UINT = 0x01;
+static const auto CLARITYTYPE_BUFFER = 0x02;
+static const auto CLARITYTYPE_BOOLTRUE = 0x03;
+static const auto CLARITYTYPE_BOOLFALSE = 0x04;
 static const auto CLARITYTYPE_PRINCIPALSTANDARD = 0x05;
+static const auto CLARITYTYPE_PRINCIPALCONTRACT = 0x06;
+static const auto CLARITYTYPE_RESPONSEOK = 0x07;
+static const auto CLARITYTYPE_RESPONSEERR = 0x08;
+static const auto CLARITYTYPE_OPTIONALNONE = 0x09;
+static const auto CLARITYTYPE_OPTIONALSOME = 0x0a;
+static const auto CLARITYTYPE_LIST = 0x0b;
+static const auto CLARITYTYPE_TUPLE = 0x0c;
+static const auto CLARITYTYPE_STRINGASCII = 0x0d;
+static const auto CLARITYTYPE_STRINGUTF8 = 0x0e;
+
+static const auto CLARITY_INT_LENGTH_BYTES = 16;
+
+static const auto CLARITY_NAME_MAX_LENGTH_BYTES = 128;
+
+static const auto ASSET_NAME_MAX_LENGTH_BYTES = 32;
 
 static const auto PAYLOADTYPE_TOKENTRANSFER = 0x00;
+static const auto PAYLOADTYPE_CONTRACTCALL = 0x02;
 
+static const auto POSTCONDITIONMODE_ALLOW = 0x01;
 static const auto POSTCONDITIONMODE_DENY = 0x02;
 
+static const auto POSTCONDITIONTYPE_STX = 0x00;
+static const auto POSTCONDITIONTYPE_FUNGIBLE = 0x01;
+static const auto POSTCONDITIONTYPE_NONFUNGIBLE = 0x02;
+
+static const auto POSTCONDITIONPRINCIPAL_ORIGIN = 0x01;
+static const auto POSTCONDITIONPRINCIPAL_STANDARD = 0x02;
+static const auto POSTCONDITIONPRINCIPAL_CONTRACT = 0x03;
+
+static const auto FUNGIBLECONDITIONCODE = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const auto NONFUNGIBLECONDITIONCODE = { 0x10, 0x11 };
+
+// Offsets in the serialized transaction: version, chain id, auth type, then the origin spending condition
+static const auto AUTHTYPE_OFFSET = 1 + 4;
+static const auto ORIGIN_CONDITION_OFFSET = AUTHTYPE_OFFSET + 1;
+
+// Offsets in a serialized spending condition: hash mode, signer, nonce, fee, then
+// key encoding and signature (single-sig), or auth fields and signatures required (multisig)
+static const auto CONDITION_NONCE_OFFSET = 1 + HASH160_LENGTH;
+static const auto CONDITION_FEE_OFFSET = CONDITION_NONCE_OFFSET + 8;
+static const auto CONDITION_FIELDS_OFFSET = CONDITION_FEE_OFFSET + 8;
+static const auto SINGLESIG_CONDITION_SIZE = CONDITION_FIELDS_OFFSET + 1 + RECOVERABLE_ECSDA_SIG_LENGTH_BYTES;
+
 static const auto PUBKEYENCODING_COMPRESSED = 0x00;
 static const auto PUBKEYENCODING_UNCOMPRESSED = 0x01;
 
@@ -57,19 +117,39 @@ static void serialize(Data& data, const Proto::SingleSigSpendingCondition& spend
     serialize(data, spending.signature());
 }
 
+static void serialize(Data& data, const Proto::MultisigSpendingCondition& spending) {
+    data.push_back(spending.hashmode());
+    auto signer = spending.signer();
+    data.insert(data.end(), signer.begin(), signer.end());
+    encode64BE(spending.nonce(), data);
+    encode64BE(spending.fee(), data);
+    encode32BE(static_cast<uint32_t>(spending.fields_size()), data);
+    for (const auto& field : spending.fields()) {
+        data.push_back(static_cast<byte>(field.fieldid()));
+        data.insert(data.end(), field.data().begin(), field.data().end());
+    }
+    encode16BE(static_cast<uint16_t>(spending.signaturesrequired()), data);
+}
+
 static void serialize(Data& data, const Proto::SpendingCondition& spending) {
-    if (!spending.has_single()) {
+    if (spending.has_single()) {
+        serialize(data, spending.single());
+    } else if (spending.has_multisig()) {
+        serialize(data, spending.multisig());
+    } else {
         throw std::invalid_argument("Invalid spending condition"); 
     }
-    serialize(data, spending.single());
 }
 
 static void serialize(Data& data, const Proto::Authorization& auth) {
-    if (auth.authtype() != AUTHTYPE_STANDARD) {
+    if (auth.authtype() != AUTHTYPE_STANDARD && auth.authtype() != AUTHTYPE_SPONSORED) {
         throw std::invalid_argument("Invalid authorization type");
     }
     data.push_back(auth.authtype());
     serialize(data, auth.spendingcondition());
+    if (auth.authtype() == AUTHTYPE_SPONSORED) {
+        serialize(data, auth.sponsorspendingcondition());
+    }
 }
 
 static void serialize(Data& data, const Proto::Address& addr) {
@@ -78,16 +158,158 @@ static void serialize(Data& data, const Proto::Address& addr) {
     data.insert(data.end(), hash.begin(), hash.end());
 }
 
+// Unset (0) lengthPrefixBytes and maxLengthBytes default to a 1-byte prefix and the given maximum length.
+static void serialize(Data& data, const Proto::LengthPrefixedString& string,
+                      uint32_t defaultMaxLengthBytes = CLARITY_NAME_MAX_LENGTH_BYTES) {
+    const auto& content = string.content();
+    const auto maxLengthBytes = string.maxlengthbytes() != 0 ? string.maxlengthbytes() : defaultMaxLengthBytes;
+    if (content.size() > maxLengthBytes) {
+        throw std::invalid_argument("Invalid length for string");
+    }
+    switch (string.lengthprefixbytes() != 0 ? string.lengthprefixbytes() : 1) {
+        case 1:
+            data.push_back(static_cast<byte>(content.size()));
+            break;
+        case 4:
+            encode32BE(static_cast<uint32_t>(content.size()), data);
+            break;
+        default:
+            throw std::invalid_argument("Invalid length prefix for string");
+    }
+    data.insert(data.end(), content.begin(), content.end());
+}
+
 static void serialize(Data& data, const Proto::StandardPrincipalCV& cv) {
     data.push_back(CLARITYTYPE_PRINCIPALSTANDARD);
     serialize(data, cv.address());
 }
 
+static void serialize(Data& data, const Proto::ContractPrincipalCV& cv) {
+    data.push_back(CLARITYTYPE_PRINCIPALCONTRACT);
+    serialize(data, cv.address());
+    serialize(data, cv.contractname());
+}
+
 static void serialize(Data& data, const Proto::PrincipalCV& cv) {
-    if (!cv.has_standard()) {
+    if (cv.has_standard()) {
+        serialize(data, cv.standard());
+    } else if (cv.has_contract()) {
+        serialize(data, cv.contract());
+    } else {
         throw std::invalid_argument("Invalid principal");
     }
-    serialize(data, cv.standard());
+}
+
+/// Clarity names (tuple keys) are length prefixed with one byte
+static void serializeClarityName(Data& data, const std::string& name) {
+    if (name.empty() || name.size() > CLARITY_NAME_MAX_LENGTH_BYTES) {
+        throw std::invalid_argument("Invalid clarity name");
+    }
+    data.push_back(static_cast<byte>(name.size()));
+    data.insert(data.end(), name.begin(), name.end());
+}
+
+/// 128-bit integers are serialized as 16 big-endian bytes; shorter input is extended (with sign for int)
+static void serializeInt128(Data& data, const std::string& value, bool isSigned) {
+    if (value.size() > CLARITY_INT_LENGTH_BYTES) {
+        throw std::invalid_argument("Invalid length for integer");
+    }
+    const auto negative = isSigned && !value.empty() && (static_cast<byte>(value[0]) & 0x80) != 0;
+    data.insert(data.end(), CLARITY_INT_LENGTH_BYTES - value.size(), negative ? 0xff : 0x00);
+    data.insert(data.end(), value.begin(), value.end());
+}
+
+static void serialize(Data& data, const Proto::ClarityValue& cv);
+
+static void serialize(Data& data, const Proto::TupleCV& cv) {
+    // entries are serialized in name order
+    std::vector<const Proto::TupleCVEntry*> entries;
+    entries.reserve(cv.entries_size());
+    for (const auto& entry : cv.entries()) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](auto lhs, auto rhs) { return lhs->name() < rhs->name(); });
+    for (size_t i = 1; i < entries.size(); ++i) {
+        if (entries[i - 1]->name() == entries[i]->name()) {
+            throw std::invalid_argument("Duplicate tuple entry name");
+        }
+    }
+    data.push_back(CLARITYTYPE_TUPLE);
+    encode32BE(static_cast<uint32_t>(entries.size()), data);
+    for (auto entry : entries) {
+        serializeClarityName(data, entry->name());
+        serialize(data, entry->value());
+    }
+}
+
+static void serialize(Data& data, const Proto::ClarityValue& cv) {
+    switch (cv.cv_oneof_case()) {
+        case Proto::ClarityValue::kIntCV:
+            data.push_back(CLARITYTYPE_INT);
+            serializeInt128(data, cv.intcv().value(), true);
+            break;
+        case Proto::ClarityValue::kUintCV:
+            data.push_back(CLARITYTYPE_UINT);
+            serializeInt128(data, cv.uintcv().value(), false);
+            break;
+        case Proto::ClarityValue::kBufferCV: {
+            const auto& buffer = cv.buffercv().data();
+            data.push_back(CLARITYTYPE_BUFFER);
+            encode32BE(static_cast<uint32_t>(buffer.size()), data);
+            data.insert(data.end(), buffer.begin(), buffer.end());
+            break;
+        }
+        case Proto::ClarityValue::kBoolCV:
+            data.push_back(cv.boolcv().value() ? CLARITYTYPE_BOOLTRUE : CLARITYTYPE_BOOLFALSE);
+            break;
+        case Proto::ClarityValue::kPrincipalCV:
+            serialize(data, cv.principalcv());
+            break;
+        case Proto::ClarityValue::kResponseCV:
+            data.push_back(cv.responsecv().ok() ? CLARITYTYPE_RESPONSEOK : CLARITYTYPE_RESPONSEERR);
+            if (!cv.responsecv().has_value()) {
+                throw std::invalid_argument("Invalid response value");
+            }
+            serialize(data, cv.responsecv().value());
+            break;
+        case Proto::ClarityValue::kOptionalCV:
+            if (!cv.optionalcv().has_value()) {
+                data.push_back(CLARITYTYPE_OPTIONALNONE);
+            } else {
+                data.push_back(CLARITYTYPE_OPTIONALSOME);
+                serialize(data, cv.optionalcv().value());
+            }
+            break;
+        case Proto::ClarityValue::kListCV:
+            data.push_back(CLARITYTYPE_LIST);
+            encode32BE(static_cast<uint32_t>(cv.listcv().values_size()), data);
+            for (const auto& value : cv.listcv().values()) {
+                serialize(data, value);
+            }
+            break;
+        case Proto::ClarityValue::kTupleCV:
+            serialize(data, cv.tuplecv());
+            break;
+        case Proto::ClarityValue::kStringAsciiCV: {
+            const auto& content = cv.stringasciicv().content();
+            if (std::any_of(content.begin(), content.end(), [](char c) { return static_cast<byte>(c) >= 0x80; })) {
+                throw std::invalid_argument("Invalid ascii string");
+            }
+            data.push_back(CLARITYTYPE_STRINGASCII);
+            encode32BE(static_cast<uint32_t>(content.size()), data);
+            data.insert(data.end(), content.begin(), content.end());
+            break;
+        }
+        case Proto::ClarityValue::kStringUtf8CV: {
+            const auto& content = cv.stringutf8cv().content();
+            data.push_back(CLARITYTYPE_STRINGUTF8);
+            encode32BE(static_cast<uint32_t>(content.size()), data);
+            data.insert(data.end(), content.begin(), content.end());
+            break;
+        }
+        default:
+            throw std::invalid_argument("Invalid clarity value");
+    }
 }
 
 static void serialize(Data& data, const Proto::MemoString& memo) {
@@ -107,11 +329,74 @@ static void serialize(Data& data, const Proto::TokenTransferPayload& transfer) {
     serialize(data, transfer.memo());
 }
 
+static void serialize(Data& data, const Proto::ContractCallPayload& call) {
+    data.push_back(PAYLOADTYPE_CONTRACTCALL);
+    serialize(data, call.contractaddress());
+    serialize(data, call.contractname());
+    serialize(data, call.functionname());
+    encode32BE(static_cast<uint32_t>(call.functionargs_size()), data);
+    for (const auto& arg : call.functionargs()) {
+        serialize(data, arg);
+    }
+}
+
 static void serialize(Data& data, const Proto::Payload& payload) {
-    if (!payload.has_transfer()) {
+    if (payload.has_transfer()) {
+        serialize(data, payload.transfer());
+    } else if (payload.has_contractcall()) {
+        serialize(data, payload.contractcall());
+    } else {
         throw std::invalid_argument("Invalid payload");
     }
-    serialize(data, payload.transfer());
+}
+
+static void serialize(Data& data, const Proto::PostConditionPrincipal& principal) {
+    if (principal.has_standard()) {
+        data.push_back(POSTCONDITIONPRINCIPAL_STANDARD);
+        serialize(data, principal.standard().address());
+    } else if (principal.has_contract()) {
+        data.push_back(POSTCONDITIONPRINCIPAL_CONTRACT);
+        serialize(data, principal.contract().address());
+        serialize(data, principal.contract().contractname());
+    } else {
+        data.push_back(POSTCONDITIONPRINCIPAL_ORIGIN);
+    }
+}
+
+static void serialize(Data& data, const Proto::AssetInfo& asset) {
+    serialize(data, asset.address());
+    serialize(data, asset.contractname());
+    serialize(data, asset.assetname(), ASSET_NAME_MAX_LENGTH_BYTES);
+}
+
+static void serializeConditionCode(Data& data, uint32_t code, const std::initializer_list<int>& validCodes) {
+    if (std::find(validCodes.begin(), validCodes.end(), code) == validCodes.end()) {
+        throw std::invalid_argument("Invalid post-condition code");
+    }
+    data.push_back(static_cast<byte>(code));
+}
+
+static void serialize(Data& data, const Proto::PostCondition& condition) {
+    if (condition.has_stx()) {
+        data.push_back(POSTCONDITIONTYPE_STX);
+        serialize(data, condition.stx().principal());
+        serializeConditionCode(data, condition.stx().conditioncode(), FUNGIBLECONDITIONCODE);
+        encode64BE(condition.stx().amount(), data);
+    } else if (condition.has_fungible()) {
+        data.push_back(POSTCONDITIONTYPE_FUNGIBLE);
+        serialize(data, condition.fungible().principal());
+        serialize(data, condition.fungible().asset());
+        serializeConditionCode(data, condition.fungible().conditioncode(), FUNGIBLECONDITIONCODE);
+        encode64BE(condition.fungible().amount(), data);
+    } else if (condition.has_nonfungible()) {
+        data.push_back(POSTCONDITIONTYPE_NONFUNGIBLE);
+        serialize(data, condition.nonfungible().principal());
+        serialize(data, condition.nonfungible().asset());
+        serialize(data, condition.nonfungible().assetname());
+        serializeConditionCode(data, condition.nonfungible().conditioncode(), NONFUNGIBLECONDITIONCODE);
+    } else {
+        throw std::invalid_argument("Invalid post-condition");
+    }
 }
 
 static void serialize(Data& data, const Proto::StacksTransaction& transaction) {
@@ -119,17 +404,18 @@ static void serialize(Data& data, const Proto::StacksTransaction& transaction) {
     encode32BE(transaction.chainid(), data);
     serialize(data, transaction.auth());
     data.push_back(transaction.anchormode());
-    data.push_back(POSTCONDITIONMODE_DENY);
-    encode32BE(0, data); // no items in post-condition list
+    data.push_back(transaction.postconditionmode());
+    encode32BE(static_cast<uint32_t>(transaction.postconditions_size()), data);
+    for (const auto& condition : transaction.postconditions()) {
+        serialize(data, condition);
+    }
     serialize(data, transaction.payload());
 }
 
 std::tuple<Data, std::string> Signer::sign() const noexcept {
     try {
-        Data encoded;
-        auto tx = generate();
-        serialize(encoded, sign(tx));
-        return std::make_tuple(encoded, "");    
+        auto [encoded, _] = signWithSigHash();
+        return std::make_tuple(encoded, "");
     }
     catch (std::exception& ex) {
         return std::make_tuple(Data(), std::string(ex.what()));
@@ -139,46 +425,126 @@ std::tuple<Data, std::string> Signer::sign() const noexcept {
 Proto::SigningOutput Signer::sign(const Proto::SigningInput& input) noexcept {
     auto signer = Signer(input);
     auto output = Proto::SigningOutput();
-    auto [encoded, error] = signer.sign();
-    output.set_encoded(&encoded[0], encoded.size());
-    output.set_error(error);
+    try {
+        auto [encoded, sigHash] = signer.signWithSigHash();
+        output.set_encoded(encoded.data(), encoded.size());
+        output.set_sighash(sigHash.data(), sigHash.size());
+    }
+    catch (std::exception& ex) {
+        output.set_error(ex.what());
+    }
     return output;
 }
 
-std::tuple<PrivateKey, TWPublicKeyType> Signer::senderKey() const {
-    auto senderKey = input.senderkey();
+Data Signer::serializeClarityValue(const Proto::ClarityValue& value) {
+    Data data;
+    serialize(data, value);
+    return data;
+}
+
+static std::tuple<PrivateKey, TWPublicKeyType> parseKey(std::string key) {
     auto keyType = TWPublicKeyTypeSECP256k1Extended;
-    if ((senderKey.size() == (PRIVATE_KEY_LENGTH + 1)) && (senderKey.back() == 0x01)) {
+    if ((key.size() == (PRIVATE_KEY_LENGTH + 1)) && (key.back() == 0x01)) {
         keyType = TWPublicKeyTypeSECP256k1;
-        senderKey.pop_back();
+        key.pop_back();
     }
-    else if (senderKey.size() != PRIVATE_KEY_LENGTH) {
-        throw std::invalid_argument("Invalid private key format"); 
+    else if (key.size() != PRIVATE_KEY_LENGTH) {
+        throw std::invalid_argument("Invalid private key format");
     }
-    return std::make_tuple(PrivateKey(senderKey), keyType);
+    return std::make_tuple(PrivateKey(key), keyType);
+}
+
+std::tuple<PrivateKey, TWPublicKeyType> Signer::senderKey() const {
+    return parseKey(input.senderkey());
+}
+
+/// Hash160 of the multisig redeem script: OP_m <public keys> OP_n OP_CHECKMULTISIG
+static Data multisigSigner(const Proto::MultisigOptions& multisig) {
+    const auto count = multisig.publickeys_size();
+    if (count < 1 || count > 16 || multisig.signaturesrequired() < 1 || multisig.signaturesrequired() > static_cast<uint32_t>(count)) {
+        throw std::invalid_argument("Invalid multisig options");
+    }
+    Data script;
+    script.push_back(static_cast<byte>(0x50 + multisig.signaturesrequired()));
+    for (const auto& publicKey : multisig.publickeys()) {
+        if (publicKey.size() != COMPRESSED_PUBLIC_KEY_LENGTH) {
+            throw std::invalid_argument("Invalid multisig public key");
+        }
+        script.push_back(static_cast<byte>(publicKey.size()));
+        script.insert(script.end(), publicKey.begin(), publicKey.end());
+    }
+    script.push_back(static_cast<byte>(0x50 + count));
+    script.push_back(0xae); // OP_CHECKMULTISIG
+    return Hash::sha256ripemd(script.data(), script.size());
+}
+
+static void setSingleSigSpendingCondition(Proto::SingleSigSpendingCondition& spending, const Data& signer,
+                                          int64_t fee, int64_t nonce, uint32_t keyEncoding) {
+    spending.set_hashmode(ADDRESSHASHMODE_SERIALIZEP2PKH);
+    spending.set_signer(signer.data(), signer.size());
+    spending.set_nonce(nonce);
+    spending.set_fee(fee);
+    spending.set_keyencoding(keyEncoding);
+    // empty signature, filled in when signing
+    spending.mutable_signature()->set_data(std::string(RECOVERABLE_ECSDA_SIG_LENGTH_BYTES, 0x00));
+}
+
+static void setLengthPrefixedString(Proto::LengthPrefixedString& string, const std::string& content) {
+    string.set_content(content);
+    string.set_lengthprefixbytes(1);
+    string.set_maxlengthbytes(CLARITY_NAME_MAX_LENGTH_BYTES);
+}
+
+void Signer::setAuthorization(Proto::StacksTransaction& tx, int64_t fee, int64_t nonce, uint32_t anchorMode, bool sponsored) const {
+    tx.set_version(MAINNET_TRANSACTION_VERSION);
+    tx.set_chainid(MAINNET_CHAIN_ID);
+    if (std::find(ANCHORMODE.begin(), ANCHORMODE.end(), anchorMode) == ANCHORMODE.end()) {
+        throw std::invalid_argument("Invalid anchor mode");
+    }
+    tx.set_anchormode(anchorMode);
+    auto auth = tx.mutable_auth();
+    auth->set_authtype(sponsored ? AUTHTYPE_SPONSORED : AUTHTYPE_STANDARD);
+    if (input.has_multisig()) {
+        auto signer = multisigSigner(input.multisig());
+        auto spending = auth->mutable_spendingcondition()->mutable_multisig();
+        spending->set_hashmode(ADDRESSHASHMODE_SERIALIZEP2SH);
+        spending->set_signer(signer.data(), signer.size());
+        spending->set_nonce(nonce);
+        spending->set_fee(fee);
+        // no auth fields, filled in when signing
+        spending->set_signaturesrequired(input.multisig().signaturesrequired());
+    } else {
+        auto[key, keyType] = senderKey();
+        auto senderAddress = Address(key.getPublicKey(keyType));
+        setSingleSigSpendingCondition(*auth->mutable_spendingcondition()->mutable_single(),
+                                      Data(senderAddress.bytes.begin() + 1, senderAddress.bytes.end()), fee, nonce,
+                                      keyType == TWPublicKeyTypeSECP256k1 ? PUBKEYENCODING_COMPRESSED : PUBKEYENCODING_UNCOMPRESSED);
+    }
+    if (sponsored) {
+        // the sponsor is not known when the origin signs, the initial sighash uses an empty sponsor spending condition
+        setSingleSigSpendingCondition(*auth->mutable_sponsorspendingcondition()->mutable_single(),
+                                      Data(HASH160_LENGTH, 0), 0, 0, PUBKEYENCODING_COMPRESSED);
+    }
+}
+
+static void setPostConditions(Proto::StacksTransaction& tx, uint32_t mode,
+                              const google::protobuf::RepeatedPtrField<Proto::PostCondition>& conditions) {
+    if (mode == 0) {
+        mode = POSTCONDITIONMODE_DENY;
+    } else if (mode != POSTCONDITIONMODE_ALLOW && mode != POSTCONDITIONMODE_DENY) {
+        throw std::invalid_argument("Invalid post-condition mode");
+    }
+    tx.set_postconditionmode(mode);
+    *tx.mutable_postconditions() = conditions;
 }
 
 Proto::StacksTransaction Signer::generate() const {
     Proto::StacksTransaction tx;
     if (input.has_tokentransfer()) {
         auto tokenTransfer = input.tokentransfer();
-        auto[key, keyType] = senderKey();
-        auto senderAddress = Address(key.getPublicKey(keyType));
         auto recipientAddress = Address(tokenTransfer.recipient());
-        tx.set_version(MAINNET_TRANSACTION_VERSION);
-        tx.set_chainid(MAINNET_CHAIN_ID);
-        if (std::find(ANCHORMODE.begin(), ANCHORMODE.end(), tokenTransfer.anchormode()) == ANCHORMODE.end()) {
-            throw std::invalid_argument("Invalid anchor mode");
-        }
-        tx.set_anchormode(tokenTransfer.anchormode());
-        auto auth = tx.mutable_auth();
-        auth->set_authtype(AUTHTYPE_STANDARD);
-        auto spending = auth->mutable_spendingcondition()->mutable_single();
-        spending->set_hashmode(ADDRESSHASHMODE_SERIALIZEP2PKH);
-        spending->set_signer(&senderAddress.bytes[1], senderAddress.bytes.size() - 1);
-        spending->set_nonce(tokenTransfer.nonce());
-        spending->set_fee(tokenTransfer.fee());
-        spending->set_keyencoding(keyType == TWPublicKeyTypeSECP256k1 ? PUBKEYENCODING_COMPRESSED : PUBKEYENCODING_UNCOMPRESSED);
+        setAuthorization(tx, tokenTransfer.fee(), tokenTransfer.nonce(), tokenTransfer.anchormode(), tokenTransfer.sponsored());
+        setPostConditions(tx, tokenTransfer.postconditionmode(), tokenTransfer.postconditions());
         auto transfer = tx.mutable_payload()->mutable_transfer();
         transfer->set_payloadtype(PAYLOADTYPE_TOKENTRANSFER);
         transfer->set_amount(tokenTransfer.amount());
@@ -188,37 +554,243 @@ Proto::StacksTransaction Signer::generate() const {
         auto memo = transfer->mutable_memo();
         memo->set_content(tokenTransfer.memo());
     }
+    else if (input.has_contractcall()) {
+        const auto& contractCall = input.contractcall();
+        auto contractAddress = Address(contractCall.contractaddress());
+        setAuthorization(tx, contractCall.fee(), contractCall.nonce(), contractCall.anchormode(), contractCall.sponsored());
+        setPostConditions(tx, contractCall.postconditionmode(), contractCall.postconditions());
+        auto call = tx.mutable_payload()->mutable_contractcall();
+        call->set_payloadtype(PAYLOADTYPE_CONTRACTCALL);
+        auto address = call->mutable_contractaddress();
+        address->set_version(contractAddress.bytes[0]);
+        address->set_hash160(&contractAddress.bytes[1], contractAddress.bytes.size() - 1);
+        setLengthPrefixedString(*call->mutable_contractname(), contractCall.contractname());
+        setLengthPrefixedString(*call->mutable_functionname(), contractCall.functionname());
+        *call->mutable_functionargs() = contractCall.functionargs();
+    }
     else {
         throw std::invalid_argument("Invalid input type");
     }
     return tx;
 }
 
-Proto::StacksTransaction& Signer::sign(Proto::StacksTransaction& tx) const {
-    auto copyTx(tx);
-    auto auth = copyTx.mutable_auth();
-    if ((auth->authtype() == AUTHTYPE_STANDARD) && auth->spendingcondition().has_single()) {
-        auto spending = auth->mutable_spendingcondition()->mutable_single();
-        spending->set_nonce(0);
-        spending->set_fee(0);
-        spending->mutable_signature()->set_data(std::string(RECOVERABLE_ECSDA_SIG_LENGTH_BYTES, 0x00));
-        Data encoded;
-        serialize(encoded, copyTx);
-        auto sigHash = Hash::sha512_256(encoded);
-        sigHash.push_back(AUTHTYPE_STANDARD);
-        encode64BE(tx.auth().spendingcondition().single().fee(), sigHash);
-        encode64BE(tx.auth().spendingcondition().single().nonce(), sigHash);
-        sigHash = Hash::sha512_256(sigHash);
-        auto [key, _] = senderKey();
-        auto signature = key.sign(sigHash, TWCurveSECP256k1);
-        signature.insert(signature.begin(), signature.back());
-        signature.pop_back();
-        spending = tx.mutable_auth()->mutable_spendingcondition()->mutable_single();    
-        spending->mutable_signature()->set_data(&signature[0], signature.size());
+static void checkSize(const Data& encoded, size_t size) {
+    if (encoded.size() < size) {
+        throw std::invalid_argument("Invalid partially signed transaction");
     }
-    else {
-        throw std::invalid_argument("Invalid signing type");
+}
+
+static bool isMultisig(byte hashMode) {
+    return hashMode == ADDRESSHASHMODE_SERIALIZEP2SH || hashMode == ADDRESSHASHMODE_SERIALIZEP2WSH;
+}
+
+/// Returns the offset after the auth fields of the multisig spending condition at the given offset,
+/// and the number of auth fields and of signatures among them.
+static std::tuple<size_t, uint32_t, uint32_t> multisigFields(const Data& encoded, size_t offset) {
+    checkSize(encoded, offset + CONDITION_FIELDS_OFFSET + 4);
+    const auto count = decode32BE(&encoded[offset + CONDITION_FIELDS_OFFSET]);
+    auto index = offset + CONDITION_FIELDS_OFFSET + 4;
+    uint32_t signatures = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        checkSize(encoded, index + 1);
+        switch (encoded[index]) {
+            case AUTHFIELD_PUBLICKEY_COMPRESSED:
+                index += 1 + COMPRESSED_PUBLIC_KEY_LENGTH;
+                break;
+            case AUTHFIELD_PUBLICKEY_UNCOMPRESSED:
+                index += 1 + UNCOMPRESSED_PUBLIC_KEY_LENGTH;
+                break;
+            case AUTHFIELD_SIGNATURE_COMPRESSED:
+            case AUTHFIELD_SIGNATURE_UNCOMPRESSED:
+                index += 1 + RECOVERABLE_ECSDA_SIG_LENGTH_BYTES;
+                ++signatures;
+                break;
+            default:
+                throw std::invalid_argument("Invalid partially signed transaction");
+        }
     }
-    return tx;
+    checkSize(encoded, index + 2);
+    return std::make_tuple(index, count, signatures);
+}
+
+/// Size of the serialized spending condition at the given offset
+static size_t spendingConditionSize(const Data& encoded, size_t offset) {
+    checkSize(encoded, offset + 1);
+    if (!isMultisig(encoded[offset])) {
+        checkSize(encoded, offset + SINGLESIG_CONDITION_SIZE);
+        return SINGLESIG_CONDITION_SIZE;
+    }
+    auto [fieldsEnd, count, signatures] = multisigFields(encoded, offset);
+    return fieldsEnd + 2 - offset;
+}
+
+/// Initial sighash: hash of the transaction with cleared origin nonce and fee, no signatures, and empty sponsor.
+/// The transaction is not signed yet, so only nonce and fee are cleared in place, and restored after hashing.
+static Data initialSigHash(Data& encoded) {
+    const auto begin = encoded.begin() + ORIGIN_CONDITION_OFFSET + CONDITION_NONCE_OFFSET;
+    const auto end = encoded.begin() + ORIGIN_CONDITION_OFFSET + CONDITION_FIELDS_OFFSET;
+    const Data nonceAndFee(begin, end);
+    std::fill(begin, end, 0);
+    auto sigHash = Hash::sha512_256(encoded);
+    std::copy(nonceAndFee.begin(), nonceAndFee.end(), begin);
+    return sigHash;
+}
+
+/// Sighash to sign, continuing the chain: the previous sighash, auth type, fee and nonce of the spending condition
+static Data presignSigHash(const Data& sigHash, byte authType, const Data& encoded, size_t conditionOffset) {
+    auto presign = sigHash;
+    presign.push_back(authType);
+    const auto fee = encoded.begin() + conditionOffset + CONDITION_FEE_OFFSET;
+    const auto nonce = encoded.begin() + conditionOffset + CONDITION_NONCE_OFFSET;
+    presign.insert(presign.end(), fee, fee + 8);
+    presign.insert(presign.end(), nonce, nonce + 8);
+    return Hash::sha512_256(presign);
+}
+
+/// Sighash after a signature, the start of the chain for the next signature
+static Data postsignSigHash(const Data& presign, byte keyEncoding, const Data& signature) {
+    auto postsign = presign;
+    postsign.push_back(keyEncoding);
+    postsign.insert(postsign.end(), signature.begin(), signature.end());
+    return Hash::sha512_256(postsign);
+}
+
+/// Recoverable signature, with the recovery id first
+static Data signRecoverable(const PrivateKey& key, const Data& hash) {
+    auto signature = key.sign(hash, TWCurveSECP256k1);
+    signature.insert(signature.begin(), signature.back());
+    signature.pop_back();
+    return signature;
 }
 
+Data Signer::signSingleSig(Data& encoded, Data sigHash, size_t offset, byte authType) const {
+    auto [key, _] = senderKey();
+    const auto presign = presignSigHash(sigHash, authType, encoded, offset);
+    const auto signature = signRecoverable(key, presign);
+    std::copy(signature.begin(), signature.end(), encoded.begin() + offset + CONDITION_FIELDS_OFFSET + 1);
+    return postsignSigHash(presign, encoded[offset + CONDITION_FIELDS_OFFSET], signature);
+}
+
+Data Signer::signMultisig(Data& encoded, Data sigHash) const {
+    const auto& multisig = input.multisig();
+    const auto offset = ORIGIN_CONDITION_OFFSET;
+    const auto signer = multisigSigner(multisig);
+    if (!std::equal(signer.begin(), signer.end(), encoded.begin() + offset + 1)) {
+        throw std::invalid_argument("Invalid multisig public keys");
+    }
+    auto [fieldsEnd, count, signatures] = multisigFields(encoded, offset);
+    if (decode16BE(&encoded[fieldsEnd]) != multisig.signaturesrequired()) {
+        throw std::invalid_argument("Invalid multisig options");
+    }
+
+    // signing keys, by participant index
+    std::vector<std::optional<PrivateKey>> keys(multisig.publickeys_size());
+    for (const auto& privateKey : multisig.privatekeys()) {
+        const auto key = std::get<0>(parseKey(privateKey));
+        const auto publicKey = key.getPublicKey(TWPublicKeyTypeSECP256k1).bytes;
+        const auto it = std::find_if(multisig.publickeys().begin(), multisig.publickeys().end(), [&](const auto& p) {
+            return Data(p.begin(), p.end()) == publicKey;
+        });
+        const auto index = std::distance(multisig.publickeys().begin(), it);
+        if (it == multisig.publickeys().end() || index < count) {
+            throw std::invalid_argument("Invalid multisig private key");
+        }
+        keys[index] = key;
+    }
+
+    // Append auth fields in participant order: a signature for the signing keys, the public key of the others.
+    // After the last signing key, public keys are only appended once enough signatures are present.
+    const auto lastSigner = std::find_if(keys.rbegin(), keys.rend(), [](const auto& key) { return key.has_value(); });
+    const auto end = std::max(static_cast<size_t>(count), signatures + multisig.privatekeys_size() >= multisig.signaturesrequired()
+        ? keys.size() : static_cast<size_t>(std::distance(lastSigner, keys.rend())));
+    Data fields;
+    for (auto index = static_cast<size_t>(count); index < end; ++index) {
+        if (keys[index].has_value()) {
+            const auto presign = presignSigHash(sigHash, AUTHTYPE_STANDARD, encoded, offset);
+            const auto signature = signRecoverable(keys[index].value(), presign);
+            fields.push_back(AUTHFIELD_SIGNATURE_COMPRESSED);
+            fields.insert(fields.end(), signature.begin(), signature.end());
+            sigHash = postsignSigHash(presign, PUBKEYENCODING_COMPRESSED, signature);
+        } else {
+            const auto& publicKey = multisig.publickeys(static_cast<int>(index));
+            fields.push_back(AUTHFIELD_PUBLICKEY_COMPRESSED);
+            fields.insert(fields.end(), publicKey.begin(), publicKey.end());
+        }
+    }
+    // appended at once, the rest of the transaction is moved only once
+    encoded.insert(encoded.begin() + fieldsEnd, fields.begin(), fields.end());
+    Data newCount;
+    encode32BE(static_cast<uint32_t>(end), newCount);
+    std::copy(newCount.begin(), newCount.end(), encoded.begin() + offset + CONDITION_FIELDS_OFFSET);
+    return sigHash;
+}
+
+Data Signer::signSponsor(Data& encoded, Data sigHash) const {
+    checkSize(encoded, ORIGIN_CONDITION_OFFSET);
+    if (encoded[AUTHTYPE_OFFSET] != AUTHTYPE_SPONSORED) {
+        throw std::invalid_argument("Transaction is not sponsored");
+    }
+    const auto originSize = spendingConditionSize(encoded, ORIGIN_CONDITION_OFFSET);
+    if (isMultisig(encoded[ORIGIN_CONDITION_OFFSET])) {
+        auto [fieldsEnd, count, signatures] = multisigFields(encoded, ORIGIN_CONDITION_OFFSET);
+        if (signatures < decode16BE(&encoded[fieldsEnd])) {
+            throw std::invalid_argument("Origin is not fully signed");
+        }
+    }
+    const auto offset = ORIGIN_CONDITION_OFFSET + originSize;
+    const auto sponsorSize = spendingConditionSize(encoded, offset);
+
+    // replace the empty sponsor spending condition
+    auto [key, keyType] = senderKey();
+    auto sponsorAddress = Address(key.getPublicKey(keyType));
+    Proto::SingleSigSpendingCondition spending;
+    setSingleSigSpendingCondition(spending, Data(sponsorAddress.bytes.begin() + 1, sponsorAddress.bytes.end()),
+                                  input.sponsor().fee(), input.sponsor().nonce(),
+                                  keyType == TWPublicKeyTypeSECP256k1 ? PUBKEYENCODING_COMPRESSED : PUBKEYENCODING_UNCOMPRESSED);
+    Data condition;
+    serialize(condition, spending);
+    encoded.erase(encoded.begin() + offset, encoded.begin() + offset + sponsorSize);
+    encoded.insert(encoded.begin() + offset, condition.begin(), condition.end());
+
+    return signSingleSig(encoded, sigHash, offset, AUTHTYPE_SPONSORED);
+}
+
+std::tuple<Data, Data> Signer::signWithSigHash() const {
+    Data encoded;
+    Data sigHash;
+    if (input.has_partiallysigned()) {
+        // continue the sighash chain of the previous signers, no need to rehash the transaction
+        const auto& partial = input.partiallysigned();
+        encoded.assign(partial.encoded().begin(), partial.encoded().end());
+        sigHash.assign(partial.sighash().begin(), partial.sighash().end());
+        if (sigHash.size() != SIGHASH_LENGTH) {
+            throw std::invalid_argument("Invalid sighash");
+        }
+        if (!input.has_multisig() && !input.has_sponsor()) {
+            throw std::invalid_argument("Invalid input type");
+        }
+        checkSize(encoded, ORIGIN_CONDITION_OFFSET + CONDITION_FIELDS_OFFSET);
+        if (input.has_multisig()) {
+            if (!isMultisig(encoded[ORIGIN_CONDITION_OFFSET])) {
+                throw std::invalid_argument("Invalid signing type");
+            }
+            sigHash = signMultisig(encoded, sigHash);
+        }
+    } else {
+        auto tx = generate();
+        serialize(encoded, tx);
+        sigHash = initialSigHash(encoded);
+        if (input.has_multisig()) {
+            sigHash = signMultisig(encoded, sigHash);
+        } else {
+            sigHash = signSingleSig(encoded, sigHash, ORIGIN_CONDITION_OFFSET, AUTHTYPE_STANDARD);
+        }
+    }
+    if (input.has_sponsor()) {
+        if (!input.has_partiallysigned()) {
+            throw std::invalid_argument("Sponsor signs a partially signed transaction");
+        }
+        sigHash = signSponsor(encoded, sigHash);
+    }
+    return std::make_tuple(encoded, sigHash);
+}
@@ -34,14 +34,29 @@ public:
     /// Signs a Proto::SigningInput transaction
     static Proto::SigningOutput sign(const Proto::SigningInput& input) noexcept;
 
+    /// Serializes a Clarity value, as in contract call arguments.  Public for testability.
+    static Data serializeClarityValue(const Proto::ClarityValue& value);
+
 private:
     Proto::SigningInput input;
 
     std::tuple<PrivateKey, TWPublicKeyType> senderKey() const;
 
+    void setAuthorization(Proto::StacksTransaction& tx, int64_t fee, int64_t nonce, uint32_t anchorMode, bool sponsored) const;
+
     Proto::StacksTransaction generate() const;
 
-    Proto::StacksTransaction& sign(Proto::StacksTransaction& tx) const;
+    /// Signs a new or partially signed transaction; returns the serialized transaction and the sighash after the last signature.
+    std::tuple<Data, Data> signWithSigHash() const;
+
+    /// Signs the single-sig spending condition at the given offset in place, continuing the sighash chain.  Returns the next sighash.
+    Data signSingleSig(Data& encoded, Data sigHash, size_t offset, byte authType) const;
+
+    /// Adds the multisig auth fields of the signing keys, and public keys of the others, to the origin spending condition.
+    Data signMultisig(Data& encoded, Data sigHash) const;
+
+    /// Fills in and signs the sponsor spending condition of a sponsored transaction, after the origin has signed.
+    Data signSponsor(Data& encoded, Data sigHash) const;
 };
 
 } // namespace TW::Stacks
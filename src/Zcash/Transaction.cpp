@@ -31,6 +31,11 @@ const std::array<byte, 4> Zcash::BlossomBranchID = {0x60, 0x0e, 0xb4, 0x2b};
 
 Data Transaction::getPreImage(const Bitcoin::Script& scriptCode, size_t index, enum TWBitcoinSigHashType hashType,
                               uint64_t amount) const {
+    return getPreImage(scriptCode, index, hashType, amount, getSigHashCache());
+}
+
+Data Transaction::getPreImage(const Bitcoin::Script& scriptCode, size_t index, enum TWBitcoinSigHashType hashType,
+                              uint64_t amount, const Bitcoin::SigHashCache& cache) const {
     assert(index < inputs.size());
 
     auto data = Data{};
@@ -43,8 +48,7 @@ Data Transaction::getPreImage(const Bitcoin::Script& scriptCode, size_t index, e
 
     // Input prevouts (none/all, depending on flags)
     if ((hashType & TWBitcoinSigHashTypeAnyoneCanPay) == 0) {
-        auto hashPrevouts = getPrevoutHash();
-        std::copy(std::begin(hashPrevouts), std::end(hashPrevouts), std::back_inserter(data));
+        append(data, cache.hashPrevouts);
     } else {
         std::fill_n(back_inserter(data), 32, 0);
     }
@@ -52,16 +56,14 @@ Data Transaction::getPreImage(const Bitcoin::Script& scriptCode, size_t index, e
     // Input nSequence (none/all, depending on flags)
     if ((hashType & TWBitcoinSigHashTypeAnyoneCanPay) == 0 &&
         !Bitcoin::hashTypeIsSingle(hashType) && !Bitcoin::hashTypeIsNone(hashType)) {
-        auto hashSequence = getSequenceHash();
-        std::copy(std::begin(hashSequence), std::end(hashSequence), std::back_inserter(data));
+        append(data, cache.hashSequence);
     } else {
         std::fill_n(back_inserter(data), 32, 0);
     }
 
     // Outputs (none/one/all, depending on flags)
     if (!Bitcoin::hashTypeIsSingle(hashType) && !Bitcoin::hashTypeIsNone(hashType)) {
-        auto hashOutputs = getOutputsHash();
-        copy(begin(hashOutputs), end(hashOutputs), back_inserter(data));
+        append(data, cache.hashOutputs);
     } else if (Bitcoin::hashTypeIsSingle(hashType) && index < outputs.size()) {
         auto outputData = Data{};
         outputs[index].encode(outputData);
@@ -136,6 +138,17 @@ Data Transaction::getOutputsHash() const {
     return hash;
 }
 
+Bitcoin::SigHashCache Transaction::getSigHashCache() const {
+    auto cache = Bitcoin::SigHashCache{};
+    cache.hashPrevouts = getPrevoutHash();
+    cache.hashSequence = getSequenceHash();
+    for (auto& output : outputs) {
+        output.encode(cache.outputs);
+    }
+    cache.hashOutputs = TW::Hash::blake2b(cache.outputs, 32, outputsHashPersonalization);
+    return cache;
+}
+
 Data Transaction::getJoinSplitsHash() const {
     Data vec(32, 0);
     return vec;
@@ -182,12 +195,18 @@ void Transaction::encode(Data& data) const {
 Data Transaction::getSignatureHash(const Bitcoin::Script& scriptCode, size_t index,
                                    enum TWBitcoinSigHashType hashType, uint64_t amount,
                                    Bitcoin::SignatureVersion version) const {
+    return getSignatureHash(scriptCode, index, hashType, amount, version, getSigHashCache());
+}
+
+Data Transaction::getSignatureHash(const Bitcoin::Script& scriptCode, size_t index,
+                                   enum TWBitcoinSigHashType hashType, uint64_t amount,
+                                   Bitcoin::SignatureVersion version, const Bitcoin::SigHashCache& cache) const {
     Data personalization;
     personalization.reserve(16);
     std::copy(sigHashPersonalization.begin(), sigHashPersonalization.begin() + 12,
               std::back_inserter(personalization));
     std::copy(branchId.begin(), branchId.end(), std::back_inserter(personalization));
-    auto preimage = getPreImage(scriptCode, index, hashType, amount);
+    auto preimage = getPreImage(scriptCode, index, hashType, amount, cache);
     auto hash = Hash::blake2b(preimage, 32, personalization);
     return hash;
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../Bitcoin/Script.h"
+#include "../Bitcoin/SigHashCache.h"
 #include "../Bitcoin/Transaction.h"
 #include "../Bitcoin/TransactionInput.h"
 #include "../Bitcoin/TransactionOutput.h"
@@ -53,10 +54,17 @@ struct Transaction {
     /// Generates the signature pre-image.
     Data getPreImage(const Bitcoin::Script& scriptCode, size_t index,
                      enum TWBitcoinSigHashType hashType, uint64_t amount) const;
+    /// Generates the signature pre-image, using previously computed transaction-wide hashes.
+    Data getPreImage(const Bitcoin::Script& scriptCode, size_t index,
+                     enum TWBitcoinSigHashType hashType, uint64_t amount,
+                     const Bitcoin::SigHashCache& cache) const;
     Data getPrevoutHash() const;
     Data getSequenceHash() const;
     Data getOutputsHash() const;
 
+    /// Computes the signature hash components shared by all inputs; to be reused when signing multiple inputs.
+    Bitcoin::SigHashCache getSigHashCache() const;
+
     Data getJoinSplitsHash() const;
     Data getShieldedSpendsHash() const;
     Data getShieldedOutputsHash() const;
@@ -68,6 +76,10 @@ struct Transaction {
                           enum TWBitcoinSigHashType hashType, uint64_t amount,
                           enum Bitcoin::SignatureVersion version) const;
 
+    Data getSignatureHash(const Bitcoin::Script& scriptCode, size_t index,
+                          enum TWBitcoinSigHashType hashType, uint64_t amount,
+                          enum Bitcoin::SignatureVersion version, const Bitcoin::SigHashCache& cache) const;
+
     /// Converts to Protobuf model
     Bitcoin::Proto::Transaction proto() const;
 };
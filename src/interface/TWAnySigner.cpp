@@ -8,6 +8,9 @@
 
 #include "Coin.h"
 
+#include <string>
+#include <vector>
+
 using namespace TW;
 
 TWData* _Nonnull TWAnySignerSign(TWData* _Nonnull data, enum TWCoinType coin) {
@@ -17,6 +20,34 @@ TWData* _Nonnull TWAnySignerSign(TWData* _Nonnull data, enum TWCoinType coin) {
     return TWDataCreateWithBytes(dataOut.data(), dataOut.size());
 }
 
+int TWAnySignerSignBatch(TWData *_Nonnull inputs, enum TWCoinType coin, uint32_t threads, TWData *_Nonnull outputs, TWData *_Nullable errors) {
+    const Data& dataIn = *(reinterpret_cast<const Data*>(inputs));
+    std::vector<Data> items;
+    if (!readDelimited(dataIn, items)) {
+        return -1;
+    }
+
+    std::vector<Data> signedItems;
+    std::vector<std::string> itemErrors;
+    TW::anyCoinSignBatch(coin, items, signedItems, itemErrors, threads);
+
+    Data& dataOut = *const_cast<Data*>(reinterpret_cast<const Data*>(outputs));
+    int failed = 0;
+    for (size_t i = 0; i < signedItems.size(); ++i) {
+        if (!itemErrors[i].empty()) {
+            ++failed;
+        }
+        writeDelimited(signedItems[i], dataOut);
+    }
+    if (errors != nullptr) {
+        Data& errorsOut = *const_cast<Data*>(reinterpret_cast<const Data*>(errors));
+        for (auto& error : itemErrors) {
+            writeDelimited(error, errorsOut);
+        }
+    }
+    return failed;
+}
+
 TWString *_Nonnull TWAnySignerSignJSON(TWString *_Nonnull json, TWData *_Nonnull key, enum TWCoinType coin) {
     const Data& keyData = *(reinterpret_cast<const Data*>(key));
     const std::string& jsonString = *(reinterpret_cast<const std::string*>(json));
@@ -81,6 +81,22 @@ struct TWPrivateKey *_Nonnull TWHDWalletGetDerivedKey(struct TWHDWallet *_Nonnul
     return new TWPrivateKey{ wallet->impl.getKey(coin, derivationPath) };
 }
 
+static TWData *_Nonnull delimitedStrings(const std::vector<std::string>& strings) {
+    Data stream;
+    for (const auto& string : strings) {
+        writeDelimited(string, stream);
+    }
+    return TWDataCreateWithBytes(stream.data(), stream.size());
+}
+
+TWData *_Nullable TWHDWalletDeriveAddresses(struct TWHDWallet *_Nonnull wallet, enum TWCoinType coin, uint32_t account, uint32_t change, uint32_t startIndex, uint32_t count, uint32_t threads) {
+    try {
+        return delimitedStrings(wallet->impl.deriveAddresses(coin, account, change, startIndex, count, threads));
+    } catch (...) {
+        return nullptr;
+    }
+}
+
 TWString *_Nonnull TWHDWalletGetExtendedPrivateKey(struct TWHDWallet *wallet, TWPurpose purpose, TWCoinType coin, TWHDVersion version) {
     return new std::string(wallet->impl.getExtendedPrivateKey(purpose, coin, version));
 }
@@ -97,3 +113,15 @@ TWPublicKey *TWHDWalletGetPublicKeyFromExtended(TWString *_Nonnull extended, enu
     }
     return new TWPublicKey{ PublicKey(*publicKey) };
 }
+
+TWData *_Nullable TWHDWalletDeriveAddressesFromExtended(TWString *_Nonnull extended, enum TWCoinType coin, uint32_t change, uint32_t startIndex, uint32_t count, uint32_t threads) {
+    try {
+        const auto addresses = HDWallet::deriveAddressesFromExtended(*reinterpret_cast<const std::string*>(extended), coin, change, startIndex, count, threads);
+        if (!addresses) {
+            return nullptr;
+        }
+        return delimitedStrings(*addresses);
+    } catch (...) {
+        return nullptr;
+    }
+}
@@ -54,6 +54,37 @@ bool TWPublicKeyVerify(struct TWPublicKey *_Nonnull pk, TWData *signature, TWDat
     return pk->impl.verify(s, m);
 }
 
+TWData *_Nullable TWPublicKeyVerifyBatch(TWData *_Nonnull publicKeys, enum TWPublicKeyType type, TWData *_Nonnull signatures, TWData *_Nonnull messages) {
+    std::vector<TW::Data> keys, sigs, digests;
+    if (!TW::readDelimited(*reinterpret_cast<const TW::Data *>(publicKeys), keys) ||
+        !TW::readDelimited(*reinterpret_cast<const TW::Data *>(signatures), sigs) ||
+        !TW::readDelimited(*reinterpret_cast<const TW::Data *>(messages), digests) ||
+        sigs.size() != keys.size() || digests.size() != keys.size()) {
+        return nullptr;
+    }
+
+    // invalid public keys are left out, their signatures are invalid
+    std::vector<size_t> items;
+    std::vector<PublicKey> validKeys;
+    std::vector<TW::Data> validSigs, validDigests;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!PublicKey::isValid(keys[i], type)) {
+            continue;
+        }
+        items.push_back(i);
+        validKeys.emplace_back(keys[i], type);
+        validSigs.push_back(std::move(sigs[i]));
+        validDigests.push_back(std::move(digests[i]));
+    }
+    const auto valid = PublicKey::verifyBatch(validKeys, validSigs, validDigests);
+
+    auto results = TW::Data(keys.size(), 0);
+    for (size_t j = 0; j < items.size(); ++j) {
+        results[items[j]] = valid[j] ? 1 : 0;
+    }
+    return TWDataCreateWithBytes(results.data(), results.size());
+}
+
 bool TWPublicKeyVerifySchnorr(struct TWPublicKey *_Nonnull pk, TWData *_Nonnull signature, TWData *_Nonnull message) {
     const auto& s = *reinterpret_cast<const TW::Data *>(signature);
     const auto& m = *reinterpret_cast<const TW::Data *>(message);
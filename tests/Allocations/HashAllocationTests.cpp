@@ -0,0 +1,69 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "Hash.h"
+#include "Hashers.h"
+#include "HexCoding.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace TW;
+
+// Counts allocations on the current thread, to check that the fixed size digest functions don't allocate.
+// Replacing operator new affects the whole program, hence this separate test executable.
+static thread_local size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    ++allocationCount;
+    if (auto* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+TEST(HashAllocationTests, DigestNoAllocation) {
+    const auto brownFox = std::string("The quick brown fox jumps over the lazy dog");
+    const auto data = Data(brownFox.begin(), brownFox.end());
+    const Hash::HasherType types[] = {
+        Hash::HasherType::sha1,           Hash::HasherType::sha256,         Hash::HasherType::sha512,
+        Hash::HasherType::sha512_256,     Hash::HasherType::keccak256,      Hash::HasherType::keccak512,
+        Hash::HasherType::sha3_256,       Hash::HasherType::sha3_512,       Hash::HasherType::ripemd,
+        Hash::HasherType::blake256,       Hash::HasherType::groestl512,     Hash::HasherType::sha256d,
+        Hash::HasherType::sha256ripemd,   Hash::HasherType::sha3_256ripemd, Hash::HasherType::blake256d,
+        Hash::HasherType::blake256ripemd, Hash::HasherType::groestl512d,
+    };
+    Hash::Digest<Hash::maxDigestSize> digest;
+
+    const auto before = allocationCount;
+    for (const auto type : types) {
+        Hash::hash(type, data.data(), data.size(), digest.data());
+    }
+    const auto sha256d = Hash::digest<Hash::HasherType::sha256d>(data);
+    const auto keccak256 = Hash::Keccak256().update(data).final();
+    const auto blake2b = Hash::Blake2b<32>::hash(data);
+    EXPECT_EQ(allocationCount, before);
+
+    EXPECT_EQ(hex(sha256d), hex(Hash::sha256d(data.data(), data.size())));
+    EXPECT_EQ(hex(keccak256), hex(Hash::keccak256(data)));
+    EXPECT_EQ(hex(blake2b), hex(Hash::blake2b(data, 32)));
+
+    // composites allocate only their result
+    const auto start = allocationCount;
+    Hash::sha256d(data.data(), data.size());
+    EXPECT_EQ(allocationCount - start, 1u);
+}
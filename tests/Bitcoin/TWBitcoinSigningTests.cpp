@@ -11,7 +11,9 @@
 #include "Bitcoin/TransactionBuilder.h"
 #include "Bitcoin/TransactionSigner.h"
 #include "Bitcoin/SigHashType.h"
+#include "Bitcoin/Signer.h"
 #include "Base58.h"
+#include "CoinEntry.h"
 #include "Hash.h"
 #include "HexCoding.h"
 #include "PrivateKey.h"
@@ -28,6 +30,8 @@
 
 #include <gtest/gtest.h>
 #include <cassert>
+#include <chrono>
+#include <iostream>
 
 using namespace TW;
 using namespace TW::Bitcoin;
@@ -131,6 +135,24 @@ TEST(BitcoinSigning, SignP2PKH_NegativeMissingKey) {
     EXPECT_EQ(result.error(), Common::Proto::Error_missing_private_key);
 }
 
+TEST(BitcoinSigning, SignBatchOutputError) {
+    const auto valid = buildInputP2PKH().SerializeAsString();
+    const auto missingKey = buildInputP2PKH(true).SerializeAsString();
+    const auto inputs = std::vector<Data>{data(valid), data(missingKey)};
+    auto outputs = std::vector<Data>(inputs.size());
+    auto errors = std::vector<std::string>(inputs.size());
+
+    signBatchTemplate<Signer, Proto::SigningInput>(inputs, 0, inputs.size(), outputs, errors);
+
+    Proto::SigningOutput output;
+    ASSERT_TRUE(output.ParseFromArray(outputs[0].data(), (int)outputs[0].size()));
+    EXPECT_EQ(output.error(), Common::Proto::OK);
+    EXPECT_EQ(errors[0], "");
+    // the signer returns an output with an error, which is reported as such
+    EXPECT_TRUE(outputs[1].empty());
+    EXPECT_EQ(errors[1], "Error_missing_private_key");
+}
+
 TEST(BitcoinSigning, EncodeP2WPKH) {
     auto unsignedTx = Transaction(1, 0x11);
 
@@ -1167,6 +1189,100 @@ TEST(BitcoinSigning, Plan_10input_MaxAmount) {
     ASSERT_EQ(serialized.size(), 1529);
 }
 
+TEST(BitcoinSigning, DISABLED_Benchmark_SignManyInputs) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // Time per input should stay flat as the input count grows (transaction-wide hashes are computed once).
+    const auto ownAddress = "bc1q0yy3juscd3zfavw76g4h3eqdqzda7qyf58rj4m";
+    const auto privKey = parse_hex("eb696a065ef48a2192da5b28b694f87544b30fae8327c4510137a922f32c6dcf");
+    const auto utxoScript = Script::lockScriptForAddress(ownAddress, TWCoinTypeBitcoin);
+    const int64_t utxoAmount = 100'000;
+
+    for (auto count : {125, 250, 500, 1000, 2000}) {
+        Proto::SigningInput input;
+        input.set_coin_type(TWCoinTypeBitcoin);
+        input.set_hash_type(hashTypeForCoin(TWCoinTypeBitcoin));
+        input.set_to_address("bc1qauwlpmzamwlf9tah6z4w0t8sunh6pnyyjgk0ne");
+        input.set_change_address(ownAddress);
+        input.add_private_key(privKey.data(), privKey.size());
+
+        // Explicit plan, to measure signing only
+        auto& plan = *input.mutable_plan();
+        for (auto i = 0; i < count; ++i) {
+            auto hash = Hash::sha256(Data{static_cast<byte>(i & 0xff), static_cast<byte>(i >> 8)});
+            auto utxo = plan.add_utxos();
+            utxo->set_script(utxoScript.bytes.data(), utxoScript.bytes.size());
+            utxo->set_amount(utxoAmount);
+            utxo->mutable_out_point()->set_hash(hash.data(), hash.size());
+            utxo->mutable_out_point()->set_index(i);
+            utxo->mutable_out_point()->set_sequence(UINT32_MAX);
+        }
+        const int64_t fee = count * 100;
+        plan.set_available_amount(count * utxoAmount);
+        plan.set_amount(count * utxoAmount - fee);
+        plan.set_fee(fee);
+        input.set_amount(plan.amount());
+
+        const auto start = std::chrono::steady_clock::now();
+        auto signer = TransactionSigner<Transaction, TransactionBuilder>(input);
+        auto result = signer.sign();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        ASSERT_TRUE(result) << std::to_string(result.error());
+        EXPECT_EQ(result.payload().inputs.size(), static_cast<size_t>(count));
+        std::cout << "sign " << count << " inputs: " << elapsed / 1000 << " ms, "
+                  << elapsed / count << " us/input" << std::endl;
+    }
+}
+
+TEST(BitcoinSigning, DISABLED_Benchmark_SignManyKeys) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // Key lookup per input should not depend on the number of private keys provided.
+    const auto ownAddress = "bc1q0yy3juscd3zfavw76g4h3eqdqzda7qyf58rj4m";
+    const auto privKey = parse_hex("eb696a065ef48a2192da5b28b694f87544b30fae8327c4510137a922f32c6dcf");
+    const auto utxoScript = Script::lockScriptForAddress(ownAddress, TWCoinTypeBitcoin);
+    const int64_t utxoAmount = 100'000;
+    const auto count = 1000;
+
+    for (auto keyCount : {1, 10, 50, 200}) {
+        Proto::SigningInput input;
+        input.set_coin_type(TWCoinTypeBitcoin);
+        input.set_hash_type(hashTypeForCoin(TWCoinTypeBitcoin));
+        input.set_to_address("bc1qauwlpmzamwlf9tah6z4w0t8sunh6pnyyjgk0ne");
+        input.set_change_address(ownAddress);
+        // unrelated keys first, the signing key last
+        for (auto i = 1; i < keyCount; ++i) {
+            auto otherKey = Hash::sha256(Data{static_cast<byte>(i)});
+            input.add_private_key(otherKey.data(), otherKey.size());
+        }
+        input.add_private_key(privKey.data(), privKey.size());
+
+        auto& plan = *input.mutable_plan();
+        for (auto i = 0; i < count; ++i) {
+            auto hash = Hash::sha256(Data{static_cast<byte>(i & 0xff), static_cast<byte>(i >> 8)});
+            auto utxo = plan.add_utxos();
+            utxo->set_script(utxoScript.bytes.data(), utxoScript.bytes.size());
+            utxo->set_amount(utxoAmount);
+            utxo->mutable_out_point()->set_hash(hash.data(), hash.size());
+            utxo->mutable_out_point()->set_index(i);
+            utxo->mutable_out_point()->set_sequence(UINT32_MAX);
+        }
+        const int64_t fee = count * 100;
+        plan.set_available_amount(count * utxoAmount);
+        plan.set_amount(count * utxoAmount - fee);
+        plan.set_fee(fee);
+        input.set_amount(plan.amount());
+
+        const auto start = std::chrono::steady_clock::now();
+        auto signer = TransactionSigner<Transaction, TransactionBuilder>(input);
+        auto result = signer.sign();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        ASSERT_TRUE(result) << std::to_string(result.error());
+        EXPECT_EQ(result.payload().inputs.size(), static_cast<size_t>(count));
+        std::cout << "sign " << count << " inputs with " << keyCount << " keys: " << elapsed / 1000 << " ms" << std::endl;
+    }
+}
+
 TEST(BitcoinSigning, Sign_LitecoinReal_a85f) {
     auto coin = TWCoinTypeLitecoin;
     auto ownAddress = "ltc1qt36tu30tgk35tyzsve6jjq3dnhu2rm8l8v5q00";
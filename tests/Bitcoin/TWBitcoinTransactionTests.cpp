@@ -12,6 +12,8 @@
 
 #include <gtest/gtest.h>
 
+#include <tuple>
+
 using namespace TW;
 using namespace TW::Bitcoin;
 
@@ -39,3 +41,82 @@ TEST(BitcoinTransaction, Encode) {
     ASSERT_EQ(hex(unsignedData),
         "02000000035897de6bd6027a475eadd57019d4e6872c396d0716c4875a5f1a6fcfdf385c1f0000000000ffffffffbf829c6bcf84579331337659d31f89dfd138f7f7785802d5501c92333145ca7c1200000000ffffffff22a6f904655d53ae2ff70e701a0bbd90aa3975c0f40bfc6cc996a9049e31cdfc0100000000ffffffff0280a81201000000001976a9141fc11f39be1729bf973a7ab6a615ca4729d6457488ac0084d717000000001976a914f2d4db28cad6502226ee484ae24505c2885cb12d88ac00000000");
 }
+
+TEST(BitcoinTransaction, SigHashCache) {
+    auto transaction = Transaction(2, 0);
+    for (auto i = 0; i < 4; ++i) {
+        auto outpoint = OutPoint(parse_hex("5897de6bd6027a475eadd57019d4e6872c396d0716c4875a5f1a6fcfdf385c1f"), i);
+        transaction.inputs.emplace_back(outpoint, Script(), 4294967295 - i);
+    }
+    transaction.outputs.emplace_back(18000000, Script(parse_hex("76a9141fc11f39be1729bf973a7ab6a615ca4729d6457488ac")));
+    transaction.outputs.emplace_back(400000000, Script(parse_hex("76a914f2d4db28cad6502226ee484ae24505c2885cb12d88ac")));
+
+    const auto scriptCode = Script(parse_hex("76a9141fc11f39be1729bf973a7ab6a615ca4729d6457488ac"));
+    const auto cache = transaction.getSigHashCache();
+    EXPECT_EQ(cache.hashPrevouts, transaction.getPrevoutHash());
+    EXPECT_EQ(cache.hashSequence, transaction.getSequenceHash());
+    EXPECT_EQ(cache.hashOutputs, transaction.getOutputsHash());
+
+    // computed without the cache, before it was introduced
+    const auto anyoneCanPay = [](auto hashType) { return static_cast<TWBitcoinSigHashType>(hashType | TWBitcoinSigHashTypeAnyoneCanPay); };
+    const auto expected = std::vector<std::tuple<TWBitcoinSigHashType, SignatureVersion, size_t, std::string>>{
+        {TWBitcoinSigHashTypeAll, BASE, 1, "adf671284088850b8e03f32817d6e14b7d93ea55b49bef0ef95da36ce368fcec"},
+        {TWBitcoinSigHashTypeAll, BASE, 3, "cb7017890a261a989fa7fbb0e732b4c92a13868756662c2d12e58477dbcdef28"},
+        {TWBitcoinSigHashTypeNone, BASE, 1, "0df43e3663b2f96e7c9d0907e7acdcb502e3684eb2099c86c185ddff7f914f1e"},
+        {TWBitcoinSigHashTypeSingle, BASE, 1, "1fd74219d287d56fd3564193176e6a491004edaaf8576b2bf7a10310de32aa56"},
+        {anyoneCanPay(TWBitcoinSigHashTypeAll), BASE, 1, "5b54f19869af85e764e6acab9513c4ef281eecd0ce5d5b6e76376ed81cacc342"},
+        {anyoneCanPay(TWBitcoinSigHashTypeNone), BASE, 1, "52d3dd9e722f8e555c98b0316fdf7f8f2be6c324c3e10f1eb8fadc4ed1119a64"},
+        {anyoneCanPay(TWBitcoinSigHashTypeSingle), BASE, 1, "dc5267a7db29896fa90ad926a26d8e8a2315aa163a2695f8a7fffa61386568ec"},
+        {TWBitcoinSigHashTypeAll, WITNESS_V0, 1, "5fd6cb6a64e0e901d2789777179459d757b2d7cbc311e1b5346151a16d097a32"},
+        {TWBitcoinSigHashTypeAll, WITNESS_V0, 3, "b1929f4fab4a68c7a988cf3ad7e466d6a338501de095826ed373e42b473895b9"},
+        {TWBitcoinSigHashTypeNone, WITNESS_V0, 1, "065770aea0caf05f3d8f5061706f24ce403325d4a9e5a229e5c6ec579093b50c"},
+        {TWBitcoinSigHashTypeSingle, WITNESS_V0, 1, "2520f58d556de1f993fd0dd14ca79bb4c2054024d2eaf6120b559b22d8a385c2"},
+        {anyoneCanPay(TWBitcoinSigHashTypeAll), WITNESS_V0, 1, "aef7869547a9299bc31a9eb596f54fa683b49349de092ed56d3af9a9431a0823"},
+        {anyoneCanPay(TWBitcoinSigHashTypeNone), WITNESS_V0, 1, "400d120599623cab4ebcba3809c419e40f48d515c84d2f846c9717c214f5bec2"},
+        {anyoneCanPay(TWBitcoinSigHashTypeSingle), WITNESS_V0, 1, "e69df6698191ef59afc385927839be9d2e8f3890fef6841854a4d49fde25faf5"},
+    };
+    for (const auto& [hashType, version, index, sighash] : expected) {
+        EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, index, hashType, 1000, version, cache)), sighash)
+            << hashType << " " << version << " " << index;
+        EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, index, hashType, 1000, version)), sighash)
+            << hashType << " " << version << " " << index;
+    }
+}
+
+TEST(BitcoinTransaction, SigHashCacheBIP143) {
+    // Native P2WPKH, https://github.com/bitcoin/bips/blob/master/bip-0143.mediawiki#native-p2wpkh
+    {
+        auto transaction = Transaction(1, 0x11);
+        transaction.inputs.emplace_back(OutPoint(parse_hex("fff7f7881a8099afa6940d42d1e7f6362bec38171ea3edf433541db4e4ad969f"), 0), Script(), 0xffffffee);
+        transaction.inputs.emplace_back(OutPoint(parse_hex("ef51e1b804cc89d182d279655c3aa89e815b1b309fe287d9b2b55d57b90ec68a"), 1), Script(), 0xffffffff);
+        transaction.outputs.emplace_back(112340000, Script(parse_hex("76a9148280b37df378db99f66f85c95a783a76ac7a6d5988ac")));
+        transaction.outputs.emplace_back(223450000, Script(parse_hex("76a9143bde42dbee7e4dbe6a21b2d50ce2f0167faa815988ac")));
+
+        const auto scriptCode = Script(parse_hex("76a9141d0f172a0ecb48aee1be1f2687d2963ae33f71a188ac"));
+        const auto sighash = transaction.getSignatureHash(scriptCode, 1, TWBitcoinSigHashTypeAll, 600000000, WITNESS_V0, transaction.getSigHashCache());
+        EXPECT_EQ(hex(sighash), "c37af31116d1b27caf68aae9e3ac82f1477929014d5b917657d0eb49478cb670");
+    }
+
+    // P2SH-P2WSH 6-of-6 multisig with all hash types, https://github.com/bitcoin/bips/blob/master/bip-0143.mediawiki#p2sh-p2wsh
+    {
+        auto transaction = Transaction(1, 0);
+        transaction.inputs.emplace_back(OutPoint(parse_hex("36641869ca081e70f394c6948e8af409e18b619df2ed74aa106c1ca29787b96e"), 1), Script(), 0xffffffff);
+        transaction.outputs.emplace_back(900000000, Script(parse_hex("76a914389ffce9cd9ae88dcc0631e88a821ffdbe9bfe2688ac")));
+        transaction.outputs.emplace_back(87000000, Script(parse_hex("76a9147480a33f950689af511e6e84c138dbbd3c3ee41588ac")));
+
+        const auto witnessScript = Script(parse_hex("56210307b8ae49ac90a048e9b53357a2354b3334e9c8bee813ecb98e99a7e07e8c3ba32103b28f0c28bfab54554ae8c658ac5c3e0ce6e79ad336331f78c428dd43eea8449b21034b8113d703413d57761b8b9781957b8c0ac1dfe69f492580ca4195f50376ba4a21033400f6afecb833092a9a21cfdf1ed1376e58c5d1f47de74683123987e967a8f42103a6d48b1131e94ba04d9737d61acdaa1322008af9602b3b14862c07a1789aac162102d8b661b0b3302ee2f162b09e07a55ad5dfbe673a9f01d9f0c19617681024306b56ae"));
+        const auto cache = transaction.getSigHashCache();
+        const auto expected = std::vector<std::pair<uint32_t, std::string>>{
+            {TWBitcoinSigHashTypeAll, "185c0be5263dce5b4bb50a047973c1b6272bfbd0103a89444597dc40b248ee7c"},
+            {TWBitcoinSigHashTypeNone, "e9733bc60ea13c95c6527066bb975a2ff29a925e80aa14c213f686cbae5d2f36"},
+            {TWBitcoinSigHashTypeSingle, "1e1f1c303dc025bd664acb72e583e933fae4cff9148bf78c157d1e8f78530aea"},
+            {TWBitcoinSigHashTypeAll | TWBitcoinSigHashTypeAnyoneCanPay, "2a67f03e63a6a422125878b40b82da593be8d4efaafe88ee528af6e5a9955c6e"},
+            {TWBitcoinSigHashTypeNone | TWBitcoinSigHashTypeAnyoneCanPay, "781ba15f3779d5542ce8ecb5c18716733a5ee42a6f51488ec96154934e2c890a"},
+            {TWBitcoinSigHashTypeSingle | TWBitcoinSigHashTypeAnyoneCanPay, "511e8e52ed574121fc1b654970395502128263f62662e076dc6baf05c2e6a99b"},
+        };
+        for (const auto& [hashType, sighash] : expected) {
+            EXPECT_EQ(hex(transaction.getSignatureHash(witnessScript, 0, static_cast<TWBitcoinSigHashType>(hashType), 987654321, WITNESS_V0, cache)), sighash)
+                << hashType;
+        }
+    }
+}
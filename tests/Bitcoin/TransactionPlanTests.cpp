@@ -569,3 +569,35 @@ TEST(TransactionPlan, LotsofUtxosMax) {
     EXPECT_EQ(filteredValueSum, 50'039'500);
     EXPECT_TRUE(verifyPlan(txPlan, filteredValues, 48'579'780, 1'459'720));
 }
+
+TEST(TransactionPlan, BranchAndBoundNoChange) {
+    auto utxos = buildTestUTXOs({120'000, 50'000, 30'000, 70'000});
+    auto byteFee = 1;
+    auto sigingInput = buildSigningInput(79'700, byteFee, utxos);
+    sigingInput.set_input_selector(Proto::BranchAndBound);
+
+    auto txPlan = TransactionBuilder::plan(sigingInput);
+
+    // no change output, the excess over the fee of 244 goes to the fee
+    EXPECT_TRUE(verifyPlan(txPlan, {50'000, 30'000}, 79'700, 300));
+    auto& feeCalculator = getFeeCalculator(TWCoinTypeBitcoin);
+    EXPECT_EQ(feeCalculator.calculate(2, 1, byteFee), 244);
+    EXPECT_EQ(txPlan.change, 0);
+
+    // same inputs, but with change, with the default selection
+    sigingInput.set_input_selector(Proto::Compatible);
+    txPlan = TransactionBuilder::plan(sigingInput);
+    EXPECT_GT(txPlan.change, 0);
+}
+
+TEST(TransactionPlan, BranchAndBoundWithChange) {
+    // no input set without change: the smallest sufficient one, with change
+    auto utxos = buildTestUTXOs({120'000, 50'000, 30'000, 70'000});
+    auto sigingInput = buildSigningInput(10'000, 1, utxos);
+    sigingInput.set_input_selector(Proto::BranchAndBound);
+
+    auto txPlan = TransactionBuilder::plan(sigingInput);
+
+    EXPECT_TRUE(verifyPlan(txPlan, {30'000}, 10'000, 147));
+    EXPECT_EQ(txPlan.change, 30'000 - 10'000 - 147);
+}
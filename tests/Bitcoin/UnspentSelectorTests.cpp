@@ -13,6 +13,9 @@
 #include "proto/Bitcoin.pb.h"
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <random>
 #include <sstream>
 
 using namespace TW;
@@ -383,3 +386,103 @@ TEST(BitcoinUnspentSelector, SelectZcashMaxUnspents2) {
 
     EXPECT_TRUE(verifySelectedUTXOs(selected, {}));
 }
+
+TEST(BitcoinUnspentSelector, SelectIndices) {
+    const auto amounts = std::vector<int64_t>{4000, 2000, 6000, 1000, 50000, 120000};
+
+    auto selector = UnspentSelector();
+    EXPECT_EQ(selector.selectIndices(amounts, 10000, 1), std::vector<size_t>({4}));
+    EXPECT_EQ(selector.selectIndices(amounts, 0, 1), std::vector<size_t>());
+    EXPECT_EQ(selector.selectIndices(amounts, 200000, 1), std::vector<size_t>());
+}
+
+TEST(BitcoinUnspentSelector, SelectTieFirstSlice) {
+    // 15000 and 25000 are equally close to twice the target, the smaller (first sorted) one wins
+    const auto amounts = std::vector<int64_t>{25000, 15000};
+
+    auto selector = UnspentSelector();
+    EXPECT_EQ(selector.selectIndices(amounts, 10000, 1), std::vector<size_t>({1}));
+}
+
+TEST(BitcoinUnspentSelector, SelectBranchAndBoundNoChange) {
+    auto utxos = buildTestUTXOs({10'000, 20'000, 30'000, 50'000, 100'000});
+
+    auto& feeCalculator = getFeeCalculator(TWCoinTypeBitcoin);
+    const auto byteFee = 1;
+    // 20'000 + 30'000 less fee of 2 inputs and 1 output
+    const auto target = 50'000 - 2 * feeCalculator.calculateSingleInput(byteFee) - feeCalculator.calculate(0, 1, byteFee);
+    EXPECT_EQ(target, 49'755);
+
+    // Compatible selects one UTXO, with change
+    auto selected = UnspentSelector(feeCalculator).select(utxos, target, byteFee);
+    EXPECT_TRUE(verifySelectedUTXOs(selected, {100'000}));
+
+    // no change output needed
+    auto selector = UnspentSelector(feeCalculator, UnspentSelector::BranchAndBound);
+    selected = selector.select(utxos, target, byteFee);
+    EXPECT_TRUE(verifySelectedUTXOs(selected, {20'000, 30'000}));
+
+    // a bit less is also fine, excess goes to fee
+    selected = selector.select(utxos, target - 100, byteFee);
+    EXPECT_TRUE(verifySelectedUTXOs(selected, {20'000, 30'000}));
+}
+
+TEST(BitcoinUnspentSelector, SelectBranchAndBoundKnapsackFallback) {
+    auto utxos = buildTestUTXOs({10'000, 20'000, 30'000, 50'000, 100'000});
+
+    auto& feeCalculator = getFeeCalculator(TWCoinTypeBitcoin);
+    auto selector = UnspentSelector(feeCalculator, UnspentSelector::BranchAndBound);
+    // no changeless match, smallest sufficient set with change
+    auto selected = selector.select(utxos, 42'000, 1);
+    EXPECT_TRUE(verifySelectedUTXOs(selected, {20'000, 30'000}));
+
+    selected = selector.select(utxos, 85'000, 1);
+    EXPECT_TRUE(verifySelectedUTXOs(selected, {10'000, 30'000, 50'000}));
+
+    selected = selector.select(utxos, 205'000, 1);
+    EXPECT_TRUE(verifySelectedUTXOs(selected, {10'000, 20'000, 30'000, 50'000, 100'000}));
+
+    selected = selector.select(utxos, 215'000, 1);
+    EXPECT_TRUE(verifySelectedUTXOs(selected, {}));
+}
+
+TEST(BitcoinUnspentSelector, SelectBranchAndBoundBudget) {
+    auto utxos = buildTestUTXOs({10'000, 20'000, 30'000, 50'000, 100'000});
+
+    auto& feeCalculator = getFeeCalculator(TWCoinTypeBitcoin);
+    auto budget = UnspentSelector::Budget();
+    budget.maxTries = 2;
+    auto selector = UnspentSelector(feeCalculator, UnspentSelector::BranchAndBound, budget);
+    // searches exhausted, the smallest sufficient single UTXO
+    auto selected = selector.select(utxos, 49'755, 1);
+    EXPECT_TRUE(verifySelectedUTXOs(selected, {100'000}));
+
+    // only the 2 largest considered
+    auto budget2 = UnspentSelector::Budget();
+    budget2.maxCandidates = 2;
+    auto selector2 = UnspentSelector(feeCalculator, UnspentSelector::BranchAndBound, budget2);
+    selected = selector2.select(utxos, 49'755, 1);
+    EXPECT_TRUE(verifySelectedUTXOs(selected, {50'000}));
+}
+
+TEST(BitcoinUnspentSelector, DISABLED_Benchmark_SelectManyUTXOs) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    auto random = std::mt19937_64(1);
+    for (auto count : {10, 100, 1'000, 10'000, 100'000}) {
+        std::vector<Proto::UnspentTransaction> utxos;
+        for (auto i = 0; i < count; ++i) {
+            utxos.push_back(buildTestUTXO(10'000 + static_cast<int64_t>(random() % 1'000'000)));
+        }
+        const auto target = UnspentSelector::sum(utxos) / 3;
+        for (auto algorithm : {UnspentSelector::Compatible, UnspentSelector::BranchAndBound}) {
+            auto selector = UnspentSelector(getFeeCalculator(TWCoinTypeBitcoin), algorithm);
+            const auto start = std::chrono::steady_clock::now();
+            auto selected = selector.select(utxos, target, 10);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+            EXPECT_FALSE(selected.empty());
+            std::cout << "select " << (algorithm == UnspentSelector::Compatible ? "compatible" : "branch-and-bound")
+                      << " from " << count << " utxos: " << selected.size() << " selected, " << elapsed << " us" << std::endl;
+        }
+    }
+}
@@ -84,6 +84,40 @@ TEST(Coin, DeriveAddress) {
 int countThreadReady = 0;
 std::mutex countThreadReadyMutex;
 
+TEST(Coin, DeriveAddresses) {
+    // Batch derivation matches one by one, for all coins; a key of the wrong type yields an empty address.
+    std::vector<PrivateKey> privateKeys;
+    for (auto i = 1; i <= 20; ++i) {
+        auto data = parse_hex("0x4646464646464646464646464646464646464646464646464646464646464646");
+        data[31] = static_cast<byte>(i);
+        privateKeys.emplace_back(data, data, data);
+    }
+    const auto otherKey = PrivateKey(parse_hex("0x4646464646464646464646464646464646464646464646464646464646464646"));
+    for (auto coin : TW::getCoinTypes()) {
+        std::vector<PublicKey> publicKeys;
+        try {
+            for (const auto& privateKey : privateKeys) {
+                publicKeys.push_back(privateKey.getPublicKey(TW::publicKeyType(coin)));
+            }
+        } catch (...) {
+            continue;
+        }
+        publicKeys.insert(publicKeys.begin() + 7, otherKey.getPublicKey(TW::publicKeyType(coin) == TWPublicKeyTypeED25519 ? TWPublicKeyTypeSECP256k1 : TWPublicKeyTypeED25519));
+
+        const auto addresses = TW::deriveAddresses(coin, publicKeys);
+        ASSERT_EQ(addresses.size(), publicKeys.size());
+        for (size_t i = 0; i < publicKeys.size(); ++i) {
+            auto expected = std::string();
+            try {
+                expected = TW::deriveAddress(coin, publicKeys[i]);
+            } catch (...) {
+            }
+            EXPECT_EQ(addresses[i], expected) << coin << " " << i;
+        }
+    }
+    EXPECT_EQ(TW::deriveAddresses(TWCoinTypeBitcoin, {}), std::vector<std::string>());
+}
+
 void useCoinFromThread() {
     const int tryCount = 20;
     for (int i = 0; i < tryCount; ++i) {
@@ -0,0 +1,353 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "Ethereum/ABI.h"
+#include "HexCoding.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace TW;
+using namespace TW::Ethereum::ABI;
+
+TEST(EthereumAbiLayout, ParseTypes) {
+    EXPECT_EQ(ParamType::parse("uint").name, "uint256");
+    EXPECT_EQ(ParamType::parse("int").name, "int256");
+    EXPECT_EQ(ParamType::parse("uint168").size, 168);
+    EXPECT_EQ(ParamType::parse("bytes7").kind, ParamType::Kind::fixedBytes);
+    EXPECT_EQ(ParamType::parse("(uint,string)[2][]").name, "(uint256,string)[2][]");
+
+    const auto fixed = ParamType::parse("(uint256,address)[3]");
+    EXPECT_FALSE(fixed.dynamic);
+    EXPECT_EQ(fixed.headSize, 3 * 64);
+    EXPECT_EQ(fixed.headOffsets, (std::vector<size_t>{0, 64, 128}));
+    const auto dynamic = ParamType::parse("(uint256,bytes)[3]");
+    EXPECT_TRUE(dynamic.dynamic);
+    EXPECT_EQ(dynamic.headSize, 32);
+
+    for (const auto type : {"", "uint7", "uint264", "uint08", "bytes0", "bytes33", "foo", "uint256[0]", "()", "(uint256"}) {
+        EXPECT_THROW(ParamType::parse(type), std::invalid_argument) << type;
+    }
+
+    // bounded head sizes, and so the offsets stored for fixed arrays
+    EXPECT_EQ(ParamType::parse("uint256[524288]").headOffsets.size(), 524288);
+    EXPECT_THROW(ParamType::parse("uint256[524289]"), std::invalid_argument);
+    EXPECT_THROW(ParamType::parse("uint256[100000000]"), std::invalid_argument);
+    EXPECT_THROW(ParamType::parse("(uint256[524288],uint8)"), std::invalid_argument);
+    EXPECT_THROW(FunctionLayout("f", std::vector<std::string>{"uint256[524288]", "uint8"}), std::invalid_argument);
+}
+
+TEST(EthereumAbiLayout, Signature) {
+    const auto layout = FunctionLayout::parse("transfer(address,uint)");
+    EXPECT_EQ(layout.getName(), "transfer");
+    EXPECT_EQ(layout.getSignature(), "transfer(address,uint256)");
+    EXPECT_EQ(hex(layout.getSelector()), "a9059cbb");
+    EXPECT_EQ(FunctionLayout::parse("f()").getSignature(), "f()");
+    EXPECT_THROW(FunctionLayout::parse("f(uint256"), std::invalid_argument);
+}
+
+TEST(EthereumAbiLayout, Cached) {
+    const auto layout = FunctionLayout::cached("transfer(address,uint)");
+    EXPECT_EQ(layout->getSignature(), "transfer(address,uint256)");
+    EXPECT_EQ(FunctionLayout::cached("transfer(address,uint)"), layout);
+    EXPECT_NE(FunctionLayout::cached("approve(address,uint256)"), layout);
+    EXPECT_THROW(FunctionLayout::cached("f(uint7)"), std::invalid_argument);
+
+    // least recently used evicted first, but still valid while held
+    for (size_t i = 0; i < FunctionLayout::cacheCapacity; ++i) {
+        FunctionLayout::cached("f" + std::to_string(i) + "()");
+    }
+    EXPECT_NE(FunctionLayout::cached("transfer(address,uint)"), layout);
+    EXPECT_EQ(hex(layout->getSelector()), "a9059cbb");
+}
+
+TEST(EthereumAbiLayout, EncodeSpecExamples) {
+    // Examples from the Solidity ABI specification
+    {
+        const auto layout = FunctionLayout::parse("sam(bytes,bool,uint256[])");
+        const auto dave = std::string("dave");
+        const auto encoded = layout.encode({
+            ParamValue::string(dave),
+            ParamValue::boolean(true),
+            ParamValue::list({ParamValue::number(1), ParamValue::number(2), ParamValue::number(3)}),
+        });
+        EXPECT_EQ(hex(encoded), "a5643bf2"
+                                "0000000000000000000000000000000000000000000000000000000000000060"
+                                "0000000000000000000000000000000000000000000000000000000000000001"
+                                "00000000000000000000000000000000000000000000000000000000000000a0"
+                                "0000000000000000000000000000000000000000000000000000000000000004"
+                                "6461766500000000000000000000000000000000000000000000000000000000"
+                                "0000000000000000000000000000000000000000000000000000000000000003"
+                                "0000000000000000000000000000000000000000000000000000000000000001"
+                                "0000000000000000000000000000000000000000000000000000000000000002"
+                                "0000000000000000000000000000000000000000000000000000000000000003");
+    }
+    {
+        const auto layout = FunctionLayout::parse("f(uint256,uint32[],bytes10,bytes)");
+        const auto digits = std::string("1234567890");
+        const auto hello = std::string("Hello, world!");
+        const auto encoded = layout.encode({
+            ParamValue::number(0x123),
+            ParamValue::list({ParamValue::number(0x456), ParamValue::number(0x789)}),
+            ParamValue::string(digits),
+            ParamValue::string(hello),
+        });
+        EXPECT_EQ(hex(encoded), "8be65246"
+                                "0000000000000000000000000000000000000000000000000000000000000123"
+                                "0000000000000000000000000000000000000000000000000000000000000080"
+                                "3132333435363738393000000000000000000000000000000000000000000000"
+                                "00000000000000000000000000000000000000000000000000000000000000e0"
+                                "0000000000000000000000000000000000000000000000000000000000000002"
+                                "0000000000000000000000000000000000000000000000000000000000000456"
+                                "0000000000000000000000000000000000000000000000000000000000000789"
+                                "000000000000000000000000000000000000000000000000000000000000000d"
+                                "48656c6c6f2c20776f726c642100000000000000000000000000000000000000");
+        EXPECT_EQ(layout.encodedSize({
+                      ParamValue::number(0x123),
+                      ParamValue::list({ParamValue::number(0x456), ParamValue::number(0x789)}),
+                      ParamValue::string(digits),
+                      ParamValue::string(hello),
+                  }),
+                  encoded.size());
+    }
+    {
+        const auto layout = FunctionLayout::parse("g(uint256[][],string[])");
+        const auto one = std::string("one");
+        const auto two = std::string("two");
+        const auto three = std::string("three");
+        const auto encoded = layout.encode({
+            ParamValue::list({
+                ParamValue::list({ParamValue::number(1), ParamValue::number(2)}),
+                ParamValue::list({ParamValue::number(3)}),
+            }),
+            ParamValue::list({ParamValue::string(one), ParamValue::string(two), ParamValue::string(three)}),
+        });
+        EXPECT_EQ(hex(encoded), "2289b18c"
+                                "0000000000000000000000000000000000000000000000000000000000000040"
+                                "0000000000000000000000000000000000000000000000000000000000000140"
+                                "0000000000000000000000000000000000000000000000000000000000000002"
+                                "0000000000000000000000000000000000000000000000000000000000000040"
+                                "00000000000000000000000000000000000000000000000000000000000000a0"
+                                "0000000000000000000000000000000000000000000000000000000000000002"
+                                "0000000000000000000000000000000000000000000000000000000000000001"
+                                "0000000000000000000000000000000000000000000000000000000000000002"
+                                "0000000000000000000000000000000000000000000000000000000000000001"
+                                "0000000000000000000000000000000000000000000000000000000000000003"
+                                "0000000000000000000000000000000000000000000000000000000000000003"
+                                "0000000000000000000000000000000000000000000000000000000000000060"
+                                "00000000000000000000000000000000000000000000000000000000000000a0"
+                                "00000000000000000000000000000000000000000000000000000000000000e0"
+                                "0000000000000000000000000000000000000000000000000000000000000003"
+                                "6f6e650000000000000000000000000000000000000000000000000000000000"
+                                "0000000000000000000000000000000000000000000000000000000000000003"
+                                "74776f0000000000000000000000000000000000000000000000000000000000"
+                                "0000000000000000000000000000000000000000000000000000000000000005"
+                                "7468726565000000000000000000000000000000000000000000000000000000");
+
+        const auto decoded = layout.decode(encoded);
+        ASSERT_TRUE(decoded.has_value());
+        ASSERT_EQ((*decoded)[0].getCount(), 2);
+        ASSERT_EQ((*decoded)[0][0].getCount(), 2);
+        EXPECT_EQ((*decoded)[0][0][1].getUInt256(), 2);
+        EXPECT_EQ((*decoded)[0][1][0].getUInt256(), 3);
+        ASSERT_EQ((*decoded)[1].getCount(), 3);
+        EXPECT_EQ((*decoded)[1][2].getString(), "three");
+    }
+}
+
+TEST(EthereumAbiLayout, MatchesFunction) {
+    const auto address = parse_hex("5aaeb6053f3e94c9b9a09f33669435e7ef1beaed");
+    const auto bytes = parse_hex("0102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021");
+    const auto text = std::string("Hello, world! Hello, world! Hello, world!");
+
+    auto func = Function("baz", std::vector<std::shared_ptr<ParamBase>>{
+        std::make_shared<ParamAddress>(address),
+        std::make_shared<ParamUInt64>(1234567),
+        std::make_shared<ParamInt32>(-5),
+        std::make_shared<ParamBool>(true),
+        std::make_shared<ParamByteArray>(bytes),
+        std::make_shared<ParamString>(text),
+        std::make_shared<ParamByteArrayFix>(4, parse_hex("deadbeef")),
+        std::make_shared<ParamArray>(std::vector<std::shared_ptr<ParamBase>>{
+            std::make_shared<ParamUInt256>(7), std::make_shared<ParamUInt256>(8)}),
+    });
+    Data expected;
+    func.encode(expected);
+
+    const auto layout = FunctionLayout("baz", {"address", "uint64", "int32", "bool", "bytes", "string", "bytes4", "uint256[]"});
+    const auto fourBytes = parse_hex("deadbeef");
+    const auto values = std::vector<ParamValue>{
+        ParamValue::bytes(address),
+        ParamValue::number(1234567),
+        ParamValue::signedNumber(-5),
+        ParamValue::boolean(true),
+        ParamValue::bytes(bytes),
+        ParamValue::string(text),
+        ParamValue::bytes(fourBytes),
+        ParamValue::list({ParamValue::number(7), ParamValue::number(8)}),
+    };
+    EXPECT_EQ(layout.getSignature(), func.getType());
+    EXPECT_EQ(hex(layout.encode(values)), hex(expected));
+
+    // appends
+    Data prefixed = {0xff};
+    layout.encode(values, prefixed);
+    EXPECT_EQ(hex(prefixed), "ff" + hex(expected));
+
+    const auto decoded = layout.decode(expected);
+    ASSERT_TRUE(decoded.has_value());
+    const auto& call = *decoded;
+    ASSERT_EQ(call.getCount(), 8);
+    EXPECT_EQ(hex(call[0].getBytes()), hex(address));
+    EXPECT_EQ(call[1].getUInt256(), 1234567);
+    EXPECT_EQ(call[2].getInt256(), -5);
+    EXPECT_TRUE(call[3].getBool());
+    EXPECT_EQ(hex(call[4].getBytes()), hex(bytes));
+    EXPECT_EQ(call[5].getString(), text);
+    EXPECT_EQ(hex(call[6].getBytes()), "deadbeef");
+    ASSERT_EQ(call[7].getCount(), 2);
+    EXPECT_EQ(call[7][1].getUInt256(), 8);
+
+    // views point into the calldata
+    EXPECT_GE(call[4].bytesData(), expected.data());
+    EXPECT_LT(call[4].bytesData(), expected.data() + expected.size());
+
+    // and agree with Function decoding
+    size_t offset = 0;
+    EXPECT_TRUE(func.decodeInput(expected, offset));
+}
+
+TEST(EthereumAbiLayout, EncodeInvalid) {
+    const auto layout = FunctionLayout::parse("f(uint8,int8,address,bytes2,bool,uint256[2])");
+    const auto address = Data(20);
+    const auto two = Data(2);
+    const auto valid = std::vector<ParamValue>{
+        ParamValue::number(255), ParamValue::signedNumber(-128), ParamValue::bytes(address), ParamValue::bytes(two),
+        ParamValue::boolean(false), ParamValue::list({ParamValue::number(1), ParamValue::number(2)}),
+    };
+    EXPECT_EQ(layout.encode(valid).size(), 4 + 7 * 32);
+
+    auto values = valid;
+    values[0] = ParamValue::number(256);
+    EXPECT_THROW(layout.encode(values), std::invalid_argument);
+    values = valid;
+    values[1] = ParamValue::signedNumber(-129);
+    EXPECT_THROW(layout.encode(values), std::invalid_argument);
+    values[1] = ParamValue::signedNumber(128);
+    EXPECT_THROW(layout.encode(values), std::invalid_argument);
+    values = valid;
+    values[2] = ParamValue::bytes(two);
+    EXPECT_THROW(layout.encode(values), std::invalid_argument);
+    values = valid;
+    values[3] = ParamValue::bytes(address);
+    EXPECT_THROW(layout.encode(values), std::invalid_argument);
+    values = valid;
+    values[4] = ParamValue::number(2);
+    EXPECT_THROW(layout.encode(values), std::invalid_argument);
+    values = valid;
+    values[5] = ParamValue::list({ParamValue::number(1)});
+    EXPECT_THROW(layout.encode(values), std::invalid_argument);
+    values.pop_back();
+    EXPECT_THROW(layout.encode(values), std::invalid_argument);
+}
+
+TEST(EthereumAbiLayout, DecodeInvalid) {
+    const auto layout = FunctionLayout::parse("f(uint256,bytes)");
+    const auto data = parse_hex("00");
+    const auto encoded = layout.encode({ParamValue::number(1), ParamValue::bytes(data)});
+    ASSERT_TRUE(layout.decode(encoded).has_value());
+
+    // wrong selector
+    auto call = encoded;
+    call[0] ^= 1;
+    EXPECT_FALSE(layout.decode(call).has_value());
+    // truncated
+    for (size_t size = 0; size < encoded.size() - 31; ++size) {
+        EXPECT_FALSE(layout.decode(encoded.data(), size).has_value()) << size;
+    }
+    // offset out of range
+    call = encoded;
+    call[4 + 63] = 0xff;
+    EXPECT_FALSE(layout.decode(call).has_value());
+    call[4 + 63] = 0x40;
+    call[4 + 32] = 0x01;
+    EXPECT_FALSE(layout.decode(call).has_value());
+    // length out of range
+    call = encoded;
+    call[4 + 95] = 0x21;
+    EXPECT_FALSE(layout.decode(call).has_value());
+
+    // arrays of offsets all pointing to the same data are rejected rather than checked over and over
+    const auto nested = FunctionLayout::parse("g(uint256[][])");
+    const size_t n = 96;
+    Data aliased(4 + 32 * (n + n + 3));
+    std::copy(nested.getSelector().begin(), nested.getSelector().end(), aliased.begin());
+    const auto put = [&](size_t word, size_t value) {
+        aliased[4 + word * 32 + 30] = static_cast<TW::byte>(value >> 8);
+        aliased[4 + word * 32 + 31] = static_cast<TW::byte>(value);
+    };
+    put(0, 0x20);
+    put(1, n);
+    for (size_t i = 0; i < n; ++i) {
+        put(2 + i, n * 32); // all at the inner array after the offsets
+    }
+    put(2 + n, n);
+    EXPECT_FALSE(nested.decode(aliased).has_value());
+    // the same with one element is fine
+    put(1, 1);
+    EXPECT_TRUE(nested.decode(aliased).has_value());
+}
+
+TEST(EthereumAbiLayout, DISABLED_Benchmark_EncodeDecode) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // ERC-20 transfer calldata, with Function and with a compiled FunctionLayout.
+    const auto count = 200000;
+    const auto time = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    const auto address = parse_hex("5aaeb6053f3e94c9b9a09f33669435e7ef1beaed");
+    const auto layout = FunctionLayout::parse("transfer(address,uint256)");
+    Data call;
+    size_t sink = 0;
+
+    const auto functionEncode = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            auto func = Function("transfer", std::vector<std::shared_ptr<ParamBase>>{
+                std::make_shared<ParamAddress>(address), std::make_shared<ParamUInt256>(uint256_t(i))});
+            call.clear();
+            func.encode(call);
+            sink += call[35];
+        }
+    });
+    const auto layoutEncode = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            call.clear();
+            layout.encode({ParamValue::bytes(address), ParamValue::number(i)}, call);
+            sink += call[35];
+        }
+    });
+    const auto functionDecode = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            auto func = Function("transfer", std::vector<std::shared_ptr<ParamBase>>{
+                std::make_shared<ParamAddress>(), std::make_shared<ParamUInt256>()});
+            size_t offset = 0;
+            sink += func.decodeInput(call, offset);
+        }
+    });
+    const auto layoutDecode = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            const auto decoded = layout.decode(call);
+            sink += static_cast<size_t>((*decoded)[1].getUInt256());
+        }
+    });
+    std::cout << count << " transfer calls: encode Function " << functionEncode << " ms, layout " << layoutEncode
+              << " ms; decode Function " << functionDecode << " ms, layout " << layoutDecode << " ms" << std::endl;
+    EXPECT_NE(sink, 0);
+}
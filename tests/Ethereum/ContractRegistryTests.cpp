@@ -0,0 +1,272 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "Ethereum/ContractCall.h"
+#include "Ethereum/ContractRegistry.h"
+#include "HexCoding.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+using namespace TW;
+using namespace TW::Ethereum::ABI;
+
+extern std::string TESTS_ROOT;
+
+static nlohmann::json loadAbi(const std::string& name) {
+    std::ifstream stream(TESTS_ROOT + "/Ethereum/Data/" + name);
+    nlohmann::json json;
+    stream >> json;
+    return json;
+}
+
+static const char* abiFiles[] = {"erc20.json", "erc721.json", "ens.json", "custom.json", "getAmountsOut.json",
+                                 "kyber_proxy.json", "uniswap_router_v2.json"};
+
+TEST(ContractRegistry, MatchesDecodeCall) {
+    ContractRegistry registry;
+    for (const auto* file : abiFiles) {
+        EXPECT_GT(registry.addAbi(loadAbi(file)), 0) << file;
+    }
+    // the same functions again are not added twice
+    const auto size = registry.size();
+    EXPECT_EQ(registry.addAbi(loadAbi("erc20.json")), 0);
+    EXPECT_EQ(registry.size(), size);
+
+    const std::pair<const char*, const char*> calls[] = {
+        {"erc20.json", "095ea7b30000000000000000000000005aaeb6053f3e94c9b9a09f33669435e7ef1beaed"
+                       "0000000000000000000000000000000000000000000000000000000000000001"},
+        {"erc721.json", "a22cb46500000000000000000000000088341d1a8f672d2780c8dc725902aae72f143b0c"
+                        "0000000000000000000000000000000000000000000000000000000000000001"},
+        {"ens.json", "1896f70ae71cd96d4ba1c4b512b0c5bee30d2b6becf61e574c32a17a67156fa9ed3c4c6f"
+                     "0000000000000000000000004976fb03c32e5b8cfe2b6ccb31c09ba78ebaba41"},
+        {"ens.json", "acf1a841000000000000000000000000000000000000000000000000000000000000004000000000000000"
+                     "00000000000000000000000000000000000000000001e185580000000000000000000000000000000000"
+                     "00000000000000000000000000000a68657769676f76656e730000000000000000000000000000000000"
+                     "0000000000"},
+        {"custom.json", "ec37a4a0000000000000000000000000000000000000000000000000000000000000006000000000000000"
+                        "0000000000000000000000000000000000000000000000000300000000000000000000000000000000"
+                        "0000000000000000000000000000006400000000000000000000000000000000000000000000000000"
+                        "000000000000067472757374790000000000000000000000000000000000000000000000000000"},
+        {"getAmountsOut.json", "d06ca61f0000000000000000000000000000000000000000000000000000000000000064"
+                               "0000000000000000000000000000000000000000000000000000000000000040"
+                               "0000000000000000000000000000000000000000000000000000000000000001"
+                               "000000000000000000000000f784682c82526e245f50975190ef0fff4e4fc077"},
+        {"uniswap_router_v2.json",
+         "38ed17390000000000000000000000000000000000000000000000000de0b6b3a76400000000000000000000"
+         "00000000000000000000000000000000229f7e501ad62bdb000000000000000000000000000000000000000000"
+         "00000000000000000000a00000000000000000000000007d8bf18c7ce84b3e175b339c4ca93aed1dd166f10000"
+         "00000000000000000000000000000000000000000000000000005f0ed070000000000000000000000000000000"
+         "00000000000000000000000000000000040000000000000000000000006b175474e89094c44da98b954eedeac4"
+         "95271d0f0000000000000000000000009f8f72aa9304c8b593d555f12ef6589cc3a579a2000000000000000000"
+         "000000c02aaa39b223fe8d0a0e5c4f27ead9083c756cc2000000000000000000000000e41d2489571d32218924"
+         "6dafa5ebde1f4699f498"},
+        {"kyber_proxy.json",
+         "ae591d54000000000000000000000000eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee000000000000000000"
+         "000000000000000000000000000004a97d605a3b980000000000000000000000000000dac17f958d2ee523a220"
+         "6206994597c13d831ec70000000000000000000000007755297c6a26d495739206181fe81646dbd0bf39ffffff"
+         "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffff00000000000000000000000000000000"
+         "000000000000000ce32ff7d63c35d189000000000000000000000000440bbd6a888a36de6e2f6a25f65bc4e168"
+         "74faa9000000000000000000000000000000000000000000000000000000000000000800000000000000000000"
+         "000000000000000000000000000000000000000001200000000000000000000000000000000000000000000000"
+         "000000000000000000"},
+    };
+    for (const auto& [file, hexCall] : calls) {
+        const auto call = parse_hex(hexCall);
+        const auto expected = decodeCall(call, loadAbi(file));
+        ASSERT_TRUE(expected.has_value()) << file;
+        const auto decoded = decodeCall(call, registry);
+        ASSERT_TRUE(decoded.has_value()) << file;
+        EXPECT_EQ(*decoded, *expected);
+    }
+
+    EXPECT_FALSE(decodeCall(Data(), registry).has_value());
+    EXPECT_FALSE(decodeCall(parse_hex("a22cb46500"), registry).has_value());
+    EXPECT_FALSE(decodeCall(parse_hex("12345678"), registry).has_value());
+}
+
+TEST(ContractRegistry, StandardAbi) {
+    const auto abi = nlohmann::json::parse(R"|([
+        {"type": "constructor", "inputs": [{"name": "owner", "type": "address"}]},
+        {"type": "event", "name": "Transfer", "inputs": [{"name": "from", "type": "address"}]},
+        {"type": "function", "name": "fill", "inputs": [
+            {"name": "order", "type": "tuple", "components": [
+                {"name": "maker", "type": "address"},
+                {"name": "amounts", "type": "uint256[]"}
+            ]},
+            {"name": "fees", "type": "tuple[2]", "components": [
+                {"name": "recipient", "type": "address"},
+                {"name": "amount", "type": "uint96"}
+            ]}
+        ]},
+        {"type": "function", "name": "unsupported", "inputs": [{"name": "x", "type": "fixed128x18"}]},
+        {"name": "noType", "inputs": []}
+    ])|");
+    ContractRegistry registry;
+    EXPECT_EQ(registry.addAbi(abi), 2);
+
+    const auto fill = FunctionLayout::parse("fill((address,uint256[]),(address,uint96)[2])");
+    const auto functions = registry.find(fill.getSelector());
+    ASSERT_EQ(functions.size(), 1);
+    EXPECT_EQ(functions[0]->layout.getSignature(), fill.getSignature());
+    EXPECT_EQ(functions[0]->inputNames, (std::vector<std::string>{"order", "fees"}));
+    EXPECT_EQ(functions[0]->inputTypes, (std::vector<std::string>{"tuple", "tuple[2]"}));
+
+    const auto maker = parse_hex("5aaeb6053f3e94c9b9a09f33669435e7ef1beaed");
+    const auto call = fill.encode({
+        ParamValue::list({ParamValue::bytes(maker), ParamValue::list({ParamValue::number(10), ParamValue::number(20)})}),
+        ParamValue::list({
+            ParamValue::list({ParamValue::bytes(maker), ParamValue::number(1)}),
+            ParamValue::list({ParamValue::bytes(maker), ParamValue::number(2)}),
+        }),
+    });
+    const auto decoded = registry.decode(call);
+    ASSERT_EQ(decoded.function, functions[0]);
+    EXPECT_EQ(decoded.matches, 1);
+    const auto& params = *decoded.params;
+    EXPECT_EQ(hex(params[0][0].getBytes()), hex(maker));
+    EXPECT_EQ(params[0][1][1].getUInt256(), 20);
+    EXPECT_EQ(params[1][1][1].getUInt256(), 2);
+
+    // moved functions stay in place
+    static_assert(!std::is_copy_constructible_v<ContractRegistry> && !std::is_copy_assignable_v<ContractRegistry>);
+    auto moved = std::move(registry);
+    EXPECT_EQ(moved.decode(call).function, functions[0]);
+    ContractRegistry assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.decode(call).function, functions[0]);
+}
+
+TEST(ContractRegistry, SelectorCollision) {
+    // burn(uint256) and collate_propagate_storage(bytes16) share the selector 42966c68
+    ContractRegistry registry;
+    EXPECT_TRUE(registry.addFunction("burn", {"uint256"}, {"amount"}));
+    EXPECT_TRUE(registry.addFunction("collate_propagate_storage", {"bytes16"}));
+    EXPECT_FALSE(registry.addFunction("burn", {"uint"}));
+    // with different parameters
+    EXPECT_TRUE(registry.addFunction("transfer", {"address", "uint256"}));
+
+    const auto burn = FunctionLayout::parse("burn(uint256)");
+    ASSERT_EQ(hex(burn.getSelector()), "42966c68");
+    const auto functions = registry.find(burn.getSelector());
+    ASSERT_EQ(functions.size(), 2);
+    EXPECT_EQ(functions[0]->layout.getSignature(), "burn(uint256)");
+    EXPECT_EQ(functions[0]->inputNames, std::vector<std::string>{"amount"});
+    EXPECT_EQ(functions[1]->layout.getSignature(), "collate_propagate_storage(bytes16)");
+    EXPECT_EQ(functions[1]->inputNames, std::vector<std::string>{""});
+
+    // both decode: the first added wins, and the ambiguity is reported
+    const auto call = burn.encode({ParamValue::number(1000)});
+    auto decoded = registry.decode(call);
+    EXPECT_EQ(decoded.function, functions[0]);
+    EXPECT_EQ(decoded.matches, 2);
+    EXPECT_EQ((*decoded.params)[0].getUInt256(), 1000);
+
+    // a function whose parameters span the calldata exactly is preferred over one leaving trailing data
+    ContractRegistry reversed;
+    reversed.addFunction("collate_propagate_storage", {"bytes16"});
+    reversed.addFunction("burn", {"uint256"});
+    decoded = reversed.decode(call);
+    EXPECT_EQ(decoded.function->layout.getSignature(), "collate_propagate_storage(bytes16)");
+    auto longer = call;
+    longer.resize(longer.size() + 32);
+    decoded = reversed.decode(longer);
+    EXPECT_EQ(decoded.matches, 2);
+    EXPECT_EQ(decoded.function->layout.getSignature(), "collate_propagate_storage(bytes16)");
+}
+
+TEST(ContractRegistry, DecodeBatch) {
+    ContractRegistry registry;
+    for (const auto* file : abiFiles) {
+        registry.addAbi(loadAbi(file));
+    }
+    const auto transfer = FunctionLayout::parse("transfer(address,uint256)");
+    const auto to = parse_hex("5aaeb6053f3e94c9b9a09f33669435e7ef1beaed");
+    std::vector<Data> calls;
+    for (size_t i = 0; i < 1000; ++i) {
+        switch (i % 4) {
+        case 0:
+            calls.push_back(transfer.encode({ParamValue::bytes(to), ParamValue::number(i)}));
+            break;
+        case 1:
+            calls.push_back(parse_hex("12345678"));
+            break;
+        case 2:
+            calls.push_back(Data(i % 7));
+            break;
+        default:
+            calls.push_back(transfer.encode({ParamValue::bytes(to), ParamValue::number(i)}));
+            calls.back().resize(40);
+        }
+    }
+    const auto results = registry.decode(calls, 4);
+    ASSERT_EQ(results.size(), calls.size());
+    for (size_t i = 0; i < calls.size(); ++i) {
+        const auto single = registry.decode(calls[i]);
+        EXPECT_EQ(results[i].function, single.function) << i;
+        if (i % 4 == 0) {
+            ASSERT_NE(results[i].function, nullptr);
+            EXPECT_EQ(results[i].function->layout.getSignature(), "transfer(address,uint256)");
+            EXPECT_EQ((*results[i].params)[1].getUInt256(), i);
+            EXPECT_EQ(results[i].function->inputNames, (std::vector<std::string>{"_to", "_value"}));
+        } else {
+            EXPECT_EQ(results[i].function, nullptr) << i;
+        }
+    }
+}
+
+TEST(ContractRegistry, DISABLED_Benchmark_Decode) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // Mixed calls decoded with decodeCall from JSON, and with a registry one by one and in bulk.
+    const auto count = 20000;
+    const auto time = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    nlohmann::json abi = nlohmann::json::object();
+    ContractRegistry registry;
+    for (const auto* file : abiFiles) {
+        const auto json = loadAbi(file);
+        abi.update(json);
+        registry.addAbi(json);
+    }
+    const auto transfer = FunctionLayout::parse("transfer(address,uint256)");
+    const auto amountsOut = FunctionLayout::parse("getAmountsOut(uint256,address[])");
+    const auto to = parse_hex("5aaeb6053f3e94c9b9a09f33669435e7ef1beaed");
+    std::vector<Data> calls;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 2 == 0) {
+            calls.push_back(transfer.encode({ParamValue::bytes(to), ParamValue::number(i)}));
+        } else {
+            calls.push_back(amountsOut.encode(
+                {ParamValue::number(i), ParamValue::list({ParamValue::bytes(to), ParamValue::bytes(to)})}));
+        }
+    }
+
+    size_t sink = 0;
+    const auto json = time([&] {
+        for (const auto& call : calls) {
+            sink += decodeCall(call, abi)->size();
+        }
+    });
+    const auto single = time([&] {
+        for (const auto& call : calls) {
+            sink += registry.decode(call).matches;
+        }
+    });
+    const auto bulk = time([&] {
+        for (const auto& result : registry.decode(calls)) {
+            sink += result.matches;
+        }
+    });
+    std::cout << count << " calls: decodeCall " << json << " ms, registry " << single << " ms, bulk " << bulk << " ms"
+              << std::endl;
+    EXPECT_NE(sink, 0);
+}
@@ -9,6 +9,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 using namespace TW;
 using namespace TW::Ethereum;
 using boost::multiprecision::uint256_t;
@@ -134,6 +137,209 @@ TEST(RLP, EncodeInvalid) {
     ASSERT_TRUE(RLP::encodeList(std::vector<int>{0, -1}).empty());
 }
 
+TEST(RLP, WriteList) {
+    EXPECT_EQ(hex(RLP::writeList([](auto&) {})), "c0");
+    EXPECT_EQ(hex(RLP::writeList([](auto& rlp) { rlp.add(1).add(2).add(3); })), "c3010203");
+    EXPECT_EQ(hex(RLP::writeList([](auto& rlp) { rlp.add(0).add(127).add(128).add(0xffffff); })), "c8807f818083ffffff");
+
+    const auto number = uint256_t("0x0100000000000000000000000000000000000000000000000000000000000000");
+    const auto longString = Data(56, 0x61);
+    const auto address = std::array<uint8_t, 20>{0x35, 0x35};
+    const auto encoded = RLP::writeList([&](auto& rlp) {
+        rlp.add(number).add(Data()).add(parse_hex("00")).add(longString).add(address);
+    });
+    Data items;
+    append(items, RLP::encode(number));
+    append(items, RLP::encode(Data()));
+    append(items, RLP::encode(parse_hex("00")));
+    append(items, RLP::encode(longString));
+    append(items, RLP::encode(address));
+    EXPECT_EQ(hex(encoded), hex(RLP::encodeList(items)));
+    EXPECT_EQ(hex(subData(encoded, 0, 4)), "f872a001");
+}
+
+TEST(RLP, WriteListNested) {
+    const auto encoded = RLP::writeList([](auto& rlp) {
+        rlp.addList([](auto& l1) {
+            l1.addList([](auto& l11) { l11.add(1).add(2).add(3); });
+            l1.addEncoded(RLP::encodeList(std::vector<std::string>{"apple", "banana", "cherry"}));
+        });
+        rlp.addList([](auto& l2) {
+            l2.addList([](auto& l21) { l21.add(parse_hex("abcdef")).add(parse_hex("00010203040506070809")); });
+            l2.addEncoded(RLP::encodeList(std::vector<std::string>{"bitcoin", "beeenbee", "eth"}));
+        });
+    });
+    // as EncodeListNested, without the double encoding of the inner lists
+    EXPECT_EQ(hex(encoded), "f841"
+        "d9c3010203d4856170706c658662616e616e6186636865727279"
+        "e6cf83abcdef8a00010203040506070809d587626974636f696e88626565656e62656583657468");
+
+    // long list, with 3-byte size
+    const auto elem = Data(100, 0x30);
+    const auto longList = RLP::writeList([&](auto& rlp) {
+        for (auto i = 0; i < 650; ++i) {
+            rlp.add(elem);
+        }
+    });
+    ASSERT_EQ(longList.size(), 66304);
+    EXPECT_EQ(hex(subData(longList, 0, 8)), "fa0102fcb8643030");
+
+    // appending
+    auto envelope = Data{0x02};
+    RLP::writeList([](auto& rlp) { rlp.add(3); }, envelope);
+    EXPECT_EQ(hex(envelope), "02c103");
+}
+
+TEST(RLP, Sizer) {
+    EXPECT_EQ(RLPSizer::headerSize(0), 1);
+    EXPECT_EQ(RLPSizer::headerSize(55), 1);
+    EXPECT_EQ(RLPSizer::headerSize(56), 2);
+    EXPECT_EQ(RLPSizer::headerSize(0xff), 2);
+    EXPECT_EQ(RLPSizer::headerSize(0x100), 3);
+    EXPECT_EQ(RLPSizer::headerSize(0x10000), 4);
+    EXPECT_EQ(RLPSizer::encodedSize(uint256_t(0)), 1);
+    EXPECT_EQ(RLPSizer::encodedSize(uint256_t(0x7f)), 1);
+    EXPECT_EQ(RLPSizer::encodedSize(uint256_t(0x80)), 2);
+    EXPECT_EQ(RLPSizer::encodedSize(uint256_t(0x100)), 3);
+    EXPECT_EQ(RLPSizer::encodedSize(~uint256_t(0)), 33);
+
+    const auto data = parse_hex("7f");
+    EXPECT_EQ(RLPSizer::encodedSize(data.data(), data.size()), 1);
+    EXPECT_EQ(RLPSizer().add(data).add(Data(56)).size(), 1 + 58);
+}
+
+TEST(RLP, Reader) {
+    const auto encoded = parse_hex("f8479cdb84c301020395d4856170706c658662616e616e6186636865727279a9e890cf83abcdef8a0001020304050607080996d587626974636f696e88626565656e62656583657468");
+    auto reader = RLPReader(encoded);
+    const auto outer = reader.next();
+    EXPECT_TRUE(outer.isList);
+    EXPECT_EQ(outer.size, 0x47);
+    EXPECT_TRUE(reader.atEnd());
+    EXPECT_EQ(reader.remaining(), 0);
+
+    auto items = outer.items();
+    const auto l1 = items.next();
+    EXPECT_FALSE(l1.isList); // encoded list as string
+    EXPECT_EQ(hex(l1.toData()), "db84c301020395d4856170706c658662616e616e6186636865727279");
+    auto l1Items = RLPReader(l1.data, l1.size).next().items();
+    EXPECT_EQ(hex(l1Items.next().toData()), "c3010203");
+    EXPECT_EQ(hex(l1Items.next().toData()), "d4856170706c658662616e616e6186636865727279");
+    EXPECT_TRUE(l1Items.atEnd());
+    EXPECT_FALSE(items.atEnd());
+    items.next();
+    EXPECT_TRUE(items.atEnd());
+    EXPECT_THROW(items.next(), std::invalid_argument);
+}
+
+TEST(RLP, ReaderTransaction) {
+    const auto encoded = parse_hex("02f8710306847735940084b2d05e0082526c94b9f5771c27664bf2282d98e09d7f50cec7cb01a78701ee0c29f50cb180c080a092c336138f7d0231fe9422bb30ee9ef10bf222761fe9e04442e3a11e88880c64a06487026011dae03dc281bc21c7d7ede5c2226d197befb813a4ecad686b559e58");
+    auto fields = RLPReader(encoded.data() + 1, encoded.size() - 1).next().items();
+    EXPECT_EQ(fields.next().toUInt256(), 3);
+    EXPECT_EQ(fields.next().toUInt256(), 6);
+    EXPECT_EQ(fields.next().toUInt256(), 2000000000);
+    EXPECT_EQ(fields.next().toUInt256(), 3000000000);
+    EXPECT_EQ(fields.next().toUInt256(), 21100);
+    EXPECT_EQ(hex(fields.next().toData()), "b9f5771c27664bf2282d98e09d7f50cec7cb01a7");
+    EXPECT_EQ(fields.next().toUInt256(), 543210987654321);
+    EXPECT_EQ(fields.next().size, 0);
+    const auto accessList = fields.next();
+    EXPECT_TRUE(accessList.isList);
+    EXPECT_TRUE(accessList.items().atEnd());
+    EXPECT_EQ(fields.next().toUInt256(), 0);
+    const auto r = fields.next();
+    EXPECT_EQ(hex(store(r.toUInt256())), "92c336138f7d0231fe9422bb30ee9ef10bf222761fe9e04442e3a11e88880c64");
+    EXPECT_THROW(accessList.toUInt256(), std::invalid_argument);
+    EXPECT_THROW(r.items(), std::invalid_argument);
+    fields.next();
+    EXPECT_TRUE(fields.atEnd());
+}
+
+TEST(RLP, ReaderInvalid) {
+    const auto next = [](const std::string& encoded) {
+        const auto data = parse_hex(encoded);
+        return RLPReader(data).next();
+    };
+    EXPECT_THROW(next(""), std::invalid_argument);
+    EXPECT_THROW(next("81636174"), std::invalid_argument);
+    EXPECT_THROW(next("b9ffff"), std::invalid_argument);
+    EXPECT_THROW(next("c883636174"), std::invalid_argument);
+    EXPECT_THROW(next("bf0f000000000000021111"), std::invalid_argument);
+    EXPECT_THROW(next("f80180"), std::invalid_argument);
+    EXPECT_THROW(next("8100"), std::invalid_argument);
+    EXPECT_THROW(next("f800"), std::invalid_argument);
+    EXPECT_THROW(next("b800"), std::invalid_argument);
+    EXPECT_THROW(next("b90037"), std::invalid_argument);
+    EXPECT_THROW(RLPItem({false, nullptr, 33}).toUInt256(), std::invalid_argument);
+
+    // nested item overruns its list
+    const auto list = parse_hex("c283636174");
+    auto items = RLPReader(list).next();
+    EXPECT_THROW(items.items().next(), std::invalid_argument);
+}
+
+// Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+TEST(RLP, DISABLED_Benchmark_EncodeTransaction) {
+    const auto count = 200000;
+    const auto to = parse_hex("6b175474e89094c44da98b954eedeac495271d0f");
+    const auto payload = parse_hex("a9059cbb0000000000000000000000005322b34c88ed0691971bf52a7047448f0f4efc840000000000000000000000000000000000000000000000001bc16d674ec80000");
+    const auto r = uint256_t("0x2843d8ed66b9623392dc336dd36d5dd5a630b2019962869b6e50fdb4ecb5b6ac");
+    const auto s = uint256_t("0x5d9ea377bc65e2921f7fc257de8135530cc74e3188b6ba57a4b9cb284393050a");
+    const auto time = [](auto&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // signed ERC20 transfer
+    Data concatenated;
+    const auto concatenating = time([&] {
+        for (auto i = 0; i < count; ++i) {
+            Data encoded;
+            append(encoded, RLP::encode(uint256_t(i)));
+            append(encoded, RLP::encode(uint256_t(42000000000)));
+            append(encoded, RLP::encode(uint256_t(78009)));
+            append(encoded, RLP::encode(to));
+            append(encoded, RLP::encode(uint256_t(0)));
+            append(encoded, RLP::encode(payload));
+            append(encoded, RLP::encode(uint256_t(0x25)));
+            append(encoded, RLP::encode(r));
+            append(encoded, RLP::encode(s));
+            concatenated = RLP::encodeList(encoded);
+        }
+    });
+    Data written;
+    const auto writing = time([&] {
+        for (auto i = 0; i < count; ++i) {
+            written = RLP::writeList([&](auto& rlp) {
+                rlp.add(uint256_t(i)).add(uint256_t(42000000000)).add(uint256_t(78009)).add(to).add(uint256_t(0));
+                rlp.add(payload).add(uint256_t(0x25)).add(r).add(s);
+            });
+        }
+    });
+    ASSERT_EQ(hex(written), hex(concatenated));
+
+    size_t decodedSize = 0;
+    const auto decoding = time([&] {
+        for (auto i = 0; i < count; ++i) {
+            decodedSize += RLP::decode(written).decoded.size();
+        }
+    });
+    size_t readSize = 0;
+    const auto reading = time([&] {
+        for (auto i = 0; i < count; ++i) {
+            auto fields = RLPReader(written).next().items();
+            while (!fields.atEnd()) {
+                fields.next();
+                ++readSize;
+            }
+        }
+    });
+    ASSERT_EQ(readSize, decodedSize);
+
+    std::cout << count << " transactions: encode " << concatenating << " ms, writeList " << writing
+              << " ms; decode " << decoding << " ms, RLPReader " << reading << " ms" << std::endl;
+}
+
 TEST(RLP, DecodeInteger) {
     EXPECT_EQ(decodeHelper("00"), "00"); // not the primary encoding for 0
     EXPECT_EQ(decodeHelper("01"), "01");
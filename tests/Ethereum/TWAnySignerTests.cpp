@@ -317,6 +317,93 @@ TEST(TWAnySignerEthereum, PlanNotSupported) {
     EXPECT_EQ(TWDataSize(outputTWData.get()), 0);
 }
 
+TEST(TWAnySignerEthereum, SignBatch) {
+    auto chainId = store(uint256_t(1));
+    auto nonce = store(uint256_t(0));
+    auto gasPrice = store(uint256_t(42000000000));
+    auto gasLimit = store(uint256_t(78009));
+    auto amountData = store(uint256_t(2000000000000000000));
+    auto key = parse_hex("0x608dcb1742bb3fb7aec002074e3420e4fab7d00cced79ccdac53ed5b27138151");
+
+    Proto::SigningInput input;
+    input.set_chain_id(chainId.data(), chainId.size());
+    input.set_nonce(nonce.data(), nonce.size());
+    input.set_gas_price(gasPrice.data(), gasPrice.size());
+    input.set_gas_limit(gasLimit.data(), gasLimit.size());
+    input.set_to_address("0x6b175474e89094c44da98b954eedeac495271d0f");
+    input.set_private_key(key.data(), key.size());
+    auto& erc20 = *input.mutable_transaction()->mutable_erc20_transfer();
+    erc20.set_to("0x5322b34c88ed0691971bf52a7047448f0f4efc84");
+    erc20.set_amount(amountData.data(), amountData.size());
+    const auto expected = "f8aa808509c7652400830130b9946b175474e89094c44da98b954eedeac495271d0f80b844a9059cbb0000000000000000000000005322b34c88ed0691971bf52a7047448f0f4efc840000000000000000000000000000000000000000000000001bc16d674ec8000025a0724c62ad4fbf47346b02de06e603e013f26f26b56fdc0be7ba3d6273401d98cea0032131cae15da7ddcda66963e8bef51ca0d9962bfef0547d3f02597a4a58c931";
+
+    auto invalidKeyInput = input;
+    invalidKeyInput.set_private_key("\x01\x02");
+    const auto valid = input.SerializeAsString();
+    const auto items = std::vector<std::string>{valid, valid, invalidKeyInput.SerializeAsString(), "\xff\xff", valid};
+
+    // length-delimited stream, varint sizes
+    auto inputs = WRAPD(TWDataCreateWithSize(0));
+    for (auto& item : items) {
+        for (auto size = item.size(); ; size >>= 7) {
+            TWDataAppendByte(inputs.get(), static_cast<uint8_t>((size & 0x7f) | (size >= 0x80 ? 0x80 : 0)));
+            if (size < 0x80) {
+                break;
+            }
+        }
+        TWDataAppendBytes(inputs.get(), (const uint8_t*)item.data(), item.size());
+    }
+    auto readItems = [](TWData* data) {
+        std::vector<std::string> result;
+        const auto bytes = TWDataBytes(data);
+        for (size_t index = 0; index < TWDataSize(data);) {
+            size_t size = 0;
+            for (auto shift = 0; ; shift += 7) {
+                const auto byte = bytes[index++];
+                size |= size_t(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            result.emplace_back((const char*)bytes + index, size);
+            index += size;
+        }
+        return result;
+    };
+
+    for (auto threads : {1u, 2u, 0u}) {
+        auto outputs = WRAPD(TWDataCreateWithSize(0));
+        auto errors = WRAPD(TWDataCreateWithSize(0));
+        EXPECT_EQ(TWAnySignerSignBatch(inputs.get(), TWCoinTypeEthereum, threads, outputs.get(), errors.get()), 2);
+
+        const auto outputItems = readItems(outputs.get());
+        const auto errorItems = readItems(errors.get());
+        ASSERT_EQ(outputItems.size(), items.size());
+        ASSERT_EQ(errorItems.size(), items.size());
+        for (auto i : {0, 1, 4}) {
+            Proto::SigningOutput output;
+            ASSERT_TRUE(output.ParseFromString(outputItems[i]));
+            EXPECT_EQ(hex(output.encoded()), expected);
+            EXPECT_EQ(errorItems[i], "");
+        }
+        EXPECT_EQ(outputItems[2], "");
+        EXPECT_EQ(errorItems[2], "Signing failed");
+        EXPECT_EQ(outputItems[3], "");
+        EXPECT_EQ(errorItems[3], "Invalid input");
+    }
+
+    // errors are optional
+    auto outputs = WRAPD(TWDataCreateWithSize(0));
+    EXPECT_EQ(TWAnySignerSignBatch(inputs.get(), TWCoinTypeEthereum, 1, outputs.get(), nullptr), 2);
+    EXPECT_EQ(readItems(outputs.get()).size(), items.size());
+
+    // truncated stream
+    auto truncated = WRAPD(TWDataCreateWithBytes(TWDataBytes(inputs.get()), TWDataSize(inputs.get()) - 1));
+    auto outputs2 = WRAPD(TWDataCreateWithSize(0));
+    EXPECT_EQ(TWAnySignerSignBatch(truncated.get(), TWCoinTypeEthereum, 1, outputs2.get(), nullptr), -1);
+    EXPECT_EQ(TWDataSize(outputs2.get()), 0);
+}
+
 TEST(TWAnySignerEthereum, SignERC1559Transfer_1442) {
     auto chainId = store(uint256_t(3));
     auto nonce = store(uint256_t(6));
@@ -0,0 +1,154 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "Ethereum/Signer.h"
+#include "Ethereum/Transaction.h"
+#include "Ethereum/TransactionBatch.h"
+#include "HexCoding.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace TW::Ethereum {
+
+using boost::multiprecision::uint256_t;
+
+static std::vector<BatchTransfer> transfers(size_t count) {
+    std::vector<BatchTransfer> result;
+    for (size_t i = 0; i < count; ++i) {
+        auto to = parse_hex("b9f5771c27664bf2282d98e09d7f50cec7cb01a7");
+        to[19] = static_cast<byte>(i);
+        result.push_back(BatchTransfer{to, uint256_t(543210987654321) * (i % 7)});
+    }
+    return result;
+}
+
+TEST(EthereumTransactionBatch, EIP1559_1442) {
+    const auto transaction = TransactionEip1559(0, 2000000000, 3000000000, 21100, Data(), 0);
+    const auto batch = TransactionBatch<TransactionEip1559>(transaction, 3);
+    const auto key = PrivateKey(parse_hex("4f96ed80e9a7555a6f74b3d658afdd9c756b0a40d4ca30c42c2039eb449bb904"));
+    const auto transfer = BatchTransfer{parse_hex("B9F5771C27664bF2282D98E09D7F50cEc7cB01a7"), 543210987654321};
+
+    const auto signedTransactions = batch.sign(key, 6, {transfer});
+    ASSERT_EQ(signedTransactions.size(), 1);
+    EXPECT_EQ(signedTransactions[0].signature.v, 0);
+    EXPECT_EQ(hex(store(signedTransactions[0].signature.r)), "92c336138f7d0231fe9422bb30ee9ef10bf222761fe9e04442e3a11e88880c64");
+    EXPECT_EQ(hex(store(signedTransactions[0].signature.s)), "6487026011dae03dc281bc21c7d7ede5c2226d197befb813a4ecad686b559e58");
+    // https://ropsten.etherscan.io/tx/0x14429509307efebfdaa05227d84c147450d168c68539351fbc01ed87c916ab2e
+    EXPECT_EQ(hex(signedTransactions[0].encoded), "02f8710306847735940084b2d05e0082526c94b9f5771c27664bf2282d98e09d7f50cec7cb01a78701ee0c29f50cb180c080a092c336138f7d0231fe9422bb30ee9ef10bf222761fe9e04442e3a11e88880c64a06487026011dae03dc281bc21c7d7ede5c2226d197befb813a4ecad686b559e58");
+}
+
+TEST(EthereumTransactionBatch, NonTypedPreHash) {
+    const auto transaction = TransactionNonTyped(0, 20000000000, 21000, Data(), 0);
+    const auto batch = TransactionBatch<TransactionNonTyped>(transaction, 1);
+    const auto transfer = BatchTransfer{parse_hex("0x3535353535353535353535353535353535353535"), 1000000000000000000};
+    EXPECT_EQ(hex(batch.preHash(9, transfer)), "daf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53");
+}
+
+TEST(EthereumTransactionBatch, MatchesSignerEIP1559) {
+    const auto payload = parse_hex("a9059cbb0000000000000000000000005322b34c88ed0691971bf52a7047448f0f4efc84");
+    const auto shared = TransactionEip1559(0, 2000000000, 3000000000, 78009, Data(), 0, payload);
+    const uint256_t chainID = 1;
+    const auto key = PrivateKey(parse_hex("4f96ed80e9a7555a6f74b3d658afdd9c756b0a40d4ca30c42c2039eb449bb904"));
+    const auto batch = TransactionBatch<TransactionEip1559>(shared, chainID);
+    const auto items = transfers(40);
+    const uint256_t firstNonce = 126;
+
+    const auto preHashes = batch.preHashes(firstNonce, items, 4);
+    const auto signedTransactions = batch.sign(key, firstNonce, items, 4);
+    ASSERT_EQ(preHashes.size(), items.size());
+    ASSERT_EQ(signedTransactions.size(), items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        const auto transaction = std::make_shared<TransactionEip1559>(
+            firstNonce + i, shared.maxInclusionFeePerGas, shared.maxFeePerGas, shared.gasLimit, items[i].to,
+            items[i].amount, payload);
+        const auto signature = Signer::sign(key, chainID, transaction);
+        EXPECT_EQ(hex(preHashes[i]), hex(transaction->preHash(chainID)));
+        EXPECT_EQ(hex(batch.preHash(firstNonce + i, items[i])), hex(preHashes[i]));
+        EXPECT_EQ(signedTransactions[i].signature.v, signature.v);
+        EXPECT_EQ(signedTransactions[i].signature.r, signature.r);
+        EXPECT_EQ(signedTransactions[i].signature.s, signature.s);
+        EXPECT_EQ(hex(signedTransactions[i].encoded), hex(transaction->encoded(signature, chainID)));
+        EXPECT_EQ(hex(batch.encoded(firstNonce + i, items[i], signature)), hex(signedTransactions[i].encoded));
+    }
+}
+
+TEST(EthereumTransactionBatch, MatchesSignerNonTyped) {
+    const auto shared = TransactionNonTyped(0, 42000000000, 21000, Data(), 0);
+    const auto key = PrivateKey(parse_hex("0x4646464646464646464646464646464646464646464646464646464646464646"));
+    const auto items = transfers(20);
+
+    for (const uint256_t chainID : {uint256_t(0), uint256_t(1), uint256_t(56)}) {
+        const auto batch = TransactionBatch<TransactionNonTyped>(shared, chainID);
+        const auto signedTransactions = batch.sign(key, 0, items, 3);
+        ASSERT_EQ(signedTransactions.size(), items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            const auto transaction = std::make_shared<TransactionNonTyped>(
+                uint256_t(i), shared.gasPrice, shared.gasLimit, items[i].to, items[i].amount);
+            const auto signature = Signer::sign(key, chainID, transaction);
+            EXPECT_EQ(signedTransactions[i].signature.v, signature.v);
+            EXPECT_EQ(hex(signedTransactions[i].encoded), hex(transaction->encoded(signature, chainID)));
+        }
+    }
+}
+
+TEST(EthereumTransactionBatch, Empty) {
+    const auto batch = TransactionBatch<TransactionEip1559>(TransactionEip1559(0, 1, 1, 21000, Data(), 0), 1);
+    const auto key = PrivateKey(parse_hex("4f96ed80e9a7555a6f74b3d658afdd9c756b0a40d4ca30c42c2039eb449bb904"));
+    EXPECT_TRUE(batch.preHashes(0, {}).empty());
+    EXPECT_TRUE(batch.sign(key, 0, {}).empty());
+}
+
+// Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+TEST(EthereumTransactionBatch, DISABLED_Benchmark_Sign) {
+    const auto count = 2000;
+    const auto shared = TransactionEip1559(0, 2000000000, 3000000000, 21100, Data(), 0);
+    const uint256_t chainID = 1;
+    const auto key = PrivateKey(parse_hex("4f96ed80e9a7555a6f74b3d658afdd9c756b0a40d4ca30c42c2039eb449bb904"));
+    const auto items = transfers(count);
+    const auto time = [](auto&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::vector<Data> single(count);
+    const auto singleTime = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            const auto transaction = std::make_shared<TransactionEip1559>(
+                uint256_t(i), shared.maxInclusionFeePerGas, shared.maxFeePerGas, shared.gasLimit, items[i].to,
+                items[i].amount);
+            single[i] = transaction->encoded(Signer::sign(key, chainID, transaction), chainID);
+        }
+    });
+    const auto batch = TransactionBatch<TransactionEip1559>(shared, chainID);
+    std::vector<BatchSignedTransaction> batched;
+    const auto batchTime = time([&] { batched = batch.sign(key, 0, items); });
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(batched[i].encoded, single[i]);
+    }
+
+    std::vector<Data> singlePreHashes(count);
+    const auto singlePreHashTime = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            const auto transaction = TransactionEip1559(uint256_t(i), shared.maxInclusionFeePerGas, shared.maxFeePerGas,
+                                                        shared.gasLimit, items[i].to, items[i].amount);
+            singlePreHashes[i] = transaction.preHash(chainID);
+        }
+    });
+    std::vector<Data> preHashes;
+    const auto preHashTime = time([&] { preHashes = batch.preHashes(0, items); });
+    ASSERT_EQ(preHashes, singlePreHashes);
+
+    std::cout << count << " transactions: Signer::sign " << singleTime << " ms, TransactionBatch::sign " << batchTime
+              << " ms (" << std::thread::hardware_concurrency() << " cores); preHash " << singlePreHashTime
+              << " ms, preHashes " << preHashTime << " ms" << std::endl;
+}
+
+} // namespace TW::Ethereum
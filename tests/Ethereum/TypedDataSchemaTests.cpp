@@ -0,0 +1,318 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "Ethereum/ABI.h"
+#include "Ethereum/ABI/TypedDataSchema.h"
+#include "HexCoding.h"
+#include "../interface/TWTestUtilities.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+using namespace TW;
+using namespace TW::Ethereum::ABI;
+using json = nlohmann::json;
+
+extern std::string TESTS_ROOT;
+
+static std::string loadTypedData(const std::string& name) {
+    std::ifstream stream(TESTS_ROOT + "/Ethereum/Data/" + name);
+    return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+}
+
+/// Hashes complete typed data with a schema compiled from its types.
+static Data hashTypedData(const std::string& typedData) {
+    const auto message = json::parse(typedData);
+    const auto schema = TypedDataSchema(message["types"]);
+    const auto domainSeparator = schema.domainSeparator(message["domain"].dump());
+    return schema.hashMessage(domainSeparator, message["primaryType"], message["message"].dump());
+}
+
+static const auto mailTypes = R"({
+    "EIP712Domain": [
+        {"name": "name", "type": "string"},
+        {"name": "version", "type": "string"},
+        {"name": "chainId", "type": "uint256"},
+        {"name": "verifyingContract", "type": "address"}
+    ],
+    "Person": [
+        {"name": "name", "type": "string"},
+        {"name": "wallets", "type": "address[]"}
+    ],
+    "Mail": [
+        {"name": "from", "type": "Person"},
+        {"name": "to", "type": "Person[]"},
+        {"name": "contents", "type": "string"}
+    ]
+})";
+
+static const auto mailDomain = R"({
+    "name": "Ether Mail",
+    "version": "1",
+    "chainId": 1,
+    "verifyingContract": "0xCcCCccccCCCCcCCCCCCcCcCccCcCCCcCcccccccC"
+})";
+
+static const auto mailMessage = R"({
+    "from": {
+        "name": "Cow",
+        "wallets": ["CD2a3d9F938E13CD947Ec05AbC7FE734Df8DD826", "DeaDbeefdEAdbeefdEadbEEFdeadbeEFdEaDbeeF"]
+    },
+    "to": [{
+        "name": "Bob",
+        "wallets": [
+            "bBbBBBBbbBBBbbbBbbBbbbbBBbBbbbbBbBbbBBbB",
+            "B0BdaBea57B0BDABeA57b0bdABEA57b0BDabEa57",
+            "B0B0b0b0b0b0B000000000000000000000000000"
+        ]
+    }],
+    "contents": "Hello, Bob!"
+})";
+
+// See 'signedTypeData_v4' in https://github.com/MetaMask/eth-sig-util/blob/main/test/index.ts
+TEST(TypedDataSchema, MailV4) {
+    const auto schema = TypedDataSchema::parse(mailTypes);
+    EXPECT_TRUE(schema.hasType("Person"));
+    EXPECT_FALSE(schema.hasType("address"));
+    EXPECT_EQ(schema.encodeType("Mail"), "Mail(Person from,Person[] to,string contents)Person(string name,address[] wallets)");
+    EXPECT_EQ(schema.encodeType("Person"), "Person(string name,address[] wallets)");
+    EXPECT_EQ(hex(schema.hashType("Mail")), "4bd8a9a2b93427bb184aca81e24beb30ffa3c747e2a33d4225ec08bf12e2e753");
+    EXPECT_EQ(hex(schema.hashType("Person")), "fabfe1ed996349fc6027709802be19d047da1aa5d6894ff5f6486d92db2e6860");
+
+    EXPECT_EQ(hex(schema.hashStruct("Person", R"({"name": "Cow", "wallets": ["CD2a3d9F938E13CD947Ec05AbC7FE734Df8DD826", "DeaDbeefdEAdbeefdEadbEEFdeadbeEFdEaDbeeF"]})")),
+              "9b4846dd48b866f0ac54d61b9b21a9e746f921cefa4ee94c4c0a1c49c774f67f");
+    EXPECT_EQ(hex(schema.hashStruct("Mail", mailMessage)), "eb4221181ff3f1a83ea7313993ca9218496e424604ba9492bb4052c03d5c3df8");
+
+    const auto domainSeparator = schema.domainSeparator(mailDomain);
+    EXPECT_EQ(hex(domainSeparator), "f2cee375fa42b42143804025fc449deafd50cc031ca257e0b194a650a912090f");
+    EXPECT_EQ(hex(schema.hashMessage(domainSeparator, "Mail", mailMessage)),
+              "a85c2e2b118698e88db68a8105b794a8cc7cec074e89ef991cb4f5f533819cc2");
+}
+
+TEST(TypedDataSchema, MatchesHashStructJson) {
+    const std::pair<const char*, const char*> files[] = {
+        {"eip712_walletconnect.json", "abc79f527273b9e7bca1b3f1ac6ad1a8431fa6dc34ece900deabcd6969856b5e"},
+        {"eip712_cryptofights.json", "db12328a6d193965801548e1174936c3aa7adbe1b54b3535a3c905bd4966467c"},
+        {"eip712_rarible.json", "df0200de55c05eb55af2597012767ea3af653d68000be49580f8e05acd91d366"},
+        {"eip712_snapshot_v4.json", "f558d08ad4a7651dbc9ec028cfcb4a8e6878a249073ef4fa694f85ee95f61c0f"},
+    };
+    for (const auto& [file, expected] : files) {
+        const auto typedData = loadTypedData(file);
+        EXPECT_EQ(hex(hashTypedData(typedData)), expected) << file;
+        EXPECT_EQ(hex(ParamStruct::hashStructJson(typedData)), expected) << file;
+    }
+
+    // recursive type, with missing struct members
+    const auto family = R"({
+        "types": {
+            "EIP712Domain": [
+                {"name": "name", "type": "string"},
+                {"name": "version", "type": "string"},
+                {"name": "chainId", "type": "uint256"},
+                {"name": "verifyingContract", "type": "address"}
+            ],
+            "Person": [
+                {"name": "name", "type": "string"},
+                {"name": "mother", "type": "Person"},
+                {"name": "father", "type": "Person"}
+            ]
+        },
+        "primaryType": "Person",
+        "domain": {
+            "name": "Family Tree",
+            "version": "1",
+            "chainId": 1,
+            "verifyingContract": "0xCcCCccccCCCCcCCCCCCcCcCccCcCCCcCcccccccC"
+        },
+        "message": {
+            "name": "Jon",
+            "mother": {"name": "Lyanna", "father": {"name": "Rickard"}},
+            "father": {"name": "Rhaegar", "father": {"name": "Aeris II"}}
+        }
+    })";
+    EXPECT_EQ(hex(hashTypedData(family)), "807773b9faa9879d4971b43856c4d60c2da15c6f8c062bd9d33afefb756de19c");
+    EXPECT_EQ(hex(hashTypedData(family)), hex(ParamStruct::hashStructJson(family)));
+}
+
+TEST(TypedDataSchema, EncodeType) {
+    // referenced types sorted by name, each once, whatever the nesting
+    const auto schema = TypedDataSchema::parse(R"({
+        "Order": [{"name": "items", "type": "Item[2][]"}, {"name": "fee", "type": "Fee"}, {"name": "amount", "type": "uint"}],
+        "Item": [{"name": "token", "type": "Token"}, {"name": "amount", "type": "uint256"}],
+        "Fee": [{"name": "token", "type": "Token"}, {"name": "recipient", "type": "address"}],
+        "Token": [{"name": "id", "type": "bytes32"}, {"name": "next", "type": "Token"}]
+    })");
+    EXPECT_EQ(schema.encodeType("Order"), "Order(Item[2][] items,Fee fee,uint256 amount)Fee(Token token,address recipient)"
+                                          "Item(Token token,uint256 amount)Token(bytes32 id,Token next)");
+    EXPECT_EQ(schema.encodeType("Token"), "Token(bytes32 id,Token next)");
+    EXPECT_EQ(hex(schema.hashType("Fee")), hex(Hash::keccak256(schema.encodeType("Fee"))));
+
+    EXPECT_EXCEPTION(TypedDataSchema::parse("NOT_A_JSON"), "Could not parse types Json");
+    EXPECT_EXCEPTION(TypedDataSchema::parse("[]"), "Expecting object");
+    EXPECT_EXCEPTION(TypedDataSchema::parse(R"({"A": {}})"), "Expecting array, in A");
+    EXPECT_EXCEPTION(TypedDataSchema::parse(R"({"A": [{"name": "a"}]})"), "Expecting 'name' and 'type', in A");
+    EXPECT_EXCEPTION(TypedDataSchema::parse(R"({"A": [{"name": "", "type": "uint8"}]})"), "Expecting 'name' and 'type', in A");
+    EXPECT_EXCEPTION(TypedDataSchema::parse(R"({"A": [{"name": "a", "type": "B"}]})"), "Unknown type B");
+    EXPECT_EXCEPTION(TypedDataSchema::parse(R"({"A": [{"name": "a", "type": "uint7"}]})"), "Unknown type uint7");
+    EXPECT_EXCEPTION(TypedDataSchema::parse(R"|({"A": [{"name": "a", "type": "(uint8)"}]})|"), "Unknown type (uint8)");
+    EXPECT_EXCEPTION(TypedDataSchema::parse(R"({"A": [{"name": "a", "type": "uint8[01]"}]})"), "Invalid type uint8[01]");
+    EXPECT_EXCEPTION(schema.encodeType("Mail"), "Type not found, Mail");
+}
+
+TEST(TypedDataSchema, Values) {
+    const auto schema = TypedDataSchema::parse(R"({
+        "Values": [
+            {"name": "u8", "type": "uint8"},
+            {"name": "i16", "type": "int16"},
+            {"name": "flag", "type": "bool"},
+            {"name": "id", "type": "bytes4"},
+            {"name": "data", "type": "bytes"},
+            {"name": "text", "type": "string"},
+            {"name": "grid", "type": "int256[2][]"},
+            {"name": "inner", "type": "Inner"}
+        ],
+        "Inner": [{"name": "owner", "type": "address"}]
+    })");
+    const auto hashOf = [&](const std::string& value) { return hex(schema.hashStruct("Values", value)); };
+
+    // hash built from the type hash and the encoded members
+    const auto typeHash = schema.hashType("Values");
+    Data expected = typeHash;
+    append(expected, parse_hex("00000000000000000000000000000000000000000000000000000000000000ff"));
+    append(expected, parse_hex("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff8000"));
+    append(expected, parse_hex("0000000000000000000000000000000000000000000000000000000000000001"));
+    append(expected, parse_hex("a9059cbb00000000000000000000000000000000000000000000000000000000"));
+    append(expected, Hash::keccak256(parse_hex("0102")));
+    append(expected, Hash::keccak256(TW::data("")));
+    Data row1 = parse_hex("0000000000000000000000000000000000000000000000000000000000000001"
+                          "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+    Data grid = Hash::keccak256(row1);
+    append(grid, Hash::keccak256(parse_hex("00000000000000000000000000000000000000000000000000000000000000ff"
+                                           "0000000000000000000000000000000000000000000000000000000000000000")));
+    append(expected, Hash::keccak256(grid));
+    append(expected, Data(32));
+    const auto hash = hex(Hash::keccak256(expected));
+
+    EXPECT_EQ(hashOf(R"({"u8": 255, "i16": -32768, "flag": true, "id": "0xa9059cbb", "data": "0x0102", "text": "",
+                         "grid": [[1, -1], [255, 0]], "inner": null})"), hash);
+    // in another order, with other representations, with other fields, with a missing struct
+    EXPECT_EQ(hashOf(R"({"extra": {"u8": [1, {"a": []}]}, "grid": [["0x1", "-1"], ["0xff", "0"]], "text": "",
+                         "data": "0102", "id": "a9059cbb", "flag": "true", "i16": "0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff8000",
+                         "u8": "255", "other": 1})"), hash);
+
+    const auto valid = json::parse(R"({"u8": 1, "i16": 1, "flag": 1, "id": "00", "data": "", "text": "t", "grid": [], "inner": {"owner": "0x00"}})");
+    EXPECT_NO_THROW(schema.hashStruct("Values", valid.dump()));
+    const auto with = [&](const std::string& member, const json& value) {
+        auto json = valid;
+        if (value.is_discarded()) {
+            json.erase(member);
+        } else {
+            json[member] = value;
+        }
+        return schema.hashStruct("Values", json.dump());
+    };
+    EXPECT_EXCEPTION(with("u8", 256), "Value out of range for uint8");
+    EXPECT_EXCEPTION(with("u8", -1), "Value out of range for uint8");
+    EXPECT_EXCEPTION(with("u8", "1.5"), "Invalid integer");
+    EXPECT_EXCEPTION(with("u8", 1.5), "Invalid integer 1.5");
+    EXPECT_EXCEPTION(with("u8", json::value_t::discarded), "Missing value for u8, in Values");
+    EXPECT_EXCEPTION(with("u8", nullptr), "Missing value for uint8");
+    EXPECT_EXCEPTION(with("i16", 32768), "Value out of range for int16");
+    EXPECT_EXCEPTION(with("i16", "-32769"), "Value out of range for int16");
+    EXPECT_EXCEPTION(with("flag", "yes"), "Expecting bool");
+    EXPECT_EXCEPTION(with("flag", 2), "Expecting bool");
+    EXPECT_EXCEPTION(with("id", "0x0102030405"), "Invalid value for bytes4");
+    EXPECT_EQ(hex(with("data", "0x102")), hex(with("data", "0x0102")));
+    EXPECT_EQ(hex(with("id", "0x0")), hex(with("id", "0x00000000")));
+    EXPECT_EXCEPTION(with("data", "hello"), "Invalid hex value");
+    EXPECT_EXCEPTION(with("text", 1), "Expecting string");
+    EXPECT_EXCEPTION(with("grid", json::parse("[[1]]")), "Wrong number of elements for int256[2][]");
+    EXPECT_EXCEPTION(with("grid", json::parse("[1, 2]")), "Expecting array");
+    EXPECT_EXCEPTION(with("grid", json::parse("{}")), "Unexpected object for int256[2][]");
+    EXPECT_EXCEPTION(with("inner", json::parse("[]")), "Unexpected array for Inner");
+    EXPECT_EXCEPTION(with("inner", json::parse(R"({"owner": "0x0000000000000000000000000000000000000000ff"})")), "Invalid address");
+    EXPECT_EXCEPTION(with("inner", json::parse(R"({})")), "Missing value for owner, in Inner");
+    EXPECT_EXCEPTION(schema.hashStruct("Values", "[]"), "Unexpected array for Values");
+    EXPECT_EXCEPTION(schema.hashStruct("Values", "null"), "Missing value for Values");
+    EXPECT_EXCEPTION(schema.hashStruct("Values", R"({"u8": 1)"), "Could not parse Json");
+    EXPECT_EXCEPTION(schema.hashStruct("Other", "{}"), "Type not found, Other");
+}
+
+TEST(TypedDataSchema, HashMessages) {
+    const auto schema = TypedDataSchema::parse(mailTypes);
+    const auto domainSeparator = schema.domainSeparator(mailDomain);
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < 500; ++i) {
+        auto message = json::parse(mailMessage);
+        message["contents"] = "Hello " + std::to_string(i);
+        if (i % 50 == 7) {
+            message["from"]["wallets"][0] = "invalid";
+        }
+        messages.push_back(message.dump());
+    }
+    const auto hashes = schema.hashMessages(domainSeparator, "Mail", messages, 4);
+    ASSERT_EQ(hashes.size(), messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        if (i % 50 == 7) {
+            EXPECT_TRUE(hashes[i].empty());
+        } else {
+            EXPECT_EQ(hex(hashes[i]), hex(schema.hashMessage(domainSeparator, "Mail", messages[i]))) << i;
+        }
+    }
+    EXPECT_EXCEPTION(schema.hashMessages(domainSeparator, "Other", messages), "Type not found, Other");
+    EXPECT_EXCEPTION(schema.hashMessages(Data(31), "Mail", messages), "Invalid domain separator");
+}
+
+TEST(TypedDataSchema, DISABLED_Benchmark_HashMessages) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // Orders with 20 items each, hashed with hashStructJson, and with a schema one by one and in bulk.
+    const auto count = 1000;
+    const auto time = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    const auto types = json::parse(R"({
+        "EIP712Domain": [{"name": "name", "type": "string"}, {"name": "chainId", "type": "uint256"}],
+        "Item": [{"name": "token", "type": "address"}, {"name": "identifier", "type": "uint256"}, {"name": "amount", "type": "uint256"}],
+        "Order": [{"name": "offerer", "type": "address"}, {"name": "items", "type": "Item[]"}, {"name": "salt", "type": "uint256"}]
+    })");
+    const auto domain = json::parse(R"({"name": "Market", "chainId": 1})");
+    std::vector<std::string> typedData;
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < count; ++i) {
+        auto message = json{{"offerer", "0x5aaeb6053f3e94c9b9a09f33669435e7ef1beaed"}, {"salt", std::to_string(i)}, {"items", json::array()}};
+        for (size_t j = 0; j < 20; ++j) {
+            message["items"].push_back({{"token", "0xdac17f958d2ee523a2206206994597c13d831ec7"}, {"identifier", j}, {"amount", "1000000000000000000"}});
+        }
+        messages.push_back(message.dump());
+        typedData.push_back(json{{"types", types}, {"primaryType", "Order"}, {"domain", domain}, {"message", message}}.dump());
+    }
+    const auto schema = TypedDataSchema(types);
+    const auto domainSeparator = schema.domainSeparator(domain.dump());
+
+    size_t sink = 0;
+    const auto tree = time([&] {
+        for (const auto& data : typedData) {
+            sink += ParamStruct::hashStructJson(data)[0];
+        }
+    });
+    const auto single = time([&] {
+        for (const auto& message : messages) {
+            sink += schema.hashMessage(domainSeparator, "Order", message)[0];
+        }
+    });
+    const auto bulk = time([&] {
+        for (const auto& hash : schema.hashMessages(domainSeparator, "Order", messages)) {
+            sink += hash[0];
+        }
+    });
+    std::cout << count << " messages: hashStructJson " << tree << " ms, schema " << single << " ms, bulk " << bulk << " ms" << std::endl;
+    EXPECT_NE(sink, 0);
+}
@@ -6,6 +6,7 @@
 
 #include "Bitcoin/OutPoint.h"
 #include "Bitcoin/Script.h"
+#include "Groestlcoin/Transaction.h"
 #include "Hash.h"
 #include "HexCoding.h"
 #include "PrivateKey.h"
@@ -187,3 +188,26 @@ TEST(GroestlcoinSigning, PlanP2WPKH) {
     EXPECT_TRUE(verifyPlan(plan, {4774}, 2500, 145));
     EXPECT_EQ(plan.branch_id(), "");
 }
+
+TEST(GroestlcoinSigning, SigHashCache) {
+    // single sha256 signature hashes, computed without the cache before it was introduced
+    auto transaction = Groestlcoin::Transaction(1, 0);
+    for (auto i = 0; i < 4; ++i) {
+        auto outpoint = OutPoint(parse_hex("5897de6bd6027a475eadd57019d4e6872c396d0716c4875a5f1a6fcfdf385c1f"), i);
+        transaction.inputs.emplace_back(outpoint, Script(), 4294967295 - i);
+    }
+    transaction.outputs.emplace_back(18000000, Script(parse_hex("76a9141fc11f39be1729bf973a7ab6a615ca4729d6457488ac")));
+    transaction.outputs.emplace_back(400000000, Script(parse_hex("76a914f2d4db28cad6502226ee484ae24505c2885cb12d88ac")));
+
+    const auto scriptCode = Script(parse_hex("76a9141fc11f39be1729bf973a7ab6a615ca4729d6457488ac"));
+    const auto cache = transaction.getSigHashCache();
+    const auto singleAnyoneCanPay = static_cast<TWBitcoinSigHashType>(TWBitcoinSigHashTypeSingle | TWBitcoinSigHashTypeAnyoneCanPay);
+    EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, 1, TWBitcoinSigHashTypeAll, 1000, BASE, cache)),
+              "87e9c306469a4c9ec3a7dc6e35d01b5020c1fa49f6a2859cce01bc8c83add637");
+    EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, 1, TWBitcoinSigHashTypeAll, 1000, WITNESS_V0, cache)),
+              "0e0910f6ef171ff7c8fdeeb30f49a0e5a543ba3f4fb64d064e1386a91fb22b42");
+    EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, 1, singleAnyoneCanPay, 1000, BASE, cache)),
+              "6bbd825f1ad08f8be1609ce41dc54fc4f368256dd724708831883e1d2c2bcbd5");
+    EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, 1, singleAnyoneCanPay, 1000, WITNESS_V0, cache)),
+              "c5758d32cc4d7cc2eb50b3a4c6eb2daa1cabbbbcfdf5b96821883520862647d3");
+}
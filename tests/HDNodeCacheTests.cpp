@@ -0,0 +1,60 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "HDNodeCache.h"
+
+#include <gtest/gtest.h>
+
+namespace TW {
+
+static HDNode node(uint32_t childNum) {
+    auto node = HDNode();
+    node.child_num = childNum;
+    node.private_key[0] = static_cast<uint8_t>(childNum);
+    return node;
+}
+
+TEST(HDNodeCache, GetPut) {
+    auto cache = HDNodeCache();
+    auto result = HDNode();
+    EXPECT_FALSE(cache.get(TWCurveSECP256k1, {}, result));
+
+    cache.put(TWCurveSECP256k1, {}, node(0));
+    cache.put(TWCurveSECP256k1, {0x8000002c}, node(1));
+    cache.put(TWCurveED25519, {0x8000002c}, node(2));
+    EXPECT_EQ(cache.size(), 3ul);
+
+    ASSERT_TRUE(cache.get(TWCurveSECP256k1, {0x8000002c}, result));
+    EXPECT_EQ(result.child_num, 1u);
+    ASSERT_TRUE(cache.get(TWCurveED25519, {0x8000002c}, result));
+    EXPECT_EQ(result.child_num, 2u);
+    EXPECT_FALSE(cache.get(TWCurveSECP256k1, {0x8000002c, 0x8000003c}, result));
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0ul);
+    EXPECT_FALSE(cache.get(TWCurveSECP256k1, {}, result));
+}
+
+TEST(HDNodeCache, EvictLeastRecentlyUsed) {
+    auto cache = HDNodeCache(2);
+    auto result = HDNode();
+    cache.put(TWCurveSECP256k1, {1}, node(1));
+    cache.put(TWCurveSECP256k1, {2}, node(2));
+    ASSERT_TRUE(cache.get(TWCurveSECP256k1, {1}, result));
+    cache.put(TWCurveSECP256k1, {3}, node(3));
+
+    EXPECT_EQ(cache.size(), 2ul);
+    EXPECT_TRUE(cache.get(TWCurveSECP256k1, {1}, result));
+    EXPECT_FALSE(cache.get(TWCurveSECP256k1, {2}, result));
+    EXPECT_TRUE(cache.get(TWCurveSECP256k1, {3}, result));
+    EXPECT_EQ(result.private_key[0], 3);
+
+    auto disabled = HDNodeCache(0);
+    disabled.put(TWCurveSECP256k1, {1}, node(1));
+    EXPECT_EQ(disabled.size(), 0ul);
+}
+
+} // namespace TW
@@ -19,6 +19,10 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+#include <set>
+
 namespace TW {
 
 const auto mnemonic1 = "ripple scissors kick mammal hire column oak again sun offer wealth tomorrow wagon turn fatal";
@@ -203,4 +207,126 @@ TEST(HDWallet, DeriveWithLeadingZerosEth) {
     EXPECT_EQ(addr.string(), "0x0ba17e928471c64AaEaf3ABfB3900EF4c27b380D");
 }
 
+TEST(HDWallet, NodeCache) {
+    // Keys derived with cached intermediate nodes match those of a fresh wallet, in any order
+    const auto coin = TWCoinTypeEthereum;
+    const auto path = [](uint32_t account, uint32_t index) { return DerivationPath(TWPurposeBIP44, coin, account, 0, index); };
+    auto wallet = HDWallet(mnemonic1, passphrase);
+    std::vector<std::string> keys;
+    for (uint32_t account = 0; account < 2; ++account) {
+        for (uint32_t index = 0; index < 3; ++index) {
+            keys.push_back(hex(wallet.getKey(coin, path(account, index)).bytes));
+        }
+    }
+    auto other = HDWallet(mnemonic1, passphrase);
+    for (auto i = keys.size(); i > 0; --i) {
+        const auto key = other.getKey(coin, path(static_cast<uint32_t>((i - 1) / 3), static_cast<uint32_t>((i - 1) % 3)));
+        EXPECT_EQ(hex(key.bytes), keys[i - 1]);
+    }
+    EXPECT_EQ(std::set<std::string>(keys.begin(), keys.end()).size(), keys.size());
+
+    // parent and master keys, other curves
+    EXPECT_EQ(hex(wallet.getKey(coin, DerivationPath("m/44'/60'/0'/0")).bytes), hex(HDWallet(mnemonic1, passphrase).getKey(coin, DerivationPath("m/44'/60'/0'/0")).bytes));
+    EXPECT_EQ(hex(wallet.getMasterKey(TWCurveSECP256k1).bytes), hex(HDWallet(mnemonic1, passphrase).getMasterKey(TWCurveSECP256k1).bytes));
+    EXPECT_EQ(hex(wallet.getKey(TWCoinTypeNEO, DerivationPath("m/44'/60'/0'/0/0")).bytes), hex(HDWallet(mnemonic1, passphrase).getKey(TWCoinTypeNEO, DerivationPath("m/44'/60'/0'/0/0")).bytes));
+    EXPECT_NE(hex(wallet.getKey(TWCoinTypeNEO, DerivationPath("m/44'/60'/0'/0/0")).bytes), keys[0]);
+
+    // copies share the cache
+    auto copy = wallet;
+    EXPECT_EQ(hex(copy.getKey(coin, path(0, 1)).bytes), keys[1]);
+
+    // moved-from wallets get an empty cache
+    auto moved = std::move(copy);
+    EXPECT_EQ(hex(moved.getKey(coin, path(1, 2)).bytes), keys[5]);
+    EXPECT_EQ(hex(copy.getKey(coin, path(1, 2)).bytes), keys[5]);
+    auto assigned = HDWallet(mnemonic1, "");
+    assigned = std::move(moved);
+    EXPECT_EQ(hex(assigned.getKey(coin, path(0, 0)).bytes), keys[0]);
+    EXPECT_EQ(hex(moved.getKey(coin, path(0, 0)).bytes), keys[0]);
+
+    const auto leadingZeros = HDWallet("name dash bleak force moral disease shine response menu rescue more will", "");
+    for (auto i = 0; i < 2; ++i) {
+        const auto addr = Ethereum::Address(leadingZeros.getKey(coin, DerivationPath("m/44'/60'")).getPublicKey(TW::publicKeyType(coin)));
+        EXPECT_EQ(addr.string(), "0x0ba17e928471c64AaEaf3ABfB3900EF4c27b380D");
+    }
+}
+
+TEST(HDWallet, DeriveAddresses) {
+    const auto coin = TWCoinTypeEthereum;
+    const auto wallet = HDWallet(mnemonic1, passphrase);
+    std::vector<std::string> expected;
+    for (uint32_t index = 5; index < 25; ++index) {
+        expected.push_back(TW::deriveAddress(coin, wallet.getKey(coin, DerivationPath(TWPurposeBIP44, coin, 1, 0, index))));
+    }
+    EXPECT_EQ(HDWallet(mnemonic1, passphrase).deriveAddresses(coin, 1, 0, 5, 20), expected);
+    EXPECT_EQ(HDWallet(mnemonic1, passphrase).deriveAddresses(coin, 1, 0, 5, 20, 4), expected);
+    EXPECT_EQ(wallet.deriveAddresses(coin, 1, 0, 5, 20, 0), expected);
+    EXPECT_EQ(wallet.deriveAddresses(coin, 1, 0, 5, 0), std::vector<std::string>());
+
+    // from the account extended public key
+    const auto xpub = wallet.getExtendedPublicKey(TWPurposeBIP44, coin, TWHDVersionXPUB);
+    const auto addresses = HDWallet::deriveAddressesFromExtended(xpub, coin, 0, 5, 20, 4);
+    ASSERT_TRUE(addresses.has_value());
+    for (uint32_t i = 0; i < 20; ++i) {
+        EXPECT_EQ(addresses->at(i), TW::deriveAddress(coin, wallet.getKey(coin, DerivationPath(TWPurposeBIP44, coin, 0, 0, 5 + i))));
+    }
+    EXPECT_FALSE(HDWallet::deriveAddressesFromExtended("xpub", coin, 0, 5, 20).has_value());
+    // hardened change index, not derivable from a public key
+    EXPECT_FALSE(HDWallet::deriveAddressesFromExtended(xpub, coin, 0x80000000, 5, 20).has_value());
+
+    EXPECT_EXCEPTION(wallet.deriveAddresses(coin, 0, 0, 0x80000000, 1), "Invalid address index range");
+    EXPECT_EXCEPTION(wallet.deriveAddresses(coin, 0, 0, 0x7fffffff, 2), "Invalid address index range");
+    EXPECT_EXCEPTION(HDWallet::deriveAddressesFromExtended(xpub, coin, 0, 0x7fffffff, 2), "Invalid address index range");
+}
+
+TEST(HDWallet, DeriveAddressesEd25519) {
+    // no public derivation on ed25519: change and address indices are hardened
+    const auto coin = TWCoinTypeSolana;
+    const auto wallet = HDWallet(mnemonic1, passphrase);
+    const auto addresses = wallet.deriveAddresses(coin, 1, 0, 5, 3, 2);
+    ASSERT_EQ(addresses.size(), 3);
+    EXPECT_EQ(addresses[0], "6PwzN2pfUcbaGG14CDq9MUCXYjD4dHt2kyAJzp4FLsY5");
+    for (uint32_t i = 0; i < 3; ++i) {
+        const auto derivationPath = DerivationPath("m/44'/501'/1'/0'/" + std::to_string(5 + i) + "'");
+        EXPECT_EQ(addresses[i], TW::deriveAddress(coin, wallet.getKey(coin, derivationPath)));
+    }
+}
+
+TEST(HDWallet, DISABLED_Benchmark_DeriveSiblings) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // Only the first key of an account derives the hardened steps, the others only the last step.
+    const auto coin = TWCoinTypeEthereum;
+    auto wallet = HDWallet(mnemonic1, passphrase);
+    for (auto count : {1, 10, 100, 1000}) {
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < count; ++i) {
+            wallet.getKey(coin, DerivationPath(TWPurposeBIP44, coin, static_cast<uint32_t>(count), 0, i));
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "derive " << count << " sibling keys: " << elapsed << " us, " << elapsed / count << " us/key" << std::endl;
+    }
+}
+
+TEST(HDWallet, DISABLED_Benchmark_DeriveAddresses) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // Gap-limit scan: addresses one by one, as a range, and as a range on all cores.
+    const auto coin = TWCoinTypeEthereum;
+    const auto count = 2000;
+    const auto time = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    const auto single = time([&] {
+        const auto wallet = HDWallet(mnemonic1, passphrase);
+        for (auto i = 0; i < count; ++i) {
+            TW::deriveAddress(coin, wallet.getKey(coin, DerivationPath(TWPurposeBIP44, coin, 0, 0, i)));
+        }
+    });
+    const auto range = time([&] { HDWallet(mnemonic1, passphrase).deriveAddresses(coin, 0, 0, 0, count); });
+    const auto threads = time([&] { HDWallet(mnemonic1, passphrase).deriveAddresses(coin, 0, 0, 0, count, 0); });
+    std::cout << "derive " << count << " addresses: " << single << " ms one by one, " << range << " ms range, "
+              << threads << " ms range on all cores" << std::endl;
+}
+
 } // namespace
@@ -5,10 +5,16 @@
 // file LICENSE at the root of the source code distribution tree.
 
 #include "Hash.h"
+#include "Hashers.h"
 #include "HexCoding.h"
 
+#include <TrezorCrypto/sha2.h>
+#include <TrezorCrypto/sha3.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 using namespace std;
 using namespace TW;
 
@@ -65,4 +71,245 @@ TEST(HashTests, hmac256) {
     EXPECT_EQ(hex(hmac), expectedHmac);
 }
 
+/// Messages of all lengths from 0 to 300 bytes, crossing block boundaries of all hashes.
+static vector<Data> multiMessages() {
+    vector<Data> messages;
+    for (size_t size = 0; size <= 300; ++size) {
+        Data message(size);
+        for (size_t i = 0; i < size; ++i) {
+            message[i] = static_cast<TW::byte>(size * 31 + i);
+        }
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+TEST(HashTests, Multi) {
+    const auto messages = multiMessages();
+    vector<const TW::byte*> data;
+    vector<size_t> sizes;
+    for (const auto& message : messages) {
+        data.push_back(message.data());
+        sizes.push_back(message.size());
+    }
+
+    const auto sha256 = Hash::sha256Multi(messages);
+    const auto keccak256 = Hash::keccak256Multi(messages);
+    vector<Hash::Digest<Hash::ripemdSize>> ripemd(messages.size());
+    vector<Hash::Digest<Hash::ripemdSize>> sha256ripemd(messages.size());
+    Hash::ripemdMulti(data.data(), sizes.data(), messages.size(), ripemd.data());
+    Hash::sha256ripemdMulti(data.data(), sizes.data(), messages.size(), sha256ripemd.data());
+    ASSERT_EQ(sha256.size(), messages.size());
+    ASSERT_EQ(keccak256.size(), messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        EXPECT_EQ(hex(sha256[i]), hex(Hash::sha256(messages[i]))) << i;
+        EXPECT_EQ(hex(keccak256[i]), hex(Hash::keccak256(messages[i]))) << i;
+        EXPECT_EQ(hex(ripemd[i]), hex(Hash::ripemd(messages[i]))) << i;
+        EXPECT_EQ(hex(sha256ripemd[i]), hex(Hash::sha256ripemd(messages[i].data(), messages[i].size()))) << i;
+    }
+
+    // any count, not just multiples of the lane count
+    for (size_t count = 0; count <= 20; ++count) {
+        vector<Hash::Digest<Hash::sha256Size>> digests(count);
+        Hash::sha256Multi(data.data() + 100, sizes.data() + 100, count, digests.data());
+        for (size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(digests[i], sha256[100 + i]) << count;
+        }
+    }
+    EXPECT_EQ(hex(Hash::keccak256Multi(vector<string>{brownFox})[0]), "4d741b6f1eb29cb2a9b9911c82f56fa8d73b04959d3d9d222895df6c0b28aa15");
+}
+
+TEST(HashTests, DISABLED_Benchmark_Multi) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // Public key sized messages, as in address derivation: one by one with the scalar functions, and multi-buffer.
+    const auto count = 100000;
+    const auto time = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    for (size_t size : {33, 64}) {
+        vector<Data> messages(count, Data(size));
+        vector<const TW::byte*> data;
+        vector<size_t> sizes;
+        for (size_t i = 0; i < messages.size(); ++i) {
+            messages[i][0] = static_cast<TW::byte>(i);
+            messages[i][1] = static_cast<TW::byte>(i >> 8);
+            data.push_back(messages[i].data());
+            sizes.push_back(messages[i].size());
+        }
+        vector<Hash::Digest<Hash::sha256Size>> digests(count);
+        const auto sha256 = time([&] {
+            for (size_t i = 0; i < count; ++i) {
+                sha256_Raw(data[i], sizes[i], digests[i].data());
+            }
+        });
+        const auto sha256Multi = time([&] { Hash::sha256Multi(data.data(), sizes.data(), count, digests.data()); });
+        const auto keccak256 = time([&] {
+            for (size_t i = 0; i < count; ++i) {
+                keccak_256(data[i], sizes[i], digests[i].data());
+            }
+        });
+        const auto keccak256Multi = time([&] { Hash::keccak256Multi(data.data(), sizes.data(), count, digests.data()); });
+        std::cout << "hash " << count << " messages of " << size << " bytes: SHA256 " << sha256 << " ms, multi " << sha256Multi
+                  << " ms; Keccak256 " << keccak256 << " ms, multi " << keccak256Multi << " ms" << std::endl;
+    }
+}
+
+const Hash::HasherType allHasherTypes[] = {
+    Hash::HasherType::sha1,           Hash::HasherType::sha256,         Hash::HasherType::sha512,
+    Hash::HasherType::sha512_256,     Hash::HasherType::keccak256,      Hash::HasherType::keccak512,
+    Hash::HasherType::sha3_256,       Hash::HasherType::sha3_512,       Hash::HasherType::ripemd,
+    Hash::HasherType::blake256,       Hash::HasherType::groestl512,     Hash::HasherType::sha256d,
+    Hash::HasherType::sha256ripemd,   Hash::HasherType::sha3_256ripemd, Hash::HasherType::blake256d,
+    Hash::HasherType::blake256ripemd, Hash::HasherType::groestl512d,
+};
+
+TEST(HashTests, HasherType) {
+    static_assert(Hash::digestSize(Hash::HasherType::sha1) == 20);
+    static_assert(Hash::digestSize(Hash::HasherType::sha256ripemd) == 20);
+    static_assert(Hash::digestSize(Hash::HasherType::keccak256) == 32);
+    static_assert(Hash::digestSize(Hash::HasherType::groestl512d) == 64);
+    static_assert(std::is_same_v<decltype(Hash::digest<Hash::HasherType::sha256d>(brownFox)), Hash::Digest<32>>);
+
+    const auto data = Data(brownFox.begin(), brownFox.end());
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::sha1, data)), hex(Hash::sha1(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::sha256, data)), hex(Hash::sha256(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::sha512, data)), hex(Hash::sha512(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::sha512_256, data)), hex(Hash::sha512_256(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::keccak256, data)), hex(Hash::keccak256(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::keccak512, data)), hex(Hash::keccak512(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::sha3_256, data)), hex(Hash::sha3_256(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::sha3_512, data)), hex(Hash::sha3_512(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::ripemd, data)), hex(Hash::ripemd(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::blake256, data)), hex(Hash::blake256(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::groestl512, data)), hex(Hash::groestl512(data)));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::sha256d, data)), hex(Hash::sha256(Hash::sha256(data))));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::sha256ripemd, data)), hex(Hash::ripemd(Hash::sha256(data))));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::sha3_256ripemd, data)), hex(Hash::ripemd(Hash::sha3_256(data))));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::blake256d, data)), hex(Hash::blake256(Hash::blake256(data))));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::blake256ripemd, data)), hex(Hash::ripemd(Hash::blake256(data))));
+    EXPECT_EQ(hex(Hash::hash(Hash::HasherType::groestl512d, data)), hex(Hash::groestl512(Hash::groestl512(data))));
+
+    for (const auto type : allHasherTypes) {
+        const auto expected = Hash::hash(type, data);
+        EXPECT_EQ(expected.size(), Hash::digestSize(type));
+        EXPECT_EQ(hex(Hash::hasher(type)(data.data(), data.size())), hex(expected));
+        EXPECT_EQ(hex(Hash::hash(type, Data())), hex(Hash::hasher(type)(nullptr, 0)));
+    }
+    EXPECT_EQ(hex(Hash::digest<Hash::HasherType::keccak256>(brownFox)), "4d741b6f1eb29cb2a9b9911c82f56fa8d73b04959d3d9d222895df6c0b28aa15");
+}
+
+/// Hashes `data` in one update and in uneven pieces, and checks both agree with `expected`.
+template <typename H>
+static void checkIncremental(H& hasher, const Data& data, const Data& expected) {
+    EXPECT_EQ(hex(hasher.update(data).final()), hex(expected));
+    // final() starts over
+    size_t offset = 0;
+    for (size_t piece = 1; offset < data.size(); piece = piece * 3 + 1) {
+        const auto size = std::min(piece, data.size() - offset);
+        hasher.update(data.data() + offset, size);
+        offset += size;
+    }
+    EXPECT_EQ(hex(hasher.final()), hex(expected));
+}
+
+TEST(HashTests, Incremental) {
+    Data data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<TW::byte>(i * 7);
+    }
+    {
+        Hash::Sha1 hasher;
+        checkIncremental(hasher, data, Hash::sha1(data));
+        EXPECT_EQ(hex(Hash::Sha1::hash(data)), hex(Hash::sha1(data)));
+    }
+    {
+        Hash::Sha256 hasher;
+        checkIncremental(hasher, data, Hash::sha256(data));
+    }
+    {
+        Hash::Sha512 hasher;
+        checkIncremental(hasher, data, Hash::sha512(data));
+    }
+    {
+        Hash::Sha512_256 hasher;
+        checkIncremental(hasher, data, Hash::sha512_256(data));
+    }
+    {
+        Hash::Keccak256 hasher;
+        checkIncremental(hasher, data, Hash::keccak256(data));
+    }
+    {
+        Hash::Keccak512 hasher;
+        checkIncremental(hasher, data, Hash::keccak512(data));
+    }
+    {
+        Hash::Sha3_256 hasher;
+        checkIncremental(hasher, data, Hash::sha3_256(data));
+    }
+    {
+        Hash::Sha3_512 hasher;
+        checkIncremental(hasher, data, Hash::sha3_512(data));
+    }
+    {
+        Hash::Ripemd160 hasher;
+        checkIncremental(hasher, data, Hash::ripemd(data));
+    }
+    {
+        Hash::Blake256 hasher;
+        checkIncremental(hasher, data, Hash::blake256(data));
+    }
+    {
+        Hash::Groestl512 hasher;
+        checkIncremental(hasher, data, Hash::groestl512(data));
+    }
+    {
+        Hash::Blake2b<32> hasher;
+        checkIncremental(hasher, data, Hash::blake2b(data, 32));
+        EXPECT_EQ(hex(Hash::Blake2b<32>::hash(data)), hex(Hash::blake2b(data, 32)));
+    }
+    {
+        const auto personal = parse_hex("5a636173685f504f5748617368");
+        auto padded = personal;
+        padded.resize(16);
+        Hash::Blake2b<64> hasher(padded);
+        checkIncremental(hasher, data, Hash::blake2b(data, 64, padded));
+        EXPECT_THROW(Hash::Blake2b<64>{personal}, std::invalid_argument);
+    }
+    EXPECT_EQ(hex(Hash::Keccak256::hash(brownFox)), "4d741b6f1eb29cb2a9b9911c82f56fa8d73b04959d3d9d222895df6c0b28aa15");
+}
+
+TEST(HashTests, DISABLED_Benchmark_Digest) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // Public key sized messages hashed to a Data result, and to a fixed size digest.
+    const auto count = 1000000;
+    const auto time = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    Data message(33, 2);
+    size_t sink = 0;
+    const auto run = [&](const char* name, const auto& f) {
+        const auto ms = time([&] {
+            for (size_t i = 0; i < count; ++i) {
+                message[1] = static_cast<TW::byte>(i);
+                sink += f()[0];
+            }
+        });
+        std::cout << name << ": " << count << " hashes in " << ms << " ms" << std::endl;
+    };
+    run("sha256d Data", [&] { return Hash::sha256d(message.data(), message.size()); });
+    run("sha256d Digest", [&] { return Hash::digest<Hash::HasherType::sha256d>(message); });
+    run("sha256ripemd Data", [&] { return Hash::sha256ripemd(message.data(), message.size()); });
+    run("sha256ripemd Digest", [&] { return Hash::digest<Hash::HasherType::sha256ripemd>(message); });
+    run("keccak256 Data", [&] { return Hash::keccak256(message); });
+    run("keccak256 Keccak256", [&] { return Hash::Keccak256::hash(message); });
+    const Hash::Hasher hasher = Hash::blake256d;
+    run("blake256d Hasher", [&] { return hasher(message.data(), message.size()); });
+    run("blake256d Digest", [&] { return Hash::digest<Hash::HasherType::blake256d>(message); });
+    EXPECT_NE(sink, 0);
+}
+
 // More tests in TWHashTests
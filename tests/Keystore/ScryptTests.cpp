@@ -0,0 +1,63 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "Keystore/Scrypt.h"
+
+#include "HexCoding.h"
+
+#include <TrezorCrypto/scrypt.h>
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace TW::Keystore {
+
+static ScryptParameters params(const std::string& salt, uint32_t n, uint32_t r, uint32_t p) {
+    return ScryptParameters(TW::data(salt), n, r, p, 64);
+}
+
+// Test vectors from RFC 7914, section 12
+TEST(Scrypt, RFC7914) {
+    EXPECT_EQ(hex(scrypt(Data(), params("", 16, 1, 1), 64)),
+              "77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede21442fcd0069ded0948f8326a753a0fc81f17e8d3e0fb2e0d3628cf35e20c38d18906");
+    EXPECT_EQ(hex(scrypt(TW::data("password"), params("NaCl", 1024, 8, 16), 64)),
+              "fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b3731622eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640");
+    EXPECT_EQ(hex(scrypt(TW::data("pleaseletmein"), params("SodiumChloride", 16384, 8, 1), 64)),
+              "7023bdcb3afd7348461c06cd81fd38ebfda8fbba904f8e3ea9b543f6545da1f2d5432955613f0fcf62d49705242a9af9e61e85dc0d651e40dfcf017b45575887");
+}
+
+TEST(Scrypt, ThreadsAndScratch) {
+    const auto password = TW::data("password");
+    const auto p = params("NaCl", 1024, 8, 16);
+    Data expected(64);
+    ASSERT_EQ(::scrypt(password.data(), password.size(), p.salt.data(), p.salt.size(), p.n, p.r, p.p, expected.data(),
+                       expected.size()),
+              0);
+
+    ScryptScratch scratch;
+    for (size_t threads : {1, 3, 0}) {
+        EXPECT_EQ(hex(scrypt(password, p, 64, nullptr, threads)), hex(expected));
+        EXPECT_EQ(hex(scrypt(password, p, 64, &scratch, threads)), hex(expected));
+    }
+    EXPECT_GE(scratch.size(), 1);
+    EXPECT_LE(scratch.size(), 16);
+
+    scratch.clear();
+    EXPECT_EQ(scratch.size(), 0);
+    EXPECT_EQ(hex(scrypt(password, p, 64, &scratch, 1)), hex(expected));
+    EXPECT_EQ(scratch.size(), 1);
+}
+
+TEST(Scrypt, InvalidParameters) {
+    auto p = params("NaCl", 1024, 8, 1);
+    p.n = 1000;
+    EXPECT_THROW(scrypt(TW::data("password"), p, 32), std::invalid_argument);
+    p.n = 1024;
+    p.p = 0;
+    EXPECT_THROW(scrypt(TW::data("password"), p, 32), std::invalid_argument);
+}
+
+} // namespace TW::Keystore
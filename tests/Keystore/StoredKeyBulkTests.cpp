@@ -0,0 +1,156 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "Keystore/StoredKeyBulk.h"
+
+#include "HexCoding.h"
+#include "../interface/TWTestUtilities.h"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+extern std::string TESTS_ROOT;
+
+namespace TW::Keystore {
+
+using namespace std;
+
+static const auto bulkPassword = TW::data("password");
+static const vector<string> bulkPrivateKeys = {
+    "3a1076bf45ab87712ad64ccb3b10217737f7faacbf2872e88fdd9a537d8fe266",
+    "7a28b5ba57c53603b0b07b56bba752f7784bf506fa95edc395f5cf6c7514fe9d",
+    "4646464646464646464646464646464646464646464646464646464646464646",
+};
+
+/// Writes the test keys, a file that is not a key and one with another password into a fresh directory.
+static string writeBulkKeys(const string& name) {
+    const auto directory = getTestTempDir() + "/" + name;
+    mkdir(directory.c_str(), 0700);
+    for (size_t i = 0; i < bulkPrivateKeys.size(); ++i) {
+        auto key = StoredKey::createWithPrivateKey("key" + to_string(i), bulkPassword, parse_hex(bulkPrivateKeys[i]));
+        key.store(directory + "/key" + to_string(i) + ".json");
+    }
+    ofstream(directory + "/invalid.json") << "{}";
+    auto other = StoredKey::createWithPrivateKey("other", TW::data("other"), parse_hex(bulkPrivateKeys[0]));
+    other.store(directory + "/other.json");
+    ofstream(directory + "/notes.txt") << "not a key";
+    return directory;
+}
+
+TEST(StoredKeyBulk, ListFiles) {
+    const auto directory = writeBulkKeys("StoredKeyBulk_list");
+    const auto paths = listStoredKeyFiles(directory);
+    ASSERT_EQ(paths.size(), 5);
+    EXPECT_EQ(paths[0], directory + "/invalid.json");
+    EXPECT_EQ(paths[1], directory + "/key0.json");
+    EXPECT_EQ(paths[4], directory + "/other.json");
+
+    EXPECT_THROW(listStoredKeyFiles(directory + "/missing"), invalid_argument);
+}
+
+TEST(StoredKeyBulk, Unlock) {
+    const auto directory = writeBulkKeys("StoredKeyBulk_unlock");
+    auto paths = listStoredKeyFiles(directory);
+    paths.push_back(directory + "/missing.json");
+    paths.push_back(TESTS_ROOT + "/Keystore/Data/pbkdf2.json");
+
+    for (size_t threads : {1, 0}) {
+        BulkOptions options;
+        options.threads = threads;
+        const auto results = unlockStoredKeys(paths, bulkPassword, options);
+        ASSERT_EQ(results.size(), paths.size());
+
+        EXPECT_EQ(results[0].path, paths[0]);
+        EXPECT_EQ(results[0].error, "Invalid key file");
+        for (size_t i = 0; i < bulkPrivateKeys.size(); ++i) {
+            EXPECT_EQ(results[i + 1].error, "");
+            EXPECT_EQ(results[i + 1].key->name, "key" + to_string(i));
+            EXPECT_EQ(hex(results[i + 1].data), bulkPrivateKeys[i]);
+        }
+        EXPECT_EQ(results[4].error, "Invalid password");
+        EXPECT_TRUE(results[4].key.has_value());
+        EXPECT_TRUE(results[4].data.empty());
+        EXPECT_EQ(results[5].error, "Can't open file");
+        EXPECT_FALSE(results[5].key.has_value());
+        EXPECT_EQ(results[6].error, "Invalid password");
+    }
+}
+
+TEST(StoredKeyBulk, UnlockMemoryBound) {
+    const auto directory = writeBulkKeys("StoredKeyBulk_memory");
+    BulkOptions options;
+    options.threads = 4;
+    options.maxMemory = 1;
+    const auto results = unlockStoredKeys(listStoredKeyFiles(directory), bulkPassword, options);
+    ASSERT_EQ(results.size(), 5);
+    EXPECT_EQ(hex(results[2].data), bulkPrivateKeys[1]);
+}
+
+TEST(StoredKeyBulk, Reencrypt) {
+    const auto directory = writeBulkKeys("StoredKeyBulk_reencrypt");
+    const auto paths = listStoredKeyFiles(directory);
+    const auto newPassword = TW::data("new password");
+    auto newParams = ScryptParameters();
+    newParams.n = 1 << 10;
+    newParams.r = 8;
+    newParams.p = 1;
+
+    const auto results = reencryptStoredKeys(paths, bulkPassword, newPassword, newParams);
+    ASSERT_EQ(results.size(), paths.size());
+    EXPECT_EQ(results[0].error, "Invalid key file");
+    EXPECT_EQ(results[4].error, "Invalid password");
+    for (size_t i = 1; i <= bulkPrivateKeys.size(); ++i) {
+        EXPECT_EQ(results[i].error, "");
+        EXPECT_TRUE(results[i].data.empty());
+    }
+
+    const auto unlocked = unlockStoredKeys(paths, newPassword);
+    for (size_t i = 0; i < bulkPrivateKeys.size(); ++i) {
+        const auto& result = unlocked[i + 1];
+        EXPECT_EQ(result.error, "");
+        EXPECT_EQ(hex(result.data), bulkPrivateKeys[i]);
+        EXPECT_EQ(result.key->name, "key" + to_string(i));
+        const auto& params = boost::get<ScryptParameters>(result.key->payload.kdfParams);
+        EXPECT_EQ(params.n, newParams.n);
+        EXPECT_EQ(params.p, newParams.p);
+        EXPECT_NE(hex(params.salt), hex(newParams.salt));
+        EXPECT_EQ(hex(result.key->payload.mac), hex(results[i + 1].key->payload.mac));
+    }
+    // untouched
+    EXPECT_EQ(unlockStoredKeys({paths[4]}, TW::data("other"))[0].error, "");
+
+    newParams.n = 1000;
+    EXPECT_THROW(reencryptStoredKeys(paths, bulkPassword, newPassword, newParams), invalid_argument);
+}
+
+TEST(StoredKeyBulk, ReencryptKeepsMode) {
+    const auto directory = writeBulkKeys("StoredKeyBulk_reencrypt_mode");
+    const auto paths = vector<string>{directory + "/key0.json", directory + "/key1.json"};
+    chmod(paths[0].c_str(), 0600);
+    chmod(paths[1].c_str(), 0666);
+    // stale temporary file
+    ofstream(paths[0] + ".tmp") << "{}";
+    auto newParams = ScryptParameters();
+    newParams.n = 1 << 10;
+    newParams.r = 8;
+    newParams.p = 1;
+
+    const auto results = reencryptStoredKeys(paths, bulkPassword, TW::data("new password"), newParams);
+    for (const auto& result : results) {
+        EXPECT_EQ(result.error, "");
+    }
+    struct stat status;
+    ASSERT_EQ(stat(paths[0].c_str(), &status), 0);
+    EXPECT_EQ(status.st_mode & 07777, 0600u);
+    ASSERT_EQ(stat(paths[1].c_str(), &status), 0);
+    EXPECT_EQ(status.st_mode & 07777, 0666u);
+    EXPECT_NE(stat((paths[0] + ".tmp").c_str(), &status), 0);
+}
+
+} // namespace TW::Keystore
@@ -0,0 +1,109 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "Keystore/StoredKeySession.h"
+
+#include "HexCoding.h"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace TW::Keystore {
+
+using namespace std;
+using namespace std::chrono_literals;
+
+static const auto sessionPassword = TW::data("password");
+static const auto sessionMnemonic = "team engine square letter hero song dizzy scrub tornado fabric divert saddle";
+
+TEST(StoredKeySession, Mnemonic) {
+    auto key = StoredKey::createWithMnemonic("name", sessionPassword, sessionMnemonic);
+    auto reference = key;
+    StoredKeySession session(key, sessionPassword, 1h);
+    EXPECT_TRUE(session.isUnlocked());
+
+    EXPECT_EQ(string(session.wallet().getMnemonic()), sessionMnemonic);
+    const auto decrypted = session.decrypt();
+    EXPECT_EQ(string(decrypted.begin(), decrypted.end()), sessionMnemonic);
+
+    for (auto coin : {TWCoinTypeBitcoin, TWCoinTypeEthereum, TWCoinTypeBinance}) {
+        EXPECT_EQ(hex(session.privateKey(coin).bytes), hex(reference.privateKey(coin, sessionPassword).bytes));
+        EXPECT_EQ(session.account(coin)->address, reference.account(coin)->address);
+    }
+    EXPECT_EQ(key.accounts.size(), 3);
+    EXPECT_EQ(key.accounts[0].address, "bc1qturc268v0f2srjh4r2zu4t6zk4gdutqd5a6zny");
+
+    key.accounts[1].address = "";
+    session.fixAddresses();
+    EXPECT_EQ(key.accounts[1].address, "0x494f60cb6Ac2c8F5E1393aD9FdBdF4Ad589507F7");
+}
+
+TEST(StoredKeySession, PrivateKey) {
+    const auto privateKey = "3a1076bf45ab87712ad64ccb3b10217737f7faacbf2872e88fdd9a537d8fe266";
+    auto key = StoredKey::createWithPrivateKeyAddDefaultAddress("name", sessionPassword, TWCoinTypeBitcoin, parse_hex(privateKey));
+    StoredKeySession session(key, sessionPassword, 1h);
+
+    EXPECT_EQ(hex(session.privateKey(TWCoinTypeBitcoin).bytes), privateKey);
+    EXPECT_EQ(hex(session.decrypt()), privateKey);
+    EXPECT_THROW(session.wallet(), invalid_argument);
+
+    const auto address = key.accounts[0].address;
+    key.accounts[0].address = "";
+    session.fixAddresses();
+    EXPECT_EQ(key.accounts[0].address, address);
+}
+
+TEST(StoredKeySession, InvalidPassword) {
+    auto key = StoredKey::createWithMnemonic("name", sessionPassword, sessionMnemonic);
+    EXPECT_THROW(StoredKeySession(key, TW::data("wrong"), 1h), DecryptionError);
+}
+
+TEST(StoredKeySession, LockAndExpiry) {
+    auto key = StoredKey::createWithMnemonic("name", sessionPassword, sessionMnemonic);
+
+    StoredKeySession session(key, sessionPassword, 1h);
+    session.lock();
+    EXPECT_FALSE(session.isUnlocked());
+    EXPECT_THROW(session.privateKey(TWCoinTypeBitcoin), runtime_error);
+    session.extend(1h);
+    EXPECT_FALSE(session.isUnlocked());
+
+    StoredKeySession expiring(key, sessionPassword, 50ms);
+    expiring.extend(1h);
+    EXPECT_TRUE(expiring.isUnlocked());
+    expiring.extend(0ms);
+    EXPECT_FALSE(expiring.isUnlocked());
+    EXPECT_THROW(expiring.decrypt(), runtime_error);
+    EXPECT_THROW(expiring.account(TWCoinTypeBitcoin), runtime_error);
+}
+
+// Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+TEST(StoredKeySession, DISABLED_Benchmark_PrivateKeys) {
+    const auto coins = {TWCoinTypeBitcoin, TWCoinTypeEthereum, TWCoinTypeBinance, TWCoinTypeCosmos, TWCoinTypeTron,
+                        TWCoinTypeLitecoin, TWCoinTypeDogecoin, TWCoinTypeSmartChain, TWCoinTypeTezos, TWCoinTypeSolana};
+    auto key = StoredKey::createWithMnemonic("name", sessionPassword, sessionMnemonic);
+
+    auto start = chrono::steady_clock::now();
+    for (auto coin : coins) {
+        key.privateKey(coin, sessionPassword);
+    }
+    const auto perCall = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    StoredKeySession session(key, sessionPassword, 1min);
+    for (auto coin : coins) {
+        session.privateKey(coin);
+    }
+    const auto withSession = chrono::steady_clock::now() - start;
+
+    const auto ms = [](auto duration) { return chrono::duration<double, milli>(duration).count(); };
+    cout << "10 private keys: " << ms(perCall) << " ms, with session: " << ms(withSession) << " ms" << endl;
+}
+
+} // namespace TW::Keystore
@@ -5,6 +5,7 @@
 // file LICENSE at the root of the source code distribution tree.
 
 #include "Keystore/StoredKey.h"
+#include "Keystore/Scrypt.h"
 
 #include "Coin.h"
 #include "HexCoding.h"
@@ -12,6 +13,10 @@
 #include "PrivateKey.h"
 #include "Mnemonic.h"
 
+#include <TrezorCrypto/scrypt.h>
+
+#include <chrono>
+#include <iostream>
 #include <stdexcept>
 #include <gtest/gtest.h>
 
@@ -323,6 +328,57 @@ TEST(StoredKey, Decrypt) {
     EXPECT_EQ(hex(privateKey), "7a28b5ba57c53603b0b07b56bba752f7784bf506fa95edc395f5cf6c7514fe9d");
 }
 
+TEST(StoredKey, DecryptScratch) {
+    const auto key = StoredKey::load(TESTS_ROOT + "/Keystore/Data/key.json");
+    ScryptScratch scratch;
+    for (auto i = 0; i < 2; ++i) {
+        const auto privateKey = key.payload.decrypt(TW::data("testpassword"), &scratch);
+        EXPECT_EQ(hex(privateKey), "7a28b5ba57c53603b0b07b56bba752f7784bf506fa95edc395f5cf6c7514fe9d");
+    }
+    EXPECT_GE(scratch.size(), 1);
+}
+
+// Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+TEST(StoredKey, DISABLED_Benchmark_Unlock) {
+    // n = 2^18, r = 1, p = 8 (8 lanes of 32 MB) and n = 2^18, r = 8, p = 1 (one lane of 256 MB)
+    const auto key = StoredKey::load(TESTS_ROOT + "/Keystore/Data/key.json");
+    const auto livepeer = StoredKey::load(TESTS_ROOT + "/Keystore/Data/livepeer.json");
+    const auto scryptParams = boost::get<ScryptParameters>(key.payload.kdfParams);
+    const auto password = TW::data("testpassword");
+    const auto iterations = 5;
+
+    auto start = std::chrono::steady_clock::now();
+    Data expected(32);
+    for (auto i = 0; i < iterations; ++i) {
+        ::scrypt(password.data(), password.size(), scryptParams.salt.data(), scryptParams.salt.size(), scryptParams.n,
+                 scryptParams.r, scryptParams.p, expected.data(), expected.size());
+    }
+    const auto reference = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < iterations; ++i) {
+        EXPECT_EQ(hex(scrypt(password, scryptParams, 32, nullptr, 1)), hex(expected));
+    }
+    const auto singleThread = std::chrono::steady_clock::now() - start;
+
+    ScryptScratch scratch;
+    start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < iterations; ++i) {
+        key.payload.decrypt(password, &scratch);
+    }
+    const auto unlock = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < iterations; ++i) {
+        livepeer.payload.decrypt(TW::data("Radchenko"), &scratch);
+    }
+    const auto unlockStandard = std::chrono::steady_clock::now() - start;
+
+    const auto ms = [&](auto duration) { return std::chrono::duration<double, std::milli>(duration).count() / iterations; };
+    std::cout << "scrypt() p=8: " << ms(reference) << " ms, 1 thread: " << ms(singleThread)
+              << " ms, unlock: " << ms(unlock) << " ms, unlock r=8 p=1: " << ms(unlockStandard) << " ms" << std::endl;
+}
+
 TEST(StoredKey, CreateWallet) {
     const auto privateKey = parse_hex("3a1076bf45ab87712ad64ccb3b10217737f7faacbf2872e88fdd9a537d8fe266");
     const auto key = StoredKey::createWithPrivateKey("name", password, privateKey);
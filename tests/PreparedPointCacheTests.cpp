@@ -0,0 +1,64 @@
+// Copyright © 2017-2021 Trust Wallet.
+//
+// This file is part of Trust. The full Trust copyright notice, including
+// terms governing use, modification, and redistribution, is contained in the
+// file LICENSE at the root of the source code distribution tree.
+
+#include "PreparedPointCache.h"
+#include "HexCoding.h"
+
+#include <TrezorCrypto/nist256p1.h>
+#include <TrezorCrypto/secp256k1.h>
+
+#include <gtest/gtest.h>
+
+namespace TW {
+
+const auto key1 = parse_hex("0399c6f51ad6f98c9c583f8e92bb7758ab2ca9a04110c0a1126ec43e5453d196c1");
+const auto key2 = parse_hex("02a18a98316b5f52596e75bfa5ca9fa9912edd0c989b86b73d41bb64c9c6adb992");
+const auto key3 = parse_hex("02d8096af8a11e0b80037e1ee68246b5dcbb0aeb1cf1244fd767db80f3fa27da2b");
+
+TEST(PreparedPointCache, GetPrepare) {
+    auto cache = PreparedPointCache();
+    EXPECT_EQ(cache.get(&secp256k1, key1), nullptr);
+
+    const auto prepared = cache.prepare(&secp256k1, key1);
+    ASSERT_NE(prepared, nullptr);
+    EXPECT_EQ(prepared->curve, &secp256k1);
+    EXPECT_EQ(cache.get(&secp256k1, key1), prepared);
+    EXPECT_EQ(cache.prepare(&secp256k1, key1), prepared);
+    EXPECT_EQ(cache.get(&nist256p1, key1), nullptr);
+    EXPECT_EQ(cache.size(), 1ul);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0ul);
+    EXPECT_EQ(cache.get(&secp256k1, key1), nullptr);
+    // still usable by its holders
+    EXPECT_EQ(prepared->curve, &secp256k1);
+}
+
+TEST(PreparedPointCache, EvictLeastRecentlyUsed) {
+    auto cache = PreparedPointCache(2);
+    cache.prepare(&secp256k1, key1);
+    cache.prepare(&secp256k1, key2);
+    ASSERT_NE(cache.get(&secp256k1, key1), nullptr);
+    cache.prepare(&secp256k1, key3);
+
+    EXPECT_EQ(cache.size(), 2ul);
+    EXPECT_NE(cache.get(&secp256k1, key1), nullptr);
+    EXPECT_EQ(cache.get(&secp256k1, key2), nullptr);
+    EXPECT_NE(cache.get(&secp256k1, key3), nullptr);
+
+    auto disabled = PreparedPointCache(0);
+    EXPECT_NE(disabled.prepare(&secp256k1, key1), nullptr);
+    EXPECT_EQ(disabled.size(), 0ul);
+}
+
+TEST(PreparedPointCache, Invalid) {
+    auto cache = PreparedPointCache();
+    EXPECT_EQ(cache.prepare(&secp256k1, parse_hex("02ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff")), nullptr);
+    EXPECT_EQ(cache.prepare(&secp256k1, parse_hex("0399c6f51ad6f98c9c583f8e92bb7758ab2ca9a041")), nullptr);
+    EXPECT_EQ(cache.size(), 0ul);
+}
+
+} // namespace TW
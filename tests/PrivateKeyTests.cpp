@@ -5,6 +5,7 @@
 // file LICENSE at the root of the source code distribution tree.
 
 #include "PrivateKey.h"
+#include "PreparedPointCache.h"
 #include "PublicKey.h"
 #include "HexCoding.h"
 #include "Hash.h"
@@ -249,6 +250,16 @@ TEST(PrivateKey, getSharedKeyBidirectional) {
     EXPECT_EQ(hex(derivedKeyData1), hex(derivedKeyData2));
 }
 
+TEST(PrivateKey, getSharedKeyPrepared) {
+    const auto privateKey = PrivateKey(parse_hex("9cd3b16e10bd574fed3743d8e0de0b7b4e6c69f3245ab5a168ef010d22bfefa0"));
+    auto publicKey = PublicKey(parse_hex("02a18a98316b5f52596e75bfa5ca9fa9912edd0c989b86b73d41bb64c9c6adb992"), TWPublicKeyTypeSECP256k1);
+    ASSERT_NE(publicKey.prepare(), nullptr);
+
+    EXPECT_EQ(hex(privateKey.getSharedKey(publicKey, TWCurveSECP256k1)), "ef2cf705af8714b35c0855030f358f2bee356ff3579cea2607b2025d80133c3a");
+    EXPECT_EQ(hex(privateKey.getSharedKey(publicKey.extended(), TWCurveSECP256k1)), "ef2cf705af8714b35c0855030f358f2bee356ff3579cea2607b2025d80133c3a");
+    PreparedPointCache::shared().clear();
+}
+
 TEST(PrivateKey, getSharedKeyError) {
     Data privKeyData = parse_hex("9cd3b16e10bd574fed3743d8e0de0b7b4e6c69f3245ab5a168ef010d22bfefa0");
     auto privateKey = PrivateKey(privKeyData);
@@ -8,11 +8,15 @@
 
 #include "Hash.h"
 #include "HexCoding.h"
+#include "PreparedPointCache.h"
 #include "PrivateKey.h"
 #include "interface/TWTestUtilities.h"
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 using namespace TW;
 
 TEST(PublicKeyTests, CreateFromPrivateSecp256k1) {
@@ -190,6 +194,246 @@ TEST(PublicKeyTests, Verify) {
     }
 }
 
+TEST(PublicKeyTests, VerifyPrepared) {
+    const auto privateKey = PrivateKey(parse_hex("afeefca74d9a325cf1d6b6911d61a65c32afa8e02bd5e78e2e4ac2910bab45f5"));
+    const auto digest = Hash::sha256(TW::data("Hello"));
+    for (auto [curve, type] : {std::make_pair(TWCurveSECP256k1, TWPublicKeyTypeSECP256k1), std::make_pair(TWCurveNIST256p1, TWPublicKeyTypeNIST256p1Extended)}) {
+        const auto signature = privateKey.sign(digest, curve);
+        auto publicKey = privateKey.getPublicKey(type);
+        EXPECT_EQ(publicKey.prepared(), nullptr);
+        const auto prepared = publicKey.prepare();
+        ASSERT_NE(prepared, nullptr);
+        EXPECT_EQ(publicKey.prepare(), prepared);
+        EXPECT_EQ(publicKey.prepared(), prepared);
+        EXPECT_EQ(publicKey.compressed().prepared(), prepared);
+        EXPECT_EQ(publicKey.compressed().extended().prepared(), prepared);
+        EXPECT_EQ(PublicKey(publicKey).prepared(), prepared);
+
+        // other keys with the same bytes are prepared only on request, then from the cache
+        auto other = privateKey.getPublicKey(type);
+        EXPECT_EQ(other.prepared(), nullptr);
+        EXPECT_EQ(other.prepare(), prepared);
+
+        EXPECT_TRUE(publicKey.verify(signature, digest));
+        EXPECT_TRUE(publicKey.compressed().verify(signature, digest));
+        EXPECT_FALSE(publicKey.verify(signature, Hash::sha256(digest)));
+        auto tampered = signature;
+        tampered[40] ^= 1;
+        EXPECT_FALSE(publicKey.verify(tampered, digest));
+    }
+    EXPECT_EQ(privateKey.getPublicKey(TWPublicKeyTypeED25519).prepare(), nullptr);
+    PreparedPointCache::shared().clear();
+}
+
+/// Signs digests of numbered messages with numbered keys of a curve, as batch verification input
+static void signNumbered(size_t count, TWCurve curve, TWPublicKeyType type, std::vector<PublicKey>& publicKeys, std::vector<Data>& signatures, std::vector<Data>& digests) {
+    for (size_t i = 0; i < count; ++i) {
+        const auto privateKey = PrivateKey(Hash::sha256(TW::data("key " + std::to_string(i))));
+        const auto digest = Hash::sha256(TW::data("message " + std::to_string(i)));
+        publicKeys.push_back(privateKey.getPublicKey(type));
+        signatures.push_back(privateKey.sign(digest, curve));
+        digests.push_back(digest);
+    }
+}
+
+TEST(PublicKeyTests, VerifyBatch) {
+    std::vector<PublicKey> publicKeys;
+    std::vector<Data> signatures;
+    std::vector<Data> digests;
+    signNumbered(40, TWCurveSECP256k1, TWPublicKeyTypeSECP256k1, publicKeys, signatures, digests);
+    signNumbered(5, TWCurveSECP256k1, TWPublicKeyTypeSECP256k1Extended, publicKeys, signatures, digests);
+    signNumbered(20, TWCurveNIST256p1, TWPublicKeyTypeNIST256p1, publicKeys, signatures, digests);
+    signNumbered(3, TWCurveED25519, TWPublicKeyTypeED25519, publicKeys, signatures, digests);
+
+    // Signature of a digest equal to the group order
+    publicKeys.emplace_back(parse_hex("0479be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8"), TWPublicKeyTypeSECP256k1Extended);
+    signatures.push_back(parse_hex("a0b37f8fba683cc68f6574cd43b39f0343a50008bf6ccea9d13231d9e7e2e1e411edc8d307254296264aebfc3dc76cd8b668373a072fd64665b50000e9fcce52"));
+    digests.push_back(parse_hex("fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141"));
+
+    auto results = PublicKey::verifyBatch(publicKeys, signatures, digests);
+    ASSERT_EQ(results.size(), publicKeys.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_TRUE(results[i]) << i;
+    }
+
+    // Tampered digests and signatures, swapped keys, zero and out of range values, short signature
+    digests[1][0] ^= 1;
+    signatures[17][40] ^= 1;
+    std::swap(publicKeys[30], publicKeys[31]);
+    signatures[44] = Data(64, 0);
+    std::fill(signatures[50].begin() + 32, signatures[50].end(), 0xff);
+    digests[60] = Data(32, 0);
+    signatures[64].resize(63);
+    signatures[66][10] ^= 1;
+    const auto invalid = std::vector<size_t>{1, 17, 30, 31, 44, 50, 60, 64, 66};
+    results = PublicKey::verifyBatch(publicKeys, signatures, digests);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto expected = std::find(invalid.begin(), invalid.end(), i) == invalid.end();
+        EXPECT_EQ(results[i], expected) << i;
+        if (signatures[i].size() >= 64) {
+            EXPECT_EQ(results[i], publicKeys[i].verify(signatures[i], digests[i])) << i;
+        }
+    }
+
+    EXPECT_TRUE(PublicKey::verifyBatch({}, {}, {}).empty());
+    EXPECT_THROW(PublicKey::verifyBatch(publicKeys, signatures, {}), std::invalid_argument);
+}
+
+TEST(PublicKeyTests, VerifyBatchEd25519) {
+    std::vector<PublicKey> publicKeys;
+    std::vector<Data> signatures;
+    std::vector<Data> digests;
+    signNumbered(30, TWCurveED25519, TWPublicKeyTypeED25519, publicKeys, signatures, digests);
+    signNumbered(20, TWCurveED25519Blake2bNano, TWPublicKeyTypeED25519Blake2b, publicKeys, signatures, digests);
+    signNumbered(20, TWCurveCurve25519, TWPublicKeyTypeCURVE25519, publicKeys, signatures, digests);
+    signNumbered(5, TWCurveSECP256k1, TWPublicKeyTypeSECP256k1, publicKeys, signatures, digests);
+
+    auto results = PublicKey::verifyBatch(publicKeys, signatures, digests);
+    ASSERT_EQ(results.size(), publicKeys.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_TRUE(results[i]) << i;
+    }
+
+    // Tampered digests and signatures, swapped keys, unreduced S, short signature, flipped curve25519 sign bit
+    digests[2][0] ^= 1;
+    signatures[12][40] ^= 1;
+    std::swap(publicKeys[20], publicKeys[21]);
+    std::fill(signatures[28].begin() + 32, signatures[28].end() - 1, 0xff);
+    signatures[35][5] ^= 1;
+    signatures[47].resize(63);
+    signatures[55][63] ^= 0x80;
+    digests[66][31] ^= 1;
+    const auto invalid = std::vector<size_t>{2, 12, 20, 21, 28, 35, 47, 55, 66};
+    results = PublicKey::verifyBatch(publicKeys, signatures, digests);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto expected = std::find(invalid.begin(), invalid.end(), i) == invalid.end();
+        EXPECT_EQ(results[i], expected) << i;
+        if (signatures[i].size() >= 64) {
+            EXPECT_EQ(results[i], publicKeys[i].verify(signatures[i], digests[i])) << i;
+        }
+    }
+}
+
+TEST(PublicKeyTests, VerifyBatchEd25519SmallOrder) {
+    std::vector<PublicKey> publicKeys;
+    std::vector<Data> signatures;
+    std::vector<Data> digests;
+    signNumbered(10, TWCurveED25519, TWPublicKeyTypeED25519, publicKeys, signatures, digests);
+
+    // The identity as public key, (0, -1) as R and S = 0: invalid, but the batch equation alone holds for half of the
+    // random coefficients
+    publicKeys[4] = PublicKey(parse_hex("0100000000000000000000000000000000000000000000000000000000000000"), TWPublicKeyTypeED25519);
+    signatures[4] = parse_hex("ecffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff7f0000000000000000000000000000000000000000000000000000000000000000");
+    ASSERT_FALSE(publicKeys[4].verify(signatures[4], digests[4]));
+    for (auto i = 0; i < 32; ++i) {
+        const auto results = PublicKey::verifyBatch(publicKeys, signatures, digests);
+        for (size_t j = 0; j < results.size(); ++j) {
+            EXPECT_EQ(results[j], j != 4) << j;
+        }
+    }
+}
+
+TEST(PublicKeyTests, VerifyBatchEd25519Torsion) {
+    std::vector<PublicKey> publicKeys;
+    std::vector<Data> signatures;
+    std::vector<Data> digests;
+    signNumbered(10, TWCurveED25519, TWPublicKeyTypeED25519, publicKeys, signatures, digests);
+
+    // R and the public key have the (0, -1) component: [S]B - R - [h]A is (0, -1) for an even h, invalid, but the batch
+    // equation alone holds for half of the random coefficients; for an odd h it is the identity, valid.
+    const auto publicKey = PublicKey(parse_hex("beb7ce8ff123d0d840897012a8e0bfc88711631c315c97c090b33e6cfa06d967"), TWPublicKeyTypeED25519);
+    publicKeys[4] = publicKey;
+    signatures[4] = parse_hex("905489b05f56af21946954ec020345631abd78e90535f3dcdd46dcfc1b46758407cb76b2a93c046c71a308c2d77eaa7cec306bf5d5e616602f9d104234830606");
+    digests[4] = TW::data("torsion message 0");
+    publicKeys[7] = publicKey;
+    signatures[7] = parse_hex("905489b05f56af21946954ec020345631abd78e90535f3dcdd46dcfc1b467584b80704abeadfb9192637c0e6f82bedde7dd5ed50ed497baaec97cada986bf90e");
+    digests[7] = TW::data("torsion message 1");
+    ASSERT_FALSE(publicKeys[4].verify(signatures[4], digests[4]));
+    ASSERT_TRUE(publicKeys[7].verify(signatures[7], digests[7]));
+    for (auto i = 0; i < 32; ++i) {
+        const auto results = PublicKey::verifyBatch(publicKeys, signatures, digests);
+        for (size_t j = 0; j < results.size(); ++j) {
+            EXPECT_EQ(results[j], j != 4) << j;
+        }
+    }
+}
+
+TEST(PublicKeyTests, DISABLED_Benchmark_VerifyBatch) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    const auto count = 1000;
+    const auto time = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    for (auto [curve, type] : {std::make_pair(TWCurveSECP256k1, TWPublicKeyTypeSECP256k1), std::make_pair(TWCurveNIST256p1, TWPublicKeyTypeNIST256p1),
+                               std::make_pair(TWCurveED25519, TWPublicKeyTypeED25519), std::make_pair(TWCurveCurve25519, TWPublicKeyTypeCURVE25519)}) {
+        std::vector<PublicKey> publicKeys;
+        std::vector<Data> signatures;
+        std::vector<Data> digests;
+        signNumbered(count, curve, type, publicKeys, signatures, digests);
+        auto valid = 0;
+        const auto single = time([&] {
+            for (size_t i = 0; i < count; ++i) {
+                valid += publicKeys[i].verify(signatures[i], digests[i]);
+            }
+        });
+        const auto batch = time([&] {
+            for (auto result : PublicKey::verifyBatch(publicKeys, signatures, digests)) {
+                valid += result;
+            }
+        });
+        EXPECT_EQ(valid, 2 * count);
+        std::cout << "verify " << count << " signatures of curve " << curve << ": one by one " << single << " ms, batch " << batch << " ms" << std::endl;
+    }
+}
+
+TEST(PublicKeyTests, DISABLED_Benchmark_VerifyPrepared) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    const auto count = 1000;
+    const auto time = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::vector<PublicKey> publicKeys;
+    std::vector<Data> signatures;
+    std::vector<Data> digests;
+    signNumbered(count, TWCurveSECP256k1, TWPublicKeyTypeSECP256k1, publicKeys, signatures, digests);
+    // one counterparty key signing many messages
+    const auto privateKey = PrivateKey(Hash::sha256(TW::data("key 0")));
+    for (size_t i = 0; i < count; ++i) {
+        signatures[i] = privateKey.sign(digests[i], TWCurveSECP256k1);
+    }
+    auto publicKey = publicKeys[0];
+    auto valid = 0;
+    const auto plain = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            valid += publicKey.verify(signatures[i], digests[i]);
+        }
+    });
+    const auto prepared = time([&] {
+        publicKey.prepare();
+        for (size_t i = 0; i < count; ++i) {
+            valid += publicKey.verify(signatures[i], digests[i]);
+        }
+    });
+    const auto shared = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            privateKey.getSharedKey(publicKey, TWCurveSECP256k1);
+        }
+    });
+    PreparedPointCache::shared().clear();
+    const auto sharedPlain = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            privateKey.getSharedKey(publicKeys[0], TWCurveSECP256k1);
+        }
+    });
+    EXPECT_EQ(valid, 2 * count);
+    std::cout << "verify " << count << " signatures by one key: plain " << plain << " ms, prepared " << prepared << " ms" << std::endl;
+    std::cout << count << " shared keys with one key: plain " << sharedPlain << " ms, prepared " << shared << " ms" << std::endl;
+}
+
 TEST(PublicKeyTests, VerifyEd25519Extended) {
     const auto key = PrivateKey(parse_hex("afeefca74d9a325cf1d6b6911d61a65c32afa8e02bd5e78e2e4ac2910bab45f5"));
     const auto privateKey = PrivateKey(key);
@@ -7,11 +7,17 @@
 #include <TrustWalletCore/TWCoinType.h>
 #include "Stacks/Address.h"
 #include "Bitcoin/Address.h"
+#include "Base32.h"
+#include "Hash.h"
 #include "HexCoding.h"
 #include "PrivateKey.h"
 
+#include <boost/algorithm/string.hpp>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 using namespace std;
 using namespace TW;
 using namespace TW::Stacks;
@@ -42,3 +48,125 @@ TEST(StacksAddress, FromString) {
     const auto address = Address(compare);
     ASSERT_EQ(address.string(), compare);
 }
+
+TEST(StacksAddress, LeadingZeros) {
+    auto address = Address(PrivateKey(parse_hex("04f3335197813301af8e8ff65a71e613a93241790a9db25b1083943d81dafc1b")).getPublicKey(TWPublicKeyTypeSECP256k1));
+    address.bytes.fill(0);
+    address.bytes[0] = Address::VersionMainnetP2PKH;
+    ASSERT_EQ(address.string(), "SP000000000000000000002Q6VF78");
+    ASSERT_EQ(Address(address.string()), address);
+
+    address.bytes[20] = 1;
+    ASSERT_EQ(Address(address.string()), address);
+    address.bytes[2] = 0x80;
+    ASSERT_EQ(Address(address.string()), address);
+}
+
+TEST(StacksAddress, Bulk) {
+    const auto valid = Address::isValidBulk({
+        "SP2PP2BSNVJV56CFRQFEMC5VA2X44ZBKMZAC4BWZ9",
+        "SP2PP2BSNVJV56CFRQFEMC5VA2X44ZBKMZAC4BWZ0",
+        "ST2PP2BSNVJV56CFRQFEMC5VA2X44ZBKMZ9204TY5",
+        "sp2dfjsc3i9xowlvmpja65xgc7dotdkem9dshv44s",
+        "",
+    }, { 22 });
+    ASSERT_EQ(valid, std::vector<bool>({ true, false, false, true, false }));
+
+    const auto privateKey = PrivateKey(parse_hex("04f3335197813301af8e8ff65a71e613a93241790a9db25b1083943d81dafc1b"));
+    const auto strings = Address::stringsBulk({
+        privateKey.getPublicKey(TWPublicKeyTypeSECP256k1),
+        privateKey.getPublicKey(TWPublicKeyTypeSECP256k1),
+    }, 26);
+    ASSERT_EQ(strings, std::vector<std::string>({ "ST2PP2BSNVJV56CFRQFEMC5VA2X44ZBKMZ9204TY5", "ST2PP2BSNVJV56CFRQFEMC5VA2X44ZBKMZ9204TY5" }));
+}
+
+// Earlier implementation, for comparison
+static Data legacyDecode(const std::string& string) {
+    static const auto alphabet = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+    if ((string.length() < 6) || (string.length() > 41)) {
+        return {};
+    }
+    Data data;
+    auto normalise = boost::algorithm::to_upper_copy(string);
+    auto pad = 41 - normalise.length();
+    if (pad) {
+        normalise.insert(2, std::string(pad, '0'));
+    }
+    boost::algorithm::replace_all(normalise, "O", "0");
+    boost::algorithm::replace_all(normalise, "L", "1");
+    boost::algorithm::replace_all(normalise, "I", "1");
+    if ((normalise[0] != 'S') || !Base32::decode(normalise.substr(1), data, alphabet)) {
+        return {};
+    }
+    data[0] >>= 3;
+    auto checksum = Hash::sha256(Hash::sha256(&data[0], 21));
+    if (!std::equal(data.end() - 4, data.end(), checksum.begin())) {
+        return {};
+    }
+    return Data(data.begin(), data.begin() + 21);
+}
+
+static std::string legacyEncode(const Data& bytes) {
+    static const auto alphabet = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+    auto data = bytes;
+    auto checksum = Hash::sha256(Hash::sha256(data));
+    data.insert(data.end(), checksum.begin(), checksum.begin() + 4);
+    TW::byte prefix = data[0] << 3;
+    data[0] = 0;
+    auto encoded = Base32::encode(data, alphabet);
+    encoded.erase(0, encoded.find_first_not_of('0'));
+    for (size_t i = 1; i < data.size() && !data[i]; i++) {
+       encoded.insert(0, "0");
+    }
+    return std::string("S") + Base32::encode({prefix}, alphabet)[0] + encoded;
+}
+
+TEST(StacksAddress, DISABLED_Benchmark_Codec) {
+    // Not run by default, run with: tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+    // Compares the table-driven codec with the earlier Base32 and string based one; results must be identical.
+    const auto count = 100'000;
+    std::vector<std::string> strings;
+    std::vector<Data> bytes;
+    auto address = Address("SP2PP2BSNVJV56CFRQFEMC5VA2X44ZBKMZAC4BWZ9");
+    for (auto i = 0; i < count; ++i) {
+        auto hash = Hash::sha256(Data{static_cast<TW::byte>(i & 0xff), static_cast<TW::byte>((i >> 8) & 0xff), static_cast<TW::byte>(i >> 16)});
+        // some with leading zero bytes
+        std::fill(hash.begin(), hash.begin() + (i % 4), 0);
+        std::copy(hash.begin(), hash.begin() + 20, address.bytes.begin() + 1);
+        bytes.emplace_back(address.bytes.begin(), address.bytes.end());
+        strings.push_back(address.string());
+    }
+
+    const auto time = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::vector<std::string> encoded;
+    const auto encodeTime = time([&] {
+        for (const auto& b : bytes) {
+            std::copy(b.begin(), b.end(), address.bytes.begin());
+            encoded.push_back(address.string());
+        }
+    });
+    std::vector<std::string> legacyEncoded;
+    const auto legacyEncodeTime = time([&] {
+        for (const auto& b : bytes) {
+            legacyEncoded.push_back(legacyEncode(b));
+        }
+    });
+    std::vector<bool> valid;
+    const auto decodeTime = time([&] { valid = Address::isValidBulk(strings); });
+    std::vector<bool> legacyValid;
+    const auto legacyDecodeTime = time([&] {
+        for (const auto& s : strings) {
+            legacyValid.push_back(!legacyDecode(s).empty());
+        }
+    });
+
+    ASSERT_EQ(encoded, legacyEncoded);
+    ASSERT_EQ(valid, legacyValid);
+    ASSERT_EQ(valid, std::vector<bool>(count, true));
+    std::cout << "encode " << count << " addresses: " << encodeTime / 1000 << " ms, earlier " << legacyEncodeTime / 1000 << " ms" << std::endl;
+    std::cout << "validate " << count << " addresses: " << decodeTime / 1000 << " ms, earlier " << legacyDecodeTime / 1000 << " ms" << std::endl;
+}
@@ -104,3 +104,378 @@ TEST(StacksSigner, memoFail) {
     ASSERT_EQ(error, "Invalid length for memo");
 }
 
+TEST(StacksSigner, serializeClarityValues) {
+    auto cv = Proto::ClarityValue();
+    cv.mutable_intcv()->set_value("\x01");
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "0000000000000000000000000000000001");
+    cv.mutable_intcv()->set_value("\xfe");
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "00fffffffffffffffffffffffffffffffe");
+    cv.mutable_uintcv()->set_value("\xfe");
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "01000000000000000000000000000000fe");
+    cv.mutable_buffercv()->set_data("\xde\xad\xbe\xef");
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "0200000004deadbeef");
+    cv.mutable_boolcv()->set_value(true);
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "03");
+    cv.mutable_boolcv()->set_value(false);
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "04");
+    cv.mutable_stringasciicv()->set_content("hello world");
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "0d0000000b68656c6c6f20776f726c64");
+    cv.mutable_stringutf8cv()->set_content("hello ☃");
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "0e0000000968656c6c6f20e29883");
+
+    auto address = Address("SP3FGQ8Z7JY9BWYZ5WM53E0M9NK7WHJF0691NZ159");
+    auto principal = Proto::ClarityValue();
+    auto standard = principal.mutable_principalcv()->mutable_standard()->mutable_address();
+    standard->set_version(address.bytes[0]);
+    standard->set_hash160(&address.bytes[1], address.bytes.size() - 1);
+    EXPECT_EQ(hex(Signer::serializeClarityValue(principal)), "0516df0ba3e79792be7be5e50a370289accfc8c9e032");
+    auto contract = principal.mutable_principalcv()->mutable_contract();
+    contract->mutable_address()->set_version(address.bytes[0]);
+    contract->mutable_address()->set_hash160(&address.bytes[1], address.bytes.size() - 1);
+    contract->mutable_contractname()->set_content("abcd");
+    contract->mutable_contractname()->set_lengthprefixbytes(1);
+    contract->mutable_contractname()->set_maxlengthbytes(128);
+    EXPECT_EQ(hex(Signer::serializeClarityValue(principal)), "0616df0ba3e79792be7be5e50a370289accfc8c9e0320461626364");
+    // default length prefix and maximum length
+    contract->mutable_contractname()->clear_lengthprefixbytes();
+    contract->mutable_contractname()->clear_maxlengthbytes();
+    EXPECT_EQ(hex(Signer::serializeClarityValue(principal)), "0616df0ba3e79792be7be5e50a370289accfc8c9e0320461626364");
+    contract->mutable_contractname()->set_content(std::string(129, 'a'));
+    EXPECT_THROW(Signer::serializeClarityValue(principal), std::invalid_argument);
+
+    // (ok true), (err u1), none, (some true)
+    cv.mutable_responsecv()->set_ok(true);
+    cv.mutable_responsecv()->mutable_value()->mutable_boolcv()->set_value(true);
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "0703");
+    cv.mutable_responsecv()->set_ok(false);
+    cv.mutable_responsecv()->mutable_value()->mutable_uintcv()->set_value("\x01");
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "080100000000000000000000000000000001");
+    cv.mutable_optionalcv();
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "09");
+    cv.mutable_optionalcv()->mutable_value()->mutable_boolcv()->set_value(true);
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "0a03");
+
+    // (list true false)
+    auto list = cv.mutable_listcv();
+    list->add_values()->mutable_boolcv()->set_value(true);
+    list->add_values()->mutable_boolcv()->set_value(false);
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "0b000000020304");
+
+    // {foobar: true, baz: none}, serialized in name order
+    auto tuple = cv.mutable_tuplecv();
+    auto foobar = tuple->add_entries();
+    foobar->set_name("foobar");
+    foobar->mutable_value()->mutable_boolcv()->set_value(true);
+    auto baz = tuple->add_entries();
+    baz->set_name("baz");
+    baz->mutable_value()->mutable_optionalcv();
+    EXPECT_EQ(hex(Signer::serializeClarityValue(cv)), "0c000000020362617a0906666f6f62617203");
+}
+
+TEST(StacksSigner, serializeClarityValuesFail) {
+    auto cv = Proto::ClarityValue();
+    EXPECT_THROW(Signer::serializeClarityValue(cv), std::invalid_argument);
+    cv.mutable_uintcv()->set_value(std::string(17, '\x01'));
+    EXPECT_THROW(Signer::serializeClarityValue(cv), std::invalid_argument);
+    cv.mutable_stringasciicv()->set_content("\xe2\x98\x83");
+    EXPECT_THROW(Signer::serializeClarityValue(cv), std::invalid_argument);
+    cv.mutable_responsecv()->set_ok(true);
+    EXPECT_THROW(Signer::serializeClarityValue(cv), std::invalid_argument);
+
+    auto tuple = cv.mutable_tuplecv();
+    for (auto i = 0; i < 2; ++i) {
+        auto entry = tuple->add_entries();
+        entry->set_name("a");
+        entry->mutable_value()->mutable_boolcv();
+    }
+    EXPECT_THROW(Signer::serializeClarityValue(cv), std::invalid_argument);
+}
+
+TEST(StacksSigner, signContractCall) {
+    auto input = Proto::SigningInput();
+    auto key = parse_hex("edf9aee84d9b7abc145504dde6726c64f369d37ee34ded868fabd876c26570bc01");
+    input.set_senderkey(key.data(), key.size());
+    // SIP-010 token transfer: (transfer u100000 sender recipient none)
+    auto call = input.mutable_contractcall();
+    call->set_contractaddress("SP3DX3H4FEYZJZ586MFBS25ZW3HZDMEW92260R2PR");
+    call->set_contractname("Wrapped-Bitcoin");
+    call->set_functionname("transfer");
+    call->set_fee(2000);
+    call->set_nonce(5);
+    call->set_anchormode(Signer::AnchorModeAny);
+    call->add_functionargs()->mutable_uintcv()->set_value("\x01\x86\xa0");
+    for (auto principal : {"SP1P72Z3704VMT3DMHPP2CB8TGQWGDBHD3RPR9GZS", "SP3FGQ8Z7JY9BWYZ5WM53E0M9NK7WHJF0691NZ159"}) {
+        auto address = Address(principal);
+        auto standard = call->add_functionargs()->mutable_principalcv()->mutable_standard()->mutable_address();
+        standard->set_version(address.bytes[0]);
+        standard->set_hash160(&address.bytes[1], address.bytes.size() - 1);
+    }
+    call->add_functionargs()->mutable_optionalcv();
+
+    const auto signer = Signer(input);
+
+    const auto [encoded, error] = signer.sign();
+    ASSERT_EQ(error, "");
+    // payload: contract address, contract name, function name, 4 arguments
+    EXPECT_EQ(hex(encoded), "0000000001040015c31b8c1c11c515e244b75806bac48d1399c775000000000000000500000000000007d00000c86ced223273fa5703e28f22e4f35e4c910cb88c7edcd58873bcb6906a8925f95d55b5fb174fadbc8a9fe9ec93fe8146e25b0b61531ada67bd27b2fd9c5a2c6e030200000000"
+        "0216dbd1c48f77bf2f9506a3d79117fc1c7eda3b8910" "0f577261707065642d426974636f696e" "087472616e73666572" "00000004"
+        "01000000000000000000000000000186a0" "05166c717c6701374d0db48dac262d1a85f906ae2d1e" "0516df0ba3e79792be7be5e50a370289accfc8c9e032" "09");
+}
+
+TEST(StacksSigner, signWithPostConditions) {
+    auto input = Proto::SigningInput();
+    auto key = parse_hex("edf9aee84d9b7abc145504dde6726c64f369d37ee34ded868fabd876c26570bc01");
+    input.set_senderkey(key.data(), key.size());
+    auto transfer = input.mutable_tokentransfer();
+    transfer->set_recipient("SP3FGQ8Z7JY9BWYZ5WM53E0M9NK7WHJF0691NZ159");
+    transfer->set_amount(12345);
+    transfer->set_fee(100);
+    transfer->set_nonce(987654321);
+    transfer->set_anchormode(Signer::AnchorModeAny);
+    // origin sends exactly 12345 microstacks
+    auto stx = transfer->add_postconditions()->mutable_stx();
+    stx->set_conditioncode(0x01);
+    stx->set_amount(12345);
+
+    const auto signer = Signer(input);
+
+    const auto [encoded, error] = signer.sign();
+    ASSERT_EQ(error, "");
+    // deny mode, 1 post-condition: STX, origin, equal, amount
+    EXPECT_EQ(hex(encoded), "0000000001040015c31b8c1c11c515e244b75806bac48d1399c775000000003ade68b100000000000000640000d80695e77bf6717e56bd36962839e8a47fc27b35029910b6134d81fd59678c8f0019665332ed052bb6f65ccba44a2d074289eb1aee8e3ce190d98f8ff7090191"
+        "0302" "00000001" "00" "01" "01" "0000000000003039"
+        "000516df0ba3e79792be7be5e50a370289accfc8c9e032000000000000303900000000000000000000000000000000000000000000000000000000000000000000");
+}
+
+TEST(StacksSigner, signContractCallWithPostConditions) {
+    auto input = Proto::SigningInput();
+    auto key = parse_hex("edf9aee84d9b7abc145504dde6726c64f369d37ee34ded868fabd876c26570bc01");
+    input.set_senderkey(key.data(), key.size());
+    auto call = input.mutable_contractcall();
+    call->set_contractaddress("SP3DX3H4FEYZJZ586MFBS25ZW3HZDMEW92260R2PR");
+    call->set_contractname("Wrapped-Bitcoin");
+    call->set_functionname("transfer");
+    call->set_fee(2000);
+    call->set_nonce(5);
+    call->set_anchormode(Signer::AnchorModeAny);
+    call->add_functionargs()->mutable_uintcv()->set_value("\x01\x86\xa0");
+
+    auto sender = Address("SP3FGQ8Z7JY9BWYZ5WM53E0M9NK7WHJF0691NZ159");
+    auto contract = Address("SP3DX3H4FEYZJZ586MFBS25ZW3HZDMEW92260R2PR");
+    auto setAsset = [&](Proto::AssetInfo& asset, const char* assetName) {
+        asset.mutable_address()->set_version(contract.bytes[0]);
+        asset.mutable_address()->set_hash160(&contract.bytes[1], contract.bytes.size() - 1);
+        asset.mutable_contractname()->set_content("Wrapped-Bitcoin");
+        asset.mutable_contractname()->set_lengthprefixbytes(1);
+        asset.mutable_contractname()->set_maxlengthbytes(128);
+        // default length prefix and maximum length
+        asset.mutable_assetname()->set_content(assetName);
+    };
+    // sender sends at most 100000 wrapped-bitcoin
+    auto fungible = call->add_postconditions()->mutable_fungible();
+    auto standard = fungible->mutable_principal()->mutable_standard()->mutable_address();
+    standard->set_version(sender.bytes[0]);
+    standard->set_hash160(&sender.bytes[1], sender.bytes.size() - 1);
+    setAsset(*fungible->mutable_asset(), "wrapped-bitcoin");
+    fungible->set_conditioncode(0x05);
+    fungible->set_amount(100000);
+    // origin sends NFT u1
+    auto nonFungible = call->add_postconditions()->mutable_nonfungible();
+    setAsset(*nonFungible->mutable_asset(), "nft");
+    nonFungible->mutable_assetname()->mutable_uintcv()->set_value("\x01");
+    nonFungible->set_conditioncode(0x10);
+
+    {
+        const auto [encoded, error] = Signer(input).sign();
+        ASSERT_EQ(error, "");
+        EXPECT_EQ(hex(encoded), "0000000001040015c31b8c1c11c515e244b75806bac48d1399c775000000000000000500000000000007d00000161d217324075785128a90fba567f5e57609d8b6c3cc6c19ea2f0a6be2c65d4c6f4f7c1772d155266d9c41a7f15ac5e18cad4003c8a5bef931b460886f2d77cb"
+            // deny mode, 2 post-conditions: fungible, sender, less or equal, amount; non-fungible, origin, u1, sends
+            "0302" "00000002"
+            "01" "0216df0ba3e79792be7be5e50a370289accfc8c9e032" "16dbd1c48f77bf2f9506a3d79117fc1c7eda3b8910" "0f577261707065642d426974636f696e" "0f777261707065642d626974636f696e" "05" "00000000000186a0"
+            "02" "01" "16dbd1c48f77bf2f9506a3d79117fc1c7eda3b8910" "0f577261707065642d426974636f696e" "036e6674" "0100000000000000000000000000000001" "10"
+            "0216dbd1c48f77bf2f9506a3d79117fc1c7eda3b89100f577261707065642d426974636f696e087472616e736665720000000101000000000000000000000000000186a0");
+    }
+
+    call->set_postconditionmode(1);
+    {
+        const auto [encoded, error] = Signer(input).sign();
+        ASSERT_EQ(error, "");
+        EXPECT_EQ(hex(encoded), "0000000001040015c31b8c1c11c515e244b75806bac48d1399c775000000000000000500000000000007d00000deec8289a2629186a1549c4365303c2dfa9ff4e26e42df8719f9e3d6c653e6003ffec3fa2fd9bbca3d1ee618c347c09fef590cd13bfb417a8a6b93c03a1c971c"
+            // allow mode
+            "0301" "00000002"
+            "01" "0216df0ba3e79792be7be5e50a370289accfc8c9e032" "16dbd1c48f77bf2f9506a3d79117fc1c7eda3b8910" "0f577261707065642d426974636f696e" "0f777261707065642d626974636f696e" "05" "00000000000186a0"
+            "02" "01" "16dbd1c48f77bf2f9506a3d79117fc1c7eda3b8910" "0f577261707065642d426974636f696e" "036e6674" "0100000000000000000000000000000001" "10"
+            "0216dbd1c48f77bf2f9506a3d79117fc1c7eda3b89100f577261707065642d426974636f696e087472616e736665720000000101000000000000000000000000000186a0");
+    }
+
+    call->set_postconditionmode(3);
+    {
+        const auto [encoded, error] = Signer(input).sign();
+        EXPECT_EQ(encoded, Data());
+        EXPECT_EQ(error, "Invalid post-condition mode");
+    }
+
+    call->set_postconditionmode(2);
+    fungible->mutable_asset()->mutable_assetname()->set_content(std::string(33, 'a'));
+    {
+        const auto [encoded, error] = Signer(input).sign();
+        EXPECT_EQ(encoded, Data());
+        EXPECT_EQ(error, "Invalid length for string");
+    }
+
+    fungible->mutable_asset()->mutable_assetname()->set_content("wrapped-bitcoin");
+    fungible->set_conditioncode(0x10);
+    {
+        const auto [encoded, error] = Signer(input).sign();
+        EXPECT_EQ(encoded, Data());
+        EXPECT_EQ(error, "Invalid post-condition code");
+    }
+}
+
+static Proto::SigningInput multisigTransferInput() {
+    auto input = Proto::SigningInput();
+    auto multisig = input.mutable_multisig();
+    for (const auto& key : {"edf9aee84d9b7abc145504dde6726c64f369d37ee34ded868fabd876c26570bc",
+                            "4d7a9e6b3c0b2e1f5a8d7c6b5a4938271605f4e3d2c1b0a99887766554433221",
+                            "9f1e2d3c4b5a69788796a5b4c3d2e1f00f1e2d3c4b5a69788796a5b4c3d2e1f0"}) {
+        const auto publicKey = PrivateKey(parse_hex(key)).getPublicKey(TWPublicKeyTypeSECP256k1).bytes;
+        multisig->add_publickeys(publicKey.data(), publicKey.size());
+    }
+    multisig->set_signaturesrequired(2);
+    auto transfer = input.mutable_tokentransfer();
+    transfer->set_recipient("SP3FGQ8Z7JY9BWYZ5WM53E0M9NK7WHJF0691NZ159");
+    transfer->set_amount(12345);
+    transfer->set_fee(300);
+    transfer->set_nonce(7);
+    transfer->set_anchormode(Signer::AnchorModeAny);
+    return input;
+}
+
+TEST(StacksSigner, signMultisig) {
+    const auto key0 = parse_hex("edf9aee84d9b7abc145504dde6726c64f369d37ee34ded868fabd876c26570bc01");
+    const auto key2 = parse_hex("9f1e2d3c4b5a69788796a5b4c3d2e1f00f1e2d3c4b5a69788796a5b4c3d2e1f001");
+
+    // both signers at once
+    auto input = multisigTransferInput();
+    input.mutable_multisig()->add_privatekeys(key0.data(), key0.size());
+    input.mutable_multisig()->add_privatekeys(key2.data(), key2.size());
+    const auto output = Signer::sign(input);
+    ASSERT_EQ(output.error(), "");
+    const auto expected = "000000000104"
+        // P2SH, signer, nonce, fee
+        "01" "2b6b428c459f86913559f2e5e558123e530c685b" "0000000000000007" "000000000000012c"
+        // 3 auth fields: signature, public key, signature; 2 signatures required
+        "00000003"
+        "02" "013d37d4f20e40ae2d79f337ed7ef3f323a51ec64849af8d77969d73724f85814a1bfb910f960ab47923c38ab038aabcd595c9d8e38ba6d32365a2cff4b2d1b3e5"
+        "00" "02aac5f9f00f85d8f52bcc69e4c730a1d277039fe48a1bfebe4fe71eea21b9777d"
+        "02" "011695aff54d06c4b42e45906e842b9732d1b197a2abaeb6404a7b63f63bcf3c7f4c5513165eab5e97de1005251f743840dc3918aeee50cf26ae1ef318d3eec4b6"
+        "0002"
+        "030200000000000516df0ba3e79792be7be5e50a370289accfc8c9e032000000000000303900000000000000000000000000000000000000000000000000000000000000000000";
+    EXPECT_EQ(hex(output.encoded()), expected);
+    EXPECT_EQ(output.sighash().size(), 32ul);
+
+    // one signer at a time, the second continues from the first's sighash
+    auto input0 = multisigTransferInput();
+    input0.mutable_multisig()->add_privatekeys(key0.data(), key0.size());
+    const auto output0 = Signer::sign(input0);
+    ASSERT_EQ(output0.error(), "");
+    EXPECT_EQ(hex(output0.encoded()).substr(0, 2 * (6 + 37 + 4)), "000000000104012b6b428c459f86913559f2e5e558123e530c685b0000000000000007000000000000012c00000001");
+
+    auto input2 = multisigTransferInput();
+    input2.mutable_multisig()->add_privatekeys(key2.data(), key2.size());
+    input2.mutable_partiallysigned()->set_encoded(output0.encoded());
+    input2.mutable_partiallysigned()->set_sighash(output0.sighash());
+    const auto output2 = Signer::sign(input2);
+    ASSERT_EQ(output2.error(), "");
+    EXPECT_EQ(hex(output2.encoded()), expected);
+    EXPECT_EQ(output2.sighash(), output.sighash());
+
+    // key already signed
+    input2.mutable_partiallysigned()->set_encoded(output2.encoded());
+    EXPECT_EQ(Signer::sign(input2).error(), "Invalid multisig private key");
+
+    // other participants
+    auto inputOther = multisigTransferInput();
+    inputOther.mutable_multisig()->mutable_publickeys()->SwapElements(0, 1);
+    inputOther.mutable_multisig()->add_privatekeys(key2.data(), key2.size());
+    *inputOther.mutable_partiallysigned() = input2.partiallysigned();
+    inputOther.mutable_partiallysigned()->set_encoded(output0.encoded());
+    EXPECT_EQ(Signer::sign(inputOther).error(), "Invalid multisig public keys");
+
+    input0.mutable_multisig()->set_signaturesrequired(4);
+    EXPECT_EQ(Signer::sign(input0).error(), "Invalid multisig options");
+}
+
+TEST(StacksSigner, signSponsored) {
+    const auto originKey = parse_hex("edf9aee84d9b7abc145504dde6726c64f369d37ee34ded868fabd876c26570bc01");
+    const auto sponsorKey = parse_hex("9f1e2d3c4b5a69788796a5b4c3d2e1f00f1e2d3c4b5a69788796a5b4c3d2e1f001");
+
+    auto input = Proto::SigningInput();
+    input.set_senderkey(originKey.data(), originKey.size());
+    auto transfer = input.mutable_tokentransfer();
+    transfer->set_recipient("SP3FGQ8Z7JY9BWYZ5WM53E0M9NK7WHJF0691NZ159");
+    transfer->set_amount(12345);
+    transfer->set_nonce(7);
+    transfer->set_anchormode(Signer::AnchorModeAny);
+    transfer->set_sponsored(true);
+    const auto origin = Signer::sign(input);
+    ASSERT_EQ(origin.error(), "");
+    // sponsored, origin spending condition, empty sponsor spending condition
+    EXPECT_EQ(hex(origin.encoded()), "0000000001" "05"
+        "0015c31b8c1c11c515e244b75806bac48d1399c77500000000000000070000000000000000000087238c1477b433c991bd998731f0ebd6f0cf8ff2c556de8ee4abd19e237a367a4882f7a54edf450eb2ad47f04fad859cab39ea256b5cebd734b126be89552d41"
+        "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+        "030200000000000516df0ba3e79792be7be5e50a370289accfc8c9e032000000000000303900000000000000000000000000000000000000000000000000000000000000000000");
+
+    auto sponsorInput = Proto::SigningInput();
+    sponsorInput.set_senderkey(sponsorKey.data(), sponsorKey.size());
+    sponsorInput.mutable_sponsor()->set_fee(500);
+    sponsorInput.mutable_sponsor()->set_nonce(3);
+    sponsorInput.mutable_partiallysigned()->set_encoded(origin.encoded());
+    sponsorInput.mutable_partiallysigned()->set_sighash(origin.sighash());
+    const auto sponsored = Signer::sign(sponsorInput);
+    ASSERT_EQ(sponsored.error(), "");
+    // origin spending condition unchanged, sponsor spending condition filled in
+    EXPECT_EQ(hex(sponsored.encoded()), "0000000001" "05"
+        "0015c31b8c1c11c515e244b75806bac48d1399c77500000000000000070000000000000000000087238c1477b433c991bd998731f0ebd6f0cf8ff2c556de8ee4abd19e237a367a4882f7a54edf450eb2ad47f04fad859cab39ea256b5cebd734b126be89552d41"
+        "0080cdb55b2bdec7885beddb294018edab2fb905ca000000000000000300000000000001f40001207f8807f55fd13591ead7c8f08b2078e6eebe14d1fd52f4f6da334c988e123826159b969802a9506a6586a14065c6c5658a8589c5e95591707e203c7f703c18"
+        "030200000000000516df0ba3e79792be7be5e50a370289accfc8c9e032000000000000303900000000000000000000000000000000000000000000000000000000000000000000");
+
+    // not sponsored
+    transfer->set_sponsored(false);
+    const auto standard = Signer::sign(input);
+    sponsorInput.mutable_partiallysigned()->set_encoded(standard.encoded());
+    EXPECT_EQ(Signer::sign(sponsorInput).error(), "Transaction is not sponsored");
+
+    sponsorInput.mutable_partiallysigned()->set_sighash("abc");
+    EXPECT_EQ(Signer::sign(sponsorInput).error(), "Invalid sighash");
+
+    // a sponsor signs a partially signed transaction
+    sponsorInput.clear_partiallysigned();
+    *sponsorInput.mutable_tokentransfer() = *transfer;
+    EXPECT_EQ(Signer::sign(sponsorInput).error(), "Sponsor signs a partially signed transaction");
+
+    // nothing to sign
+    input.clear_tokentransfer();
+    *input.mutable_partiallysigned() = sponsorInput.partiallysigned();
+    input.mutable_partiallysigned()->set_encoded(origin.encoded());
+    input.mutable_partiallysigned()->set_sighash(origin.sighash());
+    EXPECT_EQ(Signer::sign(input).error(), "Invalid input type");
+}
+
+TEST(StacksSigner, signSponsoredMultisig) {
+    const auto key0 = parse_hex("edf9aee84d9b7abc145504dde6726c64f369d37ee34ded868fabd876c26570bc01");
+    const auto sponsorKey = parse_hex("9f1e2d3c4b5a69788796a5b4c3d2e1f00f1e2d3c4b5a69788796a5b4c3d2e1f001");
+
+    auto input = multisigTransferInput();
+    input.mutable_tokentransfer()->set_sponsored(true);
+    input.mutable_multisig()->add_privatekeys(key0.data(), key0.size());
+    const auto origin = Signer::sign(input);
+    ASSERT_EQ(origin.error(), "");
+
+    auto sponsorInput = Proto::SigningInput();
+    sponsorInput.set_senderkey(sponsorKey.data(), sponsorKey.size());
+    sponsorInput.mutable_sponsor()->set_fee(500);
+    sponsorInput.mutable_partiallysigned()->set_encoded(origin.encoded());
+    sponsorInput.mutable_partiallysigned()->set_sighash(origin.sighash());
+    EXPECT_EQ(Signer::sign(sponsorInput).error(), "Origin is not fully signed");
+}
@@ -79,6 +79,19 @@ TEST(TWZcashTransaction, Encode) {
 
     auto sighash = transaction.getSignatureHash(scriptCode, 0, TWBitcoinSigHashTypeAll, 0x02faf080, Bitcoin::BASE);
     ASSERT_EQ(hex(sighash.begin(), sighash.end()), "f3148f80dfab5e573d5edfe7a850f5fd39234f80b5429d3a57edcc11e34c585b");
+
+    // same results with precomputed transaction-wide hashes; other hash types computed without them, before they were introduced
+    const auto cache = transaction.getSigHashCache();
+    EXPECT_EQ(transaction.getPreImage(scriptCode, 0, TWBitcoinSigHashTypeAll, 0x02faf080, cache), preImage);
+    EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, 0, TWBitcoinSigHashTypeAll, 0x02faf080, Bitcoin::BASE, cache)),
+              "f3148f80dfab5e573d5edfe7a850f5fd39234f80b5429d3a57edcc11e34c585b");
+    EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, 0, TWBitcoinSigHashTypeNone, 0x02faf080, Bitcoin::BASE, cache)),
+              "2f0a186e474c4c2f768c2f55529523a1f3d09d182740cdf0d21bb6752028d70d");
+    EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, 0, TWBitcoinSigHashTypeSingle, 0x02faf080, Bitcoin::BASE, cache)),
+              "a3f6bf9a54c9e250fbc628ed17dc4eb29c7454671bc537eba34c39c7b6bdb514");
+    const auto allAnyoneCanPay = static_cast<TWBitcoinSigHashType>(TWBitcoinSigHashTypeAll | TWBitcoinSigHashTypeAnyoneCanPay);
+    EXPECT_EQ(hex(transaction.getSignatureHash(scriptCode, 0, allAnyoneCanPay, 0x02faf080, Bitcoin::BASE, cache)),
+              "310c0c94e32f685d7656edf030bef15e443119cd0ea341dbe5bde9ffb342df67");
 }
 
 TEST(TWZcashTransaction, SaplingSigning) {
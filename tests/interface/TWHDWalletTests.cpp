@@ -425,3 +425,21 @@ TEST(HDWallet, GetDerivedKey) {
     const auto privateKeyData = WRAPD(TWPrivateKeyData(privateKey.get()));
     assertHexEqual(privateKeyData, "1901b5994f075af71397f65bd68a9fff8d3025d65f5a2c731cf90f5e259d6aac");
 }
+
+TEST(HDWallet, DeriveAddresses) {
+    auto wallet = WRAP(TWHDWallet, TWHDWalletCreateWithMnemonic(words.get(), passphrase.get()));
+    const auto stream = WRAPD(TWHDWalletDeriveAddresses(wallet.get(), TWCoinTypeEthereum, 0, 0, 0, 3, 2));
+    ASSERT_NE(stream.get(), nullptr);
+    std::vector<TW::Data> addresses;
+    ASSERT_TRUE(TW::readDelimited(*reinterpret_cast<const TW::Data*>(stream.get()), addresses));
+    ASSERT_EQ(addresses.size(), 3ul);
+    EXPECT_EQ(std::string(addresses[0].begin(), addresses[0].end()), "0x27Ef5cDBe01777D62438AfFeb695e33fC2335979");
+
+    const auto xpub = WRAPS(TWHDWalletGetExtendedPublicKey(wallet.get(), TWPurposeBIP44, TWCoinTypeEthereum, TWHDVersionXPUB));
+    const auto xpubStream = WRAPD(TWHDWalletDeriveAddressesFromExtended(xpub.get(), TWCoinTypeEthereum, 0, 0, 3, 1));
+    ASSERT_NE(xpubStream.get(), nullptr);
+    EXPECT_EQ(*reinterpret_cast<const TW::Data*>(xpubStream.get()), *reinterpret_cast<const TW::Data*>(stream.get()));
+
+    EXPECT_EQ(TWHDWalletDeriveAddresses(wallet.get(), TWCoinTypeEthereum, 0, 0, 0x80000000, 1, 1), nullptr);
+    EXPECT_EQ(TWHDWalletDeriveAddressesFromExtended(STRING("xpub").get(), TWCoinTypeEthereum, 0, 0, 3, 1), nullptr);
+}
@@ -9,6 +9,7 @@
 #include "PublicKey.h"
 #include "PrivateKey.h"
 #include "HexCoding.h"
+#include "Hash.h"
 
 #include <TrustWalletCore/TWHash.h>
 #include <TrustWalletCore/TWPrivateKey.h>
@@ -99,6 +100,49 @@ TEST(TWPublicKeyTests, VerifyEd25519) {
     ASSERT_TRUE(TWPublicKeyVerify(publicKey2.get(), signature2.get(), digest.get()));
 }
 
+TEST(TWPublicKeyTests, VerifyBatch) {
+    Data keys, signatures, digests;
+    for (auto i = 0; i < 3; ++i) {
+        const auto privateKey = PrivateKey(Hash::sha256(TW::data("key " + std::to_string(i))));
+        const auto digest = Hash::sha256(TW::data("message " + std::to_string(i)));
+        writeDelimited(privateKey.getPublicKey(TWPublicKeyTypeSECP256k1).bytes, keys);
+        writeDelimited(privateKey.sign(digest, TWCurveSECP256k1), signatures);
+        writeDelimited(i == 1 ? Hash::sha256(digest) : digest, digests);
+    }
+    // invalid public key
+    writeDelimited(Data(33, 0), keys);
+    writeDelimited(Data(65, 0), signatures);
+    writeDelimited(Data(32, 0), digests);
+
+    const auto keysData = WRAPD(TWDataCreateWithBytes(keys.data(), keys.size()));
+    const auto signaturesData = WRAPD(TWDataCreateWithBytes(signatures.data(), signatures.size()));
+    const auto digestsData = WRAPD(TWDataCreateWithBytes(digests.data(), digests.size()));
+    const auto results = WRAPD(TWPublicKeyVerifyBatch(keysData.get(), TWPublicKeyTypeSECP256k1, signaturesData.get(), digestsData.get()));
+    ASSERT_TRUE(results.get() != nullptr);
+    assertHexEqual(results, "01000100");
+
+    const auto truncated = WRAPD(TWDataCreateWithBytes(digests.data(), 10));
+    const auto mismatched = TWPublicKeyVerifyBatch(keysData.get(), TWPublicKeyTypeSECP256k1, signaturesData.get(), truncated.get());
+    EXPECT_EQ(mismatched, nullptr);
+}
+
+TEST(TWPublicKeyTests, VerifyBatchED25519Extended) {
+    // verification is not supported for the type, signatures are invalid
+    Data keys, signatures, digests;
+    const auto privateKey = PrivateKey(parse_hex("b0884d248cb301edd1b34cf626ba6d880bb3ae8fd91b4696446999dc4f0b5744309941d56938e943980d11643c535e046653ca6f498c014b88f2ad9fd6e71effbf36a8fa9f5e11eb7a852c41e185e3969d518e66e6893c81d3fc7227009952d4"));
+    const auto digest = Hash::sha256(TW::data("message"));
+    writeDelimited(privateKey.getPublicKey(TWPublicKeyTypeED25519Extended).bytes, keys);
+    writeDelimited(privateKey.sign(digest, TWCurveED25519Extended), signatures);
+    writeDelimited(digest, digests);
+
+    const auto keysData = WRAPD(TWDataCreateWithBytes(keys.data(), keys.size()));
+    const auto signaturesData = WRAPD(TWDataCreateWithBytes(signatures.data(), signatures.size()));
+    const auto digestsData = WRAPD(TWDataCreateWithBytes(digests.data(), digests.size()));
+    const auto results = WRAPD(TWPublicKeyVerifyBatch(keysData.get(), TWPublicKeyTypeED25519Extended, signaturesData.get(), digestsData.get()));
+    ASSERT_TRUE(results.get() != nullptr);
+    assertHexEqual(results, "00");
+}
+
 TEST(TWPublicKeyTests, Recover) {
     const auto message = DATA("de4e9524586d6fce45667f9ff12f661e79870c4105fa0fb58af976619bb11432");
     const auto signature = DATA("00000000000000000000000000000000000000000000000000000000000000020123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef80");
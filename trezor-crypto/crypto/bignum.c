@@ -690,6 +690,219 @@ void bn_multiply_reduce(bignum256 *x, uint32_t res[2 * BN_LIMBS],
   }
 }
 
+#if USE_BN_64
+// [wallet-core]
+// 64-bit limb backend of bn_multiply, for 64-bit targets.
+//
+// The operands are converted to 64-bit words and multiplied with 64x64-bit
+// multiplications.  The product is reduced by folding its high part with
+// 2**256 == 2**256 - prime (mod prime) for the secp256k1 prime and order, and
+// with the Solinas form of the NIST P-256 prime (FIPS 186-4, D.2.3).  Other
+// moduli, such as the nist256p1 order, for which 2**256 - prime is too large
+// to fold quickly, use the 29-bit limb implementation.
+
+#if !defined(__SIZEOF_INT128__)
+#error "USE_BN_64 requires a compiler with unsigned __int128"
+#endif
+
+typedef unsigned __int128 bn_uint128;
+
+#define BN_WORDS 4
+
+static const uint64_t bn_secp256k1_prime[BN_WORDS] = {
+    0xfffffffefffffc2full, 0xffffffffffffffffull, 0xffffffffffffffffull,
+    0xffffffffffffffffull};
+static const uint64_t bn_secp256k1_order[BN_WORDS] = {
+    0xbfd25e8cd0364141ull, 0xbaaedce6af48a03bull, 0xfffffffffffffffeull,
+    0xffffffffffffffffull};
+static const uint64_t bn_nist256p1_prime[BN_WORDS] = {
+    0xffffffffffffffffull, 0x00000000ffffffffull, 0x0000000000000000ull,
+    0xffffffff00000001ull};
+
+// 2**256 - prime of the secp256k1 prime and order
+static const uint64_t bn_secp256k1_prime_c[BN_WORDS] = {0x00000001000003d1ull};
+static const uint64_t bn_secp256k1_order_c[BN_WORDS] = {
+    0x402da1732fc9bebfull, 0x4551231950b75fc4ull, 0x0000000000000001ull};
+
+// w = x
+// Assumes x is normalized (x < 2**261)
+static void bn_to_words(const bignum256 *x, uint64_t w[BN_WORDS + 1]) {
+  const uint32_t *v = x->val;
+  w[0] = v[0] | ((uint64_t)v[1] << 29) | ((uint64_t)v[2] << 58);
+  w[1] = (v[2] >> 6) | ((uint64_t)v[3] << 23) | ((uint64_t)v[4] << 52);
+  w[2] = (v[4] >> 12) | ((uint64_t)v[5] << 17) | ((uint64_t)v[6] << 46);
+  w[3] = (v[6] >> 18) | ((uint64_t)v[7] << 11) | ((uint64_t)v[8] << 40);
+  w[4] = v[8] >> 24;
+}
+
+// x = w
+// Assumes w < 2**256
+// Guarantees x is normalized
+static void bn_from_words(const uint64_t w[BN_WORDS], bignum256 *x) {
+  x->val[0] = w[0] & BN_LIMB_MASK;
+  x->val[1] = (w[0] >> 29) & BN_LIMB_MASK;
+  x->val[2] = ((w[0] >> 58) | (w[1] << 6)) & BN_LIMB_MASK;
+  x->val[3] = (w[1] >> 23) & BN_LIMB_MASK;
+  x->val[4] = ((w[1] >> 52) | (w[2] << 12)) & BN_LIMB_MASK;
+  x->val[5] = (w[2] >> 17) & BN_LIMB_MASK;
+  x->val[6] = ((w[2] >> 46) | (w[3] << 18)) & BN_LIMB_MASK;
+  x->val[7] = (w[3] >> 11) & BN_LIMB_MASK;
+  x->val[8] = w[3] >> 40;
+}
+
+// r = r % 2**256 + (r // 2**256) * c, using h as scratch space
+// Assumes r < 2**bits, 256 < bits <= 64 * (2 * BN_WORDS + 1),
+//   c < 2**cbits <= 2**(64 * cwords), bits - 256 + cbits < 64 * 2 * BN_WORDS
+// Returns the bound of the result: r < 2**(max(256, bits - 256 + cbits) + 1)
+static int bn_fold_words(uint64_t r[2 * BN_WORDS + 1], int bits,
+                         const uint64_t *c, int cwords, int cbits,
+                         uint64_t h[BN_WORDS + 1]) {
+  const int hwords = (bits - 256 + 63) / 64;
+  const int result = (bits - 256 + cbits > 256 ? bits - 256 + cbits : 256) + 1;
+  const int rwords = (result + 63) / 64;
+
+  for (int i = 0; i < hwords; i++) {
+    h[i] = r[BN_WORDS + i];
+  }
+  for (int i = BN_WORDS; i < hwords + BN_WORDS || i < rwords; i++) {
+    r[i] = 0;
+  }
+  for (int i = 0; i < hwords; i++) {
+    bn_uint128 acc = 0;
+    int j = 0;
+    for (; j < cwords; j++) {
+      acc += (bn_uint128)h[i] * c[j] + r[i + j];
+      r[i + j] = (uint64_t)acc;
+      acc >>= 64;
+    }
+    for (j += i; j < rwords; j++) {
+      acc += r[j];
+      r[j] = (uint64_t)acc;
+      acc >>= 64;
+    }
+  }
+  return result;
+}
+
+// Reduces r by folding with c = 2**256 - prime
+// Assumes r < 2**bits
+// Guarantees r < 2**256
+static void bn_reduce_words(uint64_t r[2 * BN_WORDS + 1], int bits,
+                            const uint64_t *c, int cwords, int cbits) {
+  uint64_t h[BN_WORDS + 1] = {0};
+
+  while (bits > 257) {
+    bits = bn_fold_words(r, bits, c, cwords, cbits, h);
+  }
+  // r < 2**257: after a fold r < 2**256 + c, and if r >= 2**256 another fold
+  // adds c to r % 2**256 < c
+  bn_fold_words(r, 257, c, cwords, cbits, h);
+  bn_fold_words(r, 257, c, cwords, cbits, h);
+
+  memzero(h, sizeof(h));
+}
+
+// r = r % prime for the NIST P-256 prime, with its Solinas form
+// Assumes r < 2**519
+// Guarantees r < 2**256
+static void bn_reduce_nist256p1(uint64_t r[2 * BN_WORDS + 1]) {
+// 32-bit words of r
+#define C(i) ((int64_t)((r[(i) / 2] >> (32 * ((i) % 2))) & 0xffffffff))
+  int64_t s[8] = {0};
+  int64_t carry = 0;
+
+  // s1 + 2 s2 + 2 s3 + s4 + s5 - s6 - s7 - s8 - s9, plus r // 2**512 times
+  // 2**512 == 5 * 2**224 - 2 * 2**192 - 2**128 - 4 * 2**96 - 2**64 + 3
+  const int64_t c16 = (int64_t)r[2 * BN_WORDS];
+  s[0] = C(0) + C(8) + C(9) - C(11) - C(12) - C(13) - C(14) + 3 * c16;
+  s[1] = C(1) + C(9) + C(10) - C(12) - C(13) - C(14) - C(15);
+  s[2] = C(2) + C(10) + C(11) - C(13) - C(14) - C(15) - c16;
+  s[3] = C(3) + 2 * C(11) + 2 * C(12) + C(13) - C(15) - C(8) - C(9) - 4 * c16;
+  s[4] = C(4) + 2 * C(12) + 2 * C(13) + C(14) - C(9) - C(10) - c16;
+  s[5] = C(5) + 2 * C(13) + 2 * C(14) + C(15) - C(10) - C(11);
+  s[6] = C(6) + 3 * C(14) + 2 * C(15) + C(13) - C(8) - C(9) - 2 * c16;
+  s[7] = C(7) + 3 * C(15) + C(8) - C(10) - C(11) - C(12) - C(13) + 5 * c16;
+#undef C
+
+  // -4 * 2**256 < s < 8 * 2**256: the carry is folded twice with
+  // 2**256 == 2**224 - 2**192 - 2**96 + 1 (mod prime), after which it is zero
+  for (int round = 0; round < 3; round++) {
+    s[0] += carry;
+    s[3] -= carry;
+    s[6] -= carry;
+    s[7] += carry;
+    carry = 0;
+    for (int i = 0; i < 8; i++) {
+      s[i] += carry;
+      carry = s[i] >> 32;
+      s[i] &= 0xffffffff;
+    }
+  }
+
+  for (int i = 0; i < BN_WORDS; i++) {
+    r[i] = (uint64_t)s[2 * i] | ((uint64_t)s[2 * i + 1] << 32);
+  }
+  memzero(s, sizeof(s));
+}
+
+// Whether the words of a number are equal to the words of a 256-bit prime
+static int bn_words_equal(const uint64_t w[BN_WORDS + 1],
+                          const uint64_t prime[BN_WORDS]) {
+  return ((w[0] ^ prime[0]) | (w[1] ^ prime[1]) | (w[2] ^ prime[2]) |
+          (w[3] ^ prime[3]) | w[4]) == 0;
+}
+
+// x = k * x % prime
+// Assumes k, x are normalized, k * x < 2**519
+// Guarantees x is normalized and partly reduced modulo prime
+// Assumes prime is normalized, 2**256 - 2**224 <= prime <= 2**256
+void bn_multiply(const bignum256 *k, bignum256 *x, const bignum256 *prime) {
+  uint64_t a[BN_WORDS + 1] = {0}, b[BN_WORDS + 1] = {0};
+  uint64_t r[2 * BN_WORDS + 1] = {0}, p[BN_WORDS + 1] = {0};
+
+  bn_to_words(prime, p);
+  const int secp256k1_prime = bn_words_equal(p, bn_secp256k1_prime);
+  const int secp256k1_order = bn_words_equal(p, bn_secp256k1_order);
+  const int nist256p1_prime = bn_words_equal(p, bn_nist256p1_prime);
+  if (!secp256k1_prime && !secp256k1_order && !nist256p1_prime) {
+    uint32_t res[2 * BN_LIMBS] = {0};
+    bn_multiply_long(k, x, res);
+    bn_multiply_reduce(x, res, prime);
+    memzero(res, sizeof(res));
+    return;
+  }
+
+  // r = a * b < 2**519
+  bn_to_words(k, a);
+  bn_to_words(x, b);
+  for (int i = 0; i <= BN_WORDS; i++) {
+    bn_uint128 acc = 0;
+    for (int j = 0; j <= BN_WORDS && i + j <= 2 * BN_WORDS; j++) {
+      acc += (bn_uint128)a[i] * b[j] + r[i + j];
+      r[i + j] = (uint64_t)acc;
+      acc >>= 64;
+    }
+    if (i < BN_WORDS) {
+      r[i + BN_WORDS + 1] = (uint64_t)acc;
+    }
+  }
+
+  if (nist256p1_prime) {
+    bn_reduce_nist256p1(r);
+  } else if (secp256k1_prime) {
+    bn_reduce_words(r, 519, bn_secp256k1_prime_c, 1, 33);
+  } else {
+    bn_reduce_words(r, 519, bn_secp256k1_order_c, 3, 129);
+  }
+  bn_from_words(r, x);
+
+  memzero(a, sizeof(a));
+  memzero(b, sizeof(b));
+  memzero(r, sizeof(r));
+}
+
+#else
+
 // x = k * x % prime
 // Assumes k, x are normalized, k * x < 2**519
 // Guarantees x is normalized and partly reduced modulo prime
@@ -703,6 +916,8 @@ void bn_multiply(const bignum256 *k, bignum256 *x, const bignum256 *prime) {
   memzero(res, sizeof(res));
 }
 
+#endif
+
 // Partly reduces x modulo prime
 // Assumes limbs of x except the last (the most significant) one are normalized
 // Assumes prime is normalized and 2^256 - 2^224 <= prime <= 2^256
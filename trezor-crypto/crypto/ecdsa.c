@@ -368,11 +368,13 @@ void point_jacobian_double(jacobian_curve_point *p, const ecdsa_curve *curve) {
   bn_multiply(&m, &m, prime);
   bn_mult_k(&m, 3, prime);
 
-  az4 = p->z;
-  bn_multiply(&az4, &az4, prime);
-  bn_multiply(&az4, &az4, prime);
-  bn_mult_k(&az4, -curve->a, prime);
-  bn_subtractmod(&m, &az4, &m, prime);
+  if (curve->a != 0) {
+    az4 = p->z;
+    bn_multiply(&az4, &az4, prime);
+    bn_multiply(&az4, &az4, prime);
+    bn_mult_k(&az4, -curve->a, prime);
+    bn_subtractmod(&m, &az4, &m, prime);
+  }
   bn_mult_half(&m, prime);
 
   // msq = m^2
@@ -525,12 +527,12 @@ void point_multiply(const ecdsa_curve *curve, const bignum256 *k,
   memzero(&jres, sizeof(jres));
 }
 
-#if USE_PRECOMPUTED_CP
-
-// res = k * G
+// [wallet-core] the body of scalar_multiply, for any point p given the table
+// of its multiples cp[i][j] = (2j + 1) * 16^i * p, laid out as curve->cp.
+// res = k * p
 // k must be a normalized number with 0 <= k < curve->order
-void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
-                     curve_point *res) {
+static void comb_multiply(const ecdsa_curve *curve, const curve_point cp[64][8],
+                          const bignum256 *k, curve_point *res) {
   assert(bn_is_less(k, &curve->order));
 
   int i = {0}, j = {0};
@@ -556,7 +558,7 @@ void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
   a.val[j] = tmp + 0xffffff + k->val[j] - (curve->order.val[j] & is_even);
   assert((a.val[0] & 1) != 0);
 
-  // special case 0*G:  just return zero. We don't care about constant time.
+  // special case 0*p:  just return zero. We don't care about constant time.
   if (!is_non_zero) {
     point_set_infinity(res);
     return;
@@ -571,23 +573,23 @@ void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
   // a[64] = 1, which is the 2^256 that we added before.
   //
   // Since k = a - 2^256 (mod curve->order), we can compute
-  //   k*G = sum_{i=0..63} a[i] 16^i * G
+  //   k*p = sum_{i=0..63} a[i] 16^i * p
   //
-  // We have a big table curve->cp that stores all possible
-  // values of |a[i]| 16^i * G.
-  // curve->cp[i][j] = (2*j+1) * 16^i * G
+  // We have a big table cp that stores all possible
+  // values of |a[i]| 16^i * p.
+  // cp[i][j] = (2*j+1) * 16^i * p
 
-  // now compute  res = sum_{i=0..63} a[i] * 16^i * G step by step.
-  // initial res = |a[0]| * G.  Note that a[0] = a & 0xf if (a&0x10) != 0
+  // now compute  res = sum_{i=0..63} a[i] * 16^i * p step by step.
+  // initial res = |a[0]| * p.  Note that a[0] = a & 0xf if (a&0x10) != 0
   // and - (16 - (a & 0xf)) otherwise.   We can compute this as
   //   ((a ^ (((a >> 4) & 1) - 1)) & 0xf) >> 1
   // since a is odd.
   lowbits = a.val[0] & ((1 << 5) - 1);
   lowbits ^= (lowbits >> 4) - 1;
   lowbits &= 15;
-  curve_to_jacobian(&curve->cp[0][lowbits >> 1], &jres, prime);
+  curve_to_jacobian(&cp[0][lowbits >> 1], &jres, prime);
   for (i = 1; i < 64; i++) {
-    // invariant res = sign(a[i-1]) sum_{j=0..i-1} (a[j] * 16^j * G)
+    // invariant res = sign(a[i-1]) sum_{j=0..i-1} (a[j] * 16^j * p)
 
     // shift a by 4 places.
     for (j = 0; j < 8; j++) {
@@ -606,7 +608,7 @@ void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
     bn_cnegate(~lowbits & 1, &jres.y, prime);
 
     // add odd factor
-    point_jacobian_add(&curve->cp[i][lowbits >> 1], &jres, curve);
+    point_jacobian_add(&cp[i][lowbits >> 1], &jres, curve);
   }
   bn_cnegate(~(a.val[0] >> 4) & 1, &jres.y, prime);
   jacobian_to_curve(&jres, res, prime);
@@ -614,6 +616,15 @@ void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
   memzero(&jres, sizeof(jres));
 }
 
+#if USE_PRECOMPUTED_CP
+
+// res = k * G
+// k must be a normalized number with 0 <= k < curve->order
+void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
+                     curve_point *res) {
+  comb_multiply(curve, curve->cp, k, res);
+}
+
 #else
 
 void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
@@ -1250,3 +1261,366 @@ int zil_schnorr_verify(const ecdsa_curve *curve, const uint8_t *pub_key, const u
 
 	return schnorr_verify(curve, pub_key, msg, msg_len, &sign);
 }
+
+// [wallet-core]
+// Signatures are verified in chunks that share their modular inversions.
+#define ECDSA_VERIFY_BATCH_CHUNK 16
+// Width of the window NAF used in batch verification, the tables hold the odd
+// multiples 1, 3, ..., 2^(w-1) - 1 of a point.
+#define ECDSA_WNAF_WIDTH 5
+#define ECDSA_WNAF_TABLE_SIZE (1 << (ECDSA_WNAF_WIDTH - 2))
+#define ECDSA_WNAF_LENGTH (256 + ECDSA_WNAF_WIDTH + 1)
+
+// x[i] = 1/x[i] % prime for all i, with a single inversion (Montgomery's trick)
+// Assumes x[i] are normalized, partly reduced and nonzero modulo prime
+// Guarantees x[i] are fully reduced modulo prime
+// scratch must have room for count numbers
+static void bn_batch_inverse(bignum256 *x, size_t count,
+                             const bignum256 *prime, bignum256 *scratch) {
+  bignum256 inv = {0}, t = {0};
+  size_t i = 0;
+
+  if (count == 0) {
+    return;
+  }
+  // scratch[i] = x[0] * ... * x[i]
+  scratch[0] = x[0];
+  for (i = 1; i < count; i++) {
+    scratch[i] = x[i];
+    bn_multiply(&scratch[i - 1], &scratch[i], prime);
+  }
+  inv = scratch[count - 1];
+  bn_mod(&inv, prime);
+  bn_inverse(&inv, prime);
+  // invariant inv = 1 / (x[0] * ... * x[i])
+  for (i = count - 1; i > 0; i--) {
+    t = scratch[i - 1];
+    bn_multiply(&inv, &t, prime);
+    bn_multiply(&x[i], &inv, prime);
+    bn_mod(&t, prime);
+    x[i] = t;
+  }
+  bn_mod(&inv, prime);
+  x[0] = inv;
+}
+
+// Window NAF of k: k = sum_i naf[i] 2^i, where each naf[i] is zero or odd with
+// |naf[i]| < 2^(w-1), and each nonzero digit is followed by w-1 zero digits.
+// Variable time: only for public scalars.
+static void ecdsa_wnaf(const bignum256 *k, int8_t naf[ECDSA_WNAF_LENGTH]) {
+  int bit = 0, carry = 0, word = 0, j = 0;
+
+  memset(naf, 0, ECDSA_WNAF_LENGTH);
+  while (bit < 256) {
+    if ((int)bn_testbit(k, bit) == carry) {
+      bit++;
+      continue;
+    }
+    word = carry;
+    for (j = 0; j < ECDSA_WNAF_WIDTH && bit + j < 256; j++) {
+      word += (int)bn_testbit(k, bit + j) << j;
+    }
+    carry = (word >> (ECDSA_WNAF_WIDTH - 1)) & 1;
+    word -= carry << ECDSA_WNAF_WIDTH;
+    naf[bit] = (int8_t)word;
+    bit += ECDSA_WNAF_WIDTH;
+  }
+  naf[bit] = (int8_t)carry;
+}
+
+// table[j] = (2j + 1) * p in jacobian coordinates
+static void ecdsa_odd_multiples(const ecdsa_curve *curve, const curve_point *p,
+                                jacobian_curve_point *table) {
+  int j = 0;
+
+  table[0].x = p->x;
+  table[0].y = p->y;
+  bn_one(&table[0].z);
+  for (j = 1; j < ECDSA_WNAF_TABLE_SIZE; j++) {
+    table[j] = table[j - 1];
+    point_jacobian_add(p, &table[j], curve);
+    point_jacobian_add(p, &table[j], curve);
+  }
+}
+
+// res += digit * p, where table[j] = (2j + 1) * p and digit is odd.
+// started tells whether res holds a point yet (it starts as infinity).
+static void ecdsa_add_multiple(const ecdsa_curve *curve,
+                               const curve_point *table, int digit,
+                               jacobian_curve_point *res, int *started) {
+  curve_point p = table[(digit < 0 ? -digit : digit) >> 1];
+
+  if (digit < 0) {
+    bn_subtract(&curve->prime, &p.y, &p.y);
+  }
+  if (*started) {
+    point_jacobian_add(&p, res, curve);
+  } else {
+    res->x = p.x;
+    res->y = p.y;
+    bn_one(&res->z);
+    *started = 1;
+  }
+}
+
+static void ecdsa_verify_digest_chunk(const ecdsa_curve *curve, size_t count,
+                                      const uint8_t *const *pub_keys,
+                                      const uint8_t *const *sigs,
+                                      const uint8_t *const *digests,
+                                      int *results) {
+  // items still valid after the checks of ecdsa_verify_digest, with their
+  // public keys (and G, if there is no precomputed table for it)
+  size_t items[ECDSA_VERIFY_BATCH_CHUNK] = {0};
+  curve_point pub[ECDSA_VERIFY_BATCH_CHUNK + 1] = {0};
+  bignum256 r[ECDSA_VERIFY_BATCH_CHUNK] = {0};
+  bignum256 u1[ECDSA_VERIFY_BATCH_CHUNK] = {0};
+  bignum256 u2[ECDSA_VERIFY_BATCH_CHUNK] = {0};
+  bignum256 z[(ECDSA_VERIFY_BATCH_CHUNK + 1) * ECDSA_WNAF_TABLE_SIZE] = {0};
+  bignum256 scratch[(ECDSA_VERIFY_BATCH_CHUNK + 1) * ECDSA_WNAF_TABLE_SIZE] = {
+      0};
+  jacobian_curve_point jtable[(ECDSA_VERIFY_BATCH_CHUNK + 1) *
+                              ECDSA_WNAF_TABLE_SIZE] = {0};
+  curve_point table[ECDSA_VERIFY_BATCH_CHUNK + 1][ECDSA_WNAF_TABLE_SIZE] = {0};
+  jacobian_curve_point res[ECDSA_VERIFY_BATCH_CHUNK] = {0};
+  int8_t naf1[ECDSA_WNAF_LENGTH] = {0}, naf2[ECDSA_WNAF_LENGTH] = {0};
+  const curve_point *gtable = NULL;
+  const bignum256 *prime = &curve->prime;
+  size_t valid = 0, points = 0, finite = 0, i = 0, j = 0;
+  int started = 0, k = 0;
+
+  for (i = 0; i < count; i++) {
+    results[i] = 0;
+    if (!ecdsa_read_pubkey(curve, pub_keys[i], &pub[valid])) {
+      results[i] = 1;
+      continue;
+    }
+    bn_read_be(sigs[i], &r[valid]);
+    bn_read_be(sigs[i] + 32, &u2[valid]);
+    bn_read_be(digests[i], &u1[valid]);
+    if (bn_is_zero(&r[valid]) || bn_is_zero(&u2[valid]) ||
+        (!bn_is_less(&r[valid], &curve->order)) ||
+        (!bn_is_less(&u2[valid], &curve->order))) {
+      results[i] = 2;
+    }
+    if (bn_is_zero(&u1[valid])) {
+      // all-zero digest, see ecdsa_verify_digest
+      results[i] = 3;
+    }
+    if (results[i] == 0) {
+      items[valid++] = i;
+    }
+  }
+
+  // u2 = s^-1, then u1 = z * s^-1 and u2 = r * s^-1
+  bn_batch_inverse(u2, valid, &curve->order, scratch);
+  for (i = 0; i < valid; i++) {
+    bn_multiply(&u2[i], &u1[i], &curve->order);
+    bn_mod(&u1[i], &curve->order);
+    bn_multiply(&r[i], &u2[i], &curve->order);
+    bn_mod(&u2[i], &curve->order);
+  }
+
+  // affine tables of odd multiples, normalized with a single inversion
+  points = valid;
+#if USE_PRECOMPUTED_CP
+  // curve->cp[0][j] = (2j + 1) * G
+  gtable = curve->cp[0];
+#else
+  pub[points++] = curve->G;
+  gtable = table[valid];
+#endif
+  for (i = 0; i < points; i++) {
+    ecdsa_odd_multiples(curve, &pub[i], &jtable[i * ECDSA_WNAF_TABLE_SIZE]);
+  }
+  for (i = 0; i < points * ECDSA_WNAF_TABLE_SIZE; i++) {
+    z[i] = jtable[i].z;
+  }
+  bn_batch_inverse(z, points * ECDSA_WNAF_TABLE_SIZE, prime, scratch);
+  for (i = 0; i < points; i++) {
+    for (j = 0; j < ECDSA_WNAF_TABLE_SIZE; j++) {
+      const jacobian_curve_point *jp = &jtable[i * ECDSA_WNAF_TABLE_SIZE + j];
+      curve_point *p = &table[i][j];
+      // x = x * z^-2, y = y * z^-3
+      p->x = z[i * ECDSA_WNAF_TABLE_SIZE + j];
+      bn_multiply(&p->x, &p->x, prime);
+      p->y = p->x;
+      bn_multiply(&z[i * ECDSA_WNAF_TABLE_SIZE + j], &p->y, prime);
+      bn_multiply(&jp->x, &p->x, prime);
+      bn_multiply(&jp->y, &p->y, prime);
+      bn_mod(&p->x, prime);
+      bn_mod(&p->y, prime);
+    }
+  }
+
+  // R = u1 * G + u2 * Q, interleaving the doublings of both multiplications
+  // (Shamir's trick)
+  for (i = 0; i < valid; i++) {
+    ecdsa_wnaf(&u1[i], naf1);
+    ecdsa_wnaf(&u2[i], naf2);
+    started = 0;
+    for (k = ECDSA_WNAF_LENGTH - 1; k >= 0; k--) {
+      if (started) {
+        point_jacobian_double(&res[i], curve);
+      }
+      if (naf1[k] != 0) {
+        ecdsa_add_multiple(curve, gtable, naf1[k], &res[i], &started);
+      }
+      if (naf2[k] != 0) {
+        ecdsa_add_multiple(curve, table[i], naf2[k], &res[i], &started);
+      }
+    }
+    // R == Infinity: u1 = u2 = 0 is impossible, so z == 0 modulo prime.  This
+    // also happens when an intermediate sum is at infinity, which
+    // point_jacobian_add doesn't handle: let ecdsa_verify_digest decide.
+    z[finite] = res[i].z;
+    bn_mod(&z[finite], prime);
+    if (!started || bn_is_zero(&z[finite])) {
+      results[items[i]] = ecdsa_verify_digest(curve, pub_keys[items[i]],
+                                              sigs[items[i]], digests[items[i]]);
+      items[i] = count;
+      continue;
+    }
+    finite++;
+  }
+
+  // R.x = x * z^-2 modulo order must equal r
+  bn_batch_inverse(z, finite, prime, scratch);
+  for (i = 0, j = 0; i < valid; i++) {
+    if (items[i] == count) {
+      continue;
+    }
+    bn_multiply(&z[j], &z[j], prime);
+    bn_multiply(&res[i].x, &z[j], prime);
+    bn_mod(&z[j], prime);
+    bn_mod(&z[j], &curve->order);
+    if (!bn_is_equal(&z[j], &r[i])) {
+      // R.x != r
+      // signature does not match
+      results[items[i]] = 5;
+    }
+    j++;
+  }
+}
+
+// [wallet-core]
+void ecdsa_verify_digest_batch(const ecdsa_curve *curve, size_t count,
+                               const uint8_t *const *pub_keys,
+                               const uint8_t *const *sigs,
+                               const uint8_t *const *digests, int *results) {
+  size_t offset = 0, chunk = 0;
+
+  for (offset = 0; offset < count; offset += chunk) {
+    chunk = count - offset < ECDSA_VERIFY_BATCH_CHUNK
+                ? count - offset
+                : ECDSA_VERIFY_BATCH_CHUNK;
+    ecdsa_verify_digest_chunk(curve, chunk, pub_keys + offset, sigs + offset,
+                              digests + offset, results + offset);
+  }
+}
+
+// [wallet-core]
+int ecdsa_prepare_point(const ecdsa_curve *curve, const uint8_t *pub_key,
+                        ecdsa_prepared_point *prepared) {
+  // odd multiples (2j + 1) * 16^i * pub of a row, then 16^(i+1) * pub
+  jacobian_curve_point jtable[ECDSA_WNAF_TABLE_SIZE + 1] = {0};
+  bignum256 z[ECDSA_WNAF_TABLE_SIZE + 1] = {0};
+  bignum256 scratch[ECDSA_WNAF_TABLE_SIZE + 1] = {0};
+  curve_point base = {0};
+  const bignum256 *prime = &curve->prime;
+  int i = 0, j = 0;
+
+  if (!ecdsa_read_pubkey(curve, pub_key, &base)) {
+    return 1;
+  }
+  prepared->curve = curve;
+  prepared->pub = base;
+
+  for (i = 0; i < 64; i++) {
+    ecdsa_odd_multiples(curve, &base, jtable);
+    jtable[ECDSA_WNAF_TABLE_SIZE] = jtable[ECDSA_WNAF_TABLE_SIZE - 1];
+    point_jacobian_add(&base, &jtable[ECDSA_WNAF_TABLE_SIZE], curve);
+    for (j = 0; j <= ECDSA_WNAF_TABLE_SIZE; j++) {
+      z[j] = jtable[j].z;
+    }
+    bn_batch_inverse(z, ECDSA_WNAF_TABLE_SIZE + 1, prime, scratch);
+    for (j = 0; j <= ECDSA_WNAF_TABLE_SIZE; j++) {
+      curve_point *p =
+          j < ECDSA_WNAF_TABLE_SIZE ? &prepared->cp[i][j] : &base;
+      // x = x * z^-2, y = y * z^-3
+      p->x = z[j];
+      bn_multiply(&p->x, &p->x, prime);
+      p->y = p->x;
+      bn_multiply(&z[j], &p->y, prime);
+      bn_multiply(&jtable[j].x, &p->x, prime);
+      bn_multiply(&jtable[j].y, &p->y, prime);
+      bn_mod(&p->x, prime);
+      bn_mod(&p->y, prime);
+    }
+  }
+  return 0;
+}
+
+// [wallet-core]
+void point_multiply_prepared(const ecdsa_prepared_point *prepared,
+                             const bignum256 *k, curve_point *res) {
+  comb_multiply(prepared->curve, prepared->cp, k, res);
+}
+
+// [wallet-core]
+int ecdh_multiply_prepared(const ecdsa_prepared_point *prepared,
+                           const uint8_t *priv_key, uint8_t *session_key) {
+  curve_point point = {0};
+  bignum256 k = {0};
+
+  bn_read_be(priv_key, &k);
+  point_multiply_prepared(prepared, &k, &point);
+  memzero(&k, sizeof(k));
+
+  session_key[0] = 0x04;
+  bn_write_be(&point.x, session_key + 1);
+  bn_write_be(&point.y, session_key + 33);
+  memzero(&point, sizeof(point));
+
+  return 0;
+}
+
+// [wallet-core]
+int ecdsa_verify_digest_prepared(const ecdsa_prepared_point *prepared,
+                                 const uint8_t *sig, const uint8_t *digest) {
+  const ecdsa_curve *curve = prepared->curve;
+  curve_point pub = {0}, res = {0};
+  bignum256 r = {0}, s = {0}, z = {0};
+
+  bn_read_be(sig, &r);
+  bn_read_be(sig + 32, &s);
+  bn_read_be(digest, &z);
+  if (bn_is_zero(&r) || bn_is_zero(&s) || (!bn_is_less(&r, &curve->order)) ||
+      (!bn_is_less(&s, &curve->order))) {
+    return 2;
+  }
+  if (bn_is_zero(&z)) {
+    // all-zero digest, see ecdsa_verify_digest
+    return 3;
+  }
+
+  bn_inverse(&s, &curve->order);       // s = s^-1
+  bn_multiply(&s, &z, &curve->order);  // z = z * s  [u1 = z * s^-1 mod n]
+  bn_mod(&z, &curve->order);
+  bn_multiply(&r, &s, &curve->order);  // s = r * s  [u2 = r * s^-1 mod n]
+  bn_mod(&s, &curve->order);
+  scalar_multiply(curve, &z, &res);               // res = u1 * G
+  point_multiply_prepared(prepared, &s, &pub);    // pub = u2 * Q
+  point_add(curve, &pub, &res);  // res = pub + res  [R = u1 * G + u2 * Q]
+  if (point_is_infinity(&res)) {
+    // R == Infinity
+    return 4;
+  }
+
+  bn_mod(&(res.x), &curve->order);
+  if (!bn_is_equal(&res.x, &r)) {
+    // R.x != r
+    // signature does not match
+    return 5;
+  }
+  return 0;
+}
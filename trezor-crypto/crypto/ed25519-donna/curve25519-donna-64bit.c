@@ -0,0 +1,387 @@
+/*
+	Public domain by Andrew M. <liquidsun@gmail.com>
+	See: https://github.com/floodyberry/curve25519-donna
+
+	64 bit integer curve25519 implementation, radix 2^51 [wallet-core]
+*/
+
+#include <TrezorCrypto/ed25519-donna/ed25519-donna.h>
+
+const uint64_t reduce_mask_51 = ((uint64_t)1 << 51) - 1;
+
+/* out = in */
+void curve25519_copy(bignum25519 out, const bignum25519 in) {
+	out[0] = in[0];
+	out[1] = in[1];
+	out[2] = in[2];
+	out[3] = in[3];
+	out[4] = in[4];
+}
+
+/* out = a + b */
+void curve25519_add(bignum25519 out, const bignum25519 a, const bignum25519 b) {
+	out[0] = a[0] + b[0];
+	out[1] = a[1] + b[1];
+	out[2] = a[2] + b[2];
+	out[3] = a[3] + b[3];
+	out[4] = a[4] + b[4];
+}
+
+/* out = a + b, where a and/or b are the result of a basic op (add,sub) */
+void curve25519_add_after_basic(bignum25519 out, const bignum25519 a, const bignum25519 b) {
+	out[0] = a[0] + b[0];
+	out[1] = a[1] + b[1];
+	out[2] = a[2] + b[2];
+	out[3] = a[3] + b[3];
+	out[4] = a[4] + b[4];
+}
+
+void curve25519_add_reduce(bignum25519 out, const bignum25519 a, const bignum25519 b) {
+	uint64_t c = 0;
+	out[0] = a[0] + b[0]    ; c = (out[0] >> 51); out[0] &= reduce_mask_51;
+	out[1] = a[1] + b[1] + c; c = (out[1] >> 51); out[1] &= reduce_mask_51;
+	out[2] = a[2] + b[2] + c; c = (out[2] >> 51); out[2] &= reduce_mask_51;
+	out[3] = a[3] + b[3] + c; c = (out[3] >> 51); out[3] &= reduce_mask_51;
+	out[4] = a[4] + b[4] + c; c = (out[4] >> 51); out[4] &= reduce_mask_51;
+	out[0] += c * 19;
+}
+
+/* multiples of p */
+const uint64_t twoP0      = 0x0fffffffffffda;
+const uint64_t twoP1234   = 0x0ffffffffffffe;
+const uint64_t fourP0     = 0x1fffffffffffb4;
+const uint64_t fourP1234  = 0x1ffffffffffffc;
+
+/* out = a - b */
+void curve25519_sub(bignum25519 out, const bignum25519 a, const bignum25519 b) {
+	out[0] = a[0] + twoP0    - b[0];
+	out[1] = a[1] + twoP1234 - b[1];
+	out[2] = a[2] + twoP1234 - b[2];
+	out[3] = a[3] + twoP1234 - b[3];
+	out[4] = a[4] + twoP1234 - b[4];
+}
+
+/* out = in * scalar */
+void curve25519_scalar_product(bignum25519 out, const bignum25519 in, const uint32_t scalar) {
+	uint128_t a = 0;
+	uint64_t c = 0;
+	a = mul64x64_128(in[0], scalar);     out[0] = (uint64_t)a & reduce_mask_51; c = (uint64_t)(a >> 51);
+	a = mul64x64_128(in[1], scalar) + c; out[1] = (uint64_t)a & reduce_mask_51; c = (uint64_t)(a >> 51);
+	a = mul64x64_128(in[2], scalar) + c; out[2] = (uint64_t)a & reduce_mask_51; c = (uint64_t)(a >> 51);
+	a = mul64x64_128(in[3], scalar) + c; out[3] = (uint64_t)a & reduce_mask_51; c = (uint64_t)(a >> 51);
+	a = mul64x64_128(in[4], scalar) + c; out[4] = (uint64_t)a & reduce_mask_51; c = (uint64_t)(a >> 51);
+	                                     out[0] += c * 19;
+}
+
+/* out = a - b, where a is the result of a basic op (add,sub) */
+void curve25519_sub_after_basic(bignum25519 out, const bignum25519 a, const bignum25519 b) {
+	out[0] = a[0] + fourP0    - b[0];
+	out[1] = a[1] + fourP1234 - b[1];
+	out[2] = a[2] + fourP1234 - b[2];
+	out[3] = a[3] + fourP1234 - b[3];
+	out[4] = a[4] + fourP1234 - b[4];
+}
+
+void curve25519_sub_reduce(bignum25519 out, const bignum25519 a, const bignum25519 b) {
+	uint64_t c = 0;
+	out[0] = a[0] + fourP0    - b[0]    ; c = (out[0] >> 51); out[0] &= reduce_mask_51;
+	out[1] = a[1] + fourP1234 - b[1] + c; c = (out[1] >> 51); out[1] &= reduce_mask_51;
+	out[2] = a[2] + fourP1234 - b[2] + c; c = (out[2] >> 51); out[2] &= reduce_mask_51;
+	out[3] = a[3] + fourP1234 - b[3] + c; c = (out[3] >> 51); out[3] &= reduce_mask_51;
+	out[4] = a[4] + fourP1234 - b[4] + c; c = (out[4] >> 51); out[4] &= reduce_mask_51;
+	out[0] += c * 19;
+}
+
+/* out = -a */
+void curve25519_neg(bignum25519 out, const bignum25519 a) {
+	uint64_t c = 0;
+	out[0] = twoP0    - a[0]    ; c = (out[0] >> 51); out[0] &= reduce_mask_51;
+	out[1] = twoP1234 - a[1] + c; c = (out[1] >> 51); out[1] &= reduce_mask_51;
+	out[2] = twoP1234 - a[2] + c; c = (out[2] >> 51); out[2] &= reduce_mask_51;
+	out[3] = twoP1234 - a[3] + c; c = (out[3] >> 51); out[3] &= reduce_mask_51;
+	out[4] = twoP1234 - a[4] + c; c = (out[4] >> 51); out[4] &= reduce_mask_51;
+	out[0] += c * 19;
+}
+
+/* out = a * b */
+void curve25519_mul(bignum25519 out, const bignum25519 a, const bignum25519 b) {
+	uint128_t t0 = 0, t1 = 0, t2 = 0, t3 = 0, t4 = 0;
+	uint64_t r0 = 0, r1 = 0, r2 = 0, r3 = 0, r4 = 0, s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, c = 0;
+
+	r0 = b[0];
+	r1 = b[1];
+	r2 = b[2];
+	r3 = b[3];
+	r4 = b[4];
+
+	s0 = a[0];
+	s1 = a[1];
+	s2 = a[2];
+	s3 = a[3];
+	s4 = a[4];
+
+	t0 = mul64x64_128(r0, s0);
+	t1 = mul64x64_128(r0, s1) + mul64x64_128(r1, s0);
+	t2 = mul64x64_128(r0, s2) + mul64x64_128(r2, s0) + mul64x64_128(r1, s1);
+	t3 = mul64x64_128(r0, s3) + mul64x64_128(r3, s0) + mul64x64_128(r1, s2) + mul64x64_128(r2, s1);
+	t4 = mul64x64_128(r0, s4) + mul64x64_128(r4, s0) + mul64x64_128(r3, s1) + mul64x64_128(r1, s3) + mul64x64_128(r2, s2);
+
+	r1 *= 19;
+	r2 *= 19;
+	r3 *= 19;
+	r4 *= 19;
+
+	t0 += mul64x64_128(r4, s1) + mul64x64_128(r1, s4) + mul64x64_128(r2, s3) + mul64x64_128(r3, s2);
+	t1 += mul64x64_128(r4, s2) + mul64x64_128(r2, s4) + mul64x64_128(r3, s3);
+	t2 += mul64x64_128(r4, s3) + mul64x64_128(r3, s4);
+	t3 += mul64x64_128(r4, s4);
+
+	                      r0 = (uint64_t)t0 & reduce_mask_51; c = (uint64_t)(t0 >> 51);
+	t1 += c;              r1 = (uint64_t)t1 & reduce_mask_51; c = (uint64_t)(t1 >> 51);
+	t2 += c;              r2 = (uint64_t)t2 & reduce_mask_51; c = (uint64_t)(t2 >> 51);
+	t3 += c;              r3 = (uint64_t)t3 & reduce_mask_51; c = (uint64_t)(t3 >> 51);
+	t4 += c;              r4 = (uint64_t)t4 & reduce_mask_51; c = (uint64_t)(t4 >> 51);
+	r0 += c * 19;         c = r0 >> 51; r0 = r0 & reduce_mask_51;
+	r1 += c;
+
+	out[0] = r0;
+	out[1] = r1;
+	out[2] = r2;
+	out[3] = r3;
+	out[4] = r4;
+}
+
+/* out = in ^ (2 * count) */
+void curve25519_square_times(bignum25519 out, const bignum25519 in, int count) {
+	uint128_t t0 = 0, t1 = 0, t2 = 0, t3 = 0, t4 = 0;
+	uint64_t r0 = 0, r1 = 0, r2 = 0, r3 = 0, r4 = 0, c = 0;
+	uint64_t d0 = 0, d1 = 0, d2 = 0, d4 = 0, d419 = 0;
+
+	r0 = in[0];
+	r1 = in[1];
+	r2 = in[2];
+	r3 = in[3];
+	r4 = in[4];
+
+	do {
+		d0 = r0 * 2;
+		d1 = r1 * 2;
+		d2 = r2 * 2 * 19;
+		d419 = r4 * 19;
+		d4 = d419 * 2;
+
+		t0 = mul64x64_128(r0, r0) + mul64x64_128(d4, r1) + mul64x64_128(d2, r3);
+		t1 = mul64x64_128(d0, r1) + mul64x64_128(d4, r2) + mul64x64_128(r3, r3 * 19);
+		t2 = mul64x64_128(d0, r2) + mul64x64_128(r1, r1) + mul64x64_128(d4, r3);
+		t3 = mul64x64_128(d0, r3) + mul64x64_128(d1, r2) + mul64x64_128(r4, d419);
+		t4 = mul64x64_128(d0, r4) + mul64x64_128(d1, r3) + mul64x64_128(r2, r2);
+
+		                      r0 = (uint64_t)t0 & reduce_mask_51; c = (uint64_t)(t0 >> 51);
+		t1 += c;              r1 = (uint64_t)t1 & reduce_mask_51; c = (uint64_t)(t1 >> 51);
+		t2 += c;              r2 = (uint64_t)t2 & reduce_mask_51; c = (uint64_t)(t2 >> 51);
+		t3 += c;              r3 = (uint64_t)t3 & reduce_mask_51; c = (uint64_t)(t3 >> 51);
+		t4 += c;              r4 = (uint64_t)t4 & reduce_mask_51; c = (uint64_t)(t4 >> 51);
+		r0 += c * 19;         c = r0 >> 51; r0 = r0 & reduce_mask_51;
+		r1 += c;
+	} while(--count);
+
+	out[0] = r0;
+	out[1] = r1;
+	out[2] = r2;
+	out[3] = r3;
+	out[4] = r4;
+}
+
+/* out = in * in */
+void curve25519_square(bignum25519 out, const bignum25519 in) {
+	curve25519_square_times(out, in, 1);
+}
+
+/* Take a little-endian, 32-byte number and expand it into polynomial form */
+void curve25519_expand(bignum25519 out, const unsigned char in[32]) {
+	uint64_t x0 = 0, x1 = 0, x2 = 0, x3 = 0;
+
+	x0 = U8TO64_LE(in + 0);
+	x1 = U8TO64_LE(in + 8);
+	x2 = U8TO64_LE(in + 16);
+	x3 = U8TO64_LE(in + 24);
+
+	out[0] = x0 & reduce_mask_51; x0 = (x0 >> 51) | (x1 << 13);
+	out[1] = x0 & reduce_mask_51; x1 = (x1 >> 38) | (x2 << 26);
+	out[2] = x1 & reduce_mask_51; x2 = (x2 >> 25) | (x3 << 39);
+	out[3] = x2 & reduce_mask_51; x3 = (x3 >> 12);
+	out[4] = x3 & reduce_mask_51; /* ignore the top bit */
+}
+
+/* Take a fully reduced polynomial form number and contract it into a
+ * little-endian, 32-byte array
+ */
+void curve25519_contract(unsigned char out[32], const bignum25519 in) {
+	bignum25519 t = {0};
+	uint64_t f = 0;
+	int i = 0;
+
+	curve25519_copy(t, in);
+
+	#define carry_pass() \
+		t[1] += t[0] >> 51; t[0] &= reduce_mask_51; \
+		t[2] += t[1] >> 51; t[1] &= reduce_mask_51; \
+		t[3] += t[2] >> 51; t[2] &= reduce_mask_51; \
+		t[4] += t[3] >> 51; t[3] &= reduce_mask_51;
+
+	#define carry_pass_full() \
+		carry_pass() \
+		t[0] += 19 * (t[4] >> 51); t[4] &= reduce_mask_51;
+
+	#define carry_pass_final() \
+		carry_pass() \
+		t[4] &= reduce_mask_51;
+
+	carry_pass_full()
+	carry_pass_full()
+
+	/* now t is between 0 and 2^255-1, properly carried. */
+	/* case 1: between 0 and 2^255-20. case 2: between 2^255-19 and 2^255-1. */
+	t[0] += 19;
+	carry_pass_full()
+
+	/* now between 19 and 2^255-1 in both cases, and offset by 19. */
+	t[0] += (reduce_mask_51 + 1) - 19;
+	t[1] += (reduce_mask_51 + 1) - 1;
+	t[2] += (reduce_mask_51 + 1) - 1;
+	t[3] += (reduce_mask_51 + 1) - 1;
+	t[4] += (reduce_mask_51 + 1) - 1;
+
+	/* now between 2^255 and 2^256-20, and offset by 2^255. */
+	carry_pass_final()
+
+	#undef carry_pass
+	#undef carry_pass_full
+	#undef carry_pass_final
+
+	#define write51full(n,shift) \
+		f = ((t[n] >> shift) | (t[n+1] << (51 - shift))); \
+		for (i = 0; i < 8; i++, f >>= 8) *out++ = (unsigned char)f;
+	#define write51(n) write51full(n,13*n)
+	write51(0)
+	write51(1)
+	write51(2)
+	write51(3)
+	#undef write51
+	#undef write51full
+}
+
+/* if (iswap) swap(a, b) */
+void curve25519_swap_conditional(bignum25519 a, bignum25519 b, uint32_t iswap) {
+	const uint64_t swap = (uint64_t)(-(int64_t)iswap);
+	uint64_t x0 = 0, x1 = 0, x2 = 0, x3 = 0, x4 = 0;
+
+	x0 = swap & (a[0] ^ b[0]); a[0] ^= x0; b[0] ^= x0;
+	x1 = swap & (a[1] ^ b[1]); a[1] ^= x1; b[1] ^= x1;
+	x2 = swap & (a[2] ^ b[2]); a[2] ^= x2; b[2] ^= x2;
+	x3 = swap & (a[3] ^ b[3]); a[3] ^= x3; b[3] ^= x3;
+	x4 = swap & (a[4] ^ b[4]); a[4] ^= x4; b[4] ^= x4;
+}
+
+void curve25519_set(bignum25519 r, uint32_t x){
+	r[0] = x;
+	r[1] = 0;
+	r[2] = 0;
+	r[3] = 0;
+	r[4] = 0;
+}
+
+void curve25519_set_d(bignum25519 r){
+	curve25519_copy(r, ge25519_ecd);
+}
+
+void curve25519_set_2d(bignum25519 r){
+	curve25519_copy(r, ge25519_ec2d);
+}
+
+void curve25519_set_sqrtneg1(bignum25519 r){
+	curve25519_copy(r, ge25519_sqrtneg1);
+}
+
+int curve25519_isnegative(const bignum25519 f) {
+	unsigned char s[32] = {0};
+	curve25519_contract(s, f);
+	return s[0] & 1;
+}
+
+int curve25519_isnonzero(const bignum25519 f) {
+	unsigned char s[32] = {0};
+	curve25519_contract(s, f);
+	return ((((int) (s[0] | s[1] | s[2] | s[3] | s[4] | s[5] | s[6] | s[7] | s[8] |
+									s[9] | s[10] | s[11] | s[12] | s[13] | s[14] | s[15] | s[16] | s[17] |
+									s[18] | s[19] | s[20] | s[21] | s[22] | s[23] | s[24] | s[25] | s[26] |
+									s[27] | s[28] | s[29] | s[30] | s[31]) - 1) >> 8) + 1) & 0x1;
+}
+
+void curve25519_reduce(bignum25519 out, const bignum25519 in) {
+	uint64_t c = 0;
+	out[0] = in[0]    ; c = (out[0] >> 51); out[0] &= reduce_mask_51;
+	out[1] = in[1] + c; c = (out[1] >> 51); out[1] &= reduce_mask_51;
+	out[2] = in[2] + c; c = (out[2] >> 51); out[2] &= reduce_mask_51;
+	out[3] = in[3] + c; c = (out[3] >> 51); out[3] &= reduce_mask_51;
+	out[4] = in[4] + c; c = (out[4] >> 51); out[4] &= reduce_mask_51;
+	out[0] += 19 * c;
+}
+
+void curve25519_divpowm1(bignum25519 r, const bignum25519 u, const bignum25519 v) {
+	bignum25519 v3={0}, uv7={0}, t0={0}, t1={0}, t2={0};
+
+	curve25519_square(v3, v);
+	curve25519_mul(v3, v3, v); /* v3 = v^3 */
+	curve25519_square(uv7, v3);
+	curve25519_mul(uv7, uv7, v);
+	curve25519_mul(uv7, uv7, u); /* uv7 = uv^7 */
+
+	/*fe_pow22523(uv7, uv7);*/
+	/* From fe_pow22523.c, with the squaring runs done by square_times */
+
+	curve25519_square(t0, uv7);
+	curve25519_square_times(t1, t0, 2);
+	curve25519_mul(t1, uv7, t1);
+	curve25519_mul(t0, t0, t1);
+	curve25519_square(t0, t0);
+	curve25519_mul(t0, t1, t0);
+	curve25519_square_times(t1, t0, 5);
+	curve25519_mul(t0, t1, t0);
+	curve25519_square_times(t1, t0, 10);
+	curve25519_mul(t1, t1, t0);
+	curve25519_square_times(t2, t1, 20);
+	curve25519_mul(t1, t2, t1);
+	curve25519_square_times(t1, t1, 10);
+	curve25519_mul(t0, t1, t0);
+	curve25519_square_times(t1, t0, 50);
+	curve25519_mul(t1, t1, t0);
+	curve25519_square_times(t2, t1, 100);
+	curve25519_mul(t1, t2, t1);
+	curve25519_square_times(t1, t1, 50);
+	curve25519_mul(t0, t1, t0);
+	curve25519_square_times(t0, t0, 2);
+	curve25519_mul(t0, t0, uv7);
+
+	/* End fe_pow22523.c */
+	/* t0 = (uv^7)^((q-5)/8) */
+	curve25519_mul(t0, t0, v3);
+	curve25519_mul(r, t0, u); /* u^(m+1)v^(-(m+1)) */
+}
+
+void curve25519_expand_reduce(bignum25519 out, const unsigned char in[32]) {
+	uint64_t x0 = 0, x1 = 0, x2 = 0, x3 = 0;
+
+	x0 = U8TO64_LE(in + 0);
+	x1 = U8TO64_LE(in + 8);
+	x2 = U8TO64_LE(in + 16);
+	x3 = U8TO64_LE(in + 24);
+
+	out[0] = x0 & reduce_mask_51; x0 = (x0 >> 51) | (x1 << 13);
+	out[1] = x0 & reduce_mask_51; x1 = (x1 >> 38) | (x2 << 26);
+	out[2] = x1 & reduce_mask_51; x2 = (x2 >> 25) | (x3 << 39);
+	out[3] = x2 & reduce_mask_51; x3 = (x3 >> 12);
+	out[4] = x3; /* keep the top bit */
+	out[0] += 19 * (out[4] >> 51);
+	out[4] &= reduce_mask_51;
+}
@@ -4,6 +4,28 @@
 
 /* sqrt(x) is such an integer y that 0 <= y <= p - 1, y % 2 = 0, and y^2 = x (mod p). */
 /* d = -121665 / 121666 */
+#if USE_ED25519_64 // [wallet-core]
+#if !defined(NDEBUG)
+const bignum25519 ALIGN(16) fe_d = {
+		0x34dca135978a3,0x1a8283b156ebd,0x5e7a26001c029,0x739c663a03cbb,0x52036cee2b6ff}; /* d */
+#endif
+const bignum25519 ALIGN(16) fe_sqrtm1 = {
+		0x61b274a0ea0b0,0x0d5a5fc8f189d,0x7ef5e9cbd0c60,0x78595a6804c9e,0x2b8324804fc1d}; /* sqrt(-1) */
+
+/* A = 2 * (1 - d) / (1 + d) = 486662 */
+const bignum25519 ALIGN(16) fe_ma2 = {
+		0x7ffc8db3de3c9,0x7ffffffffffff,0x7ffffffffffff,0x7ffffffffffff,0x7ffffffffffff}; /* -A^2 */
+const bignum25519 ALIGN(16) fe_ma = {
+		0x7fffffff892e7,0x7ffffffffffff,0x7ffffffffffff,0x7ffffffffffff,0x7ffffffffffff}; /* -A */
+const bignum25519 ALIGN(16) fe_fffb1 = {
+		0x0968acde3bdff,0x2e8dab18e5bab,0x0139870b9afed,0x2746fab1d645f,0x018e04102529e}; /* sqrt(-2 * A * (A + 2)) */
+const bignum25519 ALIGN(16) fe_fffb2 = {
+		0x19b7c9f83650d,0x73f75210405a4,0x7a68106b887f2,0x184b715d7241f,0x32f9e1f5fba5d}; /* sqrt(2 * A * (A + 2)) */
+const bignum25519 ALIGN(16) fe_fffb3 = {
+		0x48278e8cfd387,0x62b4d37bad4fc,0x3c9744aff6c02,0x38823b55cdfe0,0x18b5eef2eb3df}; /* sqrt(-sqrt(-1) * A * (A + 2)) */
+const bignum25519 ALIGN(16) fe_fffb4 = {
+		0x51903b6b39186,0x11427e94930a7,0x3dd0cbbb91bf0,0x5fc93607a443f,0x1a43f3031067d}; /* sqrt(sqrt(-1) * A * (A + 2)) */
+#else
 #if !defined(NDEBUG)
 const bignum25519 ALIGN(16) fe_d = {
 		0x35978a3, 0x0d37284, 0x3156ebd, 0x06a0a0e, 0x001c029, 0x179e898, 0x3a03cbb, 0x1ce7198, 0x2e2b6ff, 0x1480db3}; /* d */
@@ -26,6 +48,7 @@ const bignum25519 ALIGN(16) fe_fffb3 = {
 		0x0cfd387, 0x1209e3a, 0x3bad4fc, 0x18ad34d, 0x2ff6c02, 0x0f25d12, 0x15cdfe0, 0x0e208ed, 0x32eb3df, 0x062d7bb}; /* sqrt(-sqrt(-1) * A * (A + 2)) */
 const bignum25519 ALIGN(16) fe_fffb4 = {
 		0x2b39186, 0x14640ed, 0x14930a7, 0x04509fa, 0x3b91bf0, 0x0f7432e, 0x07a443f, 0x17f24d8, 0x031067d, 0x0690fcc}; /* sqrt(sqrt(-1) * A * (A + 2)) */
+#endif
 
 
 /*
@@ -317,6 +340,72 @@ void ge25519_double_scalarmult_vartime(ge25519 *r, const ge25519 *p1, const bign
 	memzero(slide2, sizeof(slide2));
 }
 
+// [wallet-core]
+/* computes [s1]p1 + ... + [sn]pn + [sb]base, sharing the doublings between all points */
+void ge25519_multi_scalarmult_vartime(ge25519 *r, const ge25519 *p, const bignum256modm *s, size_t n, const bignum256modm sb) {
+	signed char slide[GE25519_MULTI_SCALARMULT_MAX][256], slideb[256] = {0};
+	ge25519_pniels pre[GE25519_MULTI_SCALARMULT_MAX][S1_TABLE_SIZE];
+#ifdef ED25519_NO_PRECOMP
+	ge25519_pniels preb[S2_TABLE_SIZE] = {0};
+#endif
+	ge25519 dp = {0};
+	ge25519_p1p1 t = {0};
+	size_t j = 0;
+	int32_t i = 0, k = 0;
+
+	assert(n <= GE25519_MULTI_SCALARMULT_MAX);
+
+	for (j = 0; j < n; j++) {
+		contract256_slidingwindow_modm(slide[j], s[j], S1_SWINDOWSIZE);
+		ge25519_double(&dp, &p[j]);
+		ge25519_full_to_pniels(pre[j], &p[j]);
+		for (k = 0; k < S1_TABLE_SIZE - 1; k++)
+			ge25519_pnielsadd(&pre[j][k+1], &dp, &pre[j][k]);
+	}
+	contract256_slidingwindow_modm(slideb, sb, S2_SWINDOWSIZE);
+
+#ifdef ED25519_NO_PRECOMP
+	ge25519_double(&dp, &ge25519_basepoint);
+	ge25519_full_to_pniels(preb, &ge25519_basepoint);
+	for (k = 0; k < S2_TABLE_SIZE - 1; k++)
+		ge25519_pnielsadd(&preb[k+1], &dp, &preb[k]);
+#endif
+
+	ge25519_set_neutral(r);
+
+	for (i = 255; i >= 0; i--) {
+		if (slideb[i])
+			break;
+		for (j = 0; (j < n) && !slide[j][i]; j++)
+			;
+		if (j < n)
+			break;
+	}
+
+	for (; i >= 0; i--) {
+		ge25519_double_p1p1(&t, r);
+
+		for (j = 0; j < n; j++) {
+			if (slide[j][i]) {
+				ge25519_p1p1_to_full(r, &t);
+				ge25519_pnielsadd_p1p1(&t, r, &pre[j][abs(slide[j][i]) / 2], (unsigned char)slide[j][i] >> 7);
+			}
+		}
+
+		if (slideb[i]) {
+			ge25519_p1p1_to_full(r, &t);
+#ifdef ED25519_NO_PRECOMP
+			ge25519_pnielsadd_p1p1(&t, r, &preb[abs(slideb[i]) / 2], (unsigned char)slideb[i] >> 7);
+#else
+			ge25519_nielsadd2_p1p1(&t, r, &ge25519_niels_sliding_multiples[abs(slideb[i]) / 2], (unsigned char)slideb[i] >> 7);
+#endif
+		}
+
+		ge25519_p1p1_to_partial(r, &t);
+	}
+	curve25519_mul(r->t, t.x, t.y);
+}
+
 /* computes [s1]p1 + [s2]p2 */
 #if USE_MONERO
 void ge25519_double_scalarmult_vartime2(ge25519 *r, const ge25519 *p1, const bignum256modm s1, const ge25519 *p2, const bignum256modm s2) {
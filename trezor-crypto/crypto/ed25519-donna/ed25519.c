@@ -19,6 +19,9 @@
 
 #include <TrezorCrypto/ed25519-donna/ed25519-hash-custom.h>
 
+#include <TrezorCrypto/memzero.h>
+#include <TrezorCrypto/rand.h>
+
 /*
 	Generates a (extsk[0..31]) and aExt (extsk[32..63])
 */
@@ -201,6 +204,199 @@ ED25519_FN(ed25519_sign_open) (const unsigned char *m, size_t mlen, const ed2551
 	return ed25519_verify(RS, checkR, 32) ? 0 : -1;
 }
 
+// [wallet-core]
+/*
+	Unpacks -R, rejecting encodings that ge25519_pack would not reproduce (y >= p, or x = 0 with
+	the sign bit set), so that the batch check accepts exactly the R values ed25519_sign_open does
+*/
+static int
+ed25519_unpack_negative_canonical_vartime(ge25519 *r, const unsigned char p[32]) {
+	const unsigned char zero[32] = {0};
+	unsigned char check[32] = {0};
+
+	if (!ge25519_unpack_negative_vartime(r, p))
+		return 0;
+
+	curve25519_contract(check, r->y);
+	if (!ed25519_verify(check, p, 31) || (check[31] != (p[31] & 0x7f)))
+		return 0;
+
+	if (p[31] & 0x80) {
+		curve25519_contract(check, r->x);
+		if (ed25519_verify(check, zero, 32))
+			return 0;
+	}
+	return 1;
+}
+
+/*
+	Points of the prime order subgroup are those whose multiple by the group order l is the identity
+*/
+static int
+ed25519_is_torsion_free_vartime(const ge25519 *p) {
+	static const unsigned char order[32] = {
+		0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+	};
+	ge25519 ALIGN(16) q;
+	bignum256modm l = {0}, zero = {0};
+	bignum25519 yz = {0};
+
+	expand_raw256_modm(l, order);
+	ge25519_double_scalarmult_vartime(&q, p, l, zero);
+	curve25519_sub_reduce(yz, q.y, q.z);
+	return !curve25519_isnonzero(q.x) && !curve25519_isnonzero(yz);
+}
+
+static void
+ed25519_batch_u64(unsigned char out[8], uint64_t v) {
+	size_t i = 0;
+
+	for (i = 0; i < 8; i++, v >>= 8)
+		out[i] = (unsigned char)v;
+}
+
+/*
+	z_i = H(key, i)[0..16]
+*/
+static void
+ed25519_batch_coefficient(unsigned char z[16], const hash_512bits key, size_t i) {
+	ed25519_hash_context ctx;
+	hash_512bits hash = {0};
+	unsigned char counter[8] = {0};
+
+	ed25519_batch_u64(counter, i);
+	ed25519_hash_init(&ctx);
+	ed25519_hash_update(&ctx, key, 64);
+	ed25519_hash_update(&ctx, counter, 8);
+	ed25519_hash_final(&ctx, hash);
+	memcpy(z, hash, 16);
+	memzero(hash, sizeof(hash));
+}
+
+/*
+	Checks [sum z_i S_i]B - sum [z_i]R_i - sum [z_i H(R_i,A_i,m_i)]A_i = 0, ED25519_BATCH_SIZE
+	signatures at a time. The 128 bit z_i are derived from a hash of 32 random bytes, drawn once
+	per call, and of all signatures, public keys and messages. Malformed signatures are rejected
+	up front, and a failing batch is re-checked one signature at a time so valid[] always holds
+	per-item results.
+
+	Signatures whose R or A is not in the prime order subgroup, a zero z_i, and all signatures if no
+	random bytes can be drawn, are checked one at a time with ed25519_sign_open. A torsion component
+	in R or A would otherwise add a small order error term that vanishes for some z_i, letting the
+	batch accept a signature ed25519_sign_open rejects; with the check, valid[] always matches
+	ed25519_sign_open. The check costs two scalar multiplications per signature.
+*/
+#define ED25519_BATCH_SIZE (GE25519_MULTI_SCALARMULT_MAX / 2)
+
+int
+ED25519_FN(ed25519_sign_open_batch) (const unsigned char * const *m, const size_t *mlen, const unsigned char * const *pk, const unsigned char * const *RS, size_t num, int *valid) {
+	ge25519 ALIGN(16) points[2 * ED25519_BATCH_SIZE], Q;
+	bignum256modm scalars[2 * ED25519_BATCH_SIZE], S = {0}, sb = {0}, hram = {0};
+	hash_512bits hash = {0}, key = {0};
+	ed25519_hash_context ctx;
+	unsigned char seed[32] = {0}, z[16] = {0}, check[32] = {0}, raw[32] = {0}, length[8] = {0};
+	const unsigned char identity[32] = {1};
+	size_t index[ED25519_BATCH_SIZE];
+	size_t offset = 0, i = 0, j = 0, n = 0, end = 0;
+	int ret = 0, seeded = 0, nonzero = 0;
+
+	/* random_buffer does not report failure, which leaves the seed zero */
+	random_buffer(seed, sizeof(seed));
+	for (j = 0; j < sizeof(seed); j++)
+		seeded |= seed[j];
+
+	if (!seeded) {
+		for (i = 0; i < num; i++) {
+			valid[i] = (ED25519_FN(ed25519_sign_open)(m[i], mlen[i], pk[i], RS[i]) == 0);
+			ret |= !valid[i];
+		}
+		return ret ? -1 : 0;
+	}
+
+	/* key = H(seed, (R_i, S_i, A_i, |m_i|, m_i) for all i) */
+	ed25519_hash_init(&ctx);
+	ed25519_hash_update(&ctx, seed, sizeof(seed));
+	for (i = 0; i < num; i++) {
+		ed25519_batch_u64(length, mlen[i]);
+		ed25519_hash_update(&ctx, RS[i], 64);
+		ed25519_hash_update(&ctx, pk[i], 32);
+		ed25519_hash_update(&ctx, length, 8);
+		ed25519_hash_update(&ctx, m[i], mlen[i]);
+	}
+	ed25519_hash_final(&ctx, key);
+
+	for (offset = 0; offset < num; offset += ED25519_BATCH_SIZE) {
+		end = (num - offset < ED25519_BATCH_SIZE) ? num : offset + ED25519_BATCH_SIZE;
+		set256_modm(sb, 0);
+		n = 0;
+
+		for (i = offset; i < end; i++) {
+			valid[i] = 0;
+
+			if ((RS[i][63] & 224) || !ge25519_unpack_negative_vartime(&points[2 * n + 1], pk[i]))
+				continue;
+
+			expand_raw256_modm(S, RS[i] + 32);
+			if (!is_reduced256_modm(S))
+				continue;
+
+			if (!ed25519_unpack_negative_canonical_vartime(&points[2 * n], RS[i]))
+				continue;
+
+			ed25519_batch_coefficient(z, key, i);
+			nonzero = 0;
+			for (j = 0; j < sizeof(z); j++)
+				nonzero |= z[j];
+
+			if (!nonzero || !ed25519_is_torsion_free_vartime(&points[2 * n]) || !ed25519_is_torsion_free_vartime(&points[2 * n + 1])) {
+				valid[i] = (ED25519_FN(ed25519_sign_open)(m[i], mlen[i], pk[i], RS[i]) == 0);
+				continue;
+			}
+
+			/* hram = H(R,A,m) */
+			ed25519_hram(hash, RS[i], pk[i], m[i], mlen[i]);
+			expand256_modm(hram, hash, 64);
+
+			/* -R gets z, -A gets z * hram, B gets z * S */
+			memcpy(raw, z, 16);
+			expand_raw256_modm(scalars[2 * n], raw);
+			mul256_modm(scalars[2 * n + 1], scalars[2 * n], hram);
+			mul256_modm(S, scalars[2 * n], S);
+			add256_modm(sb, sb, S);
+
+			index[n++] = i;
+		}
+
+		if (n == 0)
+			continue;
+
+		if (n > 1) {
+			ge25519_multi_scalarmult_vartime(&Q, points, scalars, 2 * n, sb);
+			ge25519_pack(check, &Q);
+			if (ed25519_verify(check, identity, 32)) {
+				for (j = 0; j < n; j++)
+					valid[index[j]] = 1;
+				continue;
+			}
+		}
+
+		for (j = 0; j < n; j++) {
+			i = index[j];
+			valid[i] = (ED25519_FN(ed25519_sign_open)(m[i], mlen[i], pk[i], RS[i]) == 0);
+		}
+	}
+
+	for (i = 0; i < num; i++)
+		ret |= !valid[i];
+
+	memzero(seed, sizeof(seed));
+	memzero(key, sizeof(key));
+	memzero(z, sizeof(z));
+	memzero(raw, sizeof(raw));
+	return ret ? -1 : 0;
+}
+
 int
 ED25519_FN(ed25519_scalarmult) (ed25519_public_key res, const ed25519_secret_key sk, const ed25519_public_key pk) {
 	bignum256modm a = {0};
@@ -0,0 +1,412 @@
+/*
+	Public domain by Andrew M. <liquidsun@gmail.com>
+
+	64 bit integer scalar implementation, radix 2^56 [wallet-core]
+*/
+
+#include <TrezorCrypto/ed25519-donna/ed25519-donna.h>
+
+/*
+	Arithmetic modulo the group order n = 2^252 +  27742317777372353535851937790883648493 = 7237005577332262213973186563042994240857116359379907606001950938285454250989
+
+	k = 32
+	b = 1 << 8 = 256
+	m = 2^252 + 27742317777372353535851937790883648493 = 0x1000000000000000000000000000000014def9dea2f79cd65812631a5cf5d3ed
+	mu = floor( b^(k*2) / m ) = 0xfffffffffffffffffffffffffffffffeb2106215d086329a7ed9ce5a30a2c131b
+*/
+
+const bignum256modm modm_m = {
+	0x12631a5cf5d3ed, 0xf9dea2f79cd658, 0x000000000014de, 0x00000000000000,
+	0x00000010000000
+};
+
+const bignum256modm modm_mu = {
+	0x9ce5a30a2c131b, 0x215d086329a7ed, 0xffffffffeb2106, 0xffffffffffffff,
+	0x00000fffffffff
+};
+
+static bignum256modm_element_t
+lt_modm(bignum256modm_element_t a, bignum256modm_element_t b) {
+	return (a - b) >> 63;
+}
+
+/* see HAC, Alg. 14.42 Step 4 */
+void reduce256_modm(bignum256modm r) {
+	bignum256modm t = {0};
+	bignum256modm_element_t b = 0, pb = 0, mask = 0;
+
+	/* t = r - m */
+	pb = 0;
+	pb += modm_m[0]; b = lt_modm(r[0], pb); t[0] = (r[0] - pb + (b << 56)); pb = b;
+	pb += modm_m[1]; b = lt_modm(r[1], pb); t[1] = (r[1] - pb + (b << 56)); pb = b;
+	pb += modm_m[2]; b = lt_modm(r[2], pb); t[2] = (r[2] - pb + (b << 56)); pb = b;
+	pb += modm_m[3]; b = lt_modm(r[3], pb); t[3] = (r[3] - pb + (b << 56)); pb = b;
+	pb += modm_m[4]; b = lt_modm(r[4], pb); t[4] = (r[4] - pb + (b << 32));
+
+	/* keep r if r was smaller than m */
+	mask = b - 1;
+	r[0] ^= mask & (r[0] ^ t[0]);
+	r[1] ^= mask & (r[1] ^ t[1]);
+	r[2] ^= mask & (r[2] ^ t[2]);
+	r[3] ^= mask & (r[3] ^ t[3]);
+	r[4] ^= mask & (r[4] ^ t[4]);
+}
+
+/*
+	Barrett reduction,  see HAC, Alg. 14.42
+
+	Instead of passing in x, pre-process in to q1 and r1 for efficiency
+*/
+void barrett_reduce256_modm(bignum256modm r, const bignum256modm q1, const bignum256modm r1) {
+	bignum256modm q3 = {0}, r2 = {0};
+	uint128_t c = 0;
+	bignum256modm_element_t f = 0, b = 0, pb = 0;
+
+	/* q1 = x >> 248 = 264 bits = 5 56 bit elements
+	   q2 = mu * q1
+	   q3 = (q2 / 256(32+1)) = q2 / (2^8)^(32+1) = q2 >> 264 */
+	c  = mul64x64_128(modm_mu[0], q1[3]) + mul64x64_128(modm_mu[3], q1[0]) + mul64x64_128(modm_mu[1], q1[2]) + mul64x64_128(modm_mu[2], q1[1]);
+	f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(modm_mu[0], q1[4]) + f + mul64x64_128(modm_mu[4], q1[0]) + mul64x64_128(modm_mu[3], q1[1]) + mul64x64_128(modm_mu[1], q1[3]) + mul64x64_128(modm_mu[2], q1[2]);
+	f = (bignum256modm_element_t)c; q3[0] = (f >> 40) & 0xffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(modm_mu[4], q1[1]) + f + mul64x64_128(modm_mu[1], q1[4]) + mul64x64_128(modm_mu[2], q1[3]) + mul64x64_128(modm_mu[3], q1[2]);
+	f = (bignum256modm_element_t)c; q3[0] |= (f << 16) & 0xffffffffffffff; q3[1] = (f >> 40) & 0xffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(modm_mu[4], q1[2]) + f + mul64x64_128(modm_mu[2], q1[4]) + mul64x64_128(modm_mu[3], q1[3]);
+	f = (bignum256modm_element_t)c; q3[1] |= (f << 16) & 0xffffffffffffff; q3[2] = (f >> 40) & 0xffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(modm_mu[4], q1[3]) + f + mul64x64_128(modm_mu[3], q1[4]);
+	f = (bignum256modm_element_t)c; q3[2] |= (f << 16) & 0xffffffffffffff; q3[3] = (f >> 40) & 0xffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(modm_mu[4], q1[4]) + f;
+	f = (bignum256modm_element_t)c; q3[3] |= (f << 16) & 0xffffffffffffff; q3[4] = (f >> 40) & 0xffff; f = (bignum256modm_element_t)(c >> 56);
+	q3[4] |= (f << 16);
+
+	/* r2 = (q3 * m) mod (256^(32+1)) = (q3 * m) & ((1 << 264) - 1) */
+	c  = mul64x64_128(modm_m[0], q3[0]);
+	r2[0] = (bignum256modm_element_t)c & 0xffffffffffffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(modm_m[0], q3[1]) + f + mul64x64_128(modm_m[1], q3[0]);
+	r2[1] = (bignum256modm_element_t)c & 0xffffffffffffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(modm_m[0], q3[2]) + f + mul64x64_128(modm_m[2], q3[0]) + mul64x64_128(modm_m[1], q3[1]);
+	r2[2] = (bignum256modm_element_t)c & 0xffffffffffffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(modm_m[0], q3[3]) + f + mul64x64_128(modm_m[3], q3[0]) + mul64x64_128(modm_m[1], q3[2]) + mul64x64_128(modm_m[2], q3[1]);
+	r2[3] = (bignum256modm_element_t)c & 0xffffffffffffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(modm_m[0], q3[4]) + f + mul64x64_128(modm_m[4], q3[0]) + mul64x64_128(modm_m[3], q3[1]) + mul64x64_128(modm_m[1], q3[3]) + mul64x64_128(modm_m[2], q3[2]);
+	r2[4] = (bignum256modm_element_t)c & 0x0000ffffffffff;
+
+	/* r = r1 - r2, mod 2^264 */
+	pb = 0;
+	pb += r2[0]; b = lt_modm(r1[0], pb); r[0] = (r1[0] - pb + (b << 56)); pb = b;
+	pb += r2[1]; b = lt_modm(r1[1], pb); r[1] = (r1[1] - pb + (b << 56)); pb = b;
+	pb += r2[2]; b = lt_modm(r1[2], pb); r[2] = (r1[2] - pb + (b << 56)); pb = b;
+	pb += r2[3]; b = lt_modm(r1[3], pb); r[3] = (r1[3] - pb + (b << 56)); pb = b;
+	pb += r2[4]; b = lt_modm(r1[4], pb); r[4] = (r1[4] - pb + (b << 40));
+
+	reduce256_modm(r);
+	reduce256_modm(r);
+}
+
+/* addition modulo m */
+void add256_modm(bignum256modm r, const bignum256modm x, const bignum256modm y) {
+	bignum256modm_element_t c = 0;
+
+	c  = x[0] + y[0]; r[0] = c & 0xffffffffffffff; c >>= 56;
+	c += x[1] + y[1]; r[1] = c & 0xffffffffffffff; c >>= 56;
+	c += x[2] + y[2]; r[2] = c & 0xffffffffffffff; c >>= 56;
+	c += x[3] + y[3]; r[3] = c & 0xffffffffffffff; c >>= 56;
+	c += x[4] + y[4]; r[4] = c;
+
+	reduce256_modm(r);
+}
+
+/* -x modulo m */
+void neg256_modm(bignum256modm r, const bignum256modm x) {
+	bignum256modm_element_t b = 0, pb = 0;
+
+	/* r = m - x */
+	pb = 0;
+	pb += x[0]; b = lt_modm(modm_m[0], pb); r[0] = (modm_m[0] - pb + (b << 56)); pb = b;
+	pb += x[1]; b = lt_modm(modm_m[1], pb); r[1] = (modm_m[1] - pb + (b << 56)); pb = b;
+	pb += x[2]; b = lt_modm(modm_m[2], pb); r[2] = (modm_m[2] - pb + (b << 56)); pb = b;
+	pb += x[3]; b = lt_modm(modm_m[3], pb); r[3] = (modm_m[3] - pb + (b << 56)); pb = b;
+	pb += x[4]; b = lt_modm(modm_m[4], pb); r[4] = (modm_m[4] - pb + (b << 32));
+
+	// if x==0, reduction is required
+	reduce256_modm(r);
+}
+
+/* m, with every limb but the last raised by 2^56 and borrowed from the next one */
+/* Emilia Kasper trick, https://www.imperialviolet.org/2010/12/04/ecc.html */
+const uint64_t twoP[] = {
+		0x112631a5cf5d3ed, 0x1f9dea2f79cd657, 0x1000000000014dd, 0x0ffffffffffffff, 0xfffffff};
+
+/* subtraction x-y % m */
+void sub256_modm(bignum256modm r, const bignum256modm x, const bignum256modm y) {
+	bignum256modm_element_t c = 0;
+	c  = twoP[0] + x[0] - y[0]; r[0] = c & 0xffffffffffffff; c >>= 56;
+	c += twoP[1] + x[1] - y[1]; r[1] = c & 0xffffffffffffff; c >>= 56;
+	c += twoP[2] + x[2] - y[2]; r[2] = c & 0xffffffffffffff; c >>= 56;
+	c += twoP[3] + x[3] - y[3]; r[3] = c & 0xffffffffffffff; c >>= 56;
+	c += twoP[4] + x[4] - y[4]; r[4] = c;
+	reduce256_modm(r);
+}
+
+/* multiplication modulo m */
+void mul256_modm(bignum256modm r, const bignum256modm x, const bignum256modm y) {
+	bignum256modm q1 = {0}, r1 = {0};
+	uint128_t c = 0;
+	bignum256modm_element_t f = 0;
+
+	/* r1 = (x mod 256^(32+1)) = x mod (2^8)(31+1) = x & ((1 << 264) - 1)
+	   q1 = x >> 248 = 264 bits = 5 56 bit elements */
+	c  = mul64x64_128(x[0], y[0]);
+	f = (bignum256modm_element_t)c; r1[0] = (f & 0xffffffffffffff); f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(x[0], y[1]) + f + mul64x64_128(x[1], y[0]);
+	f = (bignum256modm_element_t)c; r1[1] = (f & 0xffffffffffffff); f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(x[0], y[2]) + f + mul64x64_128(x[1], y[1]) + mul64x64_128(x[2], y[0]);
+	f = (bignum256modm_element_t)c; r1[2] = (f & 0xffffffffffffff); f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(x[0], y[3]) + f + mul64x64_128(x[1], y[2]) + mul64x64_128(x[2], y[1]) + mul64x64_128(x[3], y[0]);
+	f = (bignum256modm_element_t)c; r1[3] = (f & 0xffffffffffffff); f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(x[0], y[4]) + f + mul64x64_128(x[1], y[3]) + mul64x64_128(x[2], y[2]) + mul64x64_128(x[3], y[1]) + mul64x64_128(x[4], y[0]);
+	f = (bignum256modm_element_t)c; r1[4] = (f & 0x0000ffffffffff); q1[0] = (f >> 24) & 0xffffffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(x[1], y[4]) + f + mul64x64_128(x[2], y[3]) + mul64x64_128(x[3], y[2]) + mul64x64_128(x[4], y[1]);
+	f = (bignum256modm_element_t)c; q1[0] |= (f << 32) & 0xffffffffffffff; q1[1] = (f >> 24) & 0xffffffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(x[2], y[4]) + f + mul64x64_128(x[3], y[3]) + mul64x64_128(x[4], y[2]);
+	f = (bignum256modm_element_t)c; q1[1] |= (f << 32) & 0xffffffffffffff; q1[2] = (f >> 24) & 0xffffffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(x[3], y[4]) + f + mul64x64_128(x[4], y[3]);
+	f = (bignum256modm_element_t)c; q1[2] |= (f << 32) & 0xffffffffffffff; q1[3] = (f >> 24) & 0xffffffff; f = (bignum256modm_element_t)(c >> 56);
+	c  = mul64x64_128(x[4], y[4]) + f;
+	f = (bignum256modm_element_t)c; q1[3] |= (f << 32) & 0xffffffffffffff; q1[4] = (f >> 24) & 0xffffffff; f = (bignum256modm_element_t)(c >> 56);
+	q1[4] |= (f << 32);
+
+	barrett_reduce256_modm(r, q1, r1);
+}
+
+void expand256_modm(bignum256modm out, const unsigned char *in, size_t len) {
+	unsigned char work[64] = {0};
+	bignum256modm_element_t x[8] = {0};
+	bignum256modm q1 = {0};
+
+	memcpy(work, in, len);
+	x[0] = U8TO64_LE(work +  0);
+	x[1] = U8TO64_LE(work +  8);
+	x[2] = U8TO64_LE(work + 16);
+	x[3] = U8TO64_LE(work + 24);
+	x[4] = U8TO64_LE(work + 32);
+	x[5] = U8TO64_LE(work + 40);
+	x[6] = U8TO64_LE(work + 48);
+	x[7] = U8TO64_LE(work + 56);
+
+	/* r1 = (x mod 256^(32+1)) = x mod (2^8)(31+1) = x & ((1 << 264) - 1) */
+	out[0] = (                         x[0]) & 0xffffffffffffff;
+	out[1] = ((x[ 0] >> 56) | (x[ 1] <<  8)) & 0xffffffffffffff;
+	out[2] = ((x[ 1] >> 48) | (x[ 2] << 16)) & 0xffffffffffffff;
+	out[3] = ((x[ 2] >> 40) | (x[ 3] << 24)) & 0xffffffffffffff;
+	out[4] = ((x[ 3] >> 32) | (x[ 4] << 32)) & 0x0000ffffffffff;
+
+	/* 8*31 = 248 bits, no need to reduce */
+	if (len < 32)
+		return;
+
+	/* q1 = x >> 248 = 264 bits = 5 56 bit elements */
+	q1[0] = ((x[ 3] >> 56) | (x[ 4] <<  8)) & 0xffffffffffffff;
+	q1[1] = ((x[ 4] >> 48) | (x[ 5] << 16)) & 0xffffffffffffff;
+	q1[2] = ((x[ 5] >> 40) | (x[ 6] << 24)) & 0xffffffffffffff;
+	q1[3] = ((x[ 6] >> 32) | (x[ 7] << 32)) & 0xffffffffffffff;
+	q1[4] = ((x[ 7] >> 24)                );
+
+	barrett_reduce256_modm(out, q1, out);
+}
+
+void expand_raw256_modm(bignum256modm out, const unsigned char in[32]) {
+	bignum256modm_element_t x[4] = {0};
+
+	x[0] = U8TO64_LE(in +  0);
+	x[1] = U8TO64_LE(in +  8);
+	x[2] = U8TO64_LE(in + 16);
+	x[3] = U8TO64_LE(in + 24);
+
+	out[0] = (                         x[0]) & 0xffffffffffffff;
+	out[1] = ((x[ 0] >> 56) | (x[ 1] <<  8)) & 0xffffffffffffff;
+	out[2] = ((x[ 1] >> 48) | (x[ 2] << 16)) & 0xffffffffffffff;
+	out[3] = ((x[ 2] >> 40) | (x[ 3] << 24)) & 0xffffffffffffff;
+	out[4] = ((x[ 3] >> 32)                ) & 0x000000ffffffff;
+}
+
+int is_reduced256_modm(const bignum256modm in)
+{
+	int i = 0;
+	uint32_t res1 = 0;
+	uint32_t res2 = 0;
+	for (i = 4; i >= 0; i--) {
+		res1 = (res1 << 1) | (in[i] < modm_m[i]);
+		res2 = (res2 << 1) | (in[i] > modm_m[i]);
+	}
+	return res1 > res2;
+}
+
+void contract256_modm(unsigned char out[32], const bignum256modm in) {
+	U64TO8_LE(out +  0, (in[0]      ) | (in[1] << 56));
+	U64TO8_LE(out +  8, (in[1] >>  8) | (in[2] << 48));
+	U64TO8_LE(out + 16, (in[2] >> 16) | (in[3] << 40));
+	U64TO8_LE(out + 24, (in[3] >> 24) | (in[4] << 32));
+}
+
+void contract256_window4_modm(signed char r[64], const bignum256modm in) {
+	char carry = 0;
+	signed char *quads = r;
+	bignum256modm_element_t i = 0, j = 0, v = 0, m = 0;
+
+	for (i = 0; i < 5; i++) {
+		v = in[i];
+		m = (i == 4) ? 8 : 14;
+		for (j = 0; j < m; j++) {
+			*quads++ = (v & 15);
+			v >>= 4;
+		}
+	}
+
+	/* making it signed */
+	carry = 0;
+	for(i = 0; i < 63; i++) {
+		r[i] += carry;
+		r[i+1] += (r[i] >> 4);
+		r[i] &= 15;
+		carry = (r[i] >> 3);
+		r[i] -= (carry << 4);
+	}
+	r[63] += carry;
+}
+
+void contract256_slidingwindow_modm(signed char r[256], const bignum256modm s, int windowsize) {
+	int i = 0, j = 0, k = 0, b = 0;
+	int m = (1 << (windowsize - 1)) - 1, soplen = 256;
+	signed char *bits = r;
+	bignum256modm_element_t v = 0;
+
+	/* first put the binary expansion into r  */
+	for (i = 0; i < 4; i++) {
+		v = s[i];
+		for (j = 0; j < 56; j++, v >>= 1)
+			*bits++ = (v & 1);
+	}
+	v = s[4];
+	for (j = 0; j < 32; j++, v >>= 1)
+		*bits++ = (v & 1);
+
+	/* Making it sliding window */
+	for (j = 0; j < soplen; j++) {
+		if (!r[j])
+			continue;
+
+		for (b = 1; (b < (soplen - j)) && (b <= 6); b++) {
+			if ((r[j] + (r[j + b] << b)) <= m) {
+				r[j] += r[j + b] << b;
+				r[j + b] = 0;
+			} else if ((r[j] - (r[j + b] << b)) >= -m) {
+				r[j] -= r[j + b] << b;
+				for (k = j + b; k < soplen; k++) {
+					if (!r[k]) {
+						r[k] = 1;
+						break;
+					}
+					r[k] = 0;
+				}
+			} else if (r[j + b]) {
+				break;
+			}
+		}
+	}
+}
+
+void set256_modm(bignum256modm r, uint64_t v) {
+	r[0] = v & 0xffffffffffffff; v >>= 56;
+	r[1] = v;
+	r[2] = 0;
+	r[3] = 0;
+	r[4] = 0;
+}
+
+int get256_modm(uint64_t * v, const bignum256modm r){
+	*v = 0;
+	int con1 = 0;
+
+#define NONZ(x) ((((x) | (0 - (x))) >> 63) & 1)
+	bignum256modm_element_t c = 0;
+	c  = r[0];  *v +=  c & 0xffffffffffffff;        c >>= 56; // 56
+	c += r[1];  *v += (c & 0xff) << 56; con1 |= NONZ(c >> 8); c >>= 56; // 64 bits
+	c += r[2];                          con1 |= NONZ(c); c >>= 56;
+	c += r[3];                          con1 |= NONZ(c); c >>= 56;
+	c += r[4];                          con1 |= NONZ(c); c >>= 56;
+	                                    con1 |= NONZ(c);
+#undef NONZ
+
+	return con1 ^ 1;
+}
+
+int eq256_modm(const bignum256modm x, const bignum256modm y){
+	size_t differentbits = 0;
+	int len = bignum256modm_limb_size;
+	while (len--) {
+		differentbits |= (*x++ ^ *y++);
+	}
+	return (int) (1 & ((differentbits - 1) >> bignum256modm_bits_per_limb));
+}
+
+int cmp256_modm(const bignum256modm x, const bignum256modm y){
+	int len = 4*bignum256modm_limb_size;
+	uint32_t a_gt = 0;
+	uint32_t b_gt = 0;
+
+	// 16B chunks
+	while (len--) {
+		const uint32_t ln = (const uint32_t) len;
+		const uint32_t a = (x[ln>>2] >> 16*(ln & 3)) & 0xffff;
+		const uint32_t b = (y[ln>>2] >> 16*(ln & 3)) & 0xffff;
+
+		const uint32_t limb_a_gt = ((b - a) >> 16) & 1;
+		const uint32_t limb_b_gt = ((a - b) >> 16) & 1;
+		a_gt |= limb_a_gt & ~b_gt;
+		b_gt |= limb_b_gt & ~a_gt;
+	}
+
+	return a_gt - b_gt;
+}
+
+int iszero256_modm(const bignum256modm x){
+	size_t differentbits = 0;
+	int len = bignum256modm_limb_size;
+	while (len--) {
+		differentbits |= (*x++);
+	}
+	return (int) (1 & ((differentbits - 1) >> bignum256modm_bits_per_limb));
+}
+
+void copy256_modm(bignum256modm r, const bignum256modm x){
+	r[0] = x[0];
+	r[1] = x[1];
+	r[2] = x[2];
+	r[3] = x[3];
+	r[4] = x[4];
+}
+
+int check256_modm(const bignum256modm x){
+	int ok = 1;
+	bignum256modm t={0}, z={0};
+
+	ok &= iszero256_modm(x) ^ 1;
+	barrett_reduce256_modm(t, z, x);
+	ok &= eq256_modm(t, x);
+	return ok;
+}
+
+void mulsub256_modm(bignum256modm r, const bignum256modm a, const bignum256modm b, const bignum256modm c){
+	//(cc - aa * bb) % l
+	bignum256modm t={0};
+	mul256_modm(t, a, b);
+	sub256_modm(r, c, t);
+}
+
+void muladd256_modm(bignum256modm r, const bignum256modm a, const bignum256modm b, const bignum256modm c){
+	//(cc + aa * bb) % l
+	bignum256modm t={0};
+	mul256_modm(t, a, b);
+	add256_modm(r, c, t);
+}
@@ -7,6 +7,17 @@
 #include <TrezorCrypto/rand.h>
 #include "serialize.h"
 
+#if USE_ED25519_64 // [wallet-core]
+const ge25519 ALIGN(16) xmr_h = {
+    {0x73ab1dd861ec7, 0x7c9874ef11626, 0x1b6312b46107c, 0x59d702654201d,
+     0x08475cd301c3f},
+    {0x4b8c33326feb4, 0x445cc14cf54b4, 0x1b3dd5318f5d5, 0x76bc162e578a1,
+     0x11043a74430a1},
+    {0x1dd0124fde4d2, 0x16bb0ae2ca951, 0x4e53c4c7a36a5, 0x6b6e493c5385c,
+     0x2957e92b6c581},
+    {0x17ba4da4517f7, 0x52c22abacf5d9, 0x4145d17363738, 0x3cfcb2760601e,
+     0x74f8f7dead2cd}};
+#else
 const ge25519 ALIGN(16) xmr_h = {
     {0x1861ec7, 0x1ceac77, 0x2f11626, 0x1f261d3, 0x346107c, 0x06d8c4a,
      0x254201d, 0x1675c09, 0x1301c3f, 0x0211d73},
@@ -16,6 +27,7 @@ const ge25519 ALIGN(16) xmr_h = {
      0x3c5385c, 0x1adb924, 0x2b6c581, 0x0a55fa4},
     {0x24517f7, 0x05ee936, 0x3acf5d9, 0x14b08aa, 0x3363738, 0x1051745,
      0x360601e, 0x0f3f2c9, 0x1ead2cd, 0x1d3e3df}};
+#endif
 
 void ge25519_set_xmr_h(ge25519 *r) { ge25519_copy(r, &xmr_h); }
 
@@ -341,3 +341,195 @@ void ripemd160(const uint8_t *msg, uint32_t msg_len, uint8_t hash[RIPEMD160_DIGE
     ripemd160_Update( &ctx, msg, msg_len );
     ripemd160_Final( &ctx, hash );
 }
+
+// [wallet-core]
+/*
+ * RIPEMD-160 on independent messages, several at a time
+ */
+#if defined(__GNUC__) || defined(__clang__)
+
+/* One lane per message, as GCC/Clang generic vectors: 8 lanes with AVX2, otherwise 4 (SSE2, NEON) */
+#if defined(__AVX2__)
+#define RIPEMD160_MULTI_LANES 8
+#else
+#define RIPEMD160_MULTI_LANES 4
+#endif
+typedef uint32_t ripemd160_vec __attribute__((vector_size(4 * RIPEMD160_MULTI_LANES)));
+
+/* Message word and rotation of each step, left and right line, as in ripemd160_process */
+static const uint8_t ripemd160_r[80] = {
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+     7,  4, 13,  1, 10,  6, 15,  3, 12,  0,  9,  5,  2, 14, 11,  8,
+     3, 10, 14,  4,  9, 15,  8,  1,  2,  7,  0,  6, 13, 11,  5, 12,
+     1,  9, 11, 10,  0,  8, 12,  4, 13,  3,  7, 15, 14,  5,  6,  2,
+     4,  0,  5,  9,  7, 12,  2, 10, 14,  1,  3,  8, 11,  6, 15, 13 };
+static const uint8_t ripemd160_s[80] = {
+    11, 14, 15, 12,  5,  8,  7,  9, 11, 13, 14, 15,  6,  7,  9,  8,
+     7,  6,  8, 13, 11,  9,  7, 15,  7, 12, 15,  9, 11,  7, 13, 12,
+    11, 13,  6,  7, 14,  9, 13, 15, 14,  8, 13,  6,  5, 12,  7,  5,
+    11, 12, 14, 15, 14, 15,  9,  8,  9, 14,  5,  6,  8,  6,  5, 12,
+     9, 15,  5, 11,  6,  8, 13, 12,  5, 12, 13, 14, 11,  8,  5,  6 };
+static const uint8_t ripemd160_rp[80] = {
+     5, 14,  7,  0,  9,  2, 11,  4, 13,  6, 15,  8,  1, 10,  3, 12,
+     6, 11,  3,  7,  0, 13,  5, 10, 14, 15,  8, 12,  4,  9,  1,  2,
+    15,  5,  1,  3,  7, 14,  6,  9, 11,  8, 12,  2, 10,  0,  4, 13,
+     8,  6,  4,  1,  3, 11, 15,  0,  5, 12,  2, 13,  9,  7, 10, 14,
+    12, 15, 10,  4,  1,  5,  8,  7,  6,  2, 13, 14,  0,  3,  9, 11 };
+static const uint8_t ripemd160_sp[80] = {
+     8,  9,  9, 11, 13, 15, 15,  5,  7,  7,  8, 11, 14, 14, 12,  6,
+     9, 13, 15,  7, 12,  8,  9, 11,  7,  7, 12,  7,  6, 15, 13, 11,
+     9,  7, 15, 11,  8,  6,  6, 14, 12, 13,  5, 14, 13, 13,  7,  5,
+    15,  5,  8, 11, 14, 14,  6, 14,  6,  9, 12,  9, 12,  5, 15,  8,
+     8,  5, 12,  9, 12,  5, 14,  6,  8, 13,  6,  5, 15, 13, 11, 11 };
+
+#define F1V( x, y, z )   ( (x) ^ (y) ^ (z) )
+#define F2V( x, y, z )   ( ( (x) & (y) ) | ( ~(x) & (z) ) )
+#define F3V( x, y, z )   ( ( (x) | ~(y) ) ^ (z) )
+#define F4V( x, y, z )   ( ( (x) & (z) ) | ( (y) & ~(z) ) )
+#define F5V( x, y, z )   ( (x) ^ ( (y) | ~(z) ) )
+
+#define SV( x, n ) ( ( (x) << (n) ) | ( (x) >> (32 - (n)) ) )
+
+/* Unrolled, so that word indices and rotations are constants */
+#if defined(__clang__)
+#define RIPEMD160_UNROLL _Pragma("unroll")
+#else
+#define RIPEMD160_UNROLL _Pragma("GCC unroll 16")
+#endif
+
+/* One round of 16 steps on both lines */
+#define RIPEMD160_ROUND_V( round, f, k, fp, kp )                                        \
+    RIPEMD160_UNROLL                                                                   \
+    for( j = 16 * (round); j < 16 * (round) + 16; j++ )                                \
+    {                                                                                  \
+        T = SV( A + f( B, C, D ) + X[ripemd160_r[j]] + (k), ripemd160_s[j] ) + E;       \
+        A = E; E = D; D = SV( C, 10 ); C = B; B = T;                                     \
+        T = SV( Ap + fp( Bp, Cp, Dp ) + X[ripemd160_rp[j]] + (kp), ripemd160_sp[j] ) + Ep; \
+        Ap = Ep; Ep = Dp; Dp = SV( Cp, 10 ); Cp = Bp; Bp = T;                            \
+    }
+
+/* Writes block `index` of the padded message into `block` */
+static void ripemd160_multi_block( const uint8_t *msg, size_t len, size_t index, uint8_t block[RIPEMD160_BLOCK_LENGTH] )
+{
+    size_t offset = index * RIPEMD160_BLOCK_LENGTH;
+    uint64_t bits = (uint64_t) len << 3;
+    int i;
+
+    if( offset + RIPEMD160_BLOCK_LENGTH <= len )
+    {
+        memcpy( block, msg + offset, RIPEMD160_BLOCK_LENGTH );
+        return;
+    }
+    memzero( block, RIPEMD160_BLOCK_LENGTH );
+    if( offset <= len )
+    {
+        memcpy( block, msg + offset, len - offset );
+        block[len - offset] = 0x80;
+    }
+    if( index == ( len + 8 ) / RIPEMD160_BLOCK_LENGTH )
+    {
+        for( i = 0; i < 8; i++ )
+            block[RIPEMD160_BLOCK_LENGTH - 8 + i] = (uint8_t) ( bits >> ( 8 * i ) );
+    }
+}
+
+static void ripemd160_multi_lanes( const uint8_t *const *msg, const size_t *len, size_t count,
+                                   uint8_t (*hash)[RIPEMD160_DIGEST_LENGTH] )
+{
+    static const uint32_t initial[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    ripemd160_vec state[5], X[16], active, A, B, C, D, E, Ap, Bp, Cp, Dp, Ep, T;
+    uint32_t words[16][RIPEMD160_MULTI_LANES];
+    uint32_t mask[RIPEMD160_MULTI_LANES];
+    uint8_t block[RIPEMD160_BLOCK_LENGTH];
+    size_t blocks[RIPEMD160_MULTI_LANES] = {0};
+    size_t maxBlocks = 0, index, lane;
+    int i, j;
+
+    for( lane = 0; lane < count; lane++ )
+    {
+        blocks[lane] = ( len[lane] + 8 ) / RIPEMD160_BLOCK_LENGTH + 1;
+        if( blocks[lane] > maxBlocks )
+            maxBlocks = blocks[lane];
+    }
+    for( i = 0; i < 5; i++ )
+        for( lane = 0; lane < RIPEMD160_MULTI_LANES; lane++ )
+            state[i][lane] = initial[i];
+
+    for( index = 0; index < maxBlocks; index++ )
+    {
+        /* Transpose one block of each message into X, word j of lane l at X[j][l] */
+        for( lane = 0; lane < RIPEMD160_MULTI_LANES; lane++ )
+        {
+            mask[lane] = index < blocks[lane] ? 0xFFFFFFFF : 0;
+            if( mask[lane] )
+                ripemd160_multi_block( msg[lane], len[lane], index, block );
+            else
+                memzero( block, RIPEMD160_BLOCK_LENGTH );
+            for( j = 0; j < 16; j++ )
+                GET_UINT32_LE( words[j][lane], block, 4 * j );
+        }
+        memcpy( &active, mask, sizeof( active ) );
+        memcpy( X, words, sizeof( X ) );
+
+        A = Ap = state[0];
+        B = Bp = state[1];
+        C = Cp = state[2];
+        D = Dp = state[3];
+        E = Ep = state[4];
+
+        RIPEMD160_ROUND_V( 0, F1V, 0x00000000, F5V, 0x50A28BE6 );
+        RIPEMD160_ROUND_V( 1, F2V, 0x5A827999, F4V, 0x5C4DD124 );
+        RIPEMD160_ROUND_V( 2, F3V, 0x6ED9EBA1, F3V, 0x6D703EF3 );
+        RIPEMD160_ROUND_V( 3, F4V, 0x8F1BBCDC, F2V, 0x7A6D76E9 );
+        RIPEMD160_ROUND_V( 4, F5V, 0xA953FD4E, F1V, 0x00000000 );
+
+        /* Lanes past the end of their message keep their state */
+        T        = state[1] + C + Dp;
+        state[1] = ( ( state[2] + D + Ep ) & active ) | ( state[1] & ~active );
+        state[2] = ( ( state[3] + E + Ap ) & active ) | ( state[2] & ~active );
+        state[3] = ( ( state[4] + A + Bp ) & active ) | ( state[3] & ~active );
+        state[4] = ( ( state[0] + B + Cp ) & active ) | ( state[4] & ~active );
+        state[0] = ( T & active ) | ( state[0] & ~active );
+    }
+
+    for( lane = 0; lane < count; lane++ )
+        for( i = 0; i < 5; i++ )
+            PUT_UINT32_LE( state[i][lane], hash[lane], 4 * i );
+
+    memzero( words, sizeof( words ) );
+    memzero( block, sizeof( block ) );
+    memzero( X, sizeof( X ) );
+}
+
+void ripemd160_multi( const uint8_t *const *msg, const size_t *len, size_t count,
+                      uint8_t (*hash)[RIPEMD160_DIGEST_LENGTH] )
+{
+    static const uint8_t empty[1] = {0};
+    const uint8_t *laneMsg[RIPEMD160_MULTI_LANES];
+    size_t laneLen[RIPEMD160_MULTI_LANES];
+    size_t i, lane, n;
+
+    for( i = 0; i < count; i += RIPEMD160_MULTI_LANES )
+    {
+        n = count - i < RIPEMD160_MULTI_LANES ? count - i : RIPEMD160_MULTI_LANES;
+        for( lane = 0; lane < RIPEMD160_MULTI_LANES; lane++ )
+        {
+            laneMsg[lane] = lane < n ? msg[i + lane] : empty;
+            laneLen[lane] = lane < n ? len[i + lane] : 0;
+        }
+        ripemd160_multi_lanes( laneMsg, laneLen, n, hash + i );
+    }
+}
+
+#else
+
+void ripemd160_multi( const uint8_t *const *msg, const size_t *len, size_t count,
+                      uint8_t (*hash)[RIPEMD160_DIGEST_LENGTH] )
+{
+    size_t i;
+
+    for( i = 0; i < count; i++ )
+        ripemd160( msg[i], (uint32_t) len[i], hash[i] );
+}
+
+#endif
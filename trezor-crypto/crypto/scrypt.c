@@ -32,6 +32,7 @@
 #include <TrezorCrypto/sha2.h>
 #include <TrezorCrypto/endian.h>
 #include <TrezorCrypto/pbkdf2.h>
+#include <TrezorCrypto/memzero.h>
 
 #include <sys/types.h>
 #ifndef _WIN32
@@ -42,9 +43,31 @@
 #include <stdlib.h>
 #include <string.h>
 
+// [wallet-core] Salsa20/8 on 128-bit vectors (SSE2, NEON) with GCC/Clang vector
+// extensions, keeping each 64-byte block in the diagonal order of Colin
+// Percival's crypto_scrypt-sse.c.  Define SCRYPT_SIMD=0 for the scalar core.
+#ifndef SCRYPT_SIMD
+#if defined(__has_builtin) && (defined(__SSE2__) || defined(__ARM_NEON))
+#if __has_builtin(__builtin_shufflevector)
+#define SCRYPT_SIMD 1
+#endif
+#endif
+#endif
+#ifndef SCRYPT_SIMD
+#define SCRYPT_SIMD 0
+#endif
+
+#if SCRYPT_SIMD
+typedef uint32_t salsa20_vec __attribute__((vector_size(16), may_alias));
+/* position i of a block holds word SCRYPT_WORD(i); word 1 is at position 13 */
+#define SCRYPT_WORD(i) ((i) * 5 % 16)
+#endif
+
 static void blkcpy(void *, void *, size_t);
+#if !SCRYPT_SIMD
 static void blkxor(void *, void *, size_t);
 static void salsa20_8(uint32_t[16]);
+#endif
 static void blockmix_salsa8(uint32_t *, uint32_t *, uint32_t *, size_t);
 static uint64_t integerify(void *, size_t);
 static void smix(uint8_t *, size_t, uint64_t, uint32_t *, uint32_t *);
@@ -61,6 +84,7 @@ blkcpy(void * dest, void * src, size_t len)
 		D[i] = S[i];
 }
 
+#if !SCRYPT_SIMD
 static void
 blkxor(void * dest, void * src, size_t len)
 {
@@ -72,6 +96,140 @@ blkxor(void * dest, void * src, size_t len)
 	for (i = 0; i < L; i++)
 		D[i] ^= S[i];
 }
+#endif
+
+#if SCRYPT_SIMD
+
+/**
+ * salsa20_8(X0, X1, X2, X3):
+ * Apply the salsa20/8 core to a block held in four vectors in diagonal order.
+ */
+static inline void
+salsa20_8(salsa20_vec * X0, salsa20_vec * X1, salsa20_vec * X2,
+    salsa20_vec * X3)
+{
+	salsa20_vec A = *X0, B = *X1, C = *X2, D = *X3, T;
+	size_t i;
+
+	for (i = 0; i < 8; i += 2) {
+#define R(a,b) (((a) << (b)) | ((a) >> (32 - (b))))
+		/* Operate on "columns". */
+		T = A + D;
+		B ^= R(T, 7);
+		T = B + A;
+		C ^= R(T, 9);
+		T = C + B;
+		D ^= R(T, 13);
+		T = D + C;
+		A ^= R(T, 18);
+
+		/* Rearrange data. */
+		B = __builtin_shufflevector(B, B, 3, 0, 1, 2);
+		C = __builtin_shufflevector(C, C, 2, 3, 0, 1);
+		D = __builtin_shufflevector(D, D, 1, 2, 3, 0);
+
+		/* Operate on "rows". */
+		T = A + B;
+		D ^= R(T, 7);
+		T = D + A;
+		C ^= R(T, 9);
+		T = C + D;
+		B ^= R(T, 13);
+		T = B + C;
+		A ^= R(T, 18);
+
+		/* Rearrange data. */
+		B = __builtin_shufflevector(B, B, 1, 2, 3, 0);
+		C = __builtin_shufflevector(C, C, 2, 3, 0, 1);
+		D = __builtin_shufflevector(D, D, 3, 0, 1, 2);
+#undef R
+	}
+	*X0 += A;
+	*X1 += B;
+	*X2 += C;
+	*X3 += D;
+}
+
+/**
+ * blockmix_salsa8(Bin, Bout, X, r):
+ * Compute Bout = BlockMix_{salsa20/8, r}(Bin), keeping X in registers.  The
+ * input Bin must be 128r bytes in length; the output Bout must also be the
+ * same size.  The temporary space X is unused.
+ */
+static void
+blockmix_salsa8(uint32_t * Bin, uint32_t * Bout, uint32_t * X, size_t r)
+{
+	const salsa20_vec * in = (const salsa20_vec *)Bin;
+	salsa20_vec * out = (salsa20_vec *)Bout;
+	salsa20_vec X0, X1, X2, X3;
+	size_t i;
+
+	(void)X;
+
+	/* 1: X <-- B_{2r - 1} */
+	X0 = in[(2 * r - 1) * 4 + 0];
+	X1 = in[(2 * r - 1) * 4 + 1];
+	X2 = in[(2 * r - 1) * 4 + 2];
+	X3 = in[(2 * r - 1) * 4 + 3];
+
+	/* 2: for i = 0 to 2r - 1 do */
+	for (i = 0; i < 2 * r; i++) {
+		/* 3: X <-- H(X \xor B_i) */
+		X0 ^= in[i * 4 + 0];
+		X1 ^= in[i * 4 + 1];
+		X2 ^= in[i * 4 + 2];
+		X3 ^= in[i * 4 + 3];
+		salsa20_8(&X0, &X1, &X2, &X3);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		out[((i & 1) * r + i / 2) * 4 + 0] = X0;
+		out[((i & 1) * r + i / 2) * 4 + 1] = X1;
+		out[((i & 1) * r + i / 2) * 4 + 2] = X2;
+		out[((i & 1) * r + i / 2) * 4 + 3] = X3;
+	}
+}
+
+/**
+ * blockmix_salsa8_xor(Bin1, Bin2, Bout, r):
+ * Compute Bout = BlockMix_{salsa20/8, r}(Bin1 xor Bin2) without writing the
+ * xor back.  The inputs and output must be 128r bytes in length.
+ */
+static void
+blockmix_salsa8_xor(const uint32_t * Bin1, const uint32_t * Bin2,
+    uint32_t * Bout, size_t r)
+{
+	const salsa20_vec * in1 = (const salsa20_vec *)Bin1;
+	const salsa20_vec * in2 = (const salsa20_vec *)Bin2;
+	salsa20_vec * out = (salsa20_vec *)Bout;
+	salsa20_vec X0, X1, X2, X3;
+	size_t i;
+
+	/* 1: X <-- B_{2r - 1} */
+	X0 = in1[(2 * r - 1) * 4 + 0] ^ in2[(2 * r - 1) * 4 + 0];
+	X1 = in1[(2 * r - 1) * 4 + 1] ^ in2[(2 * r - 1) * 4 + 1];
+	X2 = in1[(2 * r - 1) * 4 + 2] ^ in2[(2 * r - 1) * 4 + 2];
+	X3 = in1[(2 * r - 1) * 4 + 3] ^ in2[(2 * r - 1) * 4 + 3];
+
+	/* 2: for i = 0 to 2r - 1 do */
+	for (i = 0; i < 2 * r; i++) {
+		/* 3: X <-- H(X \xor B_i) */
+		X0 ^= in1[i * 4 + 0] ^ in2[i * 4 + 0];
+		X1 ^= in1[i * 4 + 1] ^ in2[i * 4 + 1];
+		X2 ^= in1[i * 4 + 2] ^ in2[i * 4 + 2];
+		X3 ^= in1[i * 4 + 3] ^ in2[i * 4 + 3];
+		salsa20_8(&X0, &X1, &X2, &X3);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		out[((i & 1) * r + i / 2) * 4 + 0] = X0;
+		out[((i & 1) * r + i / 2) * 4 + 1] = X1;
+		out[((i & 1) * r + i / 2) * 4 + 2] = X2;
+		out[((i & 1) * r + i / 2) * 4 + 3] = X3;
+	}
+}
+
+#else
 
 /**
  * salsa20_8(B):
@@ -151,6 +309,8 @@ blockmix_salsa8(uint32_t * Bin, uint32_t * Bout, uint32_t * X, size_t r)
 	}
 }
 
+#endif
+
 /**
  * integerify(B, r):
  * Return the result of parsing B_{2r-1} as a little-endian integer.
@@ -160,7 +320,11 @@ integerify(void * B, size_t r)
 {
 	uint32_t * X = (void *)((uintptr_t)(B) + (2 * r - 1) * 64);
 
+#if SCRYPT_SIMD
+	return (((uint64_t)(X[13]) << 32) + X[0]);
+#else
 	return (((uint64_t)(X[1]) << 32) + X[0]);
+#endif
 }
 
 /**
@@ -182,8 +346,13 @@ smix(uint8_t * B, size_t r, uint64_t N, uint32_t * V, uint32_t * XY)
 	size_t k;
 
 	/* 1: X <-- B */
+#if SCRYPT_SIMD
+	for (k = 0; k < 32 * r; k++)
+		X[k] = le32dec(&B[4 * ((k & ~(size_t)15) + SCRYPT_WORD(k & 15))]);
+#else
 	for (k = 0; k < 32 * r; k++)
 		X[k] = le32dec(&B[4 * k]);
+#endif
 
 	/* 2: for i = 0 to N - 1 do */
 	for (i = 0; i < N; i += 2) {
@@ -206,60 +375,63 @@ smix(uint8_t * B, size_t r, uint64_t N, uint32_t * V, uint32_t * XY)
 		j = integerify(X, r) & (N - 1);
 
 		/* 8: X <-- H(X \xor V_j) */
+#if SCRYPT_SIMD
+		blockmix_salsa8_xor(X, &V[j * (32 * r)], Y, r);
+#else
 		blkxor(X, &V[j * (32 * r)], 128 * r);
 		blockmix_salsa8(X, Y, Z, r);
+#endif
 
 		/* 7: j <-- Integerify(X) mod N */
 		j = integerify(Y, r) & (N - 1);
 
 		/* 8: X <-- H(X \xor V_j) */
+#if SCRYPT_SIMD
+		blockmix_salsa8_xor(Y, &V[j * (32 * r)], X, r);
+#else
 		blkxor(Y, &V[j * (32 * r)], 128 * r);
 		blockmix_salsa8(Y, X, Z, r);
+#endif
 	}
 
 	/* 10: B' <-- X */
+#if SCRYPT_SIMD
+	for (k = 0; k < 32 * r; k++)
+		le32enc(&B[4 * ((k & ~(size_t)15) + SCRYPT_WORD(k & 15))], X[k]);
+#else
 	for (k = 0; k < 32 * r; k++)
 		le32enc(&B[4 * k], X[k]);
+#endif
 }
 
 /**
- * crypto_scrypt(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen):
- * Compute scrypt(passwd[0 .. passwdlen - 1], salt[0 .. saltlen - 1], N, r,
- * p, buflen) and write the result into buf.  The parameters r, p, and buflen
- * must satisfy r * p < 2^30 and buflen <= (2^32 - 1) * 32.  The parameter N
- * must be a power of 2 greater than 1.
- *
- * Return 0 on success; or -1 on error
+ * scrypt_check_params(N, r, p, buflen):
+ * Return 0 if the parameters are acceptable for scrypt; or -1 with errno set.
  */
-int
-scrypt(const uint8_t * passwd, size_t passwdlen,
-    const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t r, uint32_t p,
-    uint8_t * buf, size_t buflen)
+static int
+scrypt_check_params(uint64_t N, uint32_t r, uint32_t p, size_t buflen)
 {
-	void * B0, * V0, * XY0;
-	uint8_t * B;
-	uint32_t * V;
-	uint32_t * XY;
-	uint32_t i;
 
 	/* Sanity-check parameters. */
 #if SIZE_MAX > UINT32_MAX
 	if (buflen > (((uint64_t)(1) << 32) - 1) * 32) {
 		errno = EFBIG;
-		goto err0;
+		return (-1);
 	}
+#else
+	(void)buflen;
 #endif
 	if ((uint64_t)(r) * (uint64_t)(p) >= (1 << 30)) {
 		errno = EFBIG;
-		goto err0;
+		return (-1);
 	}
 	if (r == 0 || p == 0) {
 		errno = EINVAL;
-		goto err0;
+		return (-1);
 	}
 	if (((N & (N - 1)) != 0) || (N < 2)) {
 		errno = EINVAL;
-		goto err0;
+		return (-1);
 	}
 	if ((r > SIZE_MAX / 128 / p) ||
 #if SIZE_MAX / 256 <= UINT32_MAX
@@ -267,46 +439,166 @@ scrypt(const uint8_t * passwd, size_t passwdlen,
 #endif
 	    (N > SIZE_MAX / 128 / r)) {
 		errno = ENOMEM;
-		goto err0;
+		return (-1);
 	}
+	return (0);
+}
 
-	/* Allocate memory. */
+/**
+ * scrypt_scratch_reserve(scratch, r, N):
+ * Make sure scratch holds V and XY buffers large enough for SMix_r with the
+ * given N, reusing the current buffers when they already are.
+ */
+static int
+scrypt_scratch_reserve(scrypt_scratch * scratch, size_t r, uint64_t N)
+{
+	size_t XYlen = 256 * r + 64;
+	size_t Vlen = 128 * r * N;
+
+	if (scratch->XYlen < XYlen) {
+		free(scratch->XY0);
+		scratch->XY0 = NULL;
+		scratch->XYlen = 0;
 #ifdef HAVE_POSIX_MEMALIGN
-	if ((errno = posix_memalign(&B0, 64, 128 * r * p)) != 0)
-		goto err0;
-	B = (uint8_t *)(B0);
-	if ((errno = posix_memalign(&XY0, 64, 256 * r + 64)) != 0)
-		goto err1;
-	XY = (uint32_t *)(XY0);
-#ifndef MAP_ANON
-	if ((errno = posix_memalign(&V0, 64, 128 * r * N)) != 0)
-		goto err2;
-	V = (uint32_t *)(V0);
-#endif
+		if ((errno = posix_memalign(&scratch->XY0, 64, XYlen)) != 0)
+			return (-1);
+		scratch->XY = (uint32_t *)(scratch->XY0);
 #else
-	if ((B0 = malloc(128 * r * p + 63)) == NULL)
-		goto err0;
-	B = (uint8_t *)(((uintptr_t)(B0) + 63) & ~ (uintptr_t)(63));
-	if ((XY0 = malloc(256 * r + 64 + 63)) == NULL)
-		goto err1;
-	XY = (uint32_t *)(((uintptr_t)(XY0) + 63) & ~ (uintptr_t)(63));
-#ifndef MAP_ANON
-	if ((V0 = malloc(128 * r * N + 63)) == NULL)
-		goto err2;
-	V = (uint32_t *)(((uintptr_t)(V0) + 63) & ~ (uintptr_t)(63));
-#endif
+		if ((scratch->XY0 = malloc(XYlen + 63)) == NULL)
+			return (-1);
+		scratch->XY = (uint32_t *)(((uintptr_t)(scratch->XY0) + 63) &
+		    ~ (uintptr_t)(63));
 #endif
+		scratch->XYlen = XYlen;
+	}
+
+	if (scratch->Vlen < Vlen) {
 #ifdef MAP_ANON
-	if ((V0 = mmap(NULL, 128 * r * N, PROT_READ | PROT_WRITE,
+		if (scratch->V0 != NULL)
+			munmap(scratch->V0, scratch->Vlen);
+		scratch->V0 = NULL;
+		scratch->Vlen = 0;
+		if ((scratch->V0 = mmap(NULL, Vlen, PROT_READ | PROT_WRITE,
 #ifdef MAP_NOCORE
-	    MAP_ANON | MAP_PRIVATE | MAP_NOCORE,
+		    MAP_ANON | MAP_PRIVATE | MAP_NOCORE,
 #else
-	    MAP_ANON | MAP_PRIVATE,
+		    MAP_ANON | MAP_PRIVATE,
+#endif
+		    -1, 0)) == MAP_FAILED) {
+			scratch->V0 = NULL;
+			return (-1);
+		}
+		scratch->V = (uint32_t *)(scratch->V0);
+#else
+		free(scratch->V0);
+		scratch->V0 = NULL;
+		scratch->Vlen = 0;
+#ifdef HAVE_POSIX_MEMALIGN
+		if ((errno = posix_memalign(&scratch->V0, 64, Vlen)) != 0)
+			return (-1);
+		scratch->V = (uint32_t *)(scratch->V0);
+#else
+		if ((scratch->V0 = malloc(Vlen + 63)) == NULL)
+			return (-1);
+		scratch->V = (uint32_t *)(((uintptr_t)(scratch->V0) + 63) &
+		    ~ (uintptr_t)(63));
 #endif
-	    -1, 0)) == MAP_FAILED)
-		goto err2;
-	V = (uint32_t *)(V0);
 #endif
+		scratch->Vlen = Vlen;
+	}
+
+	return (0);
+}
+
+/**
+ * scrypt_scratch_free(scratch):
+ * Wipe and release the buffers held by scratch and reset it to empty.
+ */
+void
+scrypt_scratch_free(scrypt_scratch * scratch)
+{
+
+	if (scratch->XY0 != NULL) {
+		memzero(scratch->XY, scratch->XYlen);
+		free(scratch->XY0);
+	}
+	if (scratch->V0 != NULL) {
+		memzero(scratch->V, scratch->Vlen);
+#ifdef MAP_ANON
+		munmap(scratch->V0, scratch->Vlen);
+#else
+		free(scratch->V0);
+#endif
+	}
+	memset(scratch, 0, sizeof(*scratch));
+}
+
+/**
+ * scrypt_smix(B, r, N, scratch):
+ * Compute B = SMix_r(B, N) for a single 128r-byte lane, growing scratch as
+ * needed.  Lanes are independent, so distinct scratches may run concurrently.
+ *
+ * Return 0 on success; or -1 on error.
+ */
+int
+scrypt_smix(uint8_t * B, uint32_t r, uint64_t N, scrypt_scratch * scratch)
+{
+
+	if (scrypt_check_params(N, r, 1, 0))
+		return (-1);
+	if (scrypt_scratch_reserve(scratch, r, N))
+		return (-1);
+	smix(B, r, N, scratch->V, scratch->XY);
+	return (0);
+}
+
+/**
+ * crypto_scrypt(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen):
+ * Compute scrypt(passwd[0 .. passwdlen - 1], salt[0 .. saltlen - 1], N, r,
+ * p, buflen) and write the result into buf.  The parameters r, p, and buflen
+ * must satisfy r * p < 2^30 and buflen <= (2^32 - 1) * 32.  The parameter N
+ * must be a power of 2 greater than 1.
+ *
+ * Return 0 on success; or -1 on error
+ */
+int
+scrypt(const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t r, uint32_t p,
+    uint8_t * buf, size_t buflen)
+{
+	scrypt_scratch scratch = {0};
+	int ret;
+
+	ret = scrypt_with_scratch(passwd, passwdlen, salt, saltlen, N, r, p,
+	    buf, buflen, &scratch);
+	scrypt_scratch_free(&scratch);
+	return (ret);
+}
+
+/**
+ * scrypt_with_scratch(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen,
+ *     scratch):
+ * As scrypt(), but keep the V and XY buffers in scratch so repeated calls
+ * with the same r and N do not allocate them again.
+ *
+ * Return 0 on success; or -1 on error
+ */
+int
+scrypt_with_scratch(const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t r, uint32_t p,
+    uint8_t * buf, size_t buflen, scrypt_scratch * scratch)
+{
+	uint8_t * B;
+	uint32_t i;
+
+	if (scrypt_check_params(N, r, p, buflen))
+		goto err0;
+
+	/* Allocate memory. */
+	if ((B = malloc(128 * r * p)) == NULL)
+		goto err0;
+	if (scrypt_scratch_reserve(scratch, r, N))
+		goto err1;
 
 	/* 1: (B_0 ... B_{p-1}) <-- PBKDF2(P, S, 1, p * MFLen) */
 	pbkdf2_hmac_sha256(passwd, passwdlen, salt, saltlen, 1, B, p * 128 * r);
@@ -314,29 +606,21 @@ scrypt(const uint8_t * passwd, size_t passwdlen,
 	/* 2: for i = 0 to p - 1 do */
 	for (i = 0; i < p; i++) {
 		/* 3: B_i <-- MF(B_i, N) */
-		smix(&B[i * 128 * r], r, N, V, XY);
+		smix(&B[i * 128 * r], r, N, scratch->V, scratch->XY);
 	}
 
 	/* 5: DK <-- PBKDF2(P, B, 1, dkLen) */
 	pbkdf2_hmac_sha256(passwd, passwdlen, B, p * 128 * r, 1, buf, buflen);
 
 	/* Free memory. */
-#ifdef MAP_ANON
-	if (munmap(V0, 128 * r * N))
-		goto err2;
-#else
-	free(V0);
-#endif
-	free(XY0);
-	free(B0);
+	memzero(B, 128 * r * p);
+	free(B);
 
 	/* Success! */
 	return (0);
 
-err2:
-	free(XY0);
 err1:
-	free(B0);
+	free(B);
 err0:
 	/* Failure! */
 	return (-1);
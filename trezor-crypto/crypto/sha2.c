@@ -985,6 +985,145 @@ char* sha256_Data(const sha2_byte* data, size_t len, char digest[SHA256_DIGEST_S
 	return sha256_End(&context, digest);
 }
 
+// [wallet-core]
+/*** SHA-256 on independent messages, several at a time: ***************/
+#if defined(__GNUC__) || defined(__clang__)
+
+/* One lane per message, as GCC/Clang generic vectors: 8 lanes with AVX2, otherwise 4 (SSE2, NEON) */
+#if defined(__AVX2__)
+#define SHA256_MULTI_LANES 8
+#else
+#define SHA256_MULTI_LANES 4
+#endif
+typedef sha2_word32 sha256_vec __attribute__((vector_size(4 * SHA256_MULTI_LANES)));
+
+#define ROTR32V(b,x)	(((x) >> (b)) | ((x) << (32 - (b))))
+#define Sigma0_256V(x)	(ROTR32V(2,  (x)) ^ ROTR32V(13, (x)) ^ ROTR32V(22, (x)))
+#define Sigma1_256V(x)	(ROTR32V(6,  (x)) ^ ROTR32V(11, (x)) ^ ROTR32V(25, (x)))
+#define sigma0_256V(x)	(ROTR32V(7,  (x)) ^ ROTR32V(18, (x)) ^ ((x) >> 3))
+#define sigma1_256V(x)	(ROTR32V(17, (x)) ^ ROTR32V(19, (x)) ^ ((x) >> 10))
+
+/* Writes block `index` of the padded message into `block`. */
+static void sha256_multi_block(const sha2_byte* data, size_t len, size_t index, sha2_byte block[SHA256_BLOCK_LENGTH]) {
+	size_t offset = index * SHA256_BLOCK_LENGTH;
+	size_t last = (len + 8) / SHA256_BLOCK_LENGTH;
+	uint64_t bits = (uint64_t)len << 3;
+	int i;
+
+	if (offset + SHA256_BLOCK_LENGTH <= len) {
+		memcpy(block, data + offset, SHA256_BLOCK_LENGTH);
+		return;
+	}
+	memzero(block, SHA256_BLOCK_LENGTH);
+	if (offset <= len) {
+		memcpy(block, data + offset, len - offset);
+		block[len - offset] = 0x80;
+	}
+	if (index == last) {
+		for (i = 0; i < 8; i++) {
+			block[SHA256_BLOCK_LENGTH - 1 - i] = (sha2_byte)(bits >> (8 * i));
+		}
+	}
+}
+
+static void sha256_multi_lanes(const sha2_byte* const* data, const size_t* len, size_t count, uint8_t (*digest)[SHA256_DIGEST_LENGTH]) {
+	sha256_vec state[8], W[16], active, a, b, c, d, e, f, g, h, T1, T2;
+	sha2_word32 words[16][SHA256_MULTI_LANES];
+	sha2_word32 mask[SHA256_MULTI_LANES];
+	sha2_byte block[SHA256_BLOCK_LENGTH];
+	size_t blocks[SHA256_MULTI_LANES] = {0};
+	size_t maxBlocks = 0, index, lane;
+	int i, j;
+
+	for (lane = 0; lane < count; lane++) {
+		blocks[lane] = (len[lane] + 8) / SHA256_BLOCK_LENGTH + 1;
+		if (blocks[lane] > maxBlocks) {
+			maxBlocks = blocks[lane];
+		}
+	}
+	for (i = 0; i < 8; i++) {
+		for (lane = 0; lane < SHA256_MULTI_LANES; lane++) {
+			state[i][lane] = sha256_initial_hash_value[i];
+		}
+	}
+
+	for (index = 0; index < maxBlocks; index++) {
+		/* Transpose one block of each message into W, word j of lane l at W[j][l] */
+		for (lane = 0; lane < SHA256_MULTI_LANES; lane++) {
+			mask[lane] = index < blocks[lane] ? 0xffffffffUL : 0;
+			if (mask[lane]) {
+				sha256_multi_block(data[lane], len[lane], index, block);
+			} else {
+				memzero(block, SHA256_BLOCK_LENGTH);
+			}
+			for (j = 0; j < 16; j++) {
+				words[j][lane] = ((sha2_word32)block[4 * j] << 24) | ((sha2_word32)block[4 * j + 1] << 16) |
+					((sha2_word32)block[4 * j + 2] << 8) | block[4 * j + 3];
+			}
+		}
+		memcpy(&active, mask, sizeof(active));
+		memcpy(W, words, sizeof(W));
+
+		a = state[0]; b = state[1]; c = state[2]; d = state[3];
+		e = state[4]; f = state[5]; g = state[6]; h = state[7];
+		for (j = 0; j < 64; j++) {
+			if (j >= 16) {
+				W[j & 0x0f] += sigma1_256V(W[(j + 14) & 0x0f]) + W[(j + 9) & 0x0f] + sigma0_256V(W[(j + 1) & 0x0f]);
+			}
+			T1 = h + Sigma1_256V(e) + ((e & f) ^ (~e & g)) + K256[j] + W[j & 0x0f];
+			T2 = Sigma0_256V(a) + ((a & b) ^ (a & c) ^ (b & c));
+			h = g; g = f; f = e; e = d + T1;
+			d = c; c = b; b = a; a = T1 + T2;
+		}
+		/* Lanes past the end of their message keep their state */
+		state[0] += a & active; state[1] += b & active;
+		state[2] += c & active; state[3] += d & active;
+		state[4] += e & active; state[5] += f & active;
+		state[6] += g & active; state[7] += h & active;
+	}
+
+	for (lane = 0; lane < count; lane++) {
+		for (i = 0; i < 8; i++) {
+			digest[lane][4 * i] = (sha2_byte)(state[i][lane] >> 24);
+			digest[lane][4 * i + 1] = (sha2_byte)(state[i][lane] >> 16);
+			digest[lane][4 * i + 2] = (sha2_byte)(state[i][lane] >> 8);
+			digest[lane][4 * i + 3] = (sha2_byte)state[i][lane];
+		}
+	}
+	memzero(words, sizeof(words));
+	memzero(block, sizeof(block));
+	memzero(state, sizeof(state));
+	memzero(W, sizeof(W));
+}
+
+void sha256_Raw_multi(const uint8_t* const* data, const size_t* len, size_t count, uint8_t (*digest)[SHA256_DIGEST_LENGTH]) {
+	static const sha2_byte empty[1] = {0};
+	const sha2_byte* laneData[SHA256_MULTI_LANES];
+	size_t laneLen[SHA256_MULTI_LANES];
+	size_t i, lane, n;
+
+	for (i = 0; i < count; i += SHA256_MULTI_LANES) {
+		n = count - i < SHA256_MULTI_LANES ? count - i : SHA256_MULTI_LANES;
+		for (lane = 0; lane < SHA256_MULTI_LANES; lane++) {
+			laneData[lane] = lane < n ? data[i + lane] : empty;
+			laneLen[lane] = lane < n ? len[i + lane] : 0;
+		}
+		sha256_multi_lanes(laneData, laneLen, n, digest + i);
+	}
+}
+
+#else
+
+void sha256_Raw_multi(const uint8_t* const* data, const size_t* len, size_t count, uint8_t (*digest)[SHA256_DIGEST_LENGTH]) {
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		sha256_Raw(data[i], len[i], digest[i]);
+	}
+}
+
+#endif
+
 
 /*** SHA-512: *********************************************************/
 void sha512_Init(SHA512_CTX* context) {
@@ -378,6 +378,186 @@ void keccak_512(const unsigned char* data, size_t len, unsigned char* digest)
 	keccak_Update(&ctx, data, len);
 	keccak_Final(&ctx, digest);
 }
+
+// [wallet-core]
+/* Keccak-256 on independent messages, several at a time */
+#if defined(__GNUC__) || defined(__clang__)
+
+/* One lane per message, as GCC/Clang generic vectors: 4 lanes with AVX2, otherwise 2 (SSE2, NEON) */
+#if defined(__AVX2__)
+#define KECCAK_MULTI_LANES 4
+#else
+#define KECCAK_MULTI_LANES 2
+#endif
+typedef uint64_t keccak_vec __attribute__((vector_size(8 * KECCAK_MULTI_LANES)));
+
+#define KECCAK_256_RATE 136
+
+/* sha3_permutation on vectors: theta, rho and pi, chi, iota */
+static void keccak_permutation_multi(keccak_vec *A)
+{
+	keccak_vec C[5], D[5], A1, row0, row1;
+	int round = 0, x = 0, i = 0;
+
+	for (round = 0; round < NumberOfRounds; round++)
+	{
+		for (x = 0; x < 5; x++) {
+			C[x] = A[x] ^ A[x + 5] ^ A[x + 10] ^ A[x + 15] ^ A[x + 20];
+		}
+		for (x = 0; x < 5; x++) {
+			D[x] = ROTL64(C[(x + 1) % 5], 1) ^ C[(x + 4) % 5];
+		}
+		for (x = 0; x < 5; x++) {
+			A[x]      ^= D[x];
+			A[x + 5]  ^= D[x];
+			A[x + 10] ^= D[x];
+			A[x + 15] ^= D[x];
+			A[x + 20] ^= D[x];
+		}
+
+		A1 = ROTL64(A[1], 1);
+		A[ 1] = ROTL64(A[ 6], 44);
+		A[ 6] = ROTL64(A[ 9], 20);
+		A[ 9] = ROTL64(A[22], 61);
+		A[22] = ROTL64(A[14], 39);
+		A[14] = ROTL64(A[20], 18);
+		A[20] = ROTL64(A[ 2], 62);
+		A[ 2] = ROTL64(A[12], 43);
+		A[12] = ROTL64(A[13], 25);
+		A[13] = ROTL64(A[19],  8);
+		A[19] = ROTL64(A[23], 56);
+		A[23] = ROTL64(A[15], 41);
+		A[15] = ROTL64(A[ 4], 27);
+		A[ 4] = ROTL64(A[24], 14);
+		A[24] = ROTL64(A[21],  2);
+		A[21] = ROTL64(A[ 8], 55);
+		A[ 8] = ROTL64(A[16], 45);
+		A[16] = ROTL64(A[ 5], 36);
+		A[ 5] = ROTL64(A[ 3], 28);
+		A[ 3] = ROTL64(A[18], 21);
+		A[18] = ROTL64(A[17], 15);
+		A[17] = ROTL64(A[11], 10);
+		A[11] = ROTL64(A[ 7],  6);
+		A[ 7] = ROTL64(A[10],  3);
+		A[10] = A1;
+
+		for (i = 0; i < 25; i += 5) {
+			row0 = A[0 + i];
+			row1 = A[1 + i];
+			A[0 + i] ^= ~row1 & A[2 + i];
+			A[1 + i] ^= ~A[2 + i] & A[3 + i];
+			A[2 + i] ^= ~A[3 + i] & A[4 + i];
+			A[3 + i] ^= ~A[4 + i] & row0;
+			A[4 + i] ^= ~row0 & row1;
+		}
+
+		A[0] ^= keccak_round_constants[round];
+	}
+}
+
+/* Writes block `index` of the padded message into `block` */
+static void keccak_256_multi_block(const unsigned char* data, size_t len, size_t index, unsigned char block[KECCAK_256_RATE])
+{
+	size_t offset = index * KECCAK_256_RATE;
+
+	if (offset + KECCAK_256_RATE <= len) {
+		memcpy(block, data + offset, KECCAK_256_RATE);
+		return;
+	}
+	memzero(block, KECCAK_256_RATE);
+	memcpy(block, data + offset, len - offset);
+	block[len - offset] |= 0x01;
+	block[KECCAK_256_RATE - 1] |= 0x80;
+}
+
+static void keccak_256_multi_lanes(const unsigned char* const* data, const size_t* len, size_t count, unsigned char (*digest)[SHA3_256_DIGEST_LENGTH])
+{
+	keccak_vec state[25], previous[25], active;
+	uint64_t words[KECCAK_256_RATE / 8][KECCAK_MULTI_LANES];
+	uint64_t mask[KECCAK_MULTI_LANES];
+	unsigned char block[KECCAK_256_RATE];
+	size_t blocks[KECCAK_MULTI_LANES] = {0};
+	size_t maxBlocks = 0, index = 0, lane = 0;
+	int j = 0;
+
+	for (lane = 0; lane < count; lane++) {
+		blocks[lane] = len[lane] / KECCAK_256_RATE + 1;
+		if (blocks[lane] > maxBlocks) {
+			maxBlocks = blocks[lane];
+		}
+	}
+	memzero(state, sizeof(state));
+
+	for (index = 0; index < maxBlocks; index++) {
+		/* Transpose one block of each message, word j of lane l at words[j][l] */
+		for (lane = 0; lane < KECCAK_MULTI_LANES; lane++) {
+			mask[lane] = index < blocks[lane] ? ~(uint64_t)0 : 0;
+			if (mask[lane]) {
+				keccak_256_multi_block(data[lane], len[lane], index, block);
+			} else {
+				memzero(block, KECCAK_256_RATE);
+			}
+			for (j = 0; j < KECCAK_256_RATE / 8; j++) {
+				memcpy(&words[j][lane], block + 8 * j, 8);
+				words[j][lane] = le2me_64(words[j][lane]);
+			}
+		}
+		memcpy(&active, mask, sizeof(active));
+
+		memcpy(previous, state, sizeof(state));
+		for (j = 0; j < KECCAK_256_RATE / 8; j++) {
+			keccak_vec word;
+			memcpy(&word, words[j], sizeof(word));
+			state[j] ^= word;
+		}
+		keccak_permutation_multi(state);
+		/* Lanes past the end of their message keep their state */
+		for (j = 0; j < 25; j++) {
+			state[j] = (state[j] & active) | (previous[j] & ~active);
+		}
+	}
+
+	for (lane = 0; lane < count; lane++) {
+		for (j = 0; j < SHA3_256_DIGEST_LENGTH / 8; j++) {
+			uint64_t word = le2me_64(state[j][lane]);
+			memcpy(digest[lane] + 8 * j, &word, 8);
+		}
+	}
+	memzero(words, sizeof(words));
+	memzero(block, sizeof(block));
+	memzero(state, sizeof(state));
+	memzero(previous, sizeof(previous));
+}
+
+void keccak_256_multi(const unsigned char* const* data, const size_t* len, size_t count, unsigned char (*digest)[SHA3_256_DIGEST_LENGTH])
+{
+	static const unsigned char empty[1] = {0};
+	const unsigned char* laneData[KECCAK_MULTI_LANES];
+	size_t laneLen[KECCAK_MULTI_LANES];
+	size_t i = 0, lane = 0, n = 0;
+
+	for (i = 0; i < count; i += KECCAK_MULTI_LANES) {
+		n = count - i < KECCAK_MULTI_LANES ? count - i : KECCAK_MULTI_LANES;
+		for (lane = 0; lane < KECCAK_MULTI_LANES; lane++) {
+			laneData[lane] = lane < n ? data[i + lane] : empty;
+			laneLen[lane] = lane < n ? len[i + lane] : 0;
+		}
+		keccak_256_multi_lanes(laneData, laneLen, n, digest + i);
+	}
+}
+
+#else
+
+void keccak_256_multi(const unsigned char* const* data, const size_t* len, size_t count, unsigned char (*digest)[SHA3_256_DIGEST_LENGTH])
+{
+	size_t i = 0;
+
+	for (i = 0; i < count; i++) {
+		keccak_256(data[i], len[i], digest[i]);
+	}
+}
+
+#endif
 #endif /* USE_KECCAK */
 
 void sha3_256(const unsigned char* data, size_t len, unsigned char* digest)
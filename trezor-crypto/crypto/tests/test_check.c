@@ -6206,6 +6206,79 @@ START_TEST(test_scalar_point_mult_nist256p1) {
 }
 END_TEST
 
+// [wallet-core]
+static void test_prepared_point_mult_curve(const ecdsa_curve *curve) {
+  int i, j;
+  static ecdsa_prepared_point prepared;
+  uint8_t pub_key[33], priv_key[32], digest[32], sig[64];
+  uint8_t session_key1[65], session_key2[65];
+  // get a "random" number and a "random" point
+  bignum256 a = curve->G.x;
+  curve_point p = curve->G;
+  curve_point p1, p2;
+  for (i = 0; i < 10; i++) {
+    compress_coords(&p, pub_key);
+    ck_assert_int_eq(ecdsa_prepare_point(curve, pub_key, &prepared), 0);
+    for (j = 0; j < 20; j++) {
+      bn_mod(&a, &curve->order);
+      point_multiply(curve, &a, &p, &p1);
+      point_multiply_prepared(&prepared, &a, &p2);
+      ck_assert_mem_eq(&p1, &p2, sizeof(curve_point));
+      a = p1.y;
+    }
+    // border cases 0, 1 and order - 1
+    bn_zero(&a);
+    point_multiply_prepared(&prepared, &a, &p2);
+    ck_assert(point_is_infinity(&p2));
+    bn_one(&a);
+    point_multiply_prepared(&prepared, &a, &p2);
+    ck_assert_mem_eq(&p, &p2, sizeof(curve_point));
+    a = curve->order;
+    bn_subi(&a, 1, &curve->order);
+    bn_mod(&a, &curve->order);
+    point_multiply_prepared(&prepared, &a, &p2);
+    ck_assert(point_is_negative_of(&p, &p2));
+
+    bn_mod(&p1.x, &curve->order);
+    bn_write_be(&p1.x, priv_key);
+    bn_write_be(&p1.y, digest);
+    ck_assert_int_eq(ecdh_multiply(curve, priv_key, pub_key, session_key1), 0);
+    ck_assert_int_eq(ecdh_multiply_prepared(&prepared, priv_key, session_key2),
+                     0);
+    ck_assert_mem_eq(session_key1, session_key2, sizeof(session_key1));
+
+    // new "random" point p = priv_key * G, to verify signatures by priv_key
+    scalar_multiply(curve, &p1.x, &p);
+    compress_coords(&p, pub_key);
+    ck_assert_int_eq(ecdsa_prepare_point(curve, pub_key, &prepared), 0);
+    ck_assert_int_eq(
+        ecdsa_sign_digest(curve, priv_key, digest, sig, NULL, NULL), 0);
+    ck_assert_int_eq(ecdsa_verify_digest_prepared(&prepared, sig, digest), 0);
+    ck_assert_int_eq(ecdsa_verify_digest(curve, pub_key, sig, digest), 0);
+    digest[0] ^= 1;
+    ck_assert_int_eq(ecdsa_verify_digest_prepared(&prepared, sig, digest),
+                     ecdsa_verify_digest(curve, pub_key, sig, digest));
+    ck_assert_int_ne(ecdsa_verify_digest_prepared(&prepared, sig, digest), 0);
+
+    // new "random" number
+    a = p1.x;
+  }
+
+  // x >= prime
+  memset(pub_key, 0xff, sizeof(pub_key));
+  pub_key[0] = 0x02;
+  ck_assert_int_eq(ecdsa_prepare_point(curve, pub_key, &prepared), 1);
+}
+
+START_TEST(test_prepared_point_mult_secp256k1) {
+  test_prepared_point_mult_curve(&secp256k1);
+}
+END_TEST
+START_TEST(test_prepared_point_mult_nist256p1) {
+  test_prepared_point_mult_curve(&nist256p1);
+}
+END_TEST
+
 START_TEST(test_ed25519) {
   // test vectors from
   // https://github.com/torproject/tor/blob/master/src/test/ed25519_vectors.inc
@@ -6570,6 +6643,120 @@ START_TEST(test_ed25519_cosi) {
 }
 END_TEST
 
+// [wallet-core]
+START_TEST(test_ed25519_batch) {
+  const int N = 40;
+  ed25519_secret_key sk;
+  ed25519_public_key pks[N];
+  ed25519_signature sigs[N];
+  uint8_t msgs[N][32];
+  const unsigned char *m[N], *pk[N], *RS[N];
+  size_t mlen[N];
+  int valid[N];
+  rfc6979_state rng;
+  int res;
+
+  init_rfc6979(
+      fromhex(
+          "26c76712d89d906e6672dafa614c42e5cb1caac8c6568e4d2493087db51f0d36"),
+      fromhex(
+          "7f8d3f2ba0dd0e77bdb4bda72bdd1b8a9ac2d2b5e6ff7ab29e3ba79b9aa6f1e4"),
+      &rng);
+
+  for (int i = 0; i < N; i++) {
+    generate_rfc6979(sk, &rng);
+    generate_rfc6979(msgs[i], &rng);
+    ed25519_publickey(sk, pks[i]);
+    mlen[i] = i % sizeof(msgs[i]) + 1;
+    ed25519_sign(msgs[i], mlen[i], sk, pks[i], sigs[i]);
+    m[i] = msgs[i];
+    pk[i] = pks[i];
+    RS[i] = sigs[i];
+  }
+
+  // all valid, spanning several internal batches
+  res = ed25519_sign_open_batch(m, mlen, pk, RS, N, valid);
+  ck_assert_int_eq(res, 0);
+  for (int i = 0; i < N; i++) {
+    ck_assert_int_eq(valid[i], 1);
+  }
+
+  // a batch of one and an empty batch
+  res = ed25519_sign_open_batch(m, mlen, pk, RS, 1, valid);
+  ck_assert_int_eq(res, 0);
+  ck_assert_int_eq(valid[0], 1);
+  res = ed25519_sign_open_batch(m, mlen, pk, RS, 0, valid);
+  ck_assert_int_eq(res, 0);
+
+  // wrong message, unreduced S, bad public key, non-canonical R (y = p + 1)
+  msgs[3][0] ^= 1;
+  memset(sigs[17] + 32, 0xff, 31);
+  sigs[17][63] = 0x1f;
+  memset(pks[20], 0, sizeof(pks[20]));
+  pks[20][0] = 2;
+  memset(sigs[33], 0xff, 32);
+  sigs[33][0] = 0xee;
+  sigs[33][31] = 0x7f;
+
+  res = ed25519_sign_open_batch(m, mlen, pk, RS, N, valid);
+  ck_assert_int_eq(res, -1);
+  for (int i = 0; i < N; i++) {
+    ck_assert_int_eq(valid[i],
+                     ed25519_sign_open(m[i], mlen[i], pk[i], RS[i]) == 0);
+  }
+  ck_assert_int_eq(valid[3], 0);
+  ck_assert_int_eq(valid[17], 0);
+  ck_assert_int_eq(valid[20], 0);
+  ck_assert_int_eq(valid[33], 0);
+  ck_assert_int_eq(valid[4], 1);
+
+  // small order components, rejected by ed25519_sign_open: the identity as
+  // public key, (0, -1) as R and S = 0. Alone in its internal batch of
+  // otherwise valid signatures, the batch check would accept it for even z_i.
+  msgs[3][0] ^= 1;
+  memset(pks[5], 0, sizeof(pks[5]));
+  pks[5][0] = 1;
+  memset(sigs[5], 0, sizeof(sigs[5]));
+  memset(sigs[5], 0xff, 32);
+  sigs[5][0] = 0xec;
+  sigs[5][31] = 0x7f;
+  for (int k = 0; k < 32; k++) {
+    ed25519_sign_open_batch(m, mlen, pk, RS, N, valid);
+    ck_assert_int_eq(valid[5], 0);
+    ck_assert_int_eq(valid[3], 1);
+  }
+
+  // R = rB + T and A = aB + T with T = (0, -1), S = r + H(R,A,m)a: with an
+  // even H(R,A,m), [S]B - R - [H(R,A,m)]A = T and ed25519_sign_open rejects,
+  // which the batch check alone would miss for even z_i; with an odd one the
+  // torsion cancels and both accept.
+  memcpy(pks[8],
+         fromhex("beb7ce8ff123d0d840897012a8e0bfc88711631c315c97c090b33e6cfa06d967"),
+         32);
+  memcpy(pks[9], pks[8], 32);
+  memcpy(sigs[8],
+         fromhex("905489b05f56af21946954ec020345631abd78e90535f3dcdd46dcfc1b467584"
+                 "07cb76b2a93c046c71a308c2d77eaa7cec306bf5d5e616602f9d104234830606"),
+         64);
+  memcpy(sigs[9],
+         fromhex("905489b05f56af21946954ec020345631abd78e90535f3dcdd46dcfc1b467584"
+                 "b80704abeadfb9192637c0e6f82bedde7dd5ed50ed497baaec97cada986bf90e"),
+         64);
+  memcpy(msgs[8], "torsion message 0", 17);
+  mlen[8] = 17;
+  memcpy(msgs[9], "torsion message 1", 17);
+  mlen[9] = 17;
+  ck_assert_int_eq(ed25519_sign_open(m[8], mlen[8], pk[8], RS[8]), -1);
+  ck_assert_int_eq(ed25519_sign_open(m[9], mlen[9], pk[9], RS[9]), 0);
+  for (int k = 0; k < 32; k++) {
+    ed25519_sign_open_batch(m, mlen, pk, RS, N, valid);
+    ck_assert_int_eq(valid[8], 0);
+    ck_assert_int_eq(valid[9], 1);
+    ck_assert_int_eq(valid[3], 1);
+  }
+}
+END_TEST
+
 START_TEST(test_ed25519_modl_add) {
   char tests[][3][65] = {
       {
@@ -9194,6 +9381,11 @@ Suite *test_suite(void) {
   tcase_add_test(tc, test_scalar_point_mult_nist256p1);
   suite_add_tcase(s, tc);
 
+  tc = tcase_create("prepared_point_mult");
+  tcase_add_test(tc, test_prepared_point_mult_secp256k1);
+  tcase_add_test(tc, test_prepared_point_mult_nist256p1);
+  suite_add_tcase(s, tc);
+
   tc = tcase_create("ed25519");
   tcase_add_test(tc, test_ed25519);
   suite_add_tcase(s, tc);
@@ -9206,6 +9398,10 @@ Suite *test_suite(void) {
   tcase_add_test(tc, test_ed25519_cosi);
   suite_add_tcase(s, tc);
 
+  tc = tcase_create("ed25519_batch");
+  tcase_add_test(tc, test_ed25519_batch);
+  suite_add_tcase(s, tc);
+
   tc = tcase_create("ed25519_modm");
   tcase_add_test(tc, test_ed25519_modl_add);
   tcase_add_test(tc, test_ed25519_modl_neg);
@@ -3,12 +3,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
-#include "bip32.h"
+#include <TrezorCrypto/bip32.h>
 #include <TrezorCrypto/curves.h>
-#include "ecdsa.h"
-#include <TrezorCrypto/ed25519.h"
-#include "hasher.h"
-#include "nist256p1.h"
+#include <TrezorCrypto/ecdsa.h>
+#include <TrezorCrypto/ed25519.h>
+#include <TrezorCrypto/ed25519-donna/ed25519-blake2b.h>
+#include <TrezorCrypto/hasher.h>
+#include <TrezorCrypto/nist256p1.h>
+#include <TrezorCrypto/options.h>
 #include <TrezorCrypto/secp256k1.h>
 
 uint8_t msg[256];
@@ -54,7 +56,7 @@ void bench_sign_ed25519(int iterations) {
   ed25519_secret_key sk;
   ed25519_signature sig;
 
-  memcpy(pk,
+  memcpy(sk,
          "\xc5\x5e\xce\x85\x8b\x0d\xdd\x52\x63\xf9\x68\x10\xfe\x14\x43\x7c\xd3"
          "\xb5\xe1\xfb\xd7\xc6\xa2\xec\x1e\x03\x1f\x05\xe8\x6d\x8b\xd5",
          32);
@@ -65,6 +67,42 @@ void bench_sign_ed25519(int iterations) {
   }
 }
 
+void bench_sign_ed25519_blake2b(int iterations) {
+  ed25519_public_key pk;
+  ed25519_secret_key sk;
+  ed25519_signature sig;
+
+  memcpy(sk,
+         "\xc5\x5e\xce\x85\x8b\x0d\xdd\x52\x63\xf9\x68\x10\xfe\x14\x43\x7c\xd3"
+         "\xb5\xe1\xfb\xd7\xc6\xa2\xec\x1e\x03\x1f\x05\xe8\x6d\x8b\xd5",
+         32);
+  ed25519_publickey_blake2b(sk, pk);
+
+  for (int i = 0; i < iterations; i++) {
+    ed25519_sign_blake2b(msg, sizeof(msg), sk, pk, sig);
+  }
+}
+
+void bench_sign_ed25519_ext(int iterations) {
+  ed25519_public_key pk;
+  ed25519_secret_key sk, skext;
+  ed25519_signature sig;
+
+  memcpy(sk,
+         "\xc0\x5e\xce\x85\x8b\x0d\xdd\x52\x63\xf9\x68\x10\xfe\x14\x43\x7c\xd3"
+         "\xb5\xe1\xfb\xd7\xc6\xa2\xec\x1e\x03\x1f\x05\xe8\x6d\x8b\x55",
+         32);
+  memcpy(skext,
+         "\x96\x47\xda\xbe\x1e\xea\xaf\x25\x47\x1e\x68\x0b\x4d\x7c\x6f\xd1\x14"
+         "\x38\x76\xbb\x77\x59\xd8\x3d\x0f\xf7\xa2\x49\x08\xfd\xda\xbc",
+         32);
+  ed25519_publickey_ext(sk, skext, pk);
+
+  for (int i = 0; i < iterations; i++) {
+    ed25519_sign_ext(msg, sizeof(msg), sk, skext, pk, sig);
+  }
+}
+
 void bench_verify_secp256k1_33(int iterations) {
   uint8_t sig[64], pub[33], priv[32], pby;
 
@@ -138,7 +176,7 @@ void bench_verify_ed25519(int iterations) {
   ed25519_secret_key sk;
   ed25519_signature sig;
 
-  memcpy(pk,
+  memcpy(sk,
          "\xc5\x5e\xce\x85\x8b\x0d\xdd\x52\x63\xf9\x68\x10\xfe\x14\x43\x7c\xd3"
          "\xb5\xe1\xfb\xd7\xc6\xa2\xec\x1e\x03\x1f\x05\xe8\x6d\x8b\xd5",
          32);
@@ -150,6 +188,57 @@ void bench_verify_ed25519(int iterations) {
   }
 }
 
+void bench_pubkey_secp256k1(int iterations) {
+  uint8_t pub[33], priv[32];
+
+  memcpy(priv,
+         "\xc5\x5e\xce\x85\x8b\x0d\xdd\x52\x63\xf9\x68\x10\xfe\x14\x43\x7c\xd3"
+         "\xb5\xe1\xfb\xd7\xc6\xa2\xec\x1e\x03\x1f\x05\xe8\x6d\x8b\xd5",
+         32);
+
+  for (int i = 0; i < iterations; i++) {
+    priv[0] = i;
+    ecdsa_get_public_key33(&secp256k1, priv, pub);
+  }
+}
+
+void bench_pubkey_nist256p1(int iterations) {
+  uint8_t pub[33], priv[32];
+
+  memcpy(priv,
+         "\xc5\x5e\xce\x85\x8b\x0d\xdd\x52\x63\xf9\x68\x10\xfe\x14\x43\x7c\xd3"
+         "\xb5\xe1\xfb\xd7\xc6\xa2\xec\x1e\x03\x1f\x05\xe8\x6d\x8b\xd5",
+         32);
+
+  for (int i = 0; i < iterations; i++) {
+    priv[0] = i;
+    ecdsa_get_public_key33(&nist256p1, priv, pub);
+  }
+}
+
+void bench_pubkey_ed25519(int iterations) {
+  ed25519_public_key pk;
+  ed25519_secret_key sk;
+
+  memcpy(sk,
+         "\xc5\x5e\xce\x85\x8b\x0d\xdd\x52\x63\xf9\x68\x10\xfe\x14\x43\x7c\xd3"
+         "\xb5\xe1\xfb\xd7\xc6\xa2\xec\x1e\x03\x1f\x05\xe8\x6d\x8b\xd5",
+         32);
+
+  for (int i = 0; i < iterations; i++) {
+    sk[0] = i;
+    ed25519_publickey(sk, pk);
+  }
+}
+
+void bench_multiply_bignum(int iterations) {
+  bignum256 k = secp256k1.G.x, x = secp256k1.G.y;
+
+  for (int i = 0; i < iterations; i++) {
+    bn_multiply(&k, &x, &secp256k1.prime);
+  }
+}
+
 void bench_multiply_curve25519(int iterations) {
   uint8_t result[32];
   uint8_t secret[32];
@@ -211,6 +300,14 @@ void bench(void (*func)(int), const char *name, int iterations) {
 int main(void) {
   prepare_msg();
 
+  // configure with -DTREZOR_CRYPTO_BN_64=ON to compare the bignum backends
+  printf("bignum backend: %s\n", USE_BN_64 ? "64-bit limbs" : "29-bit limbs");
+  // configure with -DTREZOR_CRYPTO_ED25519_64=ON to compare the ed25519 backends
+  printf("ed25519 backend: %s\n",
+         USE_ED25519_64 ? "64-bit (radix 2^51)" : "32-bit (radix 2^25.5)");
+
+  BENCH(bench_multiply_bignum, 1000000);
+
   BENCH(bench_sign_secp256k1, 500);
   BENCH(bench_verify_secp256k1_33, 500);
   BENCH(bench_verify_secp256k1_65, 500);
@@ -219,8 +316,14 @@ int main(void) {
   BENCH(bench_verify_nist256p1_33, 500);
   BENCH(bench_verify_nist256p1_65, 500);
 
+  BENCH(bench_pubkey_secp256k1, 500);
+  BENCH(bench_pubkey_nist256p1, 500);
+
   BENCH(bench_sign_ed25519, 4000);
   BENCH(bench_verify_ed25519, 4000);
+  BENCH(bench_pubkey_ed25519, 4000);
+  BENCH(bench_sign_ed25519_blake2b, 4000);
+  BENCH(bench_sign_ed25519_ext, 4000);
 
   BENCH(bench_multiply_curve25519, 4000);
 
@@ -134,6 +134,39 @@ int ecdsa_sig_from_der(const uint8_t *der, size_t der_len, uint8_t sig[64]);
 int zil_schnorr_sign(const ecdsa_curve *curve, const uint8_t *priv_key, const uint8_t *msg, const uint32_t msg_len, uint8_t *sig);
 int zil_schnorr_verify(const ecdsa_curve *curve, const uint8_t *pub_key, const uint8_t *sig, const uint8_t *msg, const uint32_t msg_len);
 
+// [wallet-core]
+// results[i] = ecdsa_verify_digest(curve, pub_keys[i], sigs[i], digests[i])
+// for i < count, sharing modular inversions between signatures.
+// Variable time, which is fine for public keys, signatures and digests.
+void ecdsa_verify_digest_batch(const ecdsa_curve *curve, size_t count,
+                               const uint8_t *const *pub_keys,
+                               const uint8_t *const *sigs,
+                               const uint8_t *const *digests, int *results);
+
+// [wallet-core]
+// A public key with its multiples cp[i][j] = (2j + 1) * 16^i * pub, laid out
+// as curve->cp, so that multiplying it needs no doublings.  About 37 KB.
+typedef struct ecdsa_prepared_point {
+  const ecdsa_curve *curve;
+  curve_point pub;
+  curve_point cp[64][8];
+} ecdsa_prepared_point;
+
+// [wallet-core]
+// Computes the multiples of pub_key; returns 0 on success, 1 if pub_key is not
+// a valid public key of curve.
+int ecdsa_prepare_point(const ecdsa_curve *curve, const uint8_t *pub_key,
+                        ecdsa_prepared_point *prepared);
+// res = k * prepared->pub, as point_multiply
+void point_multiply_prepared(const ecdsa_prepared_point *prepared,
+                             const bignum256 *k, curve_point *res);
+// ecdh_multiply with a prepared public key
+int ecdh_multiply_prepared(const ecdsa_prepared_point *prepared,
+                           const uint8_t *priv_key, uint8_t *session_key);
+// ecdsa_verify_digest with a prepared public key
+int ecdsa_verify_digest_prepared(const ecdsa_prepared_point *prepared,
+                                 const uint8_t *sig, const uint8_t *digest);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
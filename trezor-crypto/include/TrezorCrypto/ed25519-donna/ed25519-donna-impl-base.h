@@ -62,6 +62,12 @@ void ge25519_set_neutral(ge25519 *r);
 /* computes [s1]p1 + [s2]base */
 void ge25519_double_scalarmult_vartime(ge25519 *r, const ge25519 *p1, const bignum256modm s1, const bignum256modm s2);
 
+// [wallet-core]
+#define GE25519_MULTI_SCALARMULT_MAX 32
+
+/* computes [s1]p1 + ... + [sn]pn + [sb]base with shared doublings, n <= GE25519_MULTI_SCALARMULT_MAX */
+void ge25519_multi_scalarmult_vartime(ge25519 *r, const ge25519 *p, const bignum256modm *s, size_t n, const bignum256modm sb);
+
 /* computes [s1]p1, constant time */
 void ge25519_scalarmult(ge25519 *r, const ge25519 *p1, const bignum256modm s1);
 
@@ -4,6 +4,8 @@
 #include <string.h>
 #include <stdint.h>
 
+#include <TrezorCrypto/options.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -27,6 +29,39 @@ static inline uint32_t U8TO32_LE(const unsigned char *p) {
 	 ((uint32_t)(p[3]) << 24));
 }
 
+#if USE_ED25519_64 // [wallet-core]
+#if !defined(__SIZEOF_INT128__)
+#error "USE_ED25519_64 requires a compiler with 128-bit integers"
+#endif
+
+typedef unsigned __int128 uint128_t;
+
+#define mul64x64_128(a,b) (((uint128_t)(a))*(b))
+
+static inline void U64TO8_LE(unsigned char *p, const uint64_t v) {
+	p[0] = (unsigned char)(v      );
+	p[1] = (unsigned char)(v >>  8);
+	p[2] = (unsigned char)(v >> 16);
+	p[3] = (unsigned char)(v >> 24);
+	p[4] = (unsigned char)(v >> 32);
+	p[5] = (unsigned char)(v >> 40);
+	p[6] = (unsigned char)(v >> 48);
+	p[7] = (unsigned char)(v >> 56);
+}
+
+static inline uint64_t U8TO64_LE(const unsigned char *p) {
+	return
+	(((uint64_t)(p[0])      ) |
+	 ((uint64_t)(p[1]) <<  8) |
+	 ((uint64_t)(p[2]) << 16) |
+	 ((uint64_t)(p[3]) << 24) |
+	 ((uint64_t)(p[4]) << 32) |
+	 ((uint64_t)(p[5]) << 40) |
+	 ((uint64_t)(p[6]) << 48) |
+	 ((uint64_t)(p[7]) << 56));
+}
+#endif
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -13,11 +13,19 @@
 
 #include <TrezorCrypto/ed25519-donna/ed25519-donna-portable.h>
 
+#if USE_ED25519_64 // [wallet-core]
+#include <TrezorCrypto/ed25519-donna/curve25519-donna-64bit.h>
+#else
 #include <TrezorCrypto/ed25519-donna/curve25519-donna-32bit.h>
+#endif
 
 #include <TrezorCrypto/ed25519-donna/curve25519-donna-helpers.h>
 
+#if USE_ED25519_64 // [wallet-core]
+#include <TrezorCrypto/ed25519-donna/modm-donna-64bit.h>
+#else
 #include <TrezorCrypto/ed25519-donna/modm-donna-32bit.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,7 +57,11 @@ typedef struct ge25519_pniels_t {
 
 #include <TrezorCrypto/ed25519-donna/ed25519-donna-basepoint-table.h>
 
+#if USE_ED25519_64 // [wallet-core]
+#include <TrezorCrypto/ed25519-donna/ed25519-donna-64bit-tables.h>
+#else
 #include <TrezorCrypto/ed25519-donna/ed25519-donna-32bit-tables.h>
+#endif
 
 #include <TrezorCrypto/ed25519-donna/ed25519-donna-impl-base.h>
 
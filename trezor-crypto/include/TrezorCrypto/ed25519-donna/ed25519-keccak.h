@@ -10,6 +10,8 @@ extern "C" {
 void ed25519_publickey_keccak(const ed25519_secret_key sk, ed25519_public_key pk);
 
 int ed25519_sign_open_keccak(const unsigned char *m, size_t mlen, const ed25519_public_key pk, const ed25519_signature RS);
+// [wallet-core] sets valid[i] per signature, returns 0 only if all are valid
+int ed25519_sign_open_batch_keccak(const unsigned char * const *m, const size_t *mlen, const unsigned char * const *pk, const unsigned char * const *RS, size_t num, int *valid);
 void ed25519_sign_keccak(const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS);
 
 int ed25519_scalarmult_keccak(ed25519_public_key res, const ed25519_secret_key sk, const ed25519_public_key pk);
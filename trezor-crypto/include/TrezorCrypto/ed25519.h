@@ -21,6 +21,8 @@ void ed25519_publickey_ext(const ed25519_secret_key sk, const ed25519_secret_key
 #endif
 
 int ed25519_sign_open(const unsigned char *m, size_t mlen, const ed25519_public_key pk, const ed25519_signature RS);
+// [wallet-core] sets valid[i] per signature, returns 0 only if all are valid
+int ed25519_sign_open_batch(const unsigned char * const *m, const size_t *mlen, const unsigned char * const *pk, const unsigned char * const *RS, size_t num, int *valid);
 void ed25519_sign(const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS);
 #if USE_CARDANO
 void ed25519_sign_ext(const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_secret_key skext, const ed25519_public_key pk, ed25519_signature RS);
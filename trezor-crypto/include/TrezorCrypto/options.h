@@ -41,6 +41,17 @@
 #define USE_INVERSE_FAST 1
 #endif
 
+// use 64-bit limbs in bignum multiplication, for 64-bit targets
+#ifndef USE_BN_64
+#define USE_BN_64 0 // [wallet-core]
+#endif
+
+// use the 64-bit (radix 2^51) ed25519-donna field and scalar arithmetic, for
+// 64-bit targets
+#ifndef USE_ED25519_64
+#define USE_ED25519_64 0 // [wallet-core]
+#endif
+
 // support for printing bignum256 structures via printf
 #ifndef USE_BN_PRINT
 #define USE_BN_PRINT 0
@@ -1,6 +1,7 @@
 #ifndef __RIPEMD160_H__
 #define __RIPEMD160_H__
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -23,6 +24,11 @@ void ripemd160_Final(RIPEMD160_CTX *ctx,
 void ripemd160(const uint8_t *msg, uint32_t msg_len,
                uint8_t hash[RIPEMD160_DIGEST_LENGTH]);
 
+// [wallet-core]
+/* hash[i] = RIPEMD-160 of msg[i][0 .. len[i] - 1], for i < count */
+void ripemd160_multi(const uint8_t *const *msg, const size_t *len, size_t count,
+                     uint8_t (*hash)[RIPEMD160_DIGEST_LENGTH]);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
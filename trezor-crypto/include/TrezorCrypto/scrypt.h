@@ -56,6 +56,44 @@ extern "C"{
 int scrypt(const uint8_t *, size_t, const uint8_t *, size_t, uint64_t,
     uint32_t, uint32_t, /*@out@*/ uint8_t *, size_t);
 
+// [wallet-core]
+/**
+ * Reusable V and XY working memory for scrypt.  Zero-initialise before first
+ * use and release with scrypt_scratch_free(); buffers only ever grow.
+ */
+typedef struct scrypt_scratch {
+	void * V0;
+	uint32_t * V;
+	size_t Vlen;
+	void * XY0;
+	uint32_t * XY;
+	size_t XYlen;
+} scrypt_scratch;
+
+/**
+ * scrypt_with_scratch(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen,
+ *     scratch):
+ * As scrypt(), but allocate V and XY in scratch and keep them for the next
+ * call.  Return 0 on success; or -1 on error.
+ */
+int scrypt_with_scratch(const uint8_t *, size_t, const uint8_t *, size_t,
+    uint64_t, uint32_t, uint32_t, /*@out@*/ uint8_t *, size_t,
+    scrypt_scratch *);
+
+/**
+ * scrypt_smix(B, r, N, scratch):
+ * Compute B = SMix_r(B, N) in place for one 128r-byte lane of the PBKDF2
+ * output.  Lanes are independent and may run concurrently on separate
+ * scratches.  Return 0 on success; or -1 on error.
+ */
+int scrypt_smix(uint8_t *, uint32_t, uint64_t, scrypt_scratch *);
+
+/**
+ * scrypt_scratch_free(scratch):
+ * Wipe and release the memory held by scratch.
+ */
+void scrypt_scratch_free(scrypt_scratch *);
+
 #ifdef __cplusplus
 }
 #endif
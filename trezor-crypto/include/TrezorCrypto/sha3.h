@@ -77,6 +77,9 @@ void sha3_Final(SHA3_CTX *ctx, unsigned char* result);
 void keccak_Final(SHA3_CTX *ctx, unsigned char* result);
 void keccak_256(const unsigned char* data, size_t len, unsigned char* digest);
 void keccak_512(const unsigned char* data, size_t len, unsigned char* digest);
+// [wallet-core]
+/* digest[i] = Keccak-256 of data[i][0 .. len[i] - 1], for i < count */
+void keccak_256_multi(const unsigned char* const* data, const size_t* len, size_t count, unsigned char (*digest)[SHA3_256_DIGEST_LENGTH]);
 #endif
 
 void sha3_256(const unsigned char* data, size_t len, unsigned char* digest);